@@ -20,45 +20,57 @@
 #ifndef ATOMICINTEGER_H_
 #define ATOMICINTEGER_H_
 
-#include <com/xuggle/ferry/JNIHelper.h>
+#include <com/xuggle/ferry/Ferry.h>
+#include <inttypes.h>
 
 namespace com { namespace xuggle { namespace ferry {
 /**
  * Internal only.  Atomic Integer represents Integers than can be updated
  * atomically from native code.
  * <p>
- * This object is NOT meant to be called from Java (in fact, that'd be stupid
- * since you'd just be calling from native code back into Java).  It's
- * here so that native code inside a JVM can have access to portable
- * thread-safe objects.
+ * This object is NOT meant to be called from Java.  It's
+ * here so that native code can have access to portable
+ * thread-safe integers.
  * </p>  
  * <p>
- * And that said, this method is really only Atomic if running inside a
- * Java JVM (or other virtual machine that can provide the functionality).
- * If running in a standalone C++ program there
- * is no current guarantee of Atomicity.
- * </p><p>
- * The object just forwards to the Java object:
- * {@link java.util.concurrent.atomic.AtomicInteger}
+ * Every operation is a single compiler atomic builtin with full
+ * memory barrier semantics (the same guarantees as
+ * {@link java.util.concurrent.atomic.AtomicInteger}), and never calls
+ * into a Java virtual machine.  That makes it safe, and cheap, to use
+ * from any thread, including ones the JVM knows nothing about.
  * </p>
  */
 class VS_API_FERRY AtomicInteger
   {
     public:
-      AtomicInteger();
-      AtomicInteger(int32_t);
-      ~AtomicInteger();
+      AtomicInteger() : mValue(0) {}
+      AtomicInteger(int32_t val) : mValue(val) {}
+      ~AtomicInteger() {}
 
-      int32_t get();
-      void set(int32_t);
+      int32_t get() { return __sync_fetch_and_add(&mValue, 0); }
+      void set(int32_t newval) {
+        __sync_synchronize();
+        mValue = newval;
+        __sync_synchronize();
+      }
 
-      int32_t getAndSet(int32_t);
-      int32_t getAndIncrement();
-      int32_t getAndDecrement();
-      int32_t getAndAdd(int32_t);
-      int32_t incrementAndGet();
-      int32_t decrementAndGet();
-      int32_t addAndGet(int32_t);
+      int32_t getAndSet(int32_t newval) {
+        int32_t oldval;
+        do {
+          oldval = mValue;
+        } while (!__sync_bool_compare_and_swap(&mValue, oldval, newval));
+        return oldval;
+      }
+      int32_t getAndIncrement() { return __sync_fetch_and_add(&mValue, 1); }
+      int32_t getAndDecrement() { return __sync_fetch_and_sub(&mValue, 1); }
+      int32_t getAndAdd(int32_t delta) {
+        return __sync_fetch_and_add(&mValue, delta);
+      }
+      int32_t incrementAndGet() { return __sync_add_and_fetch(&mValue, 1); }
+      int32_t decrementAndGet() { return __sync_sub_and_fetch(&mValue, 1); }
+      int32_t addAndGet(int32_t delta) {
+        return __sync_add_and_fetch(&mValue, delta);
+      }
 
       /**
        * Compare the current value to expected, and if
@@ -67,38 +79,21 @@ class VS_API_FERRY AtomicInteger
        * @param update the value to update to
        * @return true if equal
        */
-      bool compareAndSet(int32_t expected, int32_t update);
+      bool compareAndSet(int32_t expected, int32_t update) {
+        return __sync_bool_compare_and_swap(&mValue, expected, update);
+      }
 
       /**
        * @return true if we're actually able to guarantee
-       * atomicity; false if we can't.
+       * atomicity; now always true.
        */
-      bool isAtomic();
-
-      friend class JNIHelper;
+      bool isAtomic() { return true; }
 
     private:
-      static bool init();
-
-      int32_t mNonAtomicValue;
-      jobject mAtomicValue;
-      static void initializeClass(JavaVM*, void*);
-      void initializeObject();
-      static jclass mClass;
-      static jmethodID mConstructorMethod;
-      static jmethodID mGetMethod;
-      static jmethodID mSetMethod;
-      static jmethodID mGetAndSetMethod;
-      static jmethodID mGetAndIncrementMethod;
-      static jmethodID mGetAndDecrementMethod;
-      static jmethodID mGetAndAddMethod;
-      static jmethodID mIncrementAndGetMethod;
-      static jmethodID mDecrementAndGetMethod;
-      static jmethodID mAddAndGetMethod;
-      static jmethodID mCompareAndSetMethod;
+      AtomicInteger(const AtomicInteger&);
+      AtomicInteger& operator=(const AtomicInteger&);
 
-      static bool mInitialized;
+      volatile int32_t mValue;
   };
 }}}
 #endif // ! ATOMICINTEGER_H_
-
@@ -102,6 +102,26 @@ Java_com_xuggle_ferry_Ferry_init(JNIEnv *env, jclass)
    * Internal Only.  Do not call.
    */
   public native static void setMemoryModel(int value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolHits();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolMisses();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolRetainedBytes();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolMaxRetainedBytes();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static void setPoolMaxRetainedBytes(long value);
   
 %}
 %pragma(java) moduleimports=%{
@@ -46,6 +46,11 @@
 #undef malloc
 #endif
 
+#ifdef VSJNI_USE_JVM_FOR_MEMMANAGEMENT
+// For the per-thread pooled free lists
+#include <pthread.h>
+#endif
+
 #include "Ferry.h"
 #include "RefCounted.h"
 
@@ -69,6 +74,7 @@ enum VSJNIMemoryModel
   JAVA_DIRECT_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION = 2,
   NATIVE_BUFFERS = 3,
   NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION = 4,
+  NATIVE_BUFFERS_POOLED = 5,
 };
 
 static enum VSJNIMemoryModel sVSJNI_IsMirroringNativeMemoryInJVM =
@@ -78,6 +84,16 @@ static enum VSJNIMemoryModel sVSJNI_IsMirroringNativeMemoryInJVM =
 NATIVE_BUFFERS;
 #endif
 
+/**
+ * Statistics for the NATIVE_BUFFERS_POOLED model.  These are only
+ * ever touched with atomic builtins, as blocks can be allocated and
+ * released on any thread.
+ */
+static volatile int64_t sVSJNI_PoolHits = 0;
+static volatile int64_t sVSJNI_PoolMisses = 0;
+static volatile int64_t sVSJNI_PoolRetainedBytes = 0;
+static volatile int64_t sVSJNI_PoolMaxRetainedBytes = 64 * 1024 * 1024;
+
 namespace com
 {
 namespace xuggle
@@ -104,6 +120,43 @@ JNIMemoryManager::free(void* mem)
   VSJNI_free(mem);
 }
 
+int64_t
+JNIMemoryManager::getPoolHits()
+{
+  return __sync_add_and_fetch(&sVSJNI_PoolHits, 0);
+}
+
+int64_t
+JNIMemoryManager::getPoolMisses()
+{
+  return __sync_add_and_fetch(&sVSJNI_PoolMisses, 0);
+}
+
+int64_t
+JNIMemoryManager::getPoolRetainedBytes()
+{
+  return __sync_add_and_fetch(&sVSJNI_PoolRetainedBytes, 0);
+}
+
+int64_t
+JNIMemoryManager::getPoolMaxRetainedBytes()
+{
+  return __sync_add_and_fetch(&sVSJNI_PoolMaxRetainedBytes, 0);
+}
+
+void
+JNIMemoryManager::setPoolMaxRetainedBytes(int64_t maxBytes)
+{
+  if (maxBytes < 0)
+    maxBytes = 0;
+  int64_t oldValue;
+  do
+  {
+    oldValue = sVSJNI_PoolMaxRetainedBytes;
+  } while (!__sync_bool_compare_and_swap(&sVSJNI_PoolMaxRetainedBytes,
+      oldValue, maxBytes));
+}
+
 }
 }
 }
@@ -224,8 +277,177 @@ struct VSJNI_AllocationHeader
    * Yes it's a shame, but another four bytes go to the model.
    */
   enum VSJNIMemoryModel mModel;
+  /**
+   * For NATIVE_BUFFERS_POOLED, the size class this block was
+   * carved for, or -1 if it was too big to pool.
+   */
+  int32_t mPoolClass;
 };
 
+/*
+ * The pooled model rounds blocks up to size classes of four steps per
+ * power of two (so at most 25% waste), starting at 256 bytes.  Blocks
+ * larger than the biggest class are malloced and freed as normal.
+ */
+static const int32_t VSJNI_POOL_NUM_CLASSES = 64;
+static const int32_t VSJNI_POOL_MIN_SHIFT = 7;
+
+/**
+ * A per-thread cache of freed blocks.  While a block sits on a free
+ * list, the first bytes after its header hold the next pointer.
+ */
+struct VSJNI_PoolCache
+{
+  VSJNI_AllocationHeader* mFree[VSJNI_POOL_NUM_CLASSES];
+};
+
+static pthread_key_t sVSJNI_PoolKey;
+static pthread_once_t sVSJNI_PoolKeyOnce = PTHREAD_ONCE_INIT;
+static bool sVSJNI_PoolKeyValid = false;
+
+static int32_t
+VSJNI_poolSizeClass(size_t blockSize, size_t *classSize)
+{
+  if (blockSize <= ((size_t)1 << (VSJNI_POOL_MIN_SHIFT + 1)))
+    blockSize = ((size_t)1 << (VSJNI_POOL_MIN_SHIFT + 1));
+  size_t n = blockSize - 1;
+  int32_t octave = 0;
+  while ((n >> octave) > 1)
+    ++octave;
+  // step is in [4,7]; the class size is (step+1) << (octave-2)
+  size_t step = n >> (octave - 2);
+  int32_t sizeClass = (octave - VSJNI_POOL_MIN_SHIFT) * 4 + (int32_t)step - 7;
+  if (sizeClass < 0 || sizeClass >= VSJNI_POOL_NUM_CLASSES)
+    return -1;
+  *classSize = (step + 1) << (octave - 2);
+  return sizeClass;
+}
+
+static size_t
+VSJNI_poolClassSize(int32_t sizeClass)
+{
+  int32_t octave = (sizeClass + 3) / 4 + VSJNI_POOL_MIN_SHIFT;
+  size_t step = (size_t)((sizeClass + 3) % 4) + 4;
+  return (step + 1) << (octave - 2);
+}
+
+static void
+VSJNI_poolCacheDestroy(void *closure)
+{
+  VSJNI_PoolCache *cache = (VSJNI_PoolCache*) closure;
+  if (!cache)
+    return;
+  for (int32_t i = 0; i < VSJNI_POOL_NUM_CLASSES; i++)
+  {
+    int64_t classSize = (int64_t) VSJNI_poolClassSize(i);
+    VSJNI_AllocationHeader* header = cache->mFree[i];
+    while (header)
+    {
+      VSJNI_AllocationHeader* next = *(VSJNI_AllocationHeader**) (header + 1);
+      free(header);
+      __sync_sub_and_fetch(&sVSJNI_PoolRetainedBytes, classSize);
+      header = next;
+    }
+    cache->mFree[i] = 0;
+  }
+  free(cache);
+}
+
+static void
+VSJNI_poolKeyInit()
+{
+  sVSJNI_PoolKeyValid =
+      pthread_key_create(&sVSJNI_PoolKey, VSJNI_poolCacheDestroy) == 0;
+}
+
+/**
+ * Get the calling thread's cache, creating it if needed.  Returns
+ * null if we can't get thread-local storage, in which case callers
+ * should skip the pool.
+ */
+static VSJNI_PoolCache *
+VSJNI_poolGetCache()
+{
+  pthread_once(&sVSJNI_PoolKeyOnce, VSJNI_poolKeyInit);
+  if (!sVSJNI_PoolKeyValid)
+    return 0;
+  VSJNI_PoolCache *cache = (VSJNI_PoolCache*) pthread_getspecific(
+      sVSJNI_PoolKey);
+  if (!cache)
+  {
+    cache = (VSJNI_PoolCache*) malloc(sizeof(VSJNI_PoolCache));
+    if (!cache)
+      return 0;
+    memset(cache, 0, sizeof(VSJNI_PoolCache));
+    if (pthread_setspecific(sVSJNI_PoolKey, cache) != 0)
+    {
+      free(cache);
+      return 0;
+    }
+  }
+  return cache;
+}
+
+static void *
+VS_JNI_malloc_pooled(size_t requested_size)
+{
+  size_t blockSize = requested_size + sizeof(VSJNI_AllocationHeader)
+      + VSJNI_ALIGNMENT_BOUNDARY;
+  size_t classSize = 0;
+  int32_t sizeClass = VSJNI_poolSizeClass(blockSize, &classSize);
+  VSJNI_AllocationHeader *header = 0;
+  if (sizeClass >= 0)
+  {
+    VSJNI_PoolCache *cache = VSJNI_poolGetCache();
+    if (cache && cache->mFree[sizeClass])
+    {
+      header = cache->mFree[sizeClass];
+      cache->mFree[sizeClass] = *(VSJNI_AllocationHeader**) (header + 1);
+      __sync_sub_and_fetch(&sVSJNI_PoolRetainedBytes, (int64_t) classSize);
+      __sync_add_and_fetch(&sVSJNI_PoolHits, 1);
+    }
+    else
+      blockSize = classSize;
+  }
+  if (!header)
+  {
+    __sync_add_and_fetch(&sVSJNI_PoolMisses, 1);
+    header = (VSJNI_AllocationHeader*) malloc(blockSize);
+    if (!header)
+      throw std::bad_alloc();
+  }
+  memset(header, 0, sizeof(VSJNI_AllocationHeader));
+  header->mModel = NATIVE_BUFFERS_POOLED;
+  header->mPoolClass = sizeClass;
+
+  return (void*) ((char*) header + sizeof(VSJNI_AllocationHeader));
+}
+
+static void
+VS_JNI_free_pooled(VSJNI_AllocationHeader *header)
+{
+  int32_t sizeClass = header->mPoolClass;
+  if (sizeClass >= 0 && sizeClass < VSJNI_POOL_NUM_CLASSES)
+  {
+    int64_t classSize = (int64_t) VSJNI_poolClassSize(sizeClass);
+    // reserve room under the cap first, and back out if we blew it
+    int64_t retained = __sync_add_and_fetch(&sVSJNI_PoolRetainedBytes,
+        classSize);
+    if (retained <= sVSJNI_PoolMaxRetainedBytes)
+    {
+      VSJNI_PoolCache *cache = VSJNI_poolGetCache();
+      if (cache)
+      {
+        *(VSJNI_AllocationHeader**) (header + 1) = cache->mFree[sizeClass];
+        cache->mFree[sizeClass] = header;
+        return;
+      }
+    }
+    __sync_sub_and_fetch(&sVSJNI_PoolRetainedBytes, classSize);
+  }
+  free(header);
+}
+
 static void *
 VS_JNI_malloc_native(JNIEnv *env, jobject obj, size_t requested_size,
     bool notifyJavaHeap)
@@ -476,7 +698,7 @@ VSJNI_malloc(jobject obj, size_t requested_size)
     (void) obj;
     env = VSJNI_getEnv();
     enum VSJNIMemoryModel model = sVSJNI_IsMirroringNativeMemoryInJVM;
-    if (!env)
+    if (!env && model != NATIVE_BUFFERS_POOLED)
       model = NATIVE_BUFFERS;
     switch (model)
     {
@@ -497,6 +719,9 @@ VSJNI_malloc(jobject obj, size_t requested_size)
       case NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION:
         retval = VS_JNI_malloc_native(env, obj, requested_size, true);
         break;
+      case NATIVE_BUFFERS_POOLED:
+        retval = VS_JNI_malloc_pooled(requested_size);
+        break;
       default:
         throw std::bad_alloc();
         break;
@@ -625,6 +850,9 @@ VSJNI_free(void * mem)
         free(buffer);
       }
         break;
+      case NATIVE_BUFFERS_POOLED:
+        VS_JNI_free_pooled(header);
+        break;
       default:
         fprintf(stderr, "ERROR: Should never get here\n");
         /** error; should never be here */
@@ -769,4 +997,36 @@ Java_com_xuggle_ferry_FerryJNI_setMemoryModel(JNIEnv *, jclass, jint value)
 #endif
 }
 
+VS_API_EXPORT jlong JNICALL
+Java_com_xuggle_ferry_FerryJNI_getPoolHits(JNIEnv *, jclass)
+{
+  return (jlong) com::xuggle::ferry::JNIMemoryManager::getPoolHits();
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_com_xuggle_ferry_FerryJNI_getPoolMisses(JNIEnv *, jclass)
+{
+  return (jlong) com::xuggle::ferry::JNIMemoryManager::getPoolMisses();
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_com_xuggle_ferry_FerryJNI_getPoolRetainedBytes(JNIEnv *, jclass)
+{
+  return (jlong) com::xuggle::ferry::JNIMemoryManager::getPoolRetainedBytes();
+}
+
+VS_API_EXPORT jlong JNICALL
+Java_com_xuggle_ferry_FerryJNI_getPoolMaxRetainedBytes(JNIEnv *, jclass)
+{
+  return (jlong) com::xuggle::ferry::JNIMemoryManager::getPoolMaxRetainedBytes();
+}
+
+VS_API_EXPORT void JNICALL
+Java_com_xuggle_ferry_FerryJNI_setPoolMaxRetainedBytes(JNIEnv *, jclass,
+    jlong value)
+{
+  com::xuggle::ferry::JNIMemoryManager::setPoolMaxRetainedBytes(
+      (int64_t) value);
+}
+
 }
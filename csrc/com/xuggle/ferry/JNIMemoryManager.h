@@ -103,6 +103,49 @@ public:
    *
    */
   static void* malloc(void *allocator, size_t requested_size);
+
+  /**
+   * Get the number of allocations that were satisfied from a
+   * recycled block when using the pooled native memory model.
+   *
+   * @return number of pool hits since the process started.
+   */
+  static int64_t getPoolHits();
+
+  /**
+   * Get the number of allocations that had to go to the native
+   * heap when using the pooled native memory model.
+   *
+   * @return number of pool misses since the process started.
+   */
+  static int64_t getPoolMisses();
+
+  /**
+   * Get the number of bytes currently sitting unused in pooled
+   * free lists across all threads.
+   *
+   * @return bytes retained by the pool.
+   */
+  static int64_t getPoolRetainedBytes();
+
+  /**
+   * Get the maximum number of bytes the pooled native memory model
+   * will hold on to across all threads before releasing freed
+   * blocks back to the native heap.
+   *
+   * @return the cap, in bytes.
+   */
+  static int64_t getPoolMaxRetainedBytes();
+
+  /**
+   * Set the maximum number of bytes the pooled native memory model
+   * will hold on to.  Lowering the cap does not release blocks already
+   * pooled; it only stops more from being retained.
+   *
+   * @param maxBytes The new cap, in bytes.  Values < 0 are treated as 0,
+   *   which effectively disables recycling.
+   */
+  static void setPoolMaxRetainedBytes(int64_t maxBytes);
 };
 }}}
 #endif /* JNIMEMORYMANAGER_H_ */
@@ -19,11 +19,150 @@
 
 #include "Logger.h"
 #include "JNIHelper.h"
+#include "SpinMutex.h"
 #include <cstring>
+#include <vector>
 
 #include <iostream>
 
+#include <pthread.h>
+#include <sys/time.h>
+#include <time.h>
+
 namespace com { namespace xuggle { namespace ferry {
+
+  /*
+   * Asynchronous logging.
+   *
+   * Each thread that logs gets a single-producer, single-consumer ring
+   * of fixed size records; only that thread moves head, and only the
+   * one thread holding sDrainLock (usually the drainer) moves tail, so
+   * the logging side never takes a lock.  The list of rings itself is
+   * guarded by sRingsLock, which is only taken when a thread logs for
+   * the first time and while draining.
+   *
+   * Records point at the logger that made them, so only static loggers,
+   * which live until shutdown and flush before they go, ever queue;
+   * loggers from getLogger() may be deleted by their callers at any
+   * time, and always log synchronously.
+   */
+  namespace {
+    const int cAsyncMessageLength = 256;
+    const uint32_t cRingSize = 512;
+
+    struct LogRecord
+    {
+      Logger* logger;
+      Logger::Level level;
+      char msg[cAsyncMessageLength];
+    };
+
+    struct LogRing
+    {
+      volatile uint32_t head;
+      volatile uint32_t tail;
+      // set when the owning thread exits; the drainer frees the ring
+      // once it is empty
+      volatile int32_t abandoned;
+      LogRecord records[cRingSize];
+    };
+  }
+
+  static volatile int32_t sAsynchronous = 0;
+  static volatile int64_t sDroppedRecords = 0;
+  static volatile int64_t sForwardedRecords = 0;
+
+  static SpinMutex sRingsLock;
+  static std::vector<LogRing*> sRings;
+
+  static pthread_once_t sAsyncOnce = PTHREAD_ONCE_INIT;
+  static pthread_key_t sRingKey;
+  static pthread_mutex_t sDrainLock = PTHREAD_MUTEX_INITIALIZER;
+  static pthread_mutex_t sDrainerMutex = PTHREAD_MUTEX_INITIALIZER;
+  static pthread_cond_t sDrainerWakeup = PTHREAD_COND_INITIALIZER;
+  // guarded by sDrainerMutex
+  static bool sDrainerRunning = false;
+
+  static void
+  Logger_abandonRing(void* ring)
+  {
+    if (ring)
+      ((LogRing*)ring)->abandoned = 1;
+  }
+
+  static void
+  Logger_initAsync()
+  {
+    pthread_key_create(&sRingKey, Logger_abandonRing);
+  }
+
+  static LogRing*
+  Logger_getRing()
+  {
+    LogRing* ring = (LogRing*)pthread_getspecific(sRingKey);
+    if (!ring)
+    {
+      ring = new LogRing;
+      ring->head = 0;
+      ring->tail = 0;
+      ring->abandoned = 0;
+      sRingsLock.lock();
+      sRings.push_back(ring);
+      sRingsLock.unlock();
+      pthread_setspecific(sRingKey, ring);
+    }
+    return ring;
+  }
+
+  /*
+   * Forward everything queued in all rings; returns how many records
+   * were forwarded.  Only ever called with sDrainLock held.
+   */
+  static int64_t
+  Logger_drainRings(bool (*forward)(Logger*, Logger::Level, const char*))
+  {
+    std::vector<LogRing*> rings;
+    sRingsLock.lock();
+    rings = sRings;
+    sRingsLock.unlock();
+
+    int64_t forwarded = 0;
+    for(size_t i = 0; i < rings.size(); i++)
+    {
+      LogRing* ring = rings[i];
+      uint32_t tail = ring->tail;
+      uint32_t head = ring->head;
+      // don't read records before we've read head
+      __sync_synchronize();
+      for(; tail != head; ++tail)
+      {
+        LogRecord* record = &ring->records[tail % cRingSize];
+        forward(record->logger, record->level, record->msg);
+        ++forwarded;
+      }
+      // finish with the records before handing the slots back
+      __sync_synchronize();
+      ring->tail = tail;
+
+      if (ring->abandoned && ring->head == tail)
+      {
+        sRingsLock.lock();
+        for(std::vector<LogRing*>::iterator it = sRings.begin();
+            it != sRings.end(); ++it)
+          if (*it == ring)
+          {
+            sRings.erase(it);
+            break;
+          }
+        sRingsLock.unlock();
+        delete ring;
+      }
+    }
+    if (forwarded)
+      __sync_fetch_and_add(&sForwardedRecords, forwarded);
+    return forwarded;
+  }
+
   bool Logger :: mInitialized = false;
   bool Logger :: mGlobalIsLogging[5] = { true, true, true, true, true };
   jclass Logger :: mClass = 0;
@@ -67,6 +206,7 @@ namespace com { namespace xuggle { namespace ferry {
 
     strncpy(mLoggerName, loggerName, sizeof(mLoggerName));
 
+    mIsStatic = false;
     mJavaLogger = 0;
     JNIEnv *env=JNIHelper::sGetEnv();
     if (env && javaLogger)
@@ -77,6 +217,9 @@ namespace com { namespace xuggle { namespace ferry {
 
   Logger :: ~Logger()
   {
+    if (mIsStatic)
+      // forward anything we queued while we're still here to do it
+      flush();
     JNIEnv *env=JNIHelper::sGetEnv();
     if (env)
     {
@@ -181,6 +324,7 @@ namespace com { namespace xuggle { namespace ferry {
     logger = Logger::getLogger(aLoggerName);
     if (logger)
     {
+        logger->mIsStatic = true;
         // Register a function to kill it when the JNIHelper says we
         // can
         JNIHelper::sRegisterTerminationCallback(Logger::shutdownJavaBindings,
@@ -320,6 +464,153 @@ namespace com { namespace xuggle { namespace ferry {
     return retval;
   }
 
+  bool
+  Logger :: submit(Level level, const char* msg)
+  {
+    if (!sAsynchronous || !mIsStatic)
+      return doLog(level, msg);
+
+    size_t len = strlen(msg);
+    if (len >= (size_t)cAsyncMessageLength)
+      // too big to queue; rare enough to just log it here
+      return doLog(level, msg);
+
+    LogRing* ring = Logger_getRing();
+    uint32_t head = ring->head;
+    if (head - ring->tail >= cRingSize)
+    {
+      __sync_fetch_and_add(&sDroppedRecords, 1);
+      return false;
+    }
+    LogRecord* record = &ring->records[head % cRingSize];
+    record->logger = this;
+    record->level = level;
+    memcpy(record->msg, msg, len+1);
+    // publish the record before moving head past it
+    __sync_synchronize();
+    ring->head = head + 1;
+    // if we raced a switch to synchronous logging the drainer may
+    // already be gone; forward it ourselves
+    __sync_synchronize();
+    if (!sAsynchronous)
+      flush();
+    return true;
+  }
+
+  bool
+  Logger :: forward(Logger* logger, Level level, const char* msg)
+  {
+    return logger->doLog(level, msg);
+  }
+
+  void*
+  Logger :: drain(void*)
+  {
+    // a daemon thread, so we never keep the Java virtual machine alive
+    JavaVM* vm = JNIHelper::sGetVM();
+    if (vm)
+    {
+      JNIEnv* env = 0;
+      vm->AttachCurrentThreadAsDaemon((void**)(void*)&env, 0);
+    }
+    for(;;)
+    {
+      pthread_mutex_lock(&sDrainLock);
+      int64_t forwarded = Logger_drainRings(Logger::forward);
+      pthread_mutex_unlock(&sDrainLock);
+      if (forwarded)
+        continue;
+
+      pthread_mutex_lock(&sDrainerMutex);
+      if (!sAsynchronous)
+      {
+        // anything queued after this is forwarded by whoever queued it;
+        // see submit()
+        sDrainerRunning = false;
+        pthread_mutex_unlock(&sDrainerMutex);
+        break;
+      }
+      // loggers never wake us, so poll
+      struct timeval now;
+      gettimeofday(&now, 0);
+      struct timespec until;
+      until.tv_sec = now.tv_sec;
+      until.tv_nsec = now.tv_usec * 1000 + 5000000;
+      if (until.tv_nsec >= 1000000000)
+      {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000;
+      }
+      pthread_cond_timedwait(&sDrainerWakeup, &sDrainerMutex, &until);
+      pthread_mutex_unlock(&sDrainerMutex);
+    }
+    // one last pass for records queued while we were deciding to stop
+    flush();
+    if (vm)
+      vm->DetachCurrentThread();
+    return 0;
+  }
+
+  void
+  Logger :: setAsynchronous(bool value)
+  {
+    pthread_once(&sAsyncOnce, Logger_initAsync);
+    pthread_mutex_lock(&sDrainerMutex);
+    sAsynchronous = value;
+    if (value && !sDrainerRunning)
+    {
+      pthread_t thread;
+      pthread_attr_t attr;
+      pthread_attr_init(&attr);
+      pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+      if (pthread_create(&thread, &attr, Logger::drain, 0) == 0)
+        sDrainerRunning = true;
+      else
+        sAsynchronous = false;
+      pthread_attr_destroy(&attr);
+    }
+    // wakes the drainer so it can stop if we turned it off
+    pthread_cond_broadcast(&sDrainerWakeup);
+    pthread_mutex_unlock(&sDrainerMutex);
+    if (!value)
+      flush();
+  }
+
+  bool
+  Logger :: isAsynchronous()
+  {
+    return sAsynchronous;
+  }
+
+  void
+  Logger :: flush()
+  {
+    // waits for the drainer if it's mid-pass, then forwards the rest
+    // on this thread
+    pthread_mutex_lock(&sDrainLock);
+    Logger_drainRings(Logger::forward);
+    pthread_mutex_unlock(&sDrainLock);
+  }
+
+  int64_t
+  Logger :: getNumDroppedRecords()
+  {
+    return __sync_fetch_and_add(&sDroppedRecords, 0);
+  }
+
+  int64_t
+  Logger :: getNumForwardedRecords()
+  {
+    return __sync_fetch_and_add(&sForwardedRecords, 0);
+  }
+
+  void
+  Logger :: resetRecordCounts()
+  {
+    __sync_lock_test_and_set(&sDroppedRecords, 0);
+    __sync_lock_test_and_set(&sForwardedRecords, 0);
+  }
+
   bool
   Logger :: log(const char* filename, int line, Level level, const char *fmt, ...)
   {
@@ -340,7 +631,7 @@ namespace com { namespace xuggle { namespace ferry {
     {
       char msg[cMaxLogMessageLength+1];
       formatMsg(msg, sizeof(msg), filename, line, fmt, ap);
-      didLog = this->doLog(level, msg);
+      didLog = this->submit(level, msg);
     }
     return didLog;
   }
@@ -357,7 +648,7 @@ namespace com { namespace xuggle { namespace ferry {
   { \
     char msg[cMaxLogMessageLength+1]; \
     formatMsg(msg, sizeof(msg), filename, line, fmt, ap); \
-    didLog = this->doLog(level, msg); \
+    didLog = this->submit(level, msg); \
   } \
   va_end(ap); \
   return didLog; \
@@ -21,6 +21,7 @@
 #define LOGGER_H_
 
 #include <cstdarg>
+#include <inttypes.h>
 
 #ifdef VS_DEBUG
 #include <assert.h>
@@ -112,6 +113,62 @@ namespace com { namespace xuggle { namespace ferry {
     static void setGlobalIsLogging(Level level, bool value);
     const char * getName();
 
+    /*
+     * Added for 5.5
+     */
+
+    /**
+     * Turn asynchronous logging on or off for all static loggers.
+     * <p>
+     * When on, a thread that logs formats its message into a lock-free
+     * queue of its own and carries on; a single background thread
+     * forwards queued messages to Java (or standard error) in batches.
+     * When a thread's queue is full its messages are dropped and counted
+     * rather than making it wait.  Messages too long to queue are
+     * logged synchronously, as is everything logged through loggers
+     * from #getLogger, since their callers may delete them at any time.
+     * </p><p>
+     * Off by default.  Turning it off forwards queued messages and
+     * stops the background thread.
+     * </p>
+     * @param value true to log asynchronously.
+     * @since 5.5
+     */
+    static void setAsynchronous(bool value);
+
+    /**
+     * @return true if logging is asynchronous.
+     * @since 5.5
+     */
+    static bool isAsynchronous();
+
+    /**
+     * Forward every message queued so far, on the calling thread if
+     * the background thread hasn't got to them yet.
+     * @since 5.5
+     */
+    static void flush();
+
+    /**
+     * @return the number of messages dropped because the logging
+     *   thread's queue was full.
+     * @since 5.5
+     */
+    static int64_t getNumDroppedRecords();
+
+    /**
+     * @return the number of queued messages the background thread has
+     *   forwarded.
+     * @since 5.5
+     */
+    static int64_t getNumForwardedRecords();
+
+    /**
+     * Set the dropped and forwarded message counts to zero.
+     * @since 5.5
+     */
+    static void resetRecordCounts();
+
     virtual ~Logger();
 
   protected:
@@ -130,10 +187,16 @@ namespace com { namespace xuggle { namespace ferry {
     static const int cMaxLoggerNameLength=255;
     char mLoggerName[cMaxLoggerNameLength+1];
     bool mIsLogging[5];
+    // made by getStaticLogger; only these queue asynchronous messages
+    bool mIsStatic;
 
     bool doLog(Level level, const char*msg);
     bool doNativeLog(Level level, const char *msg);
     bool doJavaLog(Level level, const char* msg);
+    // queues msg if we're asynchronous, else logs it
+    bool submit(Level level, const char* msg);
+    static bool forward(Logger* logger, Level level, const char* msg);
+    static void* drain(void*);
 
     jobject mJavaLogger;
     static jclass mClass;
@@ -166,6 +229,9 @@ namespace com { namespace xuggle { namespace ferry {
  *      VS_LOG_ERROR("an example: %s", aStringVariable);
  * </code>
  *
+ * The level is checked before the arguments are evaluated, so
+ * disabled log statements cost a couple of loads and a branch.
+ *
  * IMPORTANT NOTE: These macros use "Variadic Macros" which are
  * not guaranteed to work on all compilers, but work on our
  * set of GCC 4.x, Visual Studio 2005+.
@@ -179,19 +245,29 @@ namespace com { namespace xuggle { namespace ferry {
   com::xuggle::ferry::Logger::getStaticLogger( VS_TOSTRING( LOGGERNAME ) ) )
 
 #define VS_LOG_ERROR(...) \
-  (void) vs_logger_static_context->error(__FILE__, __LINE__, __VA_ARGS__)
+  (void) (vs_logger_static_context->isLogging( \
+      com::xuggle::ferry::Logger::LEVEL_ERROR) && \
+    vs_logger_static_context->error(__FILE__, __LINE__, __VA_ARGS__))
 
 #define VS_LOG_WARN(...) \
-  (void) vs_logger_static_context->warn(__FILE__, __LINE__, __VA_ARGS__)
+  (void) (vs_logger_static_context->isLogging( \
+      com::xuggle::ferry::Logger::LEVEL_WARN) && \
+    vs_logger_static_context->warn(__FILE__, __LINE__, __VA_ARGS__))
 
 #define VS_LOG_INFO(...) \
-  (void) vs_logger_static_context->info(__FILE__, __LINE__, __VA_ARGS__)
+  (void) (vs_logger_static_context->isLogging( \
+      com::xuggle::ferry::Logger::LEVEL_INFO) && \
+    vs_logger_static_context->info(__FILE__, __LINE__, __VA_ARGS__))
 
 #define VS_LOG_DEBUG(...) \
-  (void) vs_logger_static_context->debug(__FILE__, __LINE__, __VA_ARGS__)
+  (void) (vs_logger_static_context->isLogging( \
+      com::xuggle::ferry::Logger::LEVEL_DEBUG) && \
+    vs_logger_static_context->debug(__FILE__, __LINE__, __VA_ARGS__))
 
 #define VS_LOG_TRACE(...) \
-  (void) vs_logger_static_context->trace(__FILE__, __LINE__, __VA_ARGS__)
+  (void) (vs_logger_static_context->isLogging( \
+      com::xuggle::ferry::Logger::LEVEL_TRACE) && \
+    vs_logger_static_context->trace(__FILE__, __LINE__, __VA_ARGS__))
 
 #ifdef VS_DEBUG
 #define VS_ASSERT( expr , msg ) \
@@ -18,7 +18,6 @@
  *******************************************************************************/
 
 #include "RefCounted.h"
-#include "AtomicInteger.h"
 #include "JNIHelper.h"
 //#include "Logger.h"
 
@@ -26,17 +25,13 @@
 
 namespace com { namespace xuggle { namespace ferry {
 
-  RefCounted :: RefCounted()
+  RefCounted :: RefCounted() : mRefCount(0)
   {
-    mRefCount = new AtomicInteger(0);
     mAllocator = 0;
   }
 
   RefCounted :: ~RefCounted()
   {
-    if (mRefCount)
-      delete mRefCount;
-    mRefCount = 0;
     if (mAllocator)
       JNIHelper::sDeleteGlobalRef((jobject)mAllocator);
     mAllocator = 0;
@@ -63,14 +58,14 @@ namespace com { namespace xuggle { namespace ferry {
   RefCounted :: acquire()
   {
     //VS_LOG_DEBUG("acquire: %p", this);
-    return mRefCount->incrementAndGet();
+    return mRefCount.incrementAndGet();
   }
 
   int32_t
   RefCounted :: release()
   {
     //VS_LOG_DEBUG("release: %p", this);
-    int32_t retval = mRefCount->decrementAndGet();
+    int32_t retval = mRefCount.decrementAndGet();
     if (!retval)
       this->destroy();
     return retval;
@@ -79,7 +74,7 @@ namespace com { namespace xuggle { namespace ferry {
   int32_t
   RefCounted :: getCurrentRefCount()
   {
-    return mRefCount->get();
+    return mRefCount.get();
   }
 
   void
@@ -30,9 +30,9 @@
 #include <stdexcept>
 
 #include <com/xuggle/ferry/Ferry.h>
+#include <com/xuggle/ferry/AtomicInteger.h>
 
 namespace com { namespace xuggle { namespace ferry {
-  class AtomicInteger;
 
   /**
    * Parent of all Ferry objects -- it mains reference counts
@@ -185,7 +185,7 @@ namespace com { namespace xuggle { namespace ferry {
      * This is the internal reference count, represented as
      * an AtomicInteger to make sure it is thread safe.
      */
-    AtomicInteger* mRefCount;
+    AtomicInteger mRefCount;
 
     /**
      * Not part of public API.
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include "SpinMutex.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+namespace com { namespace xuggle { namespace ferry {
+
+  /**
+   * How many times we check the lock word before giving up the
+   * processor.  Most critical sections guarded by a SpinMutex are
+   * a handful of instructions long.
+   */
+  static const int32_t SPINMUTEX_SPINS_BEFORE_YIELD = 100;
+
+  static inline void
+  SpinMutex_pause()
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__ ("pause");
+#endif
+  }
+
+  static inline void
+  SpinMutex_yield()
+  {
+#ifdef _WIN32
+    Sleep(0);
+#else
+    sched_yield();
+#endif
+  }
+
+  SpinMutex :: SpinMutex()
+  {
+    mLocked = 0;
+  }
+
+  SpinMutex :: ~SpinMutex()
+  {
+  }
+
+  bool
+  SpinMutex :: tryLock()
+  {
+    return !mLocked && !__sync_lock_test_and_set(&mLocked, 1);
+  }
+
+  void
+  SpinMutex :: lock()
+  {
+    if (!__sync_lock_test_and_set(&mLocked, 1))
+      return;
+    while (true)
+    {
+      // spin on a plain read so we're not bouncing the cache line
+      // between waiting processors
+      for (int32_t i = 0; mLocked && i < SPINMUTEX_SPINS_BEFORE_YIELD; i++)
+        SpinMutex_pause();
+      if (tryLock())
+        return;
+      SpinMutex_yield();
+    }
+  }
+
+  void
+  SpinMutex :: unlock()
+  {
+    __sync_lock_release(&mLocked);
+  }
+
+}}}
@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef SPINMUTEX_H_
+#define SPINMUTEX_H_
+
+#include <com/xuggle/ferry/Ferry.h>
+#include <inttypes.h>
+
+namespace com { namespace xuggle { namespace ferry {
+
+  /**
+   * Internal Only.
+   * <p>
+   * A small, non-recursive mutual exclusion lock implemented entirely
+   * in native code.
+   * </p><p>
+   * Unlike {@link Mutex}, a SpinMutex never calls into the Java virtual
+   * machine, works the same whether or not we're running inside Java,
+   * and can be used from threads the JVM knows nothing about.  It is
+   * meant for guarding short critical sections on hot paths: lock()
+   * spins briefly, and then yields the processor between attempts
+   * rather than putting the thread to sleep.
+   * </p><p>
+   * SpinMutex objects are plain C++ objects (not {@link RefCounted})
+   * so they can be embedded in other objects or declared static.
+   * </p>
+   */
+  class VS_API_FERRY SpinMutex
+  {
+  public:
+    SpinMutex();
+    ~SpinMutex();
+
+    /**
+     * Block until we hold the lock.
+     */
+    void lock();
+    /**
+     * Take the lock if nobody else holds it.
+     * @return true if we now hold the lock; false if someone else does.
+     */
+    bool tryLock();
+    /**
+     * Release a lock we hold.
+     */
+    void unlock();
+
+    /**
+     * Holds a SpinMutex until it goes out of scope, so an exception
+     * (say std::bad_alloc from a container insert) can't leave it
+     * locked.
+     */
+    class Guard
+    {
+    public:
+      Guard(SpinMutex& mutex) : mMutex(mutex) { mMutex.lock(); }
+      ~Guard() { mMutex.unlock(); }
+    private:
+      Guard(const Guard&);
+      Guard& operator=(const Guard&);
+      SpinMutex& mMutex;
+    };
+
+  private:
+    SpinMutex(const SpinMutex&);
+    SpinMutex& operator=(const SpinMutex&);
+
+    volatile int32_t mLocked;
+  };
+
+}}}
+
+#endif /*SPINMUTEX_H_*/
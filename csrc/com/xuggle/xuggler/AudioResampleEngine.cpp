@@ -0,0 +1,708 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <com/xuggle/xuggler/AudioResampleEngine.h>
+#include <com/xuggle/xuggler/FfmpegIncludes.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+namespace {
+
+const double AudioResampleEngine_kMinus3dB = 0.70710678118654752440;
+// the Kaiser window beta libavcodec's resampler used
+const double AudioResampleEngine_kKaiserBeta = 9.0;
+// keeps the filter bank to a few megabytes at worst
+const int32_t AudioResampleEngine_kMaxLog2PhaseCount = 16;
+
+int64_t
+AudioResampleEngine_gcd(int64_t a, int64_t b)
+{
+  while (b)
+  {
+    int64_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/*
+ * Zeroth order modified Bessel function of the first kind, for the
+ * Kaiser window.
+ */
+double
+AudioResampleEngine_bessel(double x)
+{
+  double v = 1;
+  double lastV = 0;
+  double t = 1;
+  x = x * x / 4;
+  for (int i = 1; v != lastV; i++)
+  {
+    lastV = v;
+    t *= x / (i * i);
+    v += t;
+  }
+  return v;
+}
+
+/*
+ * The packed format with the same sample type as format, or FMT_NONE
+ * if format is not one we know.
+ */
+IAudioSamples::Format
+AudioResampleEngine_packed(IAudioSamples::Format format)
+{
+  switch (format)
+  {
+    case IAudioSamples::FMT_U8:
+    case IAudioSamples::FMT_U8P:
+      return IAudioSamples::FMT_U8;
+    case IAudioSamples::FMT_S16:
+    case IAudioSamples::FMT_S16P:
+      return IAudioSamples::FMT_S16;
+    case IAudioSamples::FMT_S32:
+    case IAudioSamples::FMT_S32P:
+      return IAudioSamples::FMT_S32;
+    case IAudioSamples::FMT_FLT:
+    case IAudioSamples::FMT_FLTP:
+      return IAudioSamples::FMT_FLT;
+    case IAudioSamples::FMT_DBL:
+    case IAudioSamples::FMT_DBLP:
+      return IAudioSamples::FMT_DBL;
+    default:
+      return IAudioSamples::FMT_NONE;
+  }
+}
+
+bool
+AudioResampleEngine_isPlanar(IAudioSamples::Format format)
+{
+  return AudioResampleEngine_packed(format) != format;
+}
+
+int32_t
+AudioResampleEngine_bytesPerSample(IAudioSamples::Format format)
+{
+  return IAudioSamples::findSampleBitDepth(format) / 8;
+}
+
+/*
+ * The dot product of n (a multiple of 4) floats.  Both paths sum four
+ * lanes separately and add them the same way, so they give the same
+ * result.
+ */
+inline float
+AudioResampleEngine_dot(const float* a, const float* b, int32_t n)
+{
+#ifdef __SSE2__
+  __m128 sum = _mm_setzero_ps();
+  for (int32_t i = 0; i < n; i += 4)
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  // (s0+s1) + (s2+s3)
+  __m128 pairs = _mm_add_ps(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  pairs = _mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs));
+  return _mm_cvtss_f32(pairs);
+#else
+  float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  for (int32_t i = 0; i < n; i += 4)
+  {
+    s0 += a[i] * b[i];
+    s1 += a[i + 1] * b[i + 1];
+    s2 += a[i + 2] * b[i + 2];
+    s3 += a[i + 3] * b[i + 3];
+  }
+  return (s0 + s1) + (s2 + s3);
+#endif
+}
+
+inline float
+AudioResampleEngine_clip(float value, float min, float max)
+{
+  return value < min ? min : (value > max ? max : value);
+}
+
+/*
+ * Converts n contiguous samples of a packed format to float.
+ */
+void
+AudioResampleEngine_toFloat(IAudioSamples::Format format, const void* src,
+    float* dst, int32_t n)
+{
+  int32_t i = 0;
+  switch (format)
+  {
+    case IAudioSamples::FMT_U8:
+    {
+      const uint8_t* in = (const uint8_t*) src;
+      for (; i < n; i++)
+        dst[i] = (in[i] - 128) * (1.0f / 128);
+      break;
+    }
+    case IAudioSamples::FMT_S16:
+    {
+      const int16_t* in = (const int16_t*) src;
+#ifdef __SSE2__
+      const __m128 scale = _mm_set1_ps(1.0f / 32768);
+      for (; i + 8 <= n; i += 8)
+      {
+        __m128i s = _mm_loadu_si128((const __m128i*) (in + i));
+        // sign extend by unpacking into the high half and shifting down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+      }
+#endif
+      for (; i < n; i++)
+        dst[i] = in[i] * (1.0f / 32768);
+      break;
+    }
+    case IAudioSamples::FMT_S32:
+    {
+      const int32_t* in = (const int32_t*) src;
+      for (; i < n; i++)
+        dst[i] = (float) (in[i] * (1.0 / 2147483648.0));
+      break;
+    }
+    case IAudioSamples::FMT_FLT:
+      memcpy(dst, src, n * sizeof(float));
+      break;
+    case IAudioSamples::FMT_DBL:
+    {
+      const double* in = (const double*) src;
+      for (; i < n; i++)
+        dst[i] = (float) in[i];
+      break;
+    }
+    default:
+      memset(dst, 0, n * sizeof(float));
+      break;
+  }
+}
+
+/*
+ * Converts n contiguous floats to a packed format, clipping integer
+ * formats.  Rounds to nearest (even on ties) in both paths.
+ */
+void
+AudioResampleEngine_fromFloat(IAudioSamples::Format format, const float* src,
+    void* dst, int32_t n)
+{
+  int32_t i = 0;
+  switch (format)
+  {
+    case IAudioSamples::FMT_U8:
+    {
+      uint8_t* out = (uint8_t*) dst;
+      for (; i < n; i++)
+        out[i] = (uint8_t) lrintf(
+            AudioResampleEngine_clip(src[i] * 128 + 128, 0, 255));
+      break;
+    }
+    case IAudioSamples::FMT_S16:
+    {
+      int16_t* out = (int16_t*) dst;
+#ifdef __SSE2__
+      const __m128 scale = _mm_set1_ps(32768);
+      const __m128 min = _mm_set1_ps(-32768);
+      const __m128 max = _mm_set1_ps(32767);
+      for (; i + 8 <= n; i += 8)
+      {
+        __m128 a = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+        __m128 b = _mm_mul_ps(_mm_loadu_ps(src + i + 4), scale);
+        a = _mm_min_ps(_mm_max_ps(a, min), max);
+        b = _mm_min_ps(_mm_max_ps(b, min), max);
+        _mm_storeu_si128((__m128i*) (out + i),
+            _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+      }
+#endif
+      for (; i < n; i++)
+        out[i] = (int16_t) lrintf(
+            AudioResampleEngine_clip(src[i] * 32768, -32768, 32767));
+      break;
+    }
+    case IAudioSamples::FMT_S32:
+    {
+      int32_t* out = (int32_t*) dst;
+      for (; i < n; i++)
+      {
+        double v = src[i] * 2147483648.0;
+        v = v < -2147483648.0 ? -2147483648.0 : (v > 2147483647.0 ? 2147483647.0 : v);
+        out[i] = (int32_t) llrint(v);
+      }
+      break;
+    }
+    case IAudioSamples::FMT_FLT:
+      memcpy(dst, src, n * sizeof(float));
+      break;
+    case IAudioSamples::FMT_DBL:
+    {
+      double* out = (double*) dst;
+      for (; i < n; i++)
+        out[i] = src[i];
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+}
+
+AudioResampleEngine :: AudioResampleEngine()
+{
+  mOChannels = 0;
+  mIChannels = 0;
+  mFilterChannels = 0;
+  mOFmt = IAudioSamples::FMT_S16;
+  mIFmt = IAudioSamples::FMT_S16;
+  mOStep = 1;
+  mIStep = 1;
+  mTaps = 0;
+  mPaddedTaps = 0;
+  mPhaseCount = 1;
+  mLinear = false;
+  mMixIsIdentity = true;
+  mHistoryLen = 0;
+  mIndex = 0;
+  mFrac = 0;
+}
+
+AudioResampleEngine :: ~AudioResampleEngine()
+{
+}
+
+AudioResampleEngine*
+AudioResampleEngine :: make(int32_t outputChannels, int32_t inputChannels,
+    int32_t outputRate, int32_t inputRate,
+    IAudioSamples::Format outputFmt, IAudioSamples::Format inputFmt,
+    int32_t filterLen, int32_t log2PhaseCount,
+    bool linear, double cutoff)
+{
+  if (outputChannels <= 0 || inputChannels <= 0
+      || outputRate <= 0 || inputRate <= 0
+      || filterLen <= 0
+      || log2PhaseCount < 0
+      || log2PhaseCount > AudioResampleEngine_kMaxLog2PhaseCount
+      || cutoff <= 0
+      || AudioResampleEngine_packed(outputFmt) == IAudioSamples::FMT_NONE
+      || AudioResampleEngine_packed(inputFmt) == IAudioSamples::FMT_NONE)
+    return 0;
+
+  AudioResampleEngine* retval = new AudioResampleEngine();
+  retval->mOChannels = outputChannels;
+  retval->mIChannels = inputChannels;
+  retval->mFilterChannels = outputChannels < inputChannels ?
+      outputChannels : inputChannels;
+  retval->mOFmt = outputFmt;
+  retval->mIFmt = inputFmt;
+  int64_t gcd = AudioResampleEngine_gcd(outputRate, inputRate);
+  retval->mOStep = outputRate / gcd;
+  retval->mIStep = inputRate / gcd;
+  retval->mPhaseCount = 1 << log2PhaseCount;
+  retval->mLinear = linear;
+  if (outputRate != inputRate)
+    retval->buildFilters(filterLen, cutoff);
+  retval->buildMixMatrix();
+  retval->mInPlanes.resize(inputChannels);
+  retval->mMidPlanes.resize(outputChannels);
+  retval->mOutPlanes.resize(retval->mFilterChannels);
+  retval->mHistory.resize(retval->mFilterChannels);
+  retval->resetFilterState();
+  return retval;
+}
+
+void
+AudioResampleEngine :: buildFilters(int32_t filterLen, double cutoff)
+{
+  double factor = cutoff * mOStep / mIStep;
+  if (factor > 1.0)
+    factor = 1.0;
+  mTaps = (int32_t) ceil(filterLen / factor);
+  if (mTaps < 1)
+    mTaps = 1;
+  mPaddedTaps = (mTaps + 3) & ~3;
+
+  const int32_t center = (mTaps - 1) / 2;
+  std::vector<double> taps(mTaps);
+  mFilters.assign((size_t) (mPhaseCount + 1) * mPaddedTaps, 0.0f);
+  // phase mPhaseCount is phase 0 one sample later, which the linear
+  // interpolation between the last phase and the next sample needs
+  for (int32_t phase = 0; phase <= mPhaseCount; phase++)
+  {
+    double norm = 0;
+    for (int32_t i = 0; i < mTaps; i++)
+    {
+      double x = M_PI * ((double) (i - center) - (double) phase / mPhaseCount)
+          * factor;
+      double y = x == 0 ? 1.0 : sin(x) / x;
+      double w = 2.0 * x / (factor * mTaps * M_PI);
+      double t = 1.0 - w * w;
+      y *= AudioResampleEngine_bessel(
+          AudioResampleEngine_kKaiserBeta * sqrt(t > 0 ? t : 0));
+      taps[i] = y;
+      norm += y;
+    }
+    // normalize so a constant signal keeps its level
+    float* filter = &mFilters[(size_t) phase * mPaddedTaps];
+    for (int32_t i = 0; i < mTaps; i++)
+      filter[i] = (float) (taps[i] / norm);
+  }
+}
+
+void
+AudioResampleEngine :: buildMixMatrix()
+{
+  mMix.assign((size_t) mOChannels * mIChannels, 0.0f);
+  uint64_t inLayout = av_get_default_channel_layout(mIChannels);
+  uint64_t outLayout = av_get_default_channel_layout(mOChannels);
+
+  if (!inLayout || !outLayout)
+  {
+    // no idea where these channels go; pass through what lines up and
+    // repeat the input across any extra outputs
+    for (int32_t o = 0; o < mOChannels; o++)
+      mMix[o * mIChannels + o % mIChannels] = 1.0f;
+  }
+  else
+  {
+    std::vector<double> matrix((size_t) mOChannels * mIChannels, 0.0);
+    int32_t in = 0;
+    for (uint64_t bit = 1; bit && in < mIChannels; bit <<= 1)
+    {
+      if (!(inLayout & bit))
+        continue;
+
+      // the output channel index for each output bit we may mix into
+      struct {
+        uint64_t bit;
+        double level;
+      } targets[4];
+      int32_t numTargets = 0;
+#define VS_MIX_TO(b, l) do { \
+        targets[numTargets].bit = (b); \
+        targets[numTargets].level = (l); \
+        numTargets++; \
+      } while (0)
+      const uint64_t stereo = AV_CH_FRONT_LEFT | AV_CH_FRONT_RIGHT;
+      const bool isLeft = bit & (AV_CH_BACK_LEFT | AV_CH_SIDE_LEFT
+          | AV_CH_FRONT_LEFT_OF_CENTER);
+      const uint64_t front = isLeft ? AV_CH_FRONT_LEFT : AV_CH_FRONT_RIGHT;
+
+      if (outLayout & bit)
+        VS_MIX_TO(bit, 1.0);
+      else if (bit == AV_CH_FRONT_CENTER)
+      {
+        if ((outLayout & stereo) == stereo)
+        {
+          // a mono source goes to both speakers at full level
+          double level = mIChannels == 1 ? 1.0 : AudioResampleEngine_kMinus3dB;
+          VS_MIX_TO(AV_CH_FRONT_LEFT, level);
+          VS_MIX_TO(AV_CH_FRONT_RIGHT, level);
+        }
+      }
+      else if (bit == AV_CH_FRONT_LEFT || bit == AV_CH_FRONT_RIGHT)
+      {
+        if (outLayout & AV_CH_FRONT_CENTER)
+          VS_MIX_TO(AV_CH_FRONT_CENTER, AudioResampleEngine_kMinus3dB);
+      }
+      else if (bit == AV_CH_FRONT_LEFT_OF_CENTER
+          || bit == AV_CH_FRONT_RIGHT_OF_CENTER)
+      {
+        if (outLayout & front)
+          VS_MIX_TO(front, AudioResampleEngine_kMinus3dB);
+        else if (outLayout & AV_CH_FRONT_CENTER)
+          VS_MIX_TO(AV_CH_FRONT_CENTER, AudioResampleEngine_kMinus3dB);
+      }
+      else if (bit & (AV_CH_BACK_LEFT | AV_CH_BACK_RIGHT
+          | AV_CH_SIDE_LEFT | AV_CH_SIDE_RIGHT))
+      {
+        // back and side surrounds stand in for each other
+        const uint64_t other = isLeft
+            ? (bit == AV_CH_BACK_LEFT ? AV_CH_SIDE_LEFT : AV_CH_BACK_LEFT)
+            : (bit == AV_CH_BACK_RIGHT ? AV_CH_SIDE_RIGHT : AV_CH_BACK_RIGHT);
+        if (outLayout & other)
+          VS_MIX_TO(other, 1.0);
+        else if (outLayout & front)
+          VS_MIX_TO(front, AudioResampleEngine_kMinus3dB);
+        else if (outLayout & AV_CH_FRONT_CENTER)
+          VS_MIX_TO(AV_CH_FRONT_CENTER, 0.5);
+      }
+      else if (bit == AV_CH_BACK_CENTER)
+      {
+        const uint64_t back = AV_CH_BACK_LEFT | AV_CH_BACK_RIGHT;
+        const uint64_t side = AV_CH_SIDE_LEFT | AV_CH_SIDE_RIGHT;
+        if ((outLayout & back) == back)
+        {
+          VS_MIX_TO(AV_CH_BACK_LEFT, AudioResampleEngine_kMinus3dB);
+          VS_MIX_TO(AV_CH_BACK_RIGHT, AudioResampleEngine_kMinus3dB);
+        }
+        else if ((outLayout & side) == side)
+        {
+          VS_MIX_TO(AV_CH_SIDE_LEFT, AudioResampleEngine_kMinus3dB);
+          VS_MIX_TO(AV_CH_SIDE_RIGHT, AudioResampleEngine_kMinus3dB);
+        }
+        else if ((outLayout & stereo) == stereo)
+        {
+          VS_MIX_TO(AV_CH_FRONT_LEFT, 0.5);
+          VS_MIX_TO(AV_CH_FRONT_RIGHT, 0.5);
+        }
+        else if (outLayout & AV_CH_FRONT_CENTER)
+          VS_MIX_TO(AV_CH_FRONT_CENTER, 0.5);
+      }
+      // anything else, LFE included, is dropped
+#undef VS_MIX_TO
+
+      for (int32_t t = 0; t < numTargets; t++)
+      {
+        int32_t out = 0;
+        for (uint64_t b = 1; b < targets[t].bit; b <<= 1)
+          if (outLayout & b)
+            out++;
+        matrix[out * mIChannels + in] += targets[t].level;
+      }
+      in++;
+    }
+
+    // scale down so no output can clip when every input is at full level
+    double maxSum = 0;
+    for (int32_t o = 0; o < mOChannels; o++)
+    {
+      double sum = 0;
+      for (int32_t i = 0; i < mIChannels; i++)
+        sum += fabs(matrix[o * mIChannels + i]);
+      if (sum > maxSum)
+        maxSum = sum;
+    }
+    double scale = maxSum > 1.0 ? 1.0 / maxSum : 1.0;
+    for (size_t i = 0; i < matrix.size(); i++)
+      mMix[i] = (float) (matrix[i] * scale);
+  }
+
+  mMixIsIdentity = mOChannels == mIChannels;
+  for (int32_t o = 0; mMixIsIdentity && o < mOChannels; o++)
+    for (int32_t i = 0; i < mIChannels; i++)
+      if (mMix[o * mIChannels + i] != (o == i ? 1.0f : 0.0f))
+        mMixIsIdentity = false;
+}
+
+void
+AudioResampleEngine :: resetFilterState()
+{
+  // the first half of the filter reads silence
+  mHistoryLen = mTaps ? (mTaps - 1) / 2 : 0;
+  mIndex = 0;
+  mFrac = 0;
+  for (size_t c = 0; c < mHistory.size(); c++)
+    mHistory[c].assign(mHistoryLen + mPaddedTaps, 0.0f);
+}
+
+int32_t
+AudioResampleEngine :: getNumOutputSamples(int32_t numSamples, bool flush)
+{
+  if (!mTaps)
+    return numSamples;
+  int64_t available = mHistoryLen + numSamples;
+  if (flush)
+    available += mTaps - 1 - (mTaps - 1) / 2;
+  // output k reads input from mIndex + (mFrac + k*mIStep)/mOStep for
+  // mTaps samples, all of which must be available
+  int64_t room = available - mTaps - mIndex + 1;
+  if (room <= 0)
+    return 0;
+  return (int32_t) ((room * mOStep - mFrac + mIStep - 1) / mIStep);
+}
+
+void
+AudioResampleEngine :: mix(std::vector<std::vector<float> >& dst,
+    const std::vector<std::vector<float> >& src, int32_t numSamples)
+{
+  for (int32_t o = 0; o < mOChannels; o++)
+  {
+    std::vector<float>& out = dst[o];
+    out.assign(numSamples, 0.0f);
+    for (int32_t i = 0; i < mIChannels; i++)
+    {
+      const float level = mMix[o * mIChannels + i];
+      if (level == 0.0f)
+        continue;
+      const float* in = numSamples ? &src[i][0] : 0;
+      for (int32_t s = 0; s < numSamples; s++)
+        out[s] += in[s] * level;
+    }
+  }
+}
+
+int32_t
+AudioResampleEngine :: filter(std::vector<std::vector<float> >& dst,
+    const std::vector<std::vector<float> >& src, int32_t numSamples,
+    bool flush)
+{
+  const int32_t numOutput = getNumOutputSamples(numSamples, flush);
+  int32_t available = mHistoryLen + numSamples;
+  if (flush)
+    available += mTaps - 1 - (mTaps - 1) / 2;
+
+  int64_t index = mIndex;
+  int64_t frac = mFrac;
+  for (int32_t c = 0; c < mFilterChannels; c++)
+  {
+    std::vector<float>& history = mHistory[c];
+    // keep mPaddedTaps zeros past the end for the kernel to read over
+    history.resize(available + mPaddedTaps);
+    if (numSamples)
+      memcpy(&history[mHistoryLen], &src[c][0], numSamples * sizeof(float));
+    std::fill(history.begin() + mHistoryLen + numSamples, history.end(), 0.0f);
+
+    std::vector<float>& out = dst[c];
+    out.resize(numOutput);
+    index = mIndex;
+    frac = mFrac;
+    for (int32_t k = 0; k < numOutput; k++)
+    {
+      const float* x = &history[index];
+      const int64_t position = frac * mPhaseCount;
+      const int64_t phase = position / mOStep;
+      const float* taps = &mFilters[phase * mPaddedTaps];
+      float value = AudioResampleEngine_dot(x, taps, mPaddedTaps);
+      if (mLinear)
+      {
+        const int64_t remainder = position % mOStep;
+        if (remainder)
+        {
+          float next = AudioResampleEngine_dot(x, taps + mPaddedTaps,
+              mPaddedTaps);
+          value += (next - value) * ((float) remainder / mOStep);
+        }
+      }
+      out[k] = value;
+      frac += mIStep;
+      index += frac / mOStep;
+      frac %= mOStep;
+    }
+    // drop what no later output will read
+    const int32_t consumed = (int32_t) (index < available ? index : available);
+    memmove(&history[0], &history[consumed],
+        (available - consumed) * sizeof(float));
+    history.resize(available - consumed + mPaddedTaps);
+    std::fill(history.begin() + (available - consumed), history.end(), 0.0f);
+  }
+  const int32_t consumed = (int32_t) (index < available ? index : available);
+  mHistoryLen = available - consumed;
+  mIndex = index - consumed;
+  mFrac = frac;
+
+  if (flush)
+    resetFilterState();
+  return numOutput;
+}
+
+int32_t
+AudioResampleEngine :: process(void* out, const void* in,
+    int32_t inPlaneSamples, int32_t numSamples, bool flush)
+{
+  if (numSamples < 0 || !out || (numSamples && !in))
+    return -1;
+
+  // everything to planar float
+  const IAudioSamples::Format inPacked = AudioResampleEngine_packed(mIFmt);
+  const int32_t inBytes = AudioResampleEngine_bytesPerSample(mIFmt);
+  for (int32_t c = 0; c < mIChannels; c++)
+    mInPlanes[c].resize(numSamples);
+  if (numSamples)
+  {
+    if (AudioResampleEngine_isPlanar(mIFmt))
+    {
+      for (int32_t c = 0; c < mIChannels; c++)
+        AudioResampleEngine_toFloat(inPacked,
+            (const uint8_t*) in + (size_t) c * inPlaneSamples * inBytes,
+            &mInPlanes[c][0], numSamples);
+    }
+    else
+    {
+      mPacked.resize((size_t) numSamples * mIChannels);
+      AudioResampleEngine_toFloat(inPacked, in, &mPacked[0],
+          numSamples * mIChannels);
+      for (int32_t c = 0; c < mIChannels; c++)
+      {
+        float* plane = &mInPlanes[c][0];
+        const float* interleaved = &mPacked[c];
+        for (int32_t s = 0; s < numSamples; s++)
+          plane[s] = interleaved[s * mIChannels];
+      }
+    }
+  }
+
+  // mix down first, or up last, so we filter the fewest channels
+  std::vector<std::vector<float> >* planes = &mInPlanes;
+  if (!mMixIsIdentity && mOChannels <= mIChannels)
+  {
+    mix(mMidPlanes, *planes, numSamples);
+    planes = &mMidPlanes;
+  }
+  int32_t numOutput = numSamples;
+  if (mTaps)
+  {
+    numOutput = filter(mOutPlanes, *planes, numSamples, flush);
+    planes = &mOutPlanes;
+  }
+  if (!mMixIsIdentity && mOChannels > mIChannels)
+  {
+    mix(mMidPlanes, *planes, numOutput);
+    planes = &mMidPlanes;
+  }
+  if (!numOutput)
+    return 0;
+
+  // and out to whatever the caller wants
+  const IAudioSamples::Format outPacked = AudioResampleEngine_packed(mOFmt);
+  const int32_t outBytes = AudioResampleEngine_bytesPerSample(mOFmt);
+  if (AudioResampleEngine_isPlanar(mOFmt))
+  {
+    for (int32_t c = 0; c < mOChannels; c++)
+      AudioResampleEngine_fromFloat(outPacked, &(*planes)[c][0],
+          (uint8_t*) out + (size_t) c * numOutput * outBytes, numOutput);
+  }
+  else
+  {
+    mPacked.resize((size_t) numOutput * mOChannels);
+    for (int32_t c = 0; c < mOChannels; c++)
+    {
+      const float* plane = &(*planes)[c][0];
+      float* interleaved = &mPacked[c];
+      for (int32_t s = 0; s < numOutput; s++)
+        interleaved[s * mOChannels] = plane[s];
+    }
+    AudioResampleEngine_fromFloat(outPacked, &mPacked[0], out,
+        numOutput * mOChannels);
+  }
+  return numOutput;
+}
+
+}}}
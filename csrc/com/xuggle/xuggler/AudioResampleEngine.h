@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef AUDIORESAMPLEENGINE_H_
+#define AUDIORESAMPLEENGINE_H_
+
+#include <inttypes.h>
+#include <vector>
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/xuggler/IAudioSamples.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * Converts sample format, channel layout and sample rate in one pass,
+   * for {@link AudioResampler}.  Input of any IAudioSamples::Format,
+   * packed or planar, is converted to planar float, mixed down (or up)
+   * to the output channels, run through a windowed-sinc polyphase filter
+   * bank and converted to the output format.  Mixing happens before the
+   * filter when it reduces the channel count and after it otherwise, so
+   * the filter always runs on the fewer channels.
+   * </p><p>
+   * Channel counts are mapped to ffmpeg's default layout for that count
+   * (mono, stereo, ..., 5.1, 7.1) and mixed with the usual -3dB center
+   * and surround levels; LFE is dropped unless the output has one.
+   * Counts with no default layout are mapped channel for channel.
+   * </p><p>
+   * The filter bank and its delay match the old libavcodec resampler:
+   * the filter is ceil(filterLen/factor) taps long, where factor is
+   * min(1, cutoff*outputRate/inputRate), and the first
+   * (taps-1)/2 input samples are taken to be silence.  When the rates
+   * match no filtering happens and there is no delay.
+   * </p><p>
+   * The filter kernel and the float/int16 conversions use SSE2 where the
+   * compiler targets it.  Not thread safe; one engine per resampler.
+   * </p>
+   */
+  class VS_API_XUGGLER AudioResampleEngine
+  {
+  public:
+    /**
+     * @return a new engine, or null if the arguments are out of range.
+     */
+    static AudioResampleEngine* make(int32_t outputChannels,
+        int32_t inputChannels,
+        int32_t outputRate, int32_t inputRate,
+        IAudioSamples::Format outputFmt, IAudioSamples::Format inputFmt,
+        int32_t filterLen, int32_t log2PhaseCount,
+        bool linear, double cutoff);
+
+    ~AudioResampleEngine();
+
+    /**
+     * @return the number of taps actually used by the filter, or 0
+     *   if the rates match and no filter is used.
+     */
+    int32_t getTaps() { return mTaps; }
+
+    /**
+     * @return the number of samples the next call to process (or
+     *   flush, if numSamples is 0) will write for numSamples of input.
+     */
+    int32_t getNumOutputSamples(int32_t numSamples, bool flush);
+
+    /**
+     * Convert numSamples of input.  For planar input the planes start
+     * inPlaneSamples apart.  Planar output is written with planes back
+     * to back, each as long as the number of samples written.
+     *
+     * @param out where to write; must have room for
+     *   getNumOutputSamples(numSamples, false) samples.
+     * @param in the input samples.  Ignored if numSamples is 0.
+     * @param inPlaneSamples the distance between planar input planes,
+     *   in samples.
+     * @param numSamples the number of samples to take from in.
+     * @param flush if true, pad the input with enough silence to write
+     *   out everything held back in the filter, then reset.
+     * @return the number of samples written to out.
+     */
+    int32_t process(void* out, const void* in, int32_t inPlaneSamples,
+        int32_t numSamples, bool flush);
+
+  private:
+    AudioResampleEngine();
+    void buildFilters(int32_t filterLen, double cutoff);
+    void buildMixMatrix();
+    void mix(std::vector<std::vector<float> >& dst,
+        const std::vector<std::vector<float> >& src, int32_t numSamples);
+    int32_t filter(std::vector<std::vector<float> >& dst,
+        const std::vector<std::vector<float> >& src,
+        int32_t numSamples, bool flush);
+    void resetFilterState();
+
+    int32_t mOChannels;
+    int32_t mIChannels;
+    int32_t mFilterChannels;
+    IAudioSamples::Format mOFmt;
+    IAudioSamples::Format mIFmt;
+    // rates with their common divisor taken out
+    int64_t mOStep;
+    int64_t mIStep;
+
+    int32_t mTaps;
+    // mTaps rounded up to a multiple of 4, so the SIMD kernel can
+    // always work four taps at a time
+    int32_t mPaddedTaps;
+    int32_t mPhaseCount;
+    bool mLinear;
+    // mPhaseCount+1 filters of mPaddedTaps taps each; the last one
+    // is the first shifted by one sample, for interpolating.
+    std::vector<float> mFilters;
+
+    // mix[out*mIChannels+in]
+    std::vector<float> mMix;
+    bool mMixIsIdentity;
+
+    // per filtered channel: input not yet consumed by the filter,
+    // followed by mPaddedTaps zeros
+    std::vector<std::vector<float> > mHistory;
+    int32_t mHistoryLen;
+    // the next output sample sits at input sample
+    // mIndex + mFrac/mOStep (plus the filter's center)
+    int64_t mIndex;
+    int64_t mFrac;
+
+    // scratch planes
+    std::vector<std::vector<float> > mInPlanes;
+    std::vector<std::vector<float> > mMidPlanes;
+    std::vector<std::vector<float> > mOutPlanes;
+    std::vector<float> mPacked;
+  };
+
+}}}
+
+#endif /*AUDIORESAMPLEENGINE_H_*/
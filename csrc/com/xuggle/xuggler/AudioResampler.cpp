@@ -19,6 +19,7 @@
 
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/AudioResampler.h>
+#include <com/xuggle/xuggler/AudioResampleEngine.h>
 #include <com/xuggle/xuggler/AudioSamples.h>
 #include <com/xuggle/xuggler/Global.h>
 #include <com/xuggle/xuggler/FfmpegIncludes.h>
@@ -50,8 +51,7 @@ namespace com { namespace xuggle { namespace xuggler
 
   AudioResampler :: ~AudioResampler()
   {
-    if (mContext)
-      audio_resample_close(mContext);
+    delete mContext;
   }
 
   AudioResampler*
@@ -93,12 +93,6 @@ namespace com { namespace xuggle { namespace xuggler
       if (inputChannels <= 0)
         throw std::invalid_argument("inputChannels <= 0");
 
-      if (outputChannels > 2)
-        throw std::invalid_argument("outputChannels > 2; unsupported");
-
-      if (inputChannels > 2)
-        throw std::invalid_argument("inputChannels > 2; unsupported");
-
       if (outputRate <= 0)
         throw std::invalid_argument("outputRate <= 0");
 
@@ -117,10 +111,9 @@ namespace com { namespace xuggle { namespace xuggler
       retval = AudioResampler::make();
       if (retval)
       {
-        retval->mContext = av_audio_resample_init(outputChannels, inputChannels,
-            outputRate, inputRate,
-            (enum AVSampleFormat) outputFmt, (enum AVSampleFormat) inputFmt,
-            filterLen, log2PhaseCount, (int)linear, cutoff);
+        retval->mContext = AudioResampleEngine::make(outputChannels,
+            inputChannels, outputRate, inputRate, outputFmt, inputFmt,
+            filterLen, log2PhaseCount, linear, cutoff);
         if (retval->mContext)
         {
           retval->mOChannels = outputChannels;
@@ -244,15 +237,14 @@ namespace com { namespace xuggle { namespace xuggler
       if (conversionRatio <= 0)
         throw std::invalid_argument("programmer error");
 
-      // FFMPEG's re-sample function doesn't let you specify the size of your
-      // output buffer, but does use up all the space you might expect
-      // plus 16-bytes as a lead-in/lead-out for it to seed the resampler.
-      // Hence, the hard-coded 16 here.
-      // NOTE: 16 might change IF the value of filters in the audio_resample
-      // method in libavcodec/resample.c changes.
+      // The filter holds back up to its length in input samples from
+      // one call to the next and may then output them all at once;
+      // never ask for less than the 16 samples ffmpeg's old resampler
+      // documented.
 #define VS_FFMPEG_AUDIO_RESAMPLER_LEADIN 16
+      int32_t taps = mContext ? mContext->getTaps() : 0;
       retval = 
-          (int32_t)((numSamples * conversionRatio)+VS_FFMPEG_AUDIO_RESAMPLER_LEADIN+0.5);
+          (int32_t)(((numSamples + taps) * conversionRatio)+VS_FFMPEG_AUDIO_RESAMPLER_LEADIN+0.5);
     }
     catch (std::invalid_argument & e)
     {
@@ -312,7 +304,12 @@ namespace com { namespace xuggle { namespace xuggler
         sampleSize = IAudioSamples::findSampleBitDepth(mIFmt)/8;
       }
 
-      int32_t neededSamples = getMinimumNumSamplesRequiredInOutputSamples(numSamples);
+      VS_ASSERT(mContext, "Should have been set at initialization");
+      if (!mContext)
+        throw std::invalid_argument("programmer error");
+
+      int32_t neededSamples = mContext->getNumOutputSamples(numSamples,
+          !inSamples);
       int32_t bytesPerOutputSample = mOChannels*IAudioSamples::findSampleBitDepth(mOFmt)/8;
       int32_t neededBytes = neededSamples * bytesPerOutputSample;
       // This causes a buffer resize to occur if needed
@@ -338,12 +335,11 @@ namespace com { namespace xuggle { namespace xuggler
       if (!outBuf)
         throw std::invalid_argument("could not get output bytes");
 
-      VS_ASSERT(mContext, "Should have been set at initialization");
-      if (!mContext)
-        throw std::invalid_argument("programmer error");
-
       // Now we should be far enough along that we can safely try a resample.
-      retval = audio_resample(mContext, outBuf, inBuf, numSamples);
+      // Planar input keeps each channel's plane getNumSamples() long.
+      retval = mContext->process(outBuf, inBuf,
+          inSamples ? inSamples->getNumSamples() : 0, numSamples,
+          !inSamples);
 
 #if 0
       if (retval >0){
@@ -22,10 +22,9 @@
 
 #include <com/xuggle/xuggler/IAudioResampler.h>
 
-struct ReSampleContext;
-
 namespace com { namespace xuggle { namespace xuggler
   {
+  class AudioResampleEngine;
 
   class AudioResampler : public IAudioResampler
   {
@@ -71,7 +70,7 @@ namespace com { namespace xuggle { namespace xuggler
     AudioResampler();
     virtual ~AudioResampler();
   private:
-    ReSampleContext *mContext;
+    AudioResampleEngine *mContext;
     int32_t mOChannels;
     int32_t mOSampleRate;
     int32_t mIChannels;
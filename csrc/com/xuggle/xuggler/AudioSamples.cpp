@@ -19,6 +19,7 @@
 
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/AudioSamples.h>
+#include <com/xuggle/xuggler/MediaDataPool.h>
 #include <com/xuggle/xuggler/Global.h>
 
 // for memset
@@ -43,6 +44,7 @@ namespace com { namespace xuggle { namespace xuggler
     mPts = Global::NO_PTS;
     mRequestedSamples = 0;
     mTimeBase = IRational::make(1, 1000000);
+    mPool = 0;
   }
 
   AudioSamples :: ~AudioSamples()
@@ -333,7 +335,7 @@ namespace com { namespace xuggle { namespace xuggler
       if (!rawSamples)
         throw std::runtime_error("no samples buffer set in AudioSamples");
 
-      rawSamples[sampleIndex*mChannels + channel] = (short)sample;
+      rawSamples[getSampleOffset(sampleIndex, channel)] = (short)sample;
       retval = 0;
     }
     catch (std::exception & e)
@@ -361,7 +363,7 @@ namespace com { namespace xuggle { namespace xuggler
       if (!rawSamples)
         throw std::runtime_error("no samples buffer set in AudioSamples");
 
-      retval = rawSamples[sampleIndex*mChannels + channel];
+      retval = rawSamples[getSampleOffset(sampleIndex, channel)];
     }
     catch(std::exception & e)
     {
@@ -371,6 +373,19 @@ namespace com { namespace xuggle { namespace xuggler
     return retval;
   }
 
+  uint32_t
+  AudioSamples :: getSampleOffset(uint32_t sampleIndex, int32_t channel)
+  {
+    // Planar samples keep each channel's plane back to back, each
+    // as long as the buffer's share for one channel.
+    if (av_sample_fmt_is_planar((enum AVSampleFormat)mSampleFmt))
+    {
+      uint32_t samplesPerPlane = mIsComplete ? mNumSamples : getMaxSamples();
+      return channel*samplesPerPlane + sampleIndex;
+    }
+    return sampleIndex*mChannels + channel;
+  }
+
   void
   AudioSamples :: setBufferType(IAudioSamples::Format format,
       IBuffer* buffer)
@@ -403,4 +418,41 @@ namespace com { namespace xuggle { namespace xuggler
         break;
     }
   }
+
+  void
+  AudioSamples :: setPool(MediaDataPool* pool)
+  {
+    if (pool)
+      pool->acquire();
+    if (mPool)
+      mPool->release();
+    mPool = pool;
+  }
+
+  bool
+  AudioSamples :: recycle()
+  {
+    // someone else can still see the samples; don't write over them
+    if (mSamples && mSamples->getCurrentRefCount() > 1)
+      mSamples = 0;
+    mNumSamples = 0;
+    mSampleRate = 0;
+    mIsComplete = false;
+    mPts = Global::NO_PTS;
+    if (!mTimeBase || mTimeBase->getCurrentRefCount() > 1 ||
+        mTimeBase->getNumerator() != 1 ||
+        mTimeBase->getDenominator() != 1000000)
+      mTimeBase = IRational::make(1, 1000000);
+    return true;
+  }
+
+  void
+  AudioSamples :: destroy()
+  {
+    // go back to our pool if it'll have us
+    MediaDataPool* pool = mPool;
+    mPool = 0;
+    if (!pool || !pool->reclaim(this))
+      RefCounted::destroy();
+  }
 }}}
@@ -28,6 +28,7 @@
 
 namespace com { namespace xuggle { namespace xuggler
 {
+  class MediaDataPool;
 
   class AudioSamples : public IAudioSamples
   {
@@ -89,11 +90,26 @@ namespace com { namespace xuggle { namespace xuggler
     
     static AudioSamples* make(com::xuggle::ferry::IBuffer* buffer, int channels,
         IAudioSamples::Format format);
+
+    /**
+     * Set the pool this object came from; while set, releasing its last
+     * reference hands it back to the pool instead of deleting it.
+     * Called by MediaDataPool.
+     */
+    void setPool(MediaDataPool* pool);
+    /**
+     * Put this object back the way make() left it, keeping its sample buffer
+     * unless someone else still holds it.  Called by MediaDataPool.
+     * @return false if it can't be reused.
+     */
+    bool recycle();
   protected:
     AudioSamples();
     virtual ~AudioSamples();
+    virtual void destroy();
   private:
     void allocInternalSamples();
+    uint32_t getSampleOffset(uint32_t sampleIndex, int32_t channel);
     static void setBufferType(IAudioSamples::Format format,
         com::xuggle::ferry::IBuffer * buffer);
     com::xuggle::ferry::RefPointer<com::xuggle::ferry::IBuffer> mSamples;
@@ -105,6 +121,8 @@ namespace com { namespace xuggle { namespace xuggler
     int32_t mIsComplete;
     Format mSampleFmt;
     int64_t mPts;
+    // the pool we came from, if any; we hold a reference to it
+    MediaDataPool* mPool;
   };
 
 }}}
@@ -20,6 +20,7 @@
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/ferry/RefPointer.h>
 #include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
 #include <com/xuggle/xuggler/Codec.h>
 #include <com/xuggle/xuggler/ContainerFormat.h>
 
@@ -89,11 +90,7 @@ namespace com { namespace xuggle { namespace xuggler
   Codec :: findEncodingCodecByIntID(const int id)
   {
     Codec *retval = 0;
-    AVCodec *codec = 0;
-    enum CodecID ffmpeg_id = (enum CodecID) id;
-    Global::lock();
-    codec = avcodec_find_encoder(ffmpeg_id);
-    Global::unlock();
+    AVCodec *codec = CodecFormatIndex::get()->findEncoder(id);
     if (codec)
       retval = Codec::make(codec);
 
@@ -107,9 +104,7 @@ namespace com { namespace xuggle { namespace xuggler
     AVCodec *codec = 0;
     if (name && *name)
     {
-      Global::lock();
-      codec = avcodec_find_encoder_by_name(name);
-      Global::unlock();
+      codec = CodecFormatIndex::get()->findEncoder(name);
       if (codec)
         retval = Codec::make(codec);
     }
@@ -126,12 +121,7 @@ namespace com { namespace xuggle { namespace xuggler
   Codec :: findDecodingCodecByIntID(const int id)
   {
     Codec *retval = 0;
-    AVCodec *codec = 0;
-
-    Global::lock();
-    codec = avcodec_find_decoder((enum CodecID) id);
-    Global::unlock();
-    
+    AVCodec *codec = CodecFormatIndex::get()->findDecoder(id);
     if (codec)
       retval = Codec::make(codec);
     return retval;
@@ -144,9 +134,7 @@ namespace com { namespace xuggle { namespace xuggler
     AVCodec *codec = 0;
     if (name && *name)
     {
-      Global::lock();
-      codec = avcodec_find_decoder_by_name(name);
-      Global::unlock();
+      codec = CodecFormatIndex::get()->findDecoder(name);
       if (codec)
         retval = Codec::make(codec);
     }
@@ -0,0 +1,366 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <cstring>
+
+#include <com/xuggle/ferry/SpinMutex.h>
+#include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
+
+using namespace com::xuggle::ferry;
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  static SpinMutex sCodecFormatIndexLock;
+  static CodecFormatIndex* sCodecFormatIndex = 0;
+
+  // FFmpeg compares format names and extensions ignoring ASCII case only
+  static std::string
+  CodecFormatIndex_lower(const char* str, size_t len)
+  {
+    std::string retval(str, len);
+    for(size_t i = 0; i < retval.size(); i++)
+      if (retval[i] >= 'A' && retval[i] <= 'Z')
+        retval[i] += 'a' - 'A';
+    return retval;
+  }
+
+  // add every comma separated token in list, in lower case
+  static void
+  CodecFormatIndex_addTokens(
+      std::vector<std::pair<std::string, int32_t> >& table,
+      const char* list, int32_t order)
+  {
+    if (!list)
+      return;
+    for(;;)
+    {
+      const char* end = strchr(list, ',');
+      if (!end)
+        end = list + strlen(list);
+      table.push_back(std::make_pair(
+          CodecFormatIndex_lower(list, end-list), order));
+      if (!*end)
+        break;
+      list = end + 1;
+    }
+  }
+
+  CodecFormatIndex :: CodecFormatIndex()
+  {
+  }
+
+  CodecFormatIndex :: ~CodecFormatIndex()
+  {
+  }
+
+  const CodecFormatIndex*
+  CodecFormatIndex :: get()
+  {
+    CodecFormatIndex* retval = sCodecFormatIndex;
+    if (!retval)
+    {
+      Global::init();
+      build();
+      retval = sCodecFormatIndex;
+    }
+    __sync_synchronize();
+    return retval;
+  }
+
+  void
+  CodecFormatIndex :: build()
+  {
+    if (sCodecFormatIndex)
+      return;
+
+    // Every table is sorted by (key, order), so the first of several
+    // entries with the same key is the one registered first.
+    CodecFormatIndex* index = new CodecFormatIndex();
+
+    index->mCodecsByType.resize(AVMEDIA_TYPE_NB);
+    AVCodec* codec = 0;
+    while((codec = av_codec_next(codec)) != 0)
+    {
+      int32_t order = index->mCodecs.size();
+      index->mCodecs.push_back(codec);
+      if (codec->type >= 0 && codec->type < AVMEDIA_TYPE_NB)
+        index->mCodecsByType[codec->type].push_back(order);
+      if (av_codec_is_encoder(codec))
+      {
+        index->mEncodersById.push_back(IntKey(codec->id, order));
+        if (codec->name)
+          index->mEncodersByName.push_back(StringKey(codec->name, order));
+      }
+      if (av_codec_is_decoder(codec))
+      {
+        index->mDecodersById.push_back(IntKey(codec->id, order));
+        if (codec->name)
+          index->mDecodersByName.push_back(StringKey(codec->name, order));
+      }
+    }
+    std::sort(index->mEncodersById.begin(), index->mEncodersById.end());
+    std::sort(index->mDecodersById.begin(), index->mDecodersById.end());
+    std::sort(index->mEncodersByName.begin(), index->mEncodersByName.end());
+    std::sort(index->mDecodersByName.begin(), index->mDecodersByName.end());
+
+    AVInputFormat* iFormat = 0;
+    while((iFormat = av_iformat_next(iFormat)) != 0)
+    {
+      int32_t order = index->mInputFormats.size();
+      index->mInputFormats.push_back(iFormat);
+      CodecFormatIndex_addTokens(index->mInputFormatsByName, iFormat->name,
+          order);
+    }
+    std::sort(index->mInputFormatsByName.begin(),
+        index->mInputFormatsByName.end());
+
+    AVOutputFormat* oFormat = 0;
+    while((oFormat = av_oformat_next(oFormat)) != 0)
+    {
+      int32_t order = index->mOutputFormats.size();
+      index->mOutputFormats.push_back(oFormat);
+      if (oFormat->name)
+        index->mOutputFormatsByName.push_back(
+            StringKey(oFormat->name, order));
+      if (oFormat->mime_type)
+        index->mOutputFormatsByMimeType.push_back(
+            StringKey(oFormat->mime_type, order));
+      CodecFormatIndex_addTokens(index->mOutputFormatsByExtension,
+          oFormat->extensions, order);
+    }
+    std::sort(index->mOutputFormatsByName.begin(),
+        index->mOutputFormatsByName.end());
+    std::sort(index->mOutputFormatsByMimeType.begin(),
+        index->mOutputFormatsByMimeType.end());
+    std::sort(index->mOutputFormatsByExtension.begin(),
+        index->mOutputFormatsByExtension.end());
+
+    sCodecFormatIndexLock.lock();
+    if (!sCodecFormatIndex)
+    {
+      // make sure the tables are visible before the pointer is
+      __sync_synchronize();
+      sCodecFormatIndex = index;
+      index = 0;
+    }
+    sCodecFormatIndexLock.unlock();
+    // someone else got there first
+    delete index;
+  }
+
+  int32_t
+  CodecFormatIndex :: findFirst(const std::vector<StringKey>& table,
+      const std::string& key)
+  {
+    std::vector<StringKey>::const_iterator it = std::lower_bound(
+        table.begin(), table.end(), StringKey(key, -1));
+    if (it == table.end() || it->first != key)
+      return -1;
+    return it->second;
+  }
+
+  AVCodec*
+  CodecFormatIndex :: findCodec(const std::vector<IntKey>& table,
+      int32_t id) const
+  {
+    std::vector<IntKey>::const_iterator it = std::lower_bound(
+        table.begin(), table.end(), IntKey(id, -1));
+    AVCodec* experimental = 0;
+    for(; it != table.end() && it->first == id; ++it)
+    {
+      AVCodec* codec = mCodecs[it->second];
+      if (!(codec->capabilities & CODEC_CAP_EXPERIMENTAL))
+        return codec;
+      if (!experimental)
+        experimental = codec;
+    }
+    return experimental;
+  }
+
+  int32_t
+  CodecFormatIndex :: getNumCodecs() const
+  {
+    return mCodecs.size();
+  }
+
+  AVCodec*
+  CodecFormatIndex :: getCodec(int32_t index) const
+  {
+    if (index < 0 || (size_t)index >= mCodecs.size())
+      return 0;
+    return mCodecs[index];
+  }
+
+  int32_t
+  CodecFormatIndex :: getNumCodecs(enum AVMediaType type) const
+  {
+    if (type < 0 || (size_t)type >= mCodecsByType.size())
+      return 0;
+    return mCodecsByType[type].size();
+  }
+
+  AVCodec*
+  CodecFormatIndex :: getCodec(enum AVMediaType type, int32_t index) const
+  {
+    if (index < 0 || index >= getNumCodecs(type))
+      return 0;
+    return mCodecs[mCodecsByType[type][index]];
+  }
+
+  AVCodec*
+  CodecFormatIndex :: findEncoder(int32_t id) const
+  {
+    return findCodec(mEncodersById, id);
+  }
+
+  AVCodec*
+  CodecFormatIndex :: findDecoder(int32_t id) const
+  {
+    return findCodec(mDecodersById, id);
+  }
+
+  AVCodec*
+  CodecFormatIndex :: findEncoder(const char* name) const
+  {
+    if (!name)
+      return 0;
+    int32_t order = findFirst(mEncodersByName, name);
+    return order < 0 ? 0 : mCodecs[order];
+  }
+
+  AVCodec*
+  CodecFormatIndex :: findDecoder(const char* name) const
+  {
+    if (!name)
+      return 0;
+    int32_t order = findFirst(mDecodersByName, name);
+    return order < 0 ? 0 : mCodecs[order];
+  }
+
+  int32_t
+  CodecFormatIndex :: getNumInputFormats() const
+  {
+    return mInputFormats.size();
+  }
+
+  AVInputFormat*
+  CodecFormatIndex :: getInputFormat(int32_t index) const
+  {
+    if (index < 0 || (size_t)index >= mInputFormats.size())
+      return 0;
+    return mInputFormats[index];
+  }
+
+  AVInputFormat*
+  CodecFormatIndex :: findInputFormat(const char* shortName) const
+  {
+    if (!shortName)
+      return 0;
+    // FFmpeg lets a name with commas in it match across several of a
+    // format's names; that's rare enough to leave to FFmpeg.
+    if (strchr(shortName, ','))
+      return av_find_input_format(shortName);
+    int32_t order = findFirst(mInputFormatsByName,
+        CodecFormatIndex_lower(shortName, strlen(shortName)));
+    return order < 0 ? 0 : mInputFormats[order];
+  }
+
+  int32_t
+  CodecFormatIndex :: getNumOutputFormats() const
+  {
+    return mOutputFormats.size();
+  }
+
+  AVOutputFormat*
+  CodecFormatIndex :: getOutputFormat(int32_t index) const
+  {
+    if (index < 0 || (size_t)index >= mOutputFormats.size())
+      return 0;
+    return mOutputFormats[index];
+  }
+
+  AVOutputFormat*
+  CodecFormatIndex :: guessOutputFormat(const char* shortName,
+      const char* url, const char* mimeType) const
+  {
+    // image sequences like "frame%03d.png" get special treatment
+    if (!shortName && url && av_filename_number_test(url))
+      return av_guess_format(shortName, url, mimeType);
+
+    // score every format matching any of the three the same way
+    // av_guess_format does, and keep the first registered of the best
+    std::vector<std::pair<int32_t, int32_t> > scores;
+    if (shortName)
+    {
+      std::vector<StringKey>::const_iterator it = std::lower_bound(
+          mOutputFormatsByName.begin(), mOutputFormatsByName.end(),
+          StringKey(shortName, -1));
+      for(; it != mOutputFormatsByName.end() && it->first == shortName; ++it)
+        scores.push_back(std::make_pair(it->second, 100));
+    }
+    if (mimeType)
+    {
+      std::vector<StringKey>::const_iterator it = std::lower_bound(
+          mOutputFormatsByMimeType.begin(), mOutputFormatsByMimeType.end(),
+          StringKey(mimeType, -1));
+      for(; it != mOutputFormatsByMimeType.end() && it->first == mimeType;
+          ++it)
+        scores.push_back(std::make_pair(it->second, 10));
+    }
+    const char* ext = url ? strrchr(url, '.') : 0;
+    if (ext)
+    {
+      std::string key = CodecFormatIndex_lower(ext+1, strlen(ext+1));
+      std::vector<StringKey>::const_iterator it = std::lower_bound(
+          mOutputFormatsByExtension.begin(), mOutputFormatsByExtension.end(),
+          StringKey(key, -1));
+      int32_t last = -1;
+      // a format may list the same extension twice; it only scores once
+      for(; it != mOutputFormatsByExtension.end() && it->first == key; ++it)
+        if (it->second != last)
+        {
+          scores.push_back(std::make_pair(it->second, 5));
+          last = it->second;
+        }
+    }
+    if (scores.empty())
+      return 0;
+
+    std::sort(scores.begin(), scores.end());
+    int32_t best = -1;
+    int32_t bestScore = 0;
+    for(size_t i = 0; i < scores.size(); )
+    {
+      int32_t order = scores[i].first;
+      int32_t score = 0;
+      for(; i < scores.size() && scores[i].first == order; i++)
+        score += scores[i].second;
+      if (score > bestScore)
+      {
+        best = order;
+        bestScore = score;
+      }
+    }
+    return best < 0 ? 0 : mOutputFormats[best];
+  }
+
+}}}
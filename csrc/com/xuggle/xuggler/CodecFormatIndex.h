@@ -0,0 +1,134 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef CODECFORMATINDEX_H_
+#define CODECFORMATINDEX_H_
+
+#include <inttypes.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/xuggler/FfmpegIncludes.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * An index of every codec, input format and output format FFmpeg has
+   * registered, built once by {@link Global#init()} after registration
+   * and never changed afterwards, so lookups need no lock.
+   * </p><p>
+   * FFmpeg keeps these in linked lists, so asking it for the nth entry
+   * or for a codec by id or name walks the list from the start.  Here
+   * each list is copied into an array, in registration order, and
+   * sorted tables of (key, position) pairs are kept for codec ids,
+   * codec names, codec types, format names, output MIME types and
+   * output file extensions.  A table lookup finds every match; taking
+   * the one registered first gives the same answer FFmpeg's own search
+   * would.
+   * </p>
+   */
+  class CodecFormatIndex
+  {
+  public:
+    /**
+     * Get the index, calling {@link Global#init()} to build it if need be.
+     */
+    static const CodecFormatIndex* get();
+
+    /**
+     * Build the index from what FFmpeg has registered so far.  Does
+     * nothing if it is already built.  Called by Global::init().
+     */
+    static void build();
+
+    int32_t getNumCodecs() const;
+    AVCodec* getCodec(int32_t index) const;
+    int32_t getNumCodecs(enum AVMediaType type) const;
+    AVCodec* getCodec(enum AVMediaType type, int32_t index) const;
+
+    /**
+     * Same as avcodec_find_encoder: the first non-experimental encoder
+     * for id, or else the first experimental one.
+     */
+    AVCodec* findEncoder(int32_t id) const;
+    /**
+     * Same as avcodec_find_decoder.
+     */
+    AVCodec* findDecoder(int32_t id) const;
+    /**
+     * Same as avcodec_find_encoder_by_name.
+     */
+    AVCodec* findEncoder(const char* name) const;
+    /**
+     * Same as avcodec_find_decoder_by_name.
+     */
+    AVCodec* findDecoder(const char* name) const;
+
+    int32_t getNumInputFormats() const;
+    AVInputFormat* getInputFormat(int32_t index) const;
+    /**
+     * Same as av_find_input_format.
+     */
+    AVInputFormat* findInputFormat(const char* shortName) const;
+
+    int32_t getNumOutputFormats() const;
+    AVOutputFormat* getOutputFormat(int32_t index) const;
+    /**
+     * Same as av_guess_format.
+     */
+    AVOutputFormat* guessOutputFormat(const char* shortName,
+        const char* url, const char* mimeType) const;
+
+  private:
+    CodecFormatIndex();
+    ~CodecFormatIndex();
+
+    // a key and the position of the entry in registration order
+    typedef std::pair<int32_t, int32_t> IntKey;
+    typedef std::pair<std::string, int32_t> StringKey;
+
+    static int32_t findFirst(const std::vector<StringKey>& table,
+        const std::string& key);
+    AVCodec* findCodec(const std::vector<IntKey>& table, int32_t id) const;
+
+    std::vector<AVCodec*> mCodecs;
+    std::vector<std::vector<int32_t> > mCodecsByType;
+    std::vector<IntKey> mEncodersById;
+    std::vector<IntKey> mDecodersById;
+    std::vector<StringKey> mEncodersByName;
+    std::vector<StringKey> mDecodersByName;
+
+    std::vector<AVInputFormat*> mInputFormats;
+    // each of an input format's comma separated names, lower case
+    std::vector<StringKey> mInputFormatsByName;
+
+    std::vector<AVOutputFormat*> mOutputFormats;
+    std::vector<StringKey> mOutputFormatsByName;
+    std::vector<StringKey> mOutputFormatsByMimeType;
+    // each of an output format's extensions, lower case
+    std::vector<StringKey> mOutputFormatsByExtension;
+  };
+
+}}}
+
+#endif /*CODECFORMATINDEX_H_*/
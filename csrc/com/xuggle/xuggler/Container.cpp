@@ -21,6 +21,7 @@
 
 // for strncpy
 #include <cstring>
+#include <limits>
 
 //#define attribute_deprecated
 
@@ -28,10 +29,12 @@
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/Container.h>
 #include <com/xuggle/xuggler/ContainerFormat.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
 #include <com/xuggle/xuggler/Stream.h>
 #include <com/xuggle/xuggler/Packet.h>
 #include <com/xuggle/xuggler/Global.h>
 #include <com/xuggle/xuggler/Property.h>
+#include <com/xuggle/xuggler/PropertyHandle.h>
 #include <com/xuggle/xuggler/MetaData.h>
 #include <com/xuggle/ferry/IBuffer.h>
 #include <com/xuggle/xuggler/io/URLProtocolManager.h>
@@ -114,13 +117,22 @@ namespace com { namespace xuggle { namespace xuggler
     mNumStreams = 0;
     mInputBufferLength = 0;
     mReadRetryCount = 1;
+    mZeroCopyReads = false;
     mCustomIOHandler = 0;
+    mKeyFrameIndex = 0;
+    mProbeSize = 0;
+    mAnalyzeDuration = 0;
+    mMaxProbeStreams = 0;
+    mCacheProbeResults = false;
+    mProbeResultRestored = false;
   }
 
   Container :: ~Container()
   {
     reset();
     resetContext();
+    delete mKeyFrameIndex;
+    mKeyFrameIndex = 0;
     VS_LOG_TRACE("Destroyed container: %p", this);
   }
 
@@ -403,6 +415,8 @@ namespace com { namespace xuggle { namespace xuggler
         retval = 0;
       }
 
+      // the probe size also limits how much we read to guess the format
+      setProbeBudget();
       if (retval >= 0)
         retval = avformat_open_input(
             &mFormatContext,
@@ -457,7 +471,7 @@ namespace com { namespace xuggle { namespace xuggler
 
       if (!outputFormat) {
         // guess it.
-        outputFormat = av_guess_format(0, url, 0);
+        outputFormat = CodecFormatIndex::get()->guessOutputFormat(0, url, 0);
         RefPointer<ContainerFormat> format = ContainerFormat::make();
         if (!format)
           throw std::bad_alloc();
@@ -582,6 +596,8 @@ namespace com { namespace xuggle { namespace xuggler
         mStreams.pop_back();
       }
       mNumStreams = 0;
+      delete mKeyFrameIndex;
+      mKeyFrameIndex = 0;
 
       // we need to remember the avio context
       AVIOContext* pb = mFormatContext->pb;
@@ -604,6 +620,7 @@ namespace com { namespace xuggle { namespace xuggler
       resetContext();
       mIsOpened = false;
       mIsMetaDataQueried=false;
+      mProbeResultRestored = false;
     }
     XUGGLER_CHECK_INTERRUPT(retval);
     return retval;
@@ -651,7 +668,12 @@ namespace com { namespace xuggle { namespace xuggler
           (mReadRetryCount < 0 || numReads <= mReadRetryCount));
 
       if (retval >= 0)
-        pkt->wrapAVPacket(packet);
+      {
+        if (mZeroCopyReads)
+          pkt->adoptAVPacket(packet);
+        else
+          pkt->wrapAVPacket(packet);
+      }
       av_free_packet(packet);
 
       // Get a pointer to the wrapped packet
@@ -668,15 +690,28 @@ namespace com { namespace xuggle { namespace xuggler
           packet->data);
       
       // and let's try to set the packet time base if known
-      if (pkt->getStreamIndex() >= 0)
+      int32_t streamIndex = pkt->getStreamIndex();
+      if (streamIndex >= 0)
       {
-        RefPointer<IStream> stream = this->getStream(pkt->getStreamIndex());
-        if (stream)
+        if (mFormatContext->nb_streams != mNumStreams)
+          setupAllInputStreams();
+        Stream* stream = (uint32_t)streamIndex < mNumStreams ?
+            mStreams.at(streamIndex)->value() : 0;
+        AVStream* avStream = stream ? stream->getAVStream() : 0;
+        if (avStream)
         {
-          RefPointer<IRational> streamBase = stream->getTimeBase();
-          if (streamBase)
+          // Packets are usually re-used for the same streams, so only
+          // allocate a new time base when it actually changes.
+          RefPointer<IRational> packetBase = pkt->getTimeBase();
+          if (!packetBase
+              || packetBase->getNumerator() != avStream->time_base.num
+              || packetBase->getDenominator() != avStream->time_base.den)
           {
-            pkt->setTimeBase(streamBase.value());
+            RefPointer<IRational> streamBase = stream->getTimeBase();
+            if (streamBase)
+            {
+              pkt->setTimeBase(streamBase.value());
+            }
           }
         }
       }
@@ -684,6 +719,45 @@ namespace com { namespace xuggle { namespace xuggler
     XUGGLER_CHECK_INTERRUPT(retval);
     return retval;
   }
+
+  int32_t
+  Container :: readNextPackets(IPacket** packets, int32_t numPackets)
+  {
+    if (!packets || numPackets < 0)
+      return -1;
+    if (!numPackets)
+      return 0;
+
+    int32_t numRead = 0;
+    int32_t retval = 0;
+    for(; numRead < numPackets; numRead++)
+    {
+      retval = readNextPacket(packets[numRead]);
+      if (retval < 0)
+        break;
+    }
+    return numRead > 0 ? numRead : retval;
+  }
+
+  int32_t
+  Container :: writePackets(IPacket** packets, int32_t numPackets,
+      bool forceInterleave)
+  {
+    if (!packets || numPackets < 0)
+      return -1;
+    if (!numPackets)
+      return 0;
+
+    int32_t numWritten = 0;
+    int32_t retval = 0;
+    for(; numWritten < numPackets; numWritten++)
+    {
+      retval = writePacket(packets[numWritten], forceInterleave);
+      if (retval < 0)
+        break;
+    }
+    return numWritten > 0 ? numWritten : retval;
+  }
   int32_t
   Container :: writePacket(IPacket *ipkt)
   {
@@ -883,7 +957,24 @@ namespace com { namespace xuggle { namespace xuggler
     {
       if (!mIsMetaDataQueried)
       {
-        retval = avformat_find_stream_info(mFormatContext, 0);
+        mProbeResultRestored = mCacheProbeResults &&
+            StreamProbeCache::restore(getURL(), mFormatContext);
+        if (mProbeResultRestored)
+          retval = 0;
+        else
+        {
+          uint32_t numHeaderStreams = mFormatContext->nb_streams;
+          int noHeader = mFormatContext->ctx_flags & AVFMTCTX_NOHEADER;
+          setProbeBudget();
+          // enforces mMaxProbeStreams
+          mFormatContext->interrupt_callback.callback =
+              Container::probeInterruptCB;
+          retval = avformat_find_stream_info(mFormatContext, 0);
+          mFormatContext->interrupt_callback.callback = Global::avioInterruptCB;
+          mFormatContext->ctx_flags |= noHeader;
+          if (retval >= 0 && mCacheProbeResults)
+            StreamProbeCache::store(getURL(), mFormatContext, numHeaderStreams);
+        }
         // for shits and giggles, dump the ffmpeg output
         // dump_format(mFormatContext, 0, (mFormatContext ? mFormatContext->filename :0), 0);
         mIsMetaDataQueried = true;
@@ -917,7 +1008,17 @@ namespace com { namespace xuggle { namespace xuggler
         VS_LOG_WARN("Attempt to seek on streamIndex %d but only %d streams known about in container",
             streamIndex, mNumStreams);
       else
-        retval = av_seek_frame(mFormatContext, streamIndex, timestamp, flags);
+      {
+        if (flags & AVSEEK_FLAG_BACKWARD)
+          retval = seekInKeyFrameIndex(streamIndex,
+              std::numeric_limits<int64_t>::min(), timestamp, timestamp,
+              flags);
+        else
+          retval = seekInKeyFrameIndex(streamIndex, timestamp, timestamp,
+              std::numeric_limits<int64_t>::max(), flags);
+        if (retval < 0)
+          retval = av_seek_frame(mFormatContext, streamIndex, timestamp, flags);
+      }
     }
     else
     {
@@ -939,11 +1040,16 @@ namespace com { namespace xuggle { namespace xuggler
         VS_LOG_WARN("Attempt to seek on streamIndex %d but only %d streams known about in container",
             streamIndex, mNumStreams);
       else
-        retval = avformat_seek_file(mFormatContext, streamIndex,
-            minTimeStamp,
-            targetTimeStamp,
-            maxTimeStamp,
-            flags);
+      {
+        retval = seekInKeyFrameIndex(streamIndex, minTimeStamp,
+            targetTimeStamp, maxTimeStamp, flags);
+        if (retval < 0)
+          retval = avformat_seek_file(mFormatContext, streamIndex,
+              minTimeStamp,
+              targetTimeStamp,
+              maxTimeStamp,
+              flags);
+      }
     }
     else
     {
@@ -1124,6 +1230,12 @@ namespace com { namespace xuggle { namespace xuggler
     return Property::getPropertyAsBoolean(mFormatContext, aName);
   }
 
+  IPropertyHandle*
+  Container :: getPropertyHandle(const char *aName)
+  {
+    return PropertyHandle::make(this, (void**)&mFormatContext, aName);
+  }
+
   int32_t
   Container :: getFlags()
   {
@@ -1211,6 +1323,297 @@ namespace com { namespace xuggle { namespace xuggler
   {
     mReadRetryCount = aCount;
   }
+
+  bool
+  Container :: getZeroCopyReads()
+  {
+    return mZeroCopyReads;
+  }
+
+  void
+  Container :: setZeroCopyReads(bool value)
+  {
+    mZeroCopyReads = value;
+  }
+
+  int32_t
+  Container :: buildKeyFrameIndex()
+  {
+    int32_t retval = -1;
+    if (!mIsOpened || getType() != READ)
+    {
+      VS_LOG_WARN("Attempt to build a keyframe index but container is not open for reading");
+      return -1;
+    }
+    if (mFormatContext->nb_streams != mNumStreams)
+      setupAllInputStreams();
+
+    if (!mKeyFrameIndex)
+      mKeyFrameIndex = new KeyFrameIndex();
+    mKeyFrameIndex->reset(mFormatContext);
+
+    AVPacket packet;
+    av_init_packet(&packet);
+    int32_t numEntries = 0;
+    do
+    {
+      retval = av_read_frame(mFormatContext, &packet);
+      if (retval >= 0)
+      {
+        if ((uint32_t)packet.stream_index >= (uint32_t)mKeyFrameIndex->getNumStreams())
+          // a stream the demuxer found while we were scanning
+          mKeyFrameIndex->addStreams(mFormatContext);
+        if (mKeyFrameIndex->add(&packet))
+          ++numEntries;
+        av_free_packet(&packet);
+      }
+    } while (retval >= 0 || retval == AVERROR(EAGAIN));
+    XUGGLER_CHECK_INTERRUPT(retval);
+    if (retval == AVERROR(EINTR))
+      return retval;
+    if (retval != (int32_t)AVERROR_EOF)
+      VS_LOG_DEBUG("Stopped building keyframe index on read error: %d", retval);
+
+    mKeyFrameIndex->sort();
+    addKeyFrameIndexToStreams();
+
+    // and go back to where we were when we started
+    int64_t position = mKeyFrameIndex->getFirstPosition();
+    if (position >= 0)
+      retval = av_seek_frame(mFormatContext, -1, position, AVSEEK_FLAG_BYTE);
+    else
+      retval = av_seek_frame(mFormatContext, -1,
+          mFormatContext->start_time == Global::NO_PTS ? 0 :
+              mFormatContext->start_time,
+          AVSEEK_FLAG_BACKWARD);
+    if (retval < 0)
+      VS_LOG_WARN("Could not seek back after building keyframe index");
+    else
+      retval = numEntries;
+    XUGGLER_CHECK_INTERRUPT(retval);
+    return retval;
+  }
+
+  int32_t
+  Container :: writeKeyFrameIndex(const char* url)
+  {
+    int32_t retval = -1;
+    if (!url || !*url)
+    {
+      VS_LOG_WARN("No url to write keyframe index to");
+      return -1;
+    }
+    if (!mKeyFrameIndex)
+    {
+      VS_LOG_WARN("Attempt to write keyframe index before building or reading one");
+      return -1;
+    }
+    AVIOContext* pb = 0;
+    retval = avio_open2(&pb, url, AVIO_FLAG_WRITE,
+        &mFormatContext->interrupt_callback, 0);
+    if (retval >= 0)
+    {
+      int64_t fileSize = mFormatContext->pb ? avio_size(mFormatContext->pb) : -1;
+      retval = mKeyFrameIndex->write(pb, fileSize);
+      int32_t closeRetval = avio_close(pb);
+      if (retval >= 0 && closeRetval < 0)
+        retval = closeRetval;
+    }
+    else
+    {
+      VS_LOG_WARN("Could not open keyframe index for writing: %s", url);
+    }
+    XUGGLER_CHECK_INTERRUPT(retval);
+    return retval;
+  }
+
+  int32_t
+  Container :: readKeyFrameIndex(const char* url)
+  {
+    int32_t retval = -1;
+    if (!url || !*url)
+    {
+      VS_LOG_WARN("No url to read keyframe index from");
+      return -1;
+    }
+    if (!mIsOpened || getType() != READ)
+    {
+      VS_LOG_WARN("Attempt to read a keyframe index but container is not open for reading");
+      return -1;
+    }
+    if (mFormatContext->nb_streams != mNumStreams)
+      setupAllInputStreams();
+
+    AVIOContext* pb = 0;
+    retval = avio_open2(&pb, url, AVIO_FLAG_READ,
+        &mFormatContext->interrupt_callback, 0);
+    if (retval >= 0)
+    {
+      if (!mKeyFrameIndex)
+        mKeyFrameIndex = new KeyFrameIndex();
+      int64_t fileSize = mFormatContext->pb ? avio_size(mFormatContext->pb) : -1;
+      retval = mKeyFrameIndex->read(pb, mFormatContext, fileSize);
+      avio_close(pb);
+      if (retval >= 0)
+        addKeyFrameIndexToStreams();
+      else
+      {
+        delete mKeyFrameIndex;
+        mKeyFrameIndex = 0;
+      }
+    }
+    else
+    {
+      VS_LOG_WARN("Could not open keyframe index for reading: %s", url);
+    }
+    XUGGLER_CHECK_INTERRUPT(retval);
+    return retval;
+  }
+
+  int32_t
+  Container :: setProbeSize(int32_t size)
+  {
+    if (size < 0)
+      return -1;
+    mProbeSize = size;
+    return 0;
+  }
+
+  int32_t
+  Container :: getProbeSize()
+  {
+    return mProbeSize;
+  }
+
+  int32_t
+  Container :: setAnalyzeDuration(int64_t duration)
+  {
+    if (duration < 0 || duration > std::numeric_limits<int>::max())
+      return -1;
+    mAnalyzeDuration = duration;
+    return 0;
+  }
+
+  int64_t
+  Container :: getAnalyzeDuration()
+  {
+    return mAnalyzeDuration;
+  }
+
+  int32_t
+  Container :: setMaxProbeStreams(int32_t maxStreams)
+  {
+    if (maxStreams < 0)
+      return -1;
+    mMaxProbeStreams = maxStreams;
+    return 0;
+  }
+
+  int32_t
+  Container :: getMaxProbeStreams()
+  {
+    return mMaxProbeStreams;
+  }
+
+  void
+  Container :: setCacheProbeResults(bool value)
+  {
+    mCacheProbeResults = value;
+  }
+
+  bool
+  Container :: getCacheProbeResults()
+  {
+    return mCacheProbeResults;
+  }
+
+  bool
+  Container :: isProbeResultRestored()
+  {
+    return mProbeResultRestored;
+  }
+
+  void
+  Container :: setProbeBudget()
+  {
+    if (!mFormatContext)
+      return;
+    if (mProbeSize > 0)
+      mFormatContext->probesize = mProbeSize;
+    if (mAnalyzeDuration > 0)
+      mFormatContext->max_analyze_duration = mAnalyzeDuration;
+  }
+
+  int
+  Container :: probeInterruptCB(void* opaque)
+  {
+    // avformat_find_stream_info checks for interrupts at the top of every
+    // pass, just before it decides whether it is done.  It can't be done
+    // while AVFMTCTX_NOHEADER is set, since more streams might turn up;
+    // once we have as many as we want, clear it so probing stops as soon
+    // as they all have parameters.
+    Container* container = static_cast<Container*>(opaque);
+    AVFormatContext* context = container ? container->mFormatContext : 0;
+    if (context && container->mMaxProbeStreams > 0 &&
+        context->nb_streams >= (uint32_t)container->mMaxProbeStreams)
+      context->ctx_flags &= ~AVFMTCTX_NOHEADER;
+    return Global::avioInterruptCB(opaque);
+  }
+
+  void
+  Container :: addKeyFrameIndexToStreams()
+  {
+    // Hand the entries to the demuxer too, so Stream::findTimeStampEntryInIndex
+    // and FFmpeg's own generic seeking see them.  They are sorted, so each
+    // is appended rather than inserted.
+    for(int32_t i = 0; i < mKeyFrameIndex->getNumStreams() &&
+        (uint32_t)i < mFormatContext->nb_streams; i++)
+    {
+      if (!mKeyFrameIndex->canSeekByPosition(i))
+        continue;
+      AVStream* stream = mFormatContext->streams[i];
+      int32_t numEntries = mKeyFrameIndex->getNumEntries(i);
+      for(int32_t j = 0; j < numEntries; j++)
+      {
+        const KeyFrameIndex::Entry* entry = mKeyFrameIndex->getEntry(i, j);
+        av_add_index_entry(stream, entry->pos,
+            KeyFrameIndex::getTimeStamp(*entry), entry->size, 0,
+            AVINDEX_KEYFRAME);
+      }
+    }
+  }
+
+  int32_t
+  Container :: seekInKeyFrameIndex(int32_t streamIndex, int64_t minTimeStamp,
+      int64_t targetTimeStamp, int64_t maxTimeStamp, int32_t flags)
+  {
+    if (!mKeyFrameIndex ||
+        (flags & (AVSEEK_FLAG_BYTE | AVSEEK_FLAG_ANY | AVSEEK_FLAG_FRAME)))
+      return -1;
+
+    if (streamIndex < 0)
+    {
+      // time stamps are in AV_TIME_BASE units for the default stream
+      streamIndex = av_find_default_stream_index(mFormatContext);
+      if (streamIndex < 0)
+        return -1;
+      AVRational timeBase = { 1, AV_TIME_BASE };
+      AVRational streamBase = mFormatContext->streams[streamIndex]->time_base;
+      if (minTimeStamp != std::numeric_limits<int64_t>::min())
+        minTimeStamp = av_rescale_q(minTimeStamp, timeBase, streamBase);
+      targetTimeStamp = av_rescale_q(targetTimeStamp, timeBase, streamBase);
+      if (maxTimeStamp != std::numeric_limits<int64_t>::max())
+        maxTimeStamp = av_rescale_q(maxTimeStamp, timeBase, streamBase);
+    }
+    const KeyFrameIndex::Entry* entry = mKeyFrameIndex->find(streamIndex,
+        minTimeStamp, targetTimeStamp, maxTimeStamp);
+    if (!entry)
+      return -1;
+    VS_LOG_TRACE("Seeking stream %d to keyframe at %lld (position %lld)",
+        streamIndex, KeyFrameIndex::getTimeStamp(*entry), entry->pos);
+    return av_seek_frame(mFormatContext, streamIndex, entry->pos,
+        AVSEEK_FLAG_BYTE);
+  }
   
   int32_t
   Container :: setFormat(IContainerFormat* aFormat)
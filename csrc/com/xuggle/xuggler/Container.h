@@ -28,6 +28,8 @@
 #include <com/xuggle/xuggler/StreamCoder.h>
 #include <com/xuggle/xuggler/ContainerFormat.h>
 #include <com/xuggle/xuggler/MetaData.h>
+#include <com/xuggle/xuggler/KeyFrameIndex.h>
+#include <com/xuggle/xuggler/StreamProbeCache.h>
 
 #include <com/xuggle/xuggler/io/URLProtocolHandler.h>
 #include <vector>
@@ -62,6 +64,9 @@ namespace com { namespace xuggle { namespace xuggler
     virtual int32_t readNextPacket(IPacket *packet);
     virtual int32_t writePacket(IPacket *packet, bool forceInterleave);
     virtual int32_t writePacket(IPacket *packet);
+    virtual int32_t readNextPackets(IPacket** packets, int32_t numPackets);
+    virtual int32_t writePackets(IPacket** packets, int32_t numPackets,
+        bool forceInterleave);
 
     virtual int32_t writeHeader();
     virtual int32_t writeTrailer();
@@ -142,6 +147,25 @@ namespace com { namespace xuggle { namespace xuggler
     virtual int32_t open(const char *url, Type type,
         IContainerFormat* pContainerFormat, bool, bool,
         IMetaData*, IMetaData*);
+
+    /*
+     * Added for 5.5
+     */
+    virtual void setZeroCopyReads(bool value);
+    virtual bool getZeroCopyReads();
+    virtual int32_t buildKeyFrameIndex();
+    virtual int32_t writeKeyFrameIndex(const char* url);
+    virtual int32_t readKeyFrameIndex(const char* url);
+    virtual int32_t setProbeSize(int32_t size);
+    virtual int32_t getProbeSize();
+    virtual int32_t setAnalyzeDuration(int64_t duration);
+    virtual int64_t getAnalyzeDuration();
+    virtual int32_t setMaxProbeStreams(int32_t maxStreams);
+    virtual int32_t getMaxProbeStreams();
+    virtual void setCacheProbeResults(bool value);
+    virtual bool getCacheProbeResults();
+    virtual bool isProbeResultRestored();
+    virtual IPropertyHandle* getPropertyHandle(const char* name);
   protected:
     virtual ~Container();
     Container();
@@ -151,6 +175,11 @@ namespace com { namespace xuggle { namespace xuggler
     int32_t openInputURL(const char*url, bool, bool, AVDictionary** options);
     int32_t openOutputURL(const char*url, bool, AVDictionary **options);
     int32_t setupAllInputStreams();
+    int32_t seekInKeyFrameIndex(int32_t streamIndex, int64_t minTimeStamp,
+        int64_t targetTimeStamp, int64_t maxTimeStamp, int32_t flags);
+    void addKeyFrameIndexToStreams();
+    void setProbeBudget();
+    static int probeInterruptCB(void* opaque);
     AVFormatContext *mFormatContext;
     void reset();
     void resetContext();
@@ -171,10 +200,21 @@ namespace com { namespace xuggle { namespace xuggler
     uint32_t mInputBufferLength;
     
     int32_t mReadRetryCount;
+    bool mZeroCopyReads;
     com::xuggle::ferry::RefPointer<MetaData> mMetaData;
     com::xuggle::ferry::RefPointer<ContainerFormat> mFormat;
 
     io::URLProtocolHandler *mCustomIOHandler;
+    // null until an index is built or read
+    KeyFrameIndex *mKeyFrameIndex;
+
+    // 0 for FFmpeg's defaults
+    int32_t mProbeSize;
+    int64_t mAnalyzeDuration;
+    // 0 for no limit
+    int32_t mMaxProbeStreams;
+    bool mCacheProbeResults;
+    bool mProbeResultRestored;
   };
 }}}
 
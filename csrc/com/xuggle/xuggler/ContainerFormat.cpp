@@ -18,6 +18,7 @@
  *******************************************************************************/
 
 #include <com/xuggle/xuggler/ContainerFormat.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
 
 #define VS_FFMPEG_GOT_OFF_THEIR_BUTT_AND_EXPOSED_THIS
 #ifdef VS_FFMPEG_GOT_OFF_THEIR_BUTT_AND_EXPOSED_THIS
@@ -52,7 +53,7 @@ namespace com { namespace xuggle { namespace xuggler
   {
     if (shortName && *shortName)
     {
-      mInputFormat = av_find_input_format(shortName);
+      mInputFormat = CodecFormatIndex::get()->findInputFormat(shortName);
     } else {
       mInputFormat = NULL;
     }
@@ -67,7 +68,8 @@ namespace com { namespace xuggle { namespace xuggler
         (url && *url) ||
         (mimeType && *mimeType))
     {
-      mOutputFormat = av_guess_format(shortName, url, mimeType);
+      mOutputFormat = CodecFormatIndex::get()->guessOutputFormat(shortName,
+          url, mimeType);
     } else {
       mOutputFormat = NULL;
     }
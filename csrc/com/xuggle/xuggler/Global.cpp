@@ -19,6 +19,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <pthread.h>
 
 #include <com/xuggle/ferry/JNIHelper.h>
 #include <com/xuggle/ferry/Logger.h>
@@ -30,6 +31,7 @@
 #include <com/xuggle/xuggler/Container.h>
 #include <com/xuggle/xuggler/ContainerFormat.h>
 #include <com/xuggle/xuggler/Codec.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
 #include <com/xuggle/xuggler/Rational.h>
 #include <com/xuggle/xuggler/AudioSamples.h>
 #include <com/xuggle/xuggler/VideoPicture.h>
@@ -55,6 +57,8 @@ namespace com { namespace xuggle { namespace xuggler
    * it wants to log.  We then use it to dump
    * stuff into our own logs.
    */
+  static SpinMutex sLogCallbackLock;
+
   static void
   xuggler_log_callback(void* ptr, int level, const char* fmt, va_list va)
   {
@@ -69,10 +73,11 @@ namespace com { namespace xuggle { namespace xuggler
 
     if (!ffmpegLogger)
     {
-      Global::lock();
+      // not Global::lock(); FFmpeg may log while a caller holds that
+      sLogCallbackLock.lock();
       if (!ffmpegLogger)
         ffmpegLogger = Logger::getStaticLogger( "org.ffmpeg" );
-      Global::unlock();
+      sLogCallbackLock.unlock();
     }
 
     Logger::Level logLevel;
@@ -121,7 +126,17 @@ namespace com { namespace xuggle { namespace xuggler
     return retval;
   }
   
-  static int xuggler_lockmgr_cb(void** ctx, enum AVLockOp op)
+  /*
+   * Lock manager statistics.  Updated with atomic builtins so the
+   * lock manager never needs another lock to keep them.
+   */
+  static volatile int64_t sLockManagerObtains = 0;
+  static volatile int64_t sLockManagerContended = 0;
+  static volatile int64_t sLockManagerWaitTime = 0;
+  static Global::LockManagerType sLockManagerType =
+    Global::LOCK_MANAGER_NATIVE;
+
+  static int xuggler_java_lockmgr_cb(void** ctx, enum AVLockOp op)
   {
     if (!ctx)
       return 1;
@@ -134,14 +149,20 @@ namespace com { namespace xuggle { namespace xuggler
       case AV_LOCK_CREATE:
         mutex = com::xuggle::ferry::Mutex::make();
         *ctx = mutex;
-        retval = !!mutex;
+        // FFmpeg treats any non-zero return as failure
+        retval = !mutex;
         break;
       case AV_LOCK_DESTROY:
         if (mutex) mutex->release();
         *ctx = 0;
         break;
       case AV_LOCK_OBTAIN:
-        if (mutex) mutex->lock();
+        if (mutex) {
+          int64_t start = av_gettime();
+          mutex->lock();
+          __sync_fetch_and_add(&sLockManagerObtains, 1);
+          __sync_fetch_and_add(&sLockManagerWaitTime, av_gettime()-start);
+        }
         break;
       case AV_LOCK_RELEASE:
         if (mutex) mutex->unlock();
@@ -149,6 +170,57 @@ namespace com { namespace xuggle { namespace xuggler
     }
     return retval;
   }
+
+  static int xuggler_native_lockmgr_cb(void** ctx, enum AVLockOp op)
+  {
+    if (!ctx)
+      return 1;
+
+    pthread_mutex_t* mutex = static_cast<pthread_mutex_t*>(*ctx);
+    switch(op)
+    {
+      case AV_LOCK_CREATE:
+        mutex = new pthread_mutex_t;
+        if (pthread_mutex_init(mutex, 0)) {
+          delete mutex;
+          return 1;
+        }
+        *ctx = mutex;
+        break;
+      case AV_LOCK_DESTROY:
+        if (mutex) {
+          pthread_mutex_destroy(mutex);
+          delete mutex;
+        }
+        *ctx = 0;
+        break;
+      case AV_LOCK_OBTAIN:
+        if (!mutex)
+          return 1;
+        // only pay for the clock when someone else has the lock
+        if (pthread_mutex_trylock(mutex)) {
+          int64_t start = av_gettime();
+          if (pthread_mutex_lock(mutex))
+            return 1;
+          __sync_fetch_and_add(&sLockManagerContended, 1);
+          __sync_fetch_and_add(&sLockManagerWaitTime, av_gettime()-start);
+        }
+        __sync_fetch_and_add(&sLockManagerObtains, 1);
+        break;
+      case AV_LOCK_RELEASE:
+        if (!mutex || pthread_mutex_unlock(mutex))
+          return 1;
+        break;
+    }
+    return 0;
+  }
+
+  static int xuggler_lockmgr_register(Global::LockManagerType type)
+  {
+    // no logging; see the warning above
+    return av_lockmgr_register(type == Global::LOCK_MANAGER_JAVA ?
+        xuggler_java_lockmgr_cb : xuggler_native_lockmgr_cb);
+  }
   
   Global* Global :: sGlobal = 0;
 
@@ -157,7 +229,13 @@ namespace com { namespace xuggle { namespace xuggler
   {
     if (!sGlobal)
     {
-      av_lockmgr_register(xuggler_lockmgr_cb);
+      if (xuggler_lockmgr_register(sLockManagerType) < 0 &&
+          sLockManagerType != LOCK_MANAGER_NATIVE)
+      {
+        // never leave FFmpeg without locks
+        sLockManagerType = LOCK_MANAGER_NATIVE;
+        xuggler_lockmgr_register(sLockManagerType);
+      }
       av_log_set_callback(xuggler_log_callback);
       av_log_set_level(AV_LOG_ERROR); // Only log errors by default
       av_register_all();
@@ -168,10 +246,66 @@ namespace com { namespace xuggle { namespace xuggler
       // and set up the device library for webcam support
       avdevice_register_all();
 
+      // now that everything is registered, index it for lookups
+      CodecFormatIndex::build();
+
       // turn down logging
       sGlobal = new Global();
     }
   }
+  int32_t
+  Global :: init(LockManagerType type)
+  {
+    if (setLockManagerType(type) < 0)
+      return -1;
+    init();
+    return sLockManagerType == type ? 0 : -1;
+  }
+
+  Global::LockManagerType
+  Global :: getLockManagerType()
+  {
+    return sLockManagerType;
+  }
+
+  int32_t
+  Global :: setLockManagerType(LockManagerType type)
+  {
+    // FFmpeg's av_lockmgr_register destroys its locks and makes new
+    // ones, even if another thread holds them; so the lock manager can
+    // only be chosen before we first register one.
+    if (sGlobal)
+      return type == sLockManagerType ? 0 : -1;
+    sLockManagerType = type;
+    return 0;
+  }
+
+  int64_t
+  Global :: getLockManagerObtainCount()
+  {
+    return __sync_fetch_and_add(&sLockManagerObtains, 0);
+  }
+
+  int64_t
+  Global :: getLockManagerContendedCount()
+  {
+    return __sync_fetch_and_add(&sLockManagerContended, 0);
+  }
+
+  int64_t
+  Global :: getLockManagerWaitTime()
+  {
+    return __sync_fetch_and_add(&sLockManagerWaitTime, 0);
+  }
+
+  void
+  Global :: resetLockManagerStatistics()
+  {
+    __sync_lock_test_and_set(&sLockManagerObtains, 0);
+    __sync_lock_test_and_set(&sLockManagerContended, 0);
+    __sync_lock_test_and_set(&sLockManagerWaitTime, 0);
+  }
+
   void
   Global :: deinit()
   {
@@ -193,29 +327,26 @@ namespace com { namespace xuggle { namespace xuggler
     com::xuggle::ferry::JNIHelper::sRegisterTerminationCallback(
         Global::destroyStaticGlobal,
         this);
-    mLock = com::xuggle::ferry::Mutex::make();
   }
 
   Global :: ~Global()
   {
-    if (mLock)
-      mLock->release();
   }
   
   void
   Global :: lock()
   {
     Global::init();
-    if (sGlobal && sGlobal->mLock)
-      sGlobal->mLock->lock();
+    if (sGlobal)
+      sGlobal->mLock.lock();
   }
 
   void
   Global :: unlock()
   {
     Global::init();
-    if (sGlobal && sGlobal->mLock)
-      sGlobal->mLock->unlock();
+    if (sGlobal)
+      sGlobal->mLock.unlock();
   }
 
   int64_t
@@ -20,7 +20,7 @@
 #ifndef GLOBAL_H_
 #define GLOBAL_H_
 
-#include <com/xuggle/ferry/Mutex.h>
+#include <com/xuggle/ferry/SpinMutex.h>
 #include <com/xuggle/ferry/RefCounted.h>
 #include <com/xuggle/xuggler/Xuggler.h>
 #include <com/xuggle/xuggler/IContainer.h>
@@ -120,6 +120,10 @@ namespace com { namespace xuggle { namespace xuggler
      * <p>
      * Lastly, if you lock, make damn sure you call #unlock()
      * </p>
+     * <p>
+     * The lock is a native spin lock and is not re-entrant; do not
+     * call #lock() again from a thread that already holds it.
+     * </p>
      */
     static void lock();
 
@@ -166,13 +170,101 @@ namespace com { namespace xuggle { namespace xuggler
      */
     static void setFFmpegLoggingLevel(int32_t level);
 
+    /*
+     * Added for 5.5
+     */
+
+    /**
+     * The implementations of the lock manager that FFmpeg uses
+     * to serialize codec opens and closes.
+     */
+    typedef enum LockManagerType
+    {
+      /**
+       * Native mutexes that never touch the Java virtual machine.
+       * The default.
+       */
+      LOCK_MANAGER_NATIVE,
+      /**
+       * Java monitors (the behaviour before 5.5).  Every codec open
+       * and close attaches the calling thread to the Java virtual
+       * machine.
+       */
+      LOCK_MANAGER_JAVA,
+    } LockManagerType;
+
+    /**
+     * Get the lock manager implementation FFmpeg is currently using.
+     * @return the lock manager type.
+     * @since 5.5
+     */
+    static LockManagerType getLockManagerType();
+
+    /**
+     * Internal Only.  Choose the lock manager FFmpeg will use.
+     * <p>
+     * The choice is made when Xuggler is first initialized, which
+     * happens the first time almost any Xuggler object is made, so
+     * this must be called before that.  Afterwards FFmpeg's locks
+     * may be held by other threads and cannot safely be replaced.
+     * </p>
+     * @param type the lock manager type to use.
+     * @return 0 on success; < 0 if Xuggler is already initialized
+     *   with a different lock manager.
+     * @since 5.5
+     */
+    static int32_t setLockManagerType(LockManagerType type);
+
+    /**
+     * Get the number of times FFmpeg has obtained a lock from
+     * the lock manager.
+     * @return the number of lock obtains.
+     * @since 5.5
+     */
+    static int64_t getLockManagerObtainCount();
+
+    /**
+     * Get the number of lock obtains that had to wait because
+     * another thread held the lock.  Only the
+     * {@link LockManagerType#LOCK_MANAGER_NATIVE} lock manager can tell,
+     * so this stays zero with {@link LockManagerType#LOCK_MANAGER_JAVA}.
+     * @return the number of contended lock obtains.
+     * @since 5.5
+     */
+    static int64_t getLockManagerContendedCount();
+
+    /**
+     * Get the total time threads have spent waiting to obtain
+     * a lock from the lock manager.
+     * @return the time spent waiting, in microseconds.
+     * @since 5.5
+     */
+    static int64_t getLockManagerWaitTime();
+
+    /**
+     * Reset all of the lock manager counters to zero.
+     * @since 5.5
+     */
+    static void resetLockManagerStatistics();
+
+#ifndef SWIG
+    /**
+     * Internal Only.  Like {@link #init()}, but selects the lock
+     * manager FFmpeg will use; see {@link #setLockManagerType}.
+     * @param type the lock manager type to use.
+     * @return 0 on success; < 0 if already initialized with a
+     *   different lock manager, or if type could not be registered.
+     */
+    static int32_t init(LockManagerType type);
+#endif // ! SWIG
+
   private:
     Global();
     ~Global();
 
     static void destroyStaticGlobal(JavaVM*, void*closure);
     static Global* sGlobal;
-    com::xuggle::ferry::Mutex* mLock;
+    com::xuggle::ferry::SpinMutex mLock;
   };
 }}}
 
@@ -28,6 +28,12 @@ namespace com { namespace xuggle { namespace xuggler
   {
   /**
    * Used to resample {@link IAudioSamples} to different sample rates or number of channels.
+   * <p>
+   * Any number of channels, and any {@link IAudioSamples.Format}, packed or
+   * planar, may be converted in one pass.  Channels are assumed to be in
+   * FFmpeg's default layout for their count (e.g. 6 channels is 5.1) and
+   * are mixed down or up accordingly.
+   * </p>
    */
   class VS_API_XUGGLER IAudioResampler : public com::xuggle::ferry::RefCounted
   {
@@ -20,6 +20,7 @@
 #include "ICodec.h"
 #include "Global.h"
 #include "Codec.h"
+#include "CodecFormatIndex.h"
 
 #include "FfmpegIncludes.h"
 
@@ -90,28 +91,28 @@ namespace com { namespace xuggle { namespace xuggler
   int32_t
   ICodec :: getNumInstalledCodecs()
   {
-    Global::init();
-    int32_t numInstalledCodecs = 0;
-    AVCodec * codec = 0;
-    while((codec = av_codec_next(codec))!=0)
-      ++numInstalledCodecs;
-    return numInstalledCodecs;
+    return CodecFormatIndex::get()->getNumCodecs();
   }
   
   ICodec*
   ICodec :: getInstalledCodec(int32_t index)
   {
-    Global::init();
-    if (index < 0)
-      return 0;
-    
-    AVCodec * codec = 0;
-    for(int32_t i = 0; (codec = av_codec_next(codec))!=0; i++)
-    {
-      if (i == index)
-        return Codec::make(codec);
-    }
-    return 0;
+    AVCodec* codec = CodecFormatIndex::get()->getCodec(index);
+    return codec ? Codec::make(codec) : 0;
+  }
+
+  int32_t
+  ICodec :: getNumInstalledCodecsOfType(Type type)
+  {
+    return CodecFormatIndex::get()->getNumCodecs((enum AVMediaType)type);
+  }
+
+  ICodec*
+  ICodec :: getInstalledCodecOfType(Type type, int32_t index)
+  {
+    AVCodec* codec = CodecFormatIndex::get()->getCodec(
+        (enum AVMediaType)type, index);
+    return codec ? Codec::make(codec) : 0;
   }
 
 }}}
@@ -595,6 +595,32 @@ public:
    */
   static ICodec* getInstalledCodec(int32_t index);
 
+  /**
+   * Get the number of installed codecs of the given type.
+   *
+   * @param type the type of codec
+   *
+   * @return the number of installed codecs of that type.
+   *
+   * @since 5.5
+   */
+  static int32_t getNumInstalledCodecsOfType(Type type);
+
+  /**
+   * Get the {@link ICodec} of the given type at the given index.  Codecs
+   * of a type are listed in the same order as
+   * {@link #getInstalledCodec(int)} lists them.
+   *
+   * @param type the type of codec
+   * @param index the index in our list of codecs of that type
+   *
+   * @return the codec, or null if index < 0 or index >=
+   *   {@link #getNumInstalledCodecsOfType(Type)}
+   *
+   * @since 5.5
+   */
+  static ICodec* getInstalledCodecOfType(Type type, int32_t index);
+
   /**
    * Get the number of frame rates this codec supports for encoding.
    * Not all codecs will report this number.
@@ -29,6 +29,7 @@
 #include <com/xuggle/xuggler/IStreamCoder.h>
 #include <com/xuggle/xuggler/IPacket.h>
 #include <com/xuggle/xuggler/IProperty.h>
+#include <com/xuggle/xuggler/IPropertyHandle.h>
 
 namespace com { namespace xuggle { namespace xuggler
 {
@@ -1009,6 +1010,264 @@ namespace com { namespace xuggle { namespace xuggler
         bool queryStreamMetaData,
         IMetaData* options,
         IMetaData* optionsNotSet)=0;
+
+    /*
+     * Added for 5.5
+     */
+
+    /**
+     * Sets whether {@link #readNextPacket(IPacket)} hands the payload
+     * FFmpeg read directly to the {@link IPacket} instead of copying it.
+     * <p>
+     * When true, and the demuxer allocated the payload itself, the
+     * {@link IPacket} takes ownership of that memory and no copy is made.
+     * Payloads the demuxer does not own (for example data still held by a
+     * parser) are always copied.  The bytes and time stamps read are the
+     * same either way.
+     * </p><p>
+     * Defaults to false.
+     * </p>
+     *
+     * @param value true to read packets without copying their payloads.
+     * @since 5.5
+     */
+    virtual void setZeroCopyReads(bool value)=0;
+
+    /**
+     * Get whether {@link #readNextPacket(IPacket)} avoids copying payloads.
+     *
+     * @see #setZeroCopyReads(boolean)
+     * @return true if packets are read without copying their payloads.
+     * @since 5.5
+     */
+    virtual bool getZeroCopyReads()=0;
+
+    /**
+     * Reads every remaining packet in this container, indexing the
+     * keyframes of each stream, then seeks back to the start.
+     * <p>
+     * Demuxers for some formats, such as MPEG-TS, MPEG-PS and raw
+     * streams, keep little or no index of their own, so seeking in them
+     * means searching the file.  Once this container has an index,
+     * {@link #seekKeyFrame(int, long, int)} and
+     * {@link #seekKeyFrame(int, long, long, long, int)} look the nearest
+     * keyframe up in it and seek straight to its byte position, and
+     * {@link IStream#findTimeStampEntryInIndex(long, int)} sees the
+     * entries too.  Formats that read a complete index from their header
+     * (MP4, Matroska, AVI...) are indexed but still seek the usual way.
+     * </p><p>
+     * Video streams keep every keyframe; other streams keep at most one
+     * a second.  Call this right after opening, before reading or
+     * seeking.  The index lasts until the container is closed; use
+     * {@link #writeKeyFrameIndex(String)} to keep it for next time.
+     * </p>
+     *
+     * @return the number of keyframes indexed, or <0 on error.
+     * @since 5.5
+     */
+    virtual int32_t buildKeyFrameIndex()=0;
+
+    /**
+     * Saves the keyframe index built by {@link #buildKeyFrameIndex()} or
+     * read by {@link #readKeyFrameIndex(String)} to a sidecar file.
+     *
+     * @param url Where to write the index; any url FFmpeg can open for
+     *   writing.
+     * @return the number of keyframes written, or <0 on error.
+     * @since 5.5
+     */
+    virtual int32_t writeKeyFrameIndex(const char* url)=0;
+
+    /**
+     * Loads a keyframe index saved by {@link #writeKeyFrameIndex(String)},
+     * instead of building it again.
+     * <p>
+     * The index is rejected if it was written for a file of a different
+     * size, or for different streams.  Like
+     * {@link #buildKeyFrameIndex()}, call this right after opening.
+     * </p>
+     *
+     * @param url Where to read the index from.
+     * @return the number of keyframes read, or <0 on error, in which case
+     *   this container has no index.
+     * @since 5.5
+     */
+    virtual int32_t readKeyFrameIndex(const char* url)=0;
+
+    /**
+     * Sets the most bytes this container reads, when opened for reading,
+     * to guess its format and to find out the parameters of its streams.
+     * <p>
+     * Smaller values make {@link #open(String, Type, IContainerFormat)}
+     * and {@link #queryStreamMetaData()} faster, at the risk of not
+     * finding out everything about every stream.  Takes effect on the next
+     * open.
+     * </p>
+     *
+     * @param size The most bytes to read, or 0 for FFmpeg's default.
+     * @return 0 on success, or <0 if size is negative.
+     * @since 5.5
+     */
+    virtual int32_t setProbeSize(int32_t size)=0;
+
+    /**
+     * Get the most bytes read to find out about streams.
+     *
+     * @see #setProbeSize(int)
+     * @return the probe size, or 0 if FFmpeg's default is used.
+     * @since 5.5
+     */
+    virtual int32_t getProbeSize()=0;
+
+    /**
+     * Sets how much of each stream, in microseconds, this container will
+     * read to find out the stream's parameters before giving up.
+     * Takes effect on the next open, or the next
+     * {@link #queryStreamMetaData()} if the streams have not been queried
+     * yet.
+     *
+     * @param duration The most microseconds to analyze, or 0 for
+     *   FFmpeg's default.
+     * @return 0 on success, or <0 if duration is negative or too large.
+     * @since 5.5
+     */
+    virtual int32_t setAnalyzeDuration(int64_t duration)=0;
+
+    /**
+     * Get how much of each stream is read to find out its parameters.
+     *
+     * @see #setAnalyzeDuration(long)
+     * @return the duration in microseconds, or 0 if FFmpeg's default is
+     *   used.
+     * @since 5.5
+     */
+    virtual int64_t getAnalyzeDuration()=0;
+
+    /**
+     * Sets how many streams this container needs to know about before it
+     * stops looking for more.
+     * <p>
+     * Formats with no header, such as MPEG-TS, are normally read up to
+     * the probe size in case more streams turn up.  Once maxStreams
+     * streams have been found, whether on open or while probing, probing
+     * instead stops as soon as each of them has its parameters.
+     * </p>
+     *
+     * @param maxStreams The number of streams that is enough, or 0 to
+     *   always look for more.
+     * @return 0 on success, or <0 if maxStreams is negative.
+     * @since 5.5
+     */
+    virtual int32_t setMaxProbeStreams(int32_t maxStreams)=0;
+
+    /**
+     * Get how many streams are enough to stop probing for more.
+     *
+     * @see #setMaxProbeStreams(int)
+     * @return the number of streams, or 0 if there is no limit.
+     * @since 5.5
+     */
+    virtual int32_t getMaxProbeStreams()=0;
+
+    /**
+     * Sets whether this container shares what it finds out about the
+     * streams in a file with other containers that open it.
+     * <p>
+     * When true, after {@link #queryStreamMetaData()} probes a local
+     * file its stream parameters are remembered, keyed by url, size and
+     * modification time.  A later container with this set that opens the
+     * same unchanged file gets the time bases, codec parameters and
+     * extradata put straight back onto its streams instead of decoding
+     * frames to find them again.  Files whose streams are not all
+     * declared in their header (such as MPEG-TS) are always probed.
+     * </p><p>
+     * Defaults to false.  Set before opening.
+     * </p>
+     *
+     * @param value true to use cached probe results.
+     * @since 5.5
+     */
+    virtual void setCacheProbeResults(bool value)=0;
+
+    /**
+     * Get whether this container uses cached probe results.
+     *
+     * @see #setCacheProbeResults(boolean)
+     * @return true if cached probe results are used.
+     * @since 5.5
+     */
+    virtual bool getCacheProbeResults()=0;
+
+    /**
+     * Get whether the stream parameters of this open container came from
+     * the probe result cache rather than from probing the file.
+     *
+     * @see #setCacheProbeResults(boolean)
+     * @return true if the streams were restored from the cache.
+     * @since 5.5
+     */
+    virtual bool isProbeResultRestored()=0;
+
+    /**
+     * Looks up a property on this container once, and returns a handle that
+     * can get and set it without searching for it again.  Use it for
+     * properties changed often, such as the bit rate of a live encoder.
+     * <p>
+     * The handle follows this container across {@link #close()} and
+     * reopening, but properties of the format's private options can only
+     * be found while the container is open.
+     * </p>
+     *
+     * @param name The property name, as for {@link #setProperty(String, String)}.
+     *
+     * @return a handle, or null if there is no property of that name.
+     * @since 5.5
+     */
+    virtual IPropertyHandle* getPropertyHandle(const char* name)=0;
+
+#ifndef SWIG
+    /**
+     * Reads up to numPackets packets from the container, one into each
+     * of the caller-owned packets, stopping early at the first
+     * error (including end of file).
+     * <p>
+     * Each packet is read exactly as {@link #readNextPacket(IPacket)}
+     * would read it.  Java callers get this through
+     * <code>readNextPackets(IPacket[], int)</code>, which fills the
+     * whole batch in one native call.
+     * </p>
+     *
+     * @param packets [In/Out] An array of at least numPackets packets.
+     * @param numPackets The most packets to read.
+     *
+     * @return the number of packets read (which may be less than
+     *   numPackets), 0 if numPackets is 0, or <0 if the first read
+     *   failed.
+     * @since 5.5
+     */
+    virtual int32_t readNextPackets(IPacket** packets, int32_t numPackets)=0;
+
+    /**
+     * Writes numPackets packets to the container, in order, stopping
+     * early at the first error.
+     * <p>
+     * Each packet is written exactly as
+     * {@link #writePacket(IPacket, bool)} would write it.  Java callers
+     * get this through <code>writePackets(IPacket[], int, boolean)</code>.
+     * </p>
+     *
+     * @param packets [In] An array of at least numPackets packets.
+     * @param numPackets The number of packets to write.
+     * @param forceInterleave [In] See {@link #writePacket(IPacket, bool)}.
+     *
+     * @return the number of packets written (which may be less than
+     *   numPackets), 0 if numPackets is 0, or <0 if the first write
+     *   failed.
+     * @since 5.5
+     */
+    virtual int32_t writePackets(IPacket** packets, int32_t numPackets,
+        bool forceInterleave)=0;
+#endif // ! SWIG
   };
 }}}
 #endif /*ICONTAINER_H_*/
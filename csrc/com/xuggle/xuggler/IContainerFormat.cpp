@@ -20,6 +20,7 @@
 #include "IContainerFormat.h"
 #include "Global.h"
 #include "ContainerFormat.h"
+#include "CodecFormatIndex.h"
 
 #include "FfmpegIncludes.h"
 
@@ -39,60 +40,37 @@ namespace com { namespace xuggle { namespace xuggler
   int32_t
   IContainerFormat :: getNumInstalledInputFormats()
   {
-    Global::init();
-    int i = 0;
-    for(AVInputFormat* f = 0;
-    (f = av_iformat_next(f))!=0;
-    ++i)
-      ;
-    return i;
+    return CodecFormatIndex::get()->getNumInputFormats();
   }
   
   IContainerFormat*
   IContainerFormat :: getInstalledInputFormat(int32_t index)
   {
-    Global::init();
-    int i = 0;
-    for(AVInputFormat* f = 0;
-    (f = av_iformat_next(f))!=0;
-    ++i)
-      if (i == index) {
-        ContainerFormat * retval = ContainerFormat::make();
-        if (retval)
-          retval->setInputFormat(f);
-        return retval;
-      }
-    return 0;
+    AVInputFormat* f = CodecFormatIndex::get()->getInputFormat(index);
+    if (!f)
+      return 0;
+    ContainerFormat * retval = ContainerFormat::make();
+    if (retval)
+      retval->setInputFormat(f);
+    return retval;
   }
   
   int32_t
   IContainerFormat :: getNumInstalledOutputFormats()
   {
-    Global::init();
-    int i = 0;
-    for(AVOutputFormat* f = 0;
-    (f = av_oformat_next(f))!=0;
-    ++i)
-      ;
-    return i;
+    return CodecFormatIndex::get()->getNumOutputFormats();
   }
   
   IContainerFormat*
   IContainerFormat :: getInstalledOutputFormat(int32_t index)
   {
-    Global::init();
-    int i = 0;
-    for(AVOutputFormat* f = 0;
-    (f = av_oformat_next(f))!=0;
-    ++i)
-      if (i == index)
-      {
-        ContainerFormat* retval =ContainerFormat::make();
-        if (retval)
-          retval->setOutputFormat(f);
-        return retval;
-      }
-    return 0;
+    AVOutputFormat* f = CodecFormatIndex::get()->getOutputFormat(index);
+    if (!f)
+      return 0;
+    ContainerFormat* retval =ContainerFormat::make();
+    if (retval)
+      retval->setOutputFormat(f);
+    return retval;
   }
   
 }}}
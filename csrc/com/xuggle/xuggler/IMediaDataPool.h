@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef IMEDIADATAPOOL_H_
+#define IMEDIADATAPOOL_H_
+
+#include <com/xuggle/ferry/RefCounted.h>
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/xuggler/IPacket.h>
+#include <com/xuggle/xuggler/IVideoPicture.h>
+#include <com/xuggle/xuggler/IAudioSamples.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+/**
+ * A pool of {@link IPacket}, {@link IVideoPicture} and
+ * {@link IAudioSamples} objects that are reused rather than freed.
+ * <p>
+ * Making a packet, picture or samples object allocates the native
+ * object, its buffer, and (from Java) a reference the garbage collector
+ * later has to find.  Loops that make one of each per frame spend a
+ * good part of their time doing that.  Objects got from a pool go back
+ * to it, instead of being freed, when their last reference is released:
+ * from Java, when you call {@link #recycle(IMediaData)} (or
+ * {@link com.xuggle.ferry.RefCounted#delete()}) on them, or when the
+ * garbage collector collects them.  The next request for an object of
+ * the same shape gets one of those back, reset to the state a newly
+ * made object is in, but keeping its buffer.
+ * </p><p>
+ * An object is not reused while someone else still holds its buffer
+ * (for example a picture still sharing a decoder's memory); its buffer
+ * is dropped instead.  Once more than {@link #getMaxFreeObjects()}
+ * objects are waiting to be reused, the ones returned longest ago are
+ * freed.
+ * </p><p>
+ * Objects keep the pool they came from alive until they are returned.
+ * A pool is safe to share between threads.
+ * </p>
+ * @since 5.5
+ */
+class VS_API_XUGGLER IMediaDataPool: public com::xuggle::ferry::RefCounted
+{
+public:
+  /**
+   * Create a new pool.
+   *
+   * @param maxFreeObjects The most returned objects to keep for reuse.
+   * @return a new pool, or null if maxFreeObjects < 0.
+   */
+  static IMediaDataPool* make(int32_t maxFreeObjects);
+
+  /**
+   * Get a packet with room for at least payloadSize bytes, as
+   * {@link IPacket#make(int)} would make.
+   *
+   * @param payloadSize The number of bytes of payload.
+   * @return the packet, or null on error.
+   */
+  virtual IPacket* getPacket(int32_t payloadSize)=0;
+
+  /**
+   * Get a picture, as {@link IVideoPicture#make(IPixelFormat.Type, int, int)}
+   * would make.
+   *
+   * @param format The pixel format.
+   * @param width The width in pixels.
+   * @param height The height in pixels.
+   * @return the picture, or null on error.
+   */
+  virtual IVideoPicture* getVideoPicture(IPixelFormat::Type format,
+      int32_t width, int32_t height)=0;
+
+  /**
+   * Get an audio samples object with room for at least numSamples
+   * samples, as {@link IAudioSamples#make(long, long, IAudioSamples.Format)}
+   * would make.
+   *
+   * @param numSamples The number of samples (per channel).
+   * @param channels The number of channels.
+   * @param format The sample format.
+   * @return the samples, or null on error.
+   */
+  virtual IAudioSamples* getAudioSamples(int32_t numSamples,
+      int32_t channels, IAudioSamples::Format format)=0;
+
+  /**
+   * Free every object waiting to be reused.  Objects handed out are
+   * not affected.
+   */
+  virtual void clear()=0;
+
+  /**
+   * Get the most returned objects the pool keeps for reuse.
+   *
+   * @return the maximum number of free objects.
+   */
+  virtual int32_t getMaxFreeObjects()=0;
+
+  /**
+   * Get the number of returned objects waiting to be reused.
+   *
+   * @return the number of free objects.
+   */
+  virtual int32_t getNumFreeObjects()=0;
+
+  /**
+   * Get the number of objects handed out and not yet returned.
+   *
+   * @return the number of outstanding objects.
+   */
+  virtual int32_t getNumOutstandingObjects()=0;
+
+  /**
+   * Get the number of requests satisfied by reusing an object.
+   *
+   * @return the number of hits.
+   */
+  virtual int64_t getHits()=0;
+
+  /**
+   * Get the number of requests that had to make a new object.
+   *
+   * @return the number of misses.
+   */
+  virtual int64_t getMisses()=0;
+
+  /**
+   * Get the number of returned objects freed because the pool was
+   * full.
+   *
+   * @return the number of evictions.
+   */
+  virtual int64_t getEvictions()=0;
+
+protected:
+  IMediaDataPool();
+  virtual ~IMediaDataPool();
+};
+
+}}}
+
+#endif /*IMEDIADATAPOOL_H_*/
@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef IPROPERTYHANDLE_H_
+#define IPROPERTYHANDLE_H_
+
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/ferry/RefCounted.h>
+#include <com/xuggle/xuggler/IProperty.h>
+#include <com/xuggle/xuggler/IRational.h>
+
+namespace com { namespace xuggle { namespace xuggler {
+
+  /**
+   * A property of one object, such as an {@link IStreamCoder} or
+   * {@link IContainer}, looked up once so it can be read and written
+   * many times cheaply.
+   * <p>
+   * Setting a property by name (for example with
+   * {@link IStreamCoder#setProperty(String, long)}) searches the object's
+   * option list, and the option lists of any objects it contains, every
+   * time.  A handle does that search when it is made and then reads or
+   * writes the value directly, which makes it the better choice for
+   * properties changed on every packet or frame, such as the bit rate
+   * of a live encoder.
+   * </p><p>
+   * A handle notices if the object it belongs to has since replaced the
+   * native object holding the property (for example when a codec is
+   * changed, or a container is closed and reopened) and looks the
+   * property up again.  If the property can no longer be found, the
+   * setters return an error and the getters return 0 or null.
+   * </p><p>
+   * A handle keeps the object it belongs to alive.  Like the object
+   * itself, it is not thread safe.
+   * </p>
+   * @since 5.5
+   */
+  class VS_API_XUGGLER IPropertyHandle : public com::xuggle::ferry::RefCounted
+  {
+  public:
+    /**
+     * Get the name this handle was made for.
+     *
+     * @return the name.
+     */
+    virtual const char *getName()=0;
+
+    /**
+     * Is there currently a property of this name on the object?
+     *
+     * @return true if the property can be read and written.
+     */
+    virtual bool isValid()=0;
+
+    /**
+     * Get the meta data for this property.
+     *
+     * @return the meta data, or null if {@link #isValid()} is false.
+     */
+    virtual IProperty *getPropertyMetaData()=0;
+
+    /**
+     * Set the property from a string, parsed the same way as
+     * {@link IStreamCoder#setProperty(String, String)}.
+     *
+     * @param value the new value.
+     *
+     * @return >= 0 on success; <0 on error.
+     */
+    virtual int32_t setValue(const char* value)=0;
+
+    /**
+     * Set the property to a double value.
+     *
+     * @param value the new value.
+     *
+     * @return >= 0 on success; <0 on error, including if value is
+     *   out of range for the property.
+     */
+    virtual int32_t setValue(double value)=0;
+
+    /**
+     * Set the property to a long value.
+     *
+     * @param value the new value.
+     *
+     * @return >= 0 on success; <0 on error, including if value is
+     *   out of range for the property.
+     */
+    virtual int32_t setValue(int64_t value)=0;
+
+    /**
+     * Set the property to a boolean value.
+     *
+     * @param value the new value.
+     *
+     * @return >= 0 on success; <0 on error.
+     */
+    virtual int32_t setValue(bool value)=0;
+
+    /**
+     * Set the property to a rational value.
+     *
+     * @param value the new value.
+     *
+     * @return >= 0 on success; <0 on error, including if value is
+     *   out of range for the property.
+     */
+    virtual int32_t setValue(IRational *value)=0;
+
+#ifdef SWIG
+    %newobject getValueAsString();
+    %typemap(newfree) char * "free($1);";
+#endif
+    /**
+     * Get the value of the property as a string.
+     *
+     * Note for C++ users: you must free() the returned string.
+     *
+     * @return the value, or null on error.
+     */
+    virtual char *getValueAsString()=0;
+
+    /**
+     * Get the value of the property as a double.
+     *
+     * @return the value, or 0 on error.
+     */
+    virtual double getValueAsDouble()=0;
+
+    /**
+     * Get the value of the property as a long.
+     *
+     * @return the value, or 0 on error.
+     */
+    virtual int64_t getValueAsLong()=0;
+
+    /**
+     * Get the value of the property as a rational.
+     *
+     * @return the value, or null on error.
+     */
+    virtual IRational *getValueAsRational()=0;
+
+    /**
+     * Get the value of the property as a boolean.
+     *
+     * @return the value, or false on error.
+     */
+    virtual bool getValueAsBoolean()=0;
+
+  protected:
+    IPropertyHandle();
+    virtual ~IPropertyHandle();
+  };
+
+}}}
+#endif /* IPROPERTYHANDLE_H_ */
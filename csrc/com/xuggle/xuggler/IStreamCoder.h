@@ -29,6 +29,7 @@
 #include <com/xuggle/xuggler/IVideoPicture.h>
 #include <com/xuggle/xuggler/IPacket.h>
 #include <com/xuggle/xuggler/IProperty.h>
+#include <com/xuggle/xuggler/IPropertyHandle.h>
 #include <com/xuggle/xuggler/IMetaData.h>
 
 namespace com { namespace xuggle { namespace xuggler
@@ -498,6 +499,12 @@ namespace com { namespace xuggle { namespace xuggler
      * overwrite any data in the frame object, but
      * you should pass the same IVideoPicture into this function
      * repeatedly until IVideoPicture::isComplete() is true.
+     * <p>
+     * Some decoders (and all decoders using frame threading) hold on
+     * to pictures for a few packets.  To get those pictures out at the
+     * end of a stream, pass an empty packet repeatedly until
+     * IVideoPicture::isComplete() returns false.
+     * </p>
      *
      * @param pOutFrame The AudioSamples we decode.
      * @param packet    The packet we're attempting to decode from.
@@ -1060,6 +1067,174 @@ namespace com { namespace xuggle { namespace xuggler
      * {@inheritDoc}
      */
     virtual int32_t setProperty(IMetaData* valuesToSet, IMetaData* valuesNotFound)=0;
+
+    /*
+     * Added for 5.5
+     */
+
+    /**
+     * The different ways a codec may use multiple threads.
+     * These can be or-ed together.
+     *
+     * @since 5.5
+     */
+    typedef enum {
+      /**
+       * Do not use any threading, even if a thread count is set.
+       */
+      THREAD_TYPE_NONE=0,
+      /**
+       * Decode more than one frame at once.  This adds one frame
+       * of delay per thread when decoding, so callers must
+       * flush the decoder at the end of a stream by passing
+       * empty packets to {@link #decodeVideo} until no more
+       * pictures are completed.
+       */
+      THREAD_TYPE_FRAME=1,
+      /**
+       * Decode more than one part of a single frame at once.
+       */
+      THREAD_TYPE_SLICE=2,
+      /**
+       * Use frame threading if the codec supports it, and
+       * slice threading otherwise.  This is the default.
+       */
+      THREAD_TYPE_FRAME_AND_SLICE=3,
+    } ThreadType;
+
+    /**
+     * Set the number of threads this coder may use.
+     * <p>
+     * Must be called before {@link #open}.  The codec decides which
+     * of the allowed {@link ThreadType}s it can actually use;
+     * see {@link #getActiveThreadType()}.
+     * </p>
+     *
+     * @param numThreads The number of threads to use. 0 means have
+     *   the codec pick a sensible number based on the number of CPUs
+     *   on this machine, and 1 means do not use additional threads.
+     * @return 0 on success; <0 if the coder is already open or
+     *   numThreads < 0.
+     *
+     * @since 5.5
+     */
+    virtual int32_t setNumThreads(int32_t numThreads)=0;
+
+    /**
+     * Get the number of threads this coder will use.
+     *
+     * @return the number of threads.  0 means the codec will pick.
+     *
+     * @since 5.5
+     */
+    virtual int32_t getNumThreads()=0;
+
+    /**
+     * Set which kinds of threading this coder may use.
+     * Must be called before {@link #open}.
+     *
+     * @param type The threading types allowed.
+     * @return 0 on success; <0 if the coder is already open.
+     *
+     * @since 5.5
+     */
+    virtual int32_t setThreadType(ThreadType type)=0;
+
+    /**
+     * Get which kinds of threading this coder may use.
+     *
+     * @return The threading types allowed.
+     *
+     * @since 5.5
+     */
+    virtual ThreadType getThreadType()=0;
+
+    /**
+     * Get which kind of threading the codec actually chose
+     * when it was opened.
+     *
+     * @return The threading type in use, or {@link #THREAD_TYPE_NONE}
+     *   if not open or not using threads.
+     *
+     * @since 5.5
+     */
+    virtual ThreadType getActiveThreadType()=0;
+
+    /**
+     * Set whether this coder decodes only keyframes.
+     * <p>
+     * When true, {@link #decodeVideo} drops packets that are not
+     * keyframes without passing them to the decoder, returning their
+     * size with no picture completed, and the decoder is told to skip
+     * non-keyframes (AVCodecContext.skip_frame and skip_idct) and to
+     * skip the loop filter on every frame (skip_loop_filter).  Skipping
+     * the loop filter can leave some blocking, which is rarely visible
+     * once a picture is scaled down to a thumbnail.  When false, the skip
+     * settings go back to what they were before.
+     * </p><p>
+     * May be changed while the coder is open; seek to a keyframe after
+     * turning it off, as the pictures decoded until then are missing
+     * their references.  Defaults to false.
+     * </p>
+     *
+     * @param value true to decode only keyframes.
+     * @since 5.5
+     */
+    virtual void setDecodeKeyFramesOnly(bool value)=0;
+
+    /**
+     * Get whether this coder decodes only keyframes.
+     *
+     * @see #setDecodeKeyFramesOnly(boolean)
+     * @return true if only keyframes are decoded.
+     * @since 5.5
+     */
+    virtual bool getDecodeKeyFramesOnly()=0;
+
+    /**
+     * Decodes the keyframe at or before a time stamp, reading it from
+     * the {@link IContainer} this coder's {@link IStream} belongs to.
+     * <p>
+     * This is meant for taking thumbnails: call it once per time stamp
+     * wanted to get one picture each.  It seeks the container to the
+     * keyframe, asks the demuxer to drop every other stream and, where
+     * it can, this stream's non-keyframes, and decodes just the one
+     * keyframe as {@link #setDecodeKeyFramesOnly(boolean)} would.  The
+     * container's stream settings and this coder's keyframe setting are
+     * put back before it returns.  Seeking is far faster if the
+     * container has a keyframe index; see
+     * {@link IContainer#buildKeyFrameIndex()}.
+     * </p><p>
+     * Afterwards the container is positioned somewhere after the
+     * keyframe, so seek before going back to reading it in order.
+     * </p>
+     *
+     * @param pOutFrame The picture to decode into.
+     * @param timeStamp The time stamp wanted, in the time base of this
+     *   coder's stream.
+     * @return >= 0 if a picture was decoded into pOutFrame, or <0 if
+     *   this coder does not decode video from a container being read,
+     *   the seek failed, or no keyframe could be decoded.
+     * @since 5.5
+     */
+    virtual int32_t decodeVideoKeyFrame(IVideoPicture* pOutFrame,
+        int64_t timeStamp)=0;
+
+    /**
+     * Looks up a property on this coder once, and returns a handle that
+     * can get and set it without searching for it again.  Use it for
+     * properties changed often, such as the bit rate of a live encoder.
+     * <p>
+     * The handle follows this coder's context even if it is replaced,
+     * for example by {@link #setCodec(ICodec)}.
+     * </p>
+     *
+     * @param name The property name, as for {@link #setProperty(String, String)}.
+     *
+     * @return a handle, or null if there is no property of that name.
+     * @since 5.5
+     */
+    virtual IPropertyHandle* getPropertyHandle(const char* name)=0;
   };
 
 }}}
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef ITRANSCODER_H_
+#define ITRANSCODER_H_
+
+#include <com/xuggle/ferry/RefCounted.h>
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/xuggler/IContainer.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+/**
+ * Transcodes streams from one {@link IContainer} to another, in
+ * native code, using several threads.
+ * <p>
+ * The work is split into stages: one stage demultiplexes packets from
+ * the input container; for every mapped stream a decode stage, a
+ * convert stage (which rescales pictures or resamples audio when the
+ * input and output coders disagree) and an encode stage; and one stage
+ * multiplexes packets into the output container.  Stages hand work to
+ * each other through bounded queues, and a pool of threads runs
+ * whichever stages have work, so decoding one stream overlaps with
+ * encoding another and with reading and writing.
+ * </p>
+ * <p>
+ * To use, open the input container for reading and the output
+ * container for writing, add streams to the output container and set up
+ * their {@link IStreamCoder}s as you would to encode by hand, then map
+ * input streams to output streams with {@link #mapStream(int, int)} and
+ * call {@link #run()}.  Output coder settings you leave unset (width,
+ * height, pixel type, sample rate, channels) are copied from the input.
+ * Coders that are not already open are opened, and closed again when we
+ * are done.
+ * </p>
+ * <p>
+ * While (or after) {@link #run()} runs, the per-stage statistics tell
+ * you where the time goes.
+ * </p>
+ * @since 5.5
+ */
+class VS_API_XUGGLER ITranscoder: public com::xuggle::ferry::RefCounted
+{
+public:
+  /**
+   * Create a new {@link ITranscoder}.
+   *
+   * @param input The container to read from.  It must be opened for
+   *   reading.
+   * @param output The container to write to.  It must be opened for
+   *   writing, and must not have had its header written yet.
+   * @return a new transcoder, or null on error.
+   */
+  static ITranscoder* make(IContainer* input, IContainer* output);
+
+  /**
+   * Transcode the stream at inputStreamIndex in the input container into
+   * the stream at outputStreamIndex in the output container.  Streams
+   * that are not mapped are dropped.
+   *
+   * @param inputStreamIndex The index of an audio or video stream in
+   *   the input container.
+   * @param outputStreamIndex The index of a stream of the same type in
+   *   the output container.
+   * @return >= 0 on success; < 0 on error.
+   */
+  virtual int32_t mapStream(int32_t inputStreamIndex,
+      int32_t outputStreamIndex)=0;
+
+  /**
+   * Set the number of threads {@link #run()} uses.
+   *
+   * @param numThreads The number of threads, or 0 to use one thread
+   *   per stage.
+   * @return >= 0 on success; < 0 on error.
+   */
+  virtual int32_t setNumThreads(int32_t numThreads)=0;
+
+  /**
+   * Get the number of threads {@link #run()} uses.
+   *
+   * @return The number of threads, or 0 for one per stage.
+   */
+  virtual int32_t getNumThreads()=0;
+
+  /**
+   * Set how many items may wait in front of a stage before the stage
+   * feeding it stops.
+   *
+   * @param capacity The capacity of each queue; must be > 0.
+   * @return >= 0 on success; < 0 on error.
+   */
+  virtual int32_t setQueueCapacity(int32_t capacity)=0;
+
+  /**
+   * Get how many items may wait in front of a stage.
+   *
+   * @return The capacity of each queue.
+   */
+  virtual int32_t getQueueCapacity()=0;
+
+  /**
+   * Transcode everything, writing the output header and trailer.
+   * Blocks until the input is exhausted or a stage fails.
+   *
+   * @return >= 0 on success; < 0 on error.
+   */
+  virtual int32_t run()=0;
+
+  /**
+   * Get the number of stages.  This is only known once {@link #run()}
+   * has started; before then it is 0.
+   *
+   * @return The number of stages.
+   */
+  virtual int32_t getNumStages()=0;
+
+  /**
+   * Get a name for a stage, such as "demux", "decode:0" or "mux".  The
+   * number is the input stream index the stage works on.
+   *
+   * @param stage The stage, from 0 to {@link #getNumStages()}-1.
+   * @return The name, or null if stage is out of range.
+   */
+  virtual const char* getStageName(int32_t stage)=0;
+
+  /**
+   * Get the number of items a stage has taken off its queue.  For
+   * demux stages this is the number of packets read.
+   *
+   * @param stage The stage, from 0 to {@link #getNumStages()}-1.
+   * @return The number of items, or < 0 if stage is out of range.
+   */
+  virtual int64_t getStageNumItems(int32_t stage)=0;
+
+  /**
+   * Get the time a stage has spent working, in microseconds.  Items
+   * divided by busy time is the throughput of the stage.
+   *
+   * @param stage The stage, from 0 to {@link #getNumStages()}-1.
+   * @return The busy time, or < 0 if stage is out of range.
+   */
+  virtual int64_t getStageBusyTime(int32_t stage)=0;
+
+  /**
+   * Get the number of items waiting in front of a stage right now.
+   *
+   * @param stage The stage, from 0 to {@link #getNumStages()}-1.
+   * @return The queue depth, or < 0 if stage is out of range.
+   */
+  virtual int32_t getStageQueueDepth(int32_t stage)=0;
+
+  /**
+   * Get the largest number of items that have waited in front of a
+   * stage.  A stage whose queue is often full is slower than the stages
+   * in front of it.
+   *
+   * @param stage The stage, from 0 to {@link #getNumStages()}-1.
+   * @return The maximum queue depth, or < 0 if stage is out of range.
+   */
+  virtual int32_t getStageMaxQueueDepth(int32_t stage)=0;
+
+protected:
+  ITranscoder();
+  virtual ~ITranscoder();
+};
+
+}}}
+#endif /* ITRANSCODER_H_ */
@@ -21,6 +21,9 @@
 #include <com/xuggle/xuggler/Global.h>
 #include <com/xuggle/xuggler/VideoResampler.h>
 #include <com/xuggle/xuggler/config.h>
+#ifdef VS_ENABLE_GPL
+#include <com/xuggle/xuggler/ScalerContextCache.h>
+#endif
 
 namespace com { namespace xuggle { namespace xuggler
   {
@@ -66,4 +69,81 @@ namespace com { namespace xuggle { namespace xuggler
     return false;
 #endif
   }
+
+  int32_t
+  IVideoResampler :: setContextCacheSize(int32_t maxIdle)
+  {
+#ifdef VS_ENABLE_GPL
+    return ScalerContextCache::setMaxIdle(maxIdle);
+#else
+    (void) maxIdle;
+    return -1;
+#endif
+  }
+
+  int32_t
+  IVideoResampler :: getContextCacheSize()
+  {
+#ifdef VS_ENABLE_GPL
+    return ScalerContextCache::getMaxIdle();
+#else
+    return 0;
+#endif
+  }
+
+  int32_t
+  IVideoResampler :: getNumCachedContexts()
+  {
+#ifdef VS_ENABLE_GPL
+    return ScalerContextCache::getNumIdle();
+#else
+    return 0;
+#endif
+  }
+
+  int64_t
+  IVideoResampler :: getContextCacheHits()
+  {
+#ifdef VS_ENABLE_GPL
+    return ScalerContextCache::getHits();
+#else
+    return 0;
+#endif
+  }
+
+  int64_t
+  IVideoResampler :: getContextCacheMisses()
+  {
+#ifdef VS_ENABLE_GPL
+    return ScalerContextCache::getMisses();
+#else
+    return 0;
+#endif
+  }
+
+  int64_t
+  IVideoResampler :: getContextCacheEvictions()
+  {
+#ifdef VS_ENABLE_GPL
+    return ScalerContextCache::getEvictions();
+#else
+    return 0;
+#endif
+  }
+
+  void
+  IVideoResampler :: resetContextCacheStatistics()
+  {
+#ifdef VS_ENABLE_GPL
+    ScalerContextCache::resetStatistics();
+#endif
+  }
+
+  void
+  IVideoResampler :: clearContextCache()
+  {
+#ifdef VS_ENABLE_GPL
+    ScalerContextCache::clear();
+#endif
+  }
   }}}
@@ -261,6 +261,75 @@ namespace com { namespace xuggle { namespace xuggler
      * {@inheritDoc}
      */
     virtual int32_t setProperty(IMetaData* valuesToSet, IMetaData* valuesNotFound)=0;
+
+    /*
+     * Added for 5.5
+     */
+
+    /**
+     * Set how many idle scaler contexts to keep for reuse.
+     * <p>
+     * Setting up a resampler's scaler is much more expensive than
+     * resampling a picture with it, so when a resampler is deleted its
+     * scaler is kept, and a later {@link #make} call with the same sizes
+     * and pixel formats reuses it.  The cache is shared by the whole
+     * process; past this size the least recently used scalers are
+     * freed.  Resamplers that had properties set never return their
+     * scalers to the cache.
+     * </p>
+     * @param maxIdle the most scalers to keep; 0 turns off caching.
+     *   The default is 16.
+     * @return >= 0 on success; < 0 if maxIdle is negative or this build
+     *   has no resampler.
+     * @since 5.5
+     */
+    static int32_t setContextCacheSize(int32_t maxIdle);
+
+    /**
+     * @return the most idle scaler contexts that will be kept for reuse.
+     * @since 5.5
+     */
+    static int32_t getContextCacheSize();
+
+    /**
+     * @return the number of idle scaler contexts now cached.
+     * @since 5.5
+     */
+    static int32_t getNumCachedContexts();
+
+    /**
+     * @return the number of {@link #make} calls that reused a cached
+     *   scaler context.
+     * @since 5.5
+     */
+    static int64_t getContextCacheHits();
+
+    /**
+     * @return the number of {@link #make} calls that had to set up a
+     *   new scaler context.
+     * @since 5.5
+     */
+    static int64_t getContextCacheMisses();
+
+    /**
+     * @return the number of cached scaler contexts freed to make room
+     *   for more recently used ones.
+     * @since 5.5
+     */
+    static int64_t getContextCacheEvictions();
+
+    /**
+     * Set the context cache hit, miss and eviction counts to zero.
+     * @since 5.5
+     */
+    static void resetContextCacheStatistics();
+
+    /**
+     * Free all cached scaler contexts.
+     * @since 5.5
+     */
+    static void clearContextCache();
+
   protected:
     IVideoResampler();
     virtual ~IVideoResampler();
@@ -0,0 +1,328 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/xuggler/KeyFrameIndex.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  static const uint32_t KeyFrameIndex_MAGIC = MKTAG('X', 'K', 'F', 'I');
+  static const int32_t KeyFrameIndex_VERSION = 1;
+  // pts, dts and pos, then size and flags
+  static const int32_t KeyFrameIndex_ENTRY_SIZE = 3*8 + 2*4;
+  // far more keyframes than any real stream has; bounds what we allocate
+  // when we can't check a count against the size of the index
+  static const int32_t KeyFrameIndex_MAX_ENTRIES = 1 << 24;
+
+  static bool
+  KeyFrameIndex_before(const KeyFrameIndex::Entry& a,
+      const KeyFrameIndex::Entry& b)
+  {
+    return KeyFrameIndex::getTimeStamp(a) < KeyFrameIndex::getTimeStamp(b);
+  }
+
+  static bool
+  KeyFrameIndex_beforeTimeStamp(const KeyFrameIndex::Entry& a,
+      int64_t timeStamp)
+  {
+    return KeyFrameIndex::getTimeStamp(a) < timeStamp;
+  }
+
+  static bool
+  KeyFrameIndex_afterTimeStamp(int64_t timeStamp,
+      const KeyFrameIndex::Entry& a)
+  {
+    return timeStamp < KeyFrameIndex::getTimeStamp(a);
+  }
+
+  KeyFrameIndex :: KeyFrameIndex()
+  {
+  }
+
+  KeyFrameIndex :: ~KeyFrameIndex()
+  {
+  }
+
+  void
+  KeyFrameIndex :: reset(AVFormatContext* context)
+  {
+    for(size_t i = 0; i < mStreams.size(); i++)
+      mStreams[i].entries.clear();
+    addStreams(context);
+  }
+
+  void
+  KeyFrameIndex :: addStreams(AVFormatContext* context)
+  {
+    if (!context)
+      return;
+
+    AVInputFormat* format = context->iformat;
+    bool canSeekBytes = format && !(format->flags & AVFMT_NO_BYTE_SEEK);
+    for(uint32_t i = mStreams.size(); i < context->nb_streams; i++)
+    {
+      AVStream* stream = context->streams[i];
+      StreamIndex index;
+      index.type = stream->codec ? stream->codec->codec_type :
+          AVMEDIA_TYPE_UNKNOWN;
+      index.timeBase = stream->time_base;
+      // Formats using the generic index seek through it anyway; for the
+      // rest, a demuxer that already has entries read them from the file
+      // and knows better than we do how to get to them.
+      index.seekByPosition = canSeekBytes &&
+          ((format->flags & AVFMT_GENERIC_INDEX) ||
+              stream->nb_index_entries == 0);
+      mStreams.push_back(index);
+    }
+  }
+
+  bool
+  KeyFrameIndex :: add(const AVPacket* packet)
+  {
+    if (!packet || !(packet->flags & AV_PKT_FLAG_KEY) || packet->pos < 0)
+      return false;
+    if (packet->stream_index < 0 ||
+        (size_t)packet->stream_index >= mStreams.size())
+      return false;
+
+    Entry entry;
+    entry.pts = packet->pts;
+    entry.dts = packet->dts;
+    entry.pos = packet->pos;
+    entry.size = packet->size;
+    entry.flags = packet->flags;
+    int64_t timeStamp = getTimeStamp(entry);
+    if (timeStamp == Global::NO_PTS)
+      return false;
+
+    StreamIndex& index = mStreams[packet->stream_index];
+    if (index.type != AVMEDIA_TYPE_VIDEO && !index.entries.empty() &&
+        index.timeBase.num > 0)
+    {
+      int64_t last = getTimeStamp(index.entries.back());
+      int64_t second = index.timeBase.den / index.timeBase.num;
+      if (timeStamp >= last && timeStamp - last < second)
+        return false;
+    }
+    index.entries.push_back(entry);
+    return true;
+  }
+
+  void
+  KeyFrameIndex :: sort()
+  {
+    for(size_t i = 0; i < mStreams.size(); i++)
+      std::stable_sort(mStreams[i].entries.begin(), mStreams[i].entries.end(),
+          KeyFrameIndex_before);
+  }
+
+  int32_t
+  KeyFrameIndex :: getNumStreams()
+  {
+    return mStreams.size();
+  }
+
+  int32_t
+  KeyFrameIndex :: getNumEntries(int32_t streamIndex)
+  {
+    if (streamIndex < 0 || (size_t)streamIndex >= mStreams.size())
+      return 0;
+    return mStreams[streamIndex].entries.size();
+  }
+
+  const KeyFrameIndex::Entry*
+  KeyFrameIndex :: getEntry(int32_t streamIndex, int32_t entryIndex)
+  {
+    if (entryIndex < 0 || entryIndex >= getNumEntries(streamIndex))
+      return 0;
+    return &mStreams[streamIndex].entries[entryIndex];
+  }
+
+  bool
+  KeyFrameIndex :: canSeekByPosition(int32_t streamIndex)
+  {
+    if (streamIndex < 0 || (size_t)streamIndex >= mStreams.size())
+      return false;
+    return mStreams[streamIndex].seekByPosition;
+  }
+
+  int64_t
+  KeyFrameIndex :: getFirstPosition()
+  {
+    int64_t retval = -1;
+    for(size_t i = 0; i < mStreams.size(); i++)
+    {
+      const StreamIndex& index = mStreams[i];
+      if (!index.seekByPosition)
+        continue;
+      for(size_t j = 0; j < index.entries.size(); j++)
+        if (retval < 0 || index.entries[j].pos < retval)
+          retval = index.entries[j].pos;
+    }
+    return retval;
+  }
+
+  const KeyFrameIndex::Entry*
+  KeyFrameIndex :: find(int32_t streamIndex, int64_t minTimeStamp,
+      int64_t targetTimeStamp, int64_t maxTimeStamp)
+  {
+    if (!canSeekByPosition(streamIndex))
+      return 0;
+    const std::vector<Entry>& entries = mStreams[streamIndex].entries;
+
+    // the first entry after the target; the one before it, if any, is
+    // the last at or before the target.
+    std::vector<Entry>::const_iterator after = std::upper_bound(
+        entries.begin(), entries.end(), targetTimeStamp,
+        KeyFrameIndex_afterTimeStamp);
+    if (after != entries.begin())
+    {
+      std::vector<Entry>::const_iterator before = after - 1;
+      if (getTimeStamp(*before) >= minTimeStamp)
+        return &(*before);
+    }
+    std::vector<Entry>::const_iterator atOrAfter = std::lower_bound(
+        entries.begin(), entries.end(), targetTimeStamp,
+        KeyFrameIndex_beforeTimeStamp);
+    if (atOrAfter != entries.end() && getTimeStamp(*atOrAfter) <= maxTimeStamp)
+      return &(*atOrAfter);
+    return 0;
+  }
+
+  int32_t
+  KeyFrameIndex :: write(AVIOContext* pb, int64_t fileSize)
+  {
+    if (!pb)
+      return -1;
+
+    int32_t retval = 0;
+    avio_wl32(pb, KeyFrameIndex_MAGIC);
+    avio_wl32(pb, KeyFrameIndex_VERSION);
+    avio_wl64(pb, fileSize);
+    avio_wl32(pb, mStreams.size());
+    for(size_t i = 0; i < mStreams.size(); i++)
+    {
+      const StreamIndex& index = mStreams[i];
+      avio_wl32(pb, index.type);
+      avio_wl32(pb, index.timeBase.num);
+      avio_wl32(pb, index.timeBase.den);
+      avio_wl32(pb, index.entries.size());
+      for(size_t j = 0; j < index.entries.size(); j++)
+      {
+        const Entry& entry = index.entries[j];
+        avio_wl64(pb, entry.pts);
+        avio_wl64(pb, entry.dts);
+        avio_wl64(pb, entry.pos);
+        avio_wl32(pb, entry.size);
+        avio_wl32(pb, entry.flags);
+      }
+      retval += index.entries.size();
+    }
+    avio_flush(pb);
+    if (pb->error < 0)
+      retval = pb->error;
+    return retval;
+  }
+
+  int32_t
+  KeyFrameIndex :: read(AVIOContext* pb, AVFormatContext* context,
+      int64_t fileSize)
+  {
+    reset(context);
+    if (!pb || !context)
+      return -1;
+
+    int32_t retval = -1;
+    int32_t numEntries = 0;
+    try
+    {
+      if (avio_rl32(pb) != KeyFrameIndex_MAGIC)
+        throw std::invalid_argument("not a keyframe index");
+      int32_t version = avio_rl32(pb);
+      if (version != KeyFrameIndex_VERSION)
+        throw std::invalid_argument("unsupported keyframe index version");
+      int64_t indexedSize = avio_rl64(pb);
+      if (indexedSize >= 0 && fileSize >= 0 && indexedSize != fileSize)
+        throw std::invalid_argument("keyframe index is for a different file");
+      uint32_t numStreams = avio_rl32(pb);
+      if (numStreams != mStreams.size())
+        throw std::invalid_argument("keyframe index has the wrong number of streams");
+
+      int64_t indexSize = avio_size(pb);
+      for(uint32_t i = 0; i < numStreams; i++)
+      {
+        StreamIndex& index = mStreams[i];
+        int32_t type = avio_rl32(pb);
+        AVRational timeBase;
+        timeBase.num = avio_rl32(pb);
+        timeBase.den = avio_rl32(pb);
+        int32_t count = avio_rl32(pb);
+        if (type != index.type || av_cmp_q(timeBase, index.timeBase) != 0)
+          throw std::invalid_argument("keyframe index streams do not match");
+        if (count < 0 || (indexSize >= 0 &&
+            count > (indexSize - avio_tell(pb)) / KeyFrameIndex_ENTRY_SIZE))
+          throw std::invalid_argument("keyframe index is truncated");
+        if (count > KeyFrameIndex_MAX_ENTRIES)
+          throw std::invalid_argument("keyframe index is too large");
+
+        // if we don't know how big the index is, only grow as entries
+        // actually arrive so a bad count can't allocate up front
+        if (indexSize >= 0)
+          index.entries.reserve(count);
+        for(int32_t j = 0; j < count; j++)
+        {
+          Entry entry;
+          entry.pts = avio_rl64(pb);
+          entry.dts = avio_rl64(pb);
+          entry.pos = avio_rl64(pb);
+          entry.size = avio_rl32(pb);
+          entry.flags = avio_rl32(pb);
+          if (url_feof(pb) || pb->error < 0)
+            throw std::invalid_argument("keyframe index is truncated");
+          index.entries.push_back(entry);
+        }
+        numEntries += count;
+      }
+      // they were written sorted, so this is just a check
+      sort();
+      retval = numEntries;
+    }
+    catch (std::invalid_argument & e)
+    {
+      VS_LOG_WARN("Could not read keyframe index: %s", e.what());
+      reset(context);
+      retval = -1;
+    }
+    catch (std::bad_alloc & e)
+    {
+      VS_LOG_WARN("Could not read keyframe index: out of memory");
+      reset(context);
+      retval = -1;
+    }
+    return retval;
+  }
+
+}}}
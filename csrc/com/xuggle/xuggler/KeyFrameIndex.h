@@ -0,0 +1,162 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef KEYFRAMEINDEX_H_
+#define KEYFRAMEINDEX_H_
+
+#include <inttypes.h>
+#include <vector>
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/FfmpegIncludes.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * The keyframes of each stream in an input {@link Container}, sorted by
+   * time stamp, as built by Container::buildKeyFrameIndex() or loaded
+   * from a sidecar file by Container::readKeyFrameIndex().
+   * </p><p>
+   * Demuxers for MPEG-TS, MPEG-PS and raw streams keep little or no index
+   * of their own, so FFmpeg seeks in them by bisecting the file or reading
+   * forward from the start.  With this index the Container can look the
+   * nearest keyframe up with a binary search and seek straight to its
+   * byte position instead.  Streams whose demuxer loaded a full index from
+   * the file header (MP4, Matroska, AVI...) are indexed too, but seeks in
+   * them are left to the demuxer; see #canSeekByPosition.
+   * </p><p>
+   * Video streams keep every keyframe.  In other streams nearly every
+   * packet is a keyframe, so those keep at most one a second.
+   * </p><p>
+   * The sidecar is little endian: a header of "XKFI", the format version,
+   * the size of the indexed file and the number of streams, then for each
+   * stream its media type, time base and number of entries, followed by
+   * that many pts, dts, byte position, size and flags records.
+   * </p>
+   */
+  class KeyFrameIndex
+  {
+  public:
+    struct Entry
+    {
+      int64_t pts;
+      int64_t dts;
+      int64_t pos;
+      int32_t size;
+      int32_t flags;
+    };
+
+    KeyFrameIndex();
+    ~KeyFrameIndex();
+
+    /**
+     * Drop every entry, and start indexing the streams in context.
+     */
+    void reset(AVFormatContext* context);
+
+    /**
+     * Start indexing any streams in context not already known.  Whether
+     * a stream can be seeked by position is decided the first time it is
+     * seen, so this must happen before the index is handed to the
+     * demuxer.
+     */
+    void addStreams(AVFormatContext* context);
+
+    /**
+     * Index packet if it is a keyframe with a known position and time
+     * stamp.
+     * @return true if an entry was added.
+     */
+    bool add(const AVPacket* packet);
+
+    /**
+     * Sort every stream's entries by time stamp.
+     */
+    void sort();
+
+    int32_t getNumStreams();
+    int32_t getNumEntries(int32_t streamIndex);
+    const Entry* getEntry(int32_t streamIndex, int32_t entryIndex);
+
+    /**
+     * @return true if seeking to an entry's byte position is the way to
+     *   seek in this stream.
+     */
+    bool canSeekByPosition(int32_t streamIndex);
+
+    /**
+     * @return the smallest byte position of any stream that can be seeked
+     *   by position, or -1 if there is none.
+     */
+    int64_t getFirstPosition();
+
+    /**
+     * Find the keyframe to seek to for targetTimeStamp: the last one at
+     * or before it if that is no earlier than minTimeStamp, otherwise the
+     * first one after it if that is no later than maxTimeStamp.
+     *
+     * @return the entry, or null if there is none in range or the stream
+     *   can't be seeked by position.
+     */
+    const Entry* find(int32_t streamIndex, int64_t minTimeStamp,
+        int64_t targetTimeStamp, int64_t maxTimeStamp);
+
+    /**
+     * Write the index to pb.
+     * @param fileSize the size of the indexed file, or -1 if unknown.
+     * @return the number of entries written, or <0 on error.
+     */
+    int32_t write(AVIOContext* pb, int64_t fileSize);
+
+    /**
+     * Replace the index with one read from pb, after checking it was
+     * written for a file of this size with these streams.
+     * @param fileSize the size of the indexed file, or -1 if unknown.
+     * @return the number of entries read, or <0 on error, in which case
+     *   the index is left empty.
+     */
+    int32_t read(AVIOContext* pb, AVFormatContext* context, int64_t fileSize);
+
+    /**
+     * @return the time stamp an entry is sorted and searched by: its
+     *   pts, since that is what callers seek to, or its dts if it has
+     *   no pts.
+     */
+    static int64_t getTimeStamp(const Entry& entry)
+    {
+      return entry.pts != Global::NO_PTS ? entry.pts : entry.dts;
+    }
+
+  private:
+    struct StreamIndex
+    {
+      int32_t type;
+      AVRational timeBase;
+      bool seekByPosition;
+      std::vector<Entry> entries;
+    };
+    std::vector<StreamIndex> mStreams;
+  };
+
+}}}
+
+#endif /*KEYFRAMEINDEX_H_*/
@@ -0,0 +1,349 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <stdexcept>
+
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/ferry/RefPointer.h>
+#include <com/xuggle/xuggler/MediaDataPool.h>
+#include <com/xuggle/xuggler/Packet.h>
+#include <com/xuggle/xuggler/VideoPicture.h>
+#include <com/xuggle/xuggler/AudioSamples.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace com { namespace xuggle { namespace xuggler
+{
+using namespace com::xuggle::ferry;
+
+MediaDataPool :: MediaDataPool()
+{
+  mMaxFreeObjects = 0;
+  mNumFree = 0;
+  mNumOutstanding = 0;
+  mHits = 0;
+  mMisses = 0;
+  mEvictions = 0;
+}
+
+MediaDataPool :: ~MediaDataPool()
+{
+  clear();
+}
+
+MediaDataPool*
+MediaDataPool :: make(int32_t maxFreeObjects)
+{
+  if (maxFreeObjects < 0)
+    return 0;
+  MediaDataPool* retval = make();
+  if (retval)
+    retval->mMaxFreeObjects = maxFreeObjects;
+  return retval;
+}
+
+bool
+MediaDataPool :: recycle(IMediaData* data, Shape* shape)
+{
+  shape->format = 0;
+  shape->width = 0;
+  shape->height = 0;
+  shape->channels = 0;
+  shape->capacity = 0;
+
+  Packet* packet = dynamic_cast<Packet*>(data);
+  if (packet)
+  {
+    if (!packet->recycle())
+      return false;
+    shape->type = PACKET;
+    shape->capacity = packet->getMaxSize() > 0 ? packet->getMaxSize() : 0;
+    return true;
+  }
+  VideoPicture* picture = dynamic_cast<VideoPicture*>(data);
+  if (picture)
+  {
+    if (!picture->recycle())
+      return false;
+    shape->type = VIDEO_PICTURE;
+    shape->format = picture->getPixelType();
+    shape->width = picture->getWidth();
+    shape->height = picture->getHeight();
+    return true;
+  }
+  AudioSamples* samples = dynamic_cast<AudioSamples*>(data);
+  if (samples)
+  {
+    if (!samples->recycle())
+      return false;
+    shape->type = AUDIO_SAMPLES;
+    shape->format = samples->getFormat();
+    shape->channels = samples->getChannels();
+    shape->capacity = samples->getMaxSamples();
+    return true;
+  }
+  return false;
+}
+
+void
+MediaDataPool :: freeObject(IMediaData* data)
+{
+  // Free objects have a reference count of zero and no pool, so taking
+  // and dropping a reference runs their normal destroy().
+  data->acquire();
+  data->release();
+}
+
+IMediaData*
+MediaDataPool :: take(const Shape& shape)
+{
+  IMediaData* retval = 0;
+  mLock.lock();
+  for(std::list<Entry>::iterator it = mFree.begin(); it != mFree.end(); ++it)
+  {
+    const Shape& free = it->shape;
+    // a packet that lost its buffer can still be reused; it'll get a
+    // new buffer of the right size
+    if (free.type == shape.type &&
+        free.format == shape.format &&
+        free.width == shape.width &&
+        free.height == shape.height &&
+        free.channels == shape.channels &&
+        (free.capacity >= shape.capacity ||
+            (free.type == PACKET && free.capacity == 0)))
+    {
+      retval = it->data;
+      mFree.erase(it);
+      --mNumFree;
+      break;
+    }
+  }
+  if (retval)
+    ++mHits;
+  else
+    ++mMisses;
+  mLock.unlock();
+  return retval;
+}
+
+void
+MediaDataPool :: handOut()
+{
+  mLock.lock();
+  ++mNumOutstanding;
+  mLock.unlock();
+}
+
+bool
+MediaDataPool :: reclaim(IMediaData* data)
+{
+  Shape shape;
+  bool keep = false;
+  try
+  {
+    keep = mMaxFreeObjects > 0 && recycle(data, &shape);
+  }
+  catch (std::exception & e)
+  {
+    VS_LOG_DEBUG("Error: %s", e.what());
+    keep = false;
+  }
+
+  IMediaData* evicted = 0;
+  mLock.lock();
+  --mNumOutstanding;
+  if (keep)
+  {
+    Entry entry;
+    entry.shape = shape;
+    entry.data = data;
+    mFree.push_front(entry);
+    if (++mNumFree > mMaxFreeObjects)
+    {
+      evicted = mFree.back().data;
+      mFree.pop_back();
+      --mNumFree;
+      ++mEvictions;
+    }
+  }
+  mLock.unlock();
+
+  if (evicted)
+    freeObject(evicted);
+  // drop the reference data held on us; this may delete the pool, and
+  // data along with it, so touch nothing after.
+  release();
+  return keep;
+}
+
+IPacket*
+MediaDataPool :: getPacket(int32_t payloadSize)
+{
+  if (payloadSize < 0)
+    return 0;
+  Shape shape;
+  shape.type = PACKET;
+  shape.format = 0;
+  shape.width = 0;
+  shape.height = 0;
+  shape.channels = 0;
+  shape.capacity = payloadSize;
+
+  RefPointer<Packet> retval;
+  IMediaData* found = take(shape);
+  if (found)
+  {
+    retval.reset(static_cast<Packet*>(found), true);
+    handOut();
+    retval->setPool(this);
+    // reuses the buffer, which we know is big enough
+    if (retval->allocateNewPayload(payloadSize) < 0)
+      retval = 0;
+  }
+  else
+  {
+    retval = Packet::make(payloadSize);
+    if (retval)
+    {
+      handOut();
+      retval->setPool(this);
+    }
+  }
+  return retval.get();
+}
+
+IVideoPicture*
+MediaDataPool :: getVideoPicture(IPixelFormat::Type format,
+    int32_t width, int32_t height)
+{
+  Shape shape;
+  shape.type = VIDEO_PICTURE;
+  shape.format = format;
+  shape.width = width;
+  shape.height = height;
+  shape.channels = 0;
+  shape.capacity = 0;
+
+  RefPointer<VideoPicture> retval;
+  IMediaData* found = take(shape);
+  if (found)
+    retval.reset(static_cast<VideoPicture*>(found), true);
+  else
+    retval = VideoPicture::make(format, width, height);
+  if (retval)
+  {
+    handOut();
+    retval->setPool(this);
+  }
+  return retval.get();
+}
+
+IAudioSamples*
+MediaDataPool :: getAudioSamples(int32_t numSamples, int32_t channels,
+    IAudioSamples::Format format)
+{
+  if (numSamples <= 0 || channels <= 0)
+    return 0;
+  Shape shape;
+  shape.type = AUDIO_SAMPLES;
+  shape.format = format;
+  shape.width = 0;
+  shape.height = 0;
+  shape.channels = channels;
+  shape.capacity = numSamples;
+
+  RefPointer<AudioSamples> retval;
+  IMediaData* found = take(shape);
+  if (found)
+    retval.reset(static_cast<AudioSamples*>(found), true);
+  else
+    retval = AudioSamples::make(numSamples, channels, format);
+  if (retval)
+  {
+    handOut();
+    retval->setPool(this);
+  }
+  return retval.get();
+}
+
+void
+MediaDataPool :: clear()
+{
+  std::list<Entry> freed;
+  mLock.lock();
+  freed.swap(mFree);
+  mNumFree = 0;
+  mLock.unlock();
+
+  for(std::list<Entry>::iterator it = freed.begin(); it != freed.end(); ++it)
+    freeObject(it->data);
+}
+
+int32_t
+MediaDataPool :: getMaxFreeObjects()
+{
+  return mMaxFreeObjects;
+}
+
+int32_t
+MediaDataPool :: getNumFreeObjects()
+{
+  mLock.lock();
+  int32_t retval = mNumFree;
+  mLock.unlock();
+  return retval;
+}
+
+int32_t
+MediaDataPool :: getNumOutstandingObjects()
+{
+  mLock.lock();
+  int32_t retval = mNumOutstanding;
+  mLock.unlock();
+  return retval;
+}
+
+int64_t
+MediaDataPool :: getHits()
+{
+  mLock.lock();
+  int64_t retval = mHits;
+  mLock.unlock();
+  return retval;
+}
+
+int64_t
+MediaDataPool :: getMisses()
+{
+  mLock.lock();
+  int64_t retval = mMisses;
+  mLock.unlock();
+  return retval;
+}
+
+int64_t
+MediaDataPool :: getEvictions()
+{
+  mLock.lock();
+  int64_t retval = mEvictions;
+  mLock.unlock();
+  return retval;
+}
+
+}}}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MEDIADATAPOOL_H_
+#define MEDIADATAPOOL_H_
+
+#include <list>
+
+#include <com/xuggle/ferry/SpinMutex.h>
+#include <com/xuggle/xuggler/IMediaDataPool.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * The implementation of {@link IMediaDataPool}.
+   * </p><p>
+   * A Packet, VideoPicture or AudioSamples handed out by the pool holds
+   * a reference to it.  When the object's last reference is released its
+   * destroy() hands it to #reclaim instead of deleting it, and gives up
+   * that reference.  Free objects sit in the pool with a reference count
+   * of zero and no reference to the pool, so a pool nobody holds is
+   * deleted, along with its free objects, as soon as the last
+   * outstanding object comes back.
+   * </p>
+   */
+  class MediaDataPool : public IMediaDataPool
+  {
+    VS_JNIUTILS_REFCOUNTED_OBJECT_PRIVATE_MAKE(MediaDataPool);
+  public:
+    static MediaDataPool* make(int32_t maxFreeObjects);
+
+    virtual IPacket* getPacket(int32_t payloadSize);
+    virtual IVideoPicture* getVideoPicture(IPixelFormat::Type format,
+        int32_t width, int32_t height);
+    virtual IAudioSamples* getAudioSamples(int32_t numSamples,
+        int32_t channels, IAudioSamples::Format format);
+    virtual void clear();
+    virtual int32_t getMaxFreeObjects();
+    virtual int32_t getNumFreeObjects();
+    virtual int32_t getNumOutstandingObjects();
+    virtual int64_t getHits();
+    virtual int64_t getMisses();
+    virtual int64_t getEvictions();
+
+    /**
+     * Called from the destroy() of an object this pool handed out, once
+     * its last reference is gone.  Takes over the reference to the pool
+     * the object held, so the pool may be deleted before this returns.
+     *
+     * @param data the object.
+     * @return true if the pool kept data for reuse; false if the caller
+     *   should delete it.
+     */
+    bool reclaim(IMediaData* data);
+
+  protected:
+    MediaDataPool();
+    virtual ~MediaDataPool();
+
+  private:
+    enum Type {
+      PACKET,
+      VIDEO_PICTURE,
+      AUDIO_SAMPLES
+    };
+
+    // What a free object can be used for.  A request matches an object
+    // with the same type, format, width and channels and at least the
+    // capacity asked for.
+    struct Shape
+    {
+      Type type;
+      int32_t format;
+      int32_t width;
+      int32_t height;
+      int32_t channels;
+      int64_t capacity;
+    };
+    struct Entry
+    {
+      Shape shape;
+      IMediaData* data;
+    };
+
+    static bool recycle(IMediaData* data, Shape* shape);
+    static void freeObject(IMediaData* data);
+    IMediaData* take(const Shape& shape);
+    void handOut();
+
+    com::xuggle::ferry::SpinMutex mLock;
+    int32_t mMaxFreeObjects;
+    // most recently returned at the front; reference count of zero
+    std::list<Entry> mFree;
+    int32_t mNumFree;
+    int32_t mNumOutstanding;
+    int64_t mHits;
+    int64_t mMisses;
+    int64_t mEvictions;
+  };
+
+}}}
+
+#endif /*MEDIADATAPOOL_H_*/
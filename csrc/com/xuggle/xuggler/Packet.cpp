@@ -20,6 +20,7 @@
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/ferry/Buffer.h>
 #include <com/xuggle/xuggler/Packet.h>
+#include <com/xuggle/xuggler/MediaDataPool.h>
 
 // for memset
 #include <cstring>
@@ -46,6 +47,7 @@ namespace com { namespace xuggle { namespace xuggler
       mPacket->size = 0;
     }
     mIsComplete = false;
+    mPool = 0;
   }
 
   Packet :: ~Packet()
@@ -205,6 +207,45 @@ namespace com { namespace xuggle { namespace xuggler
     setComplete(true, mPacket->size);
   }
 
+  void
+  Packet :: adoptAVPacket(AVPacket* pkt)
+  {
+    VS_ASSERT(mPacket, "No packet?");
+
+    // We can only take payloads FFmpeg allocated with av_malloc and
+    // would free with av_destruct_packet; anything else (for example
+    // data still owned by a parser) is copied as usual.
+    if (!pkt->data || pkt->size <= 0 || pkt->destruct != av_destruct_packet)
+    {
+      wrapAVPacket(pkt);
+      return;
+    }
+    Buffer* buffer = Buffer::make(0, pkt->data, pkt->size,
+        Packet::freeAVBuffer, 0);
+    if (!buffer)
+    {
+      wrapAVPacket(pkt);
+      return;
+    }
+
+    reset();
+    // we take over the reference from make()
+    mBuffer = buffer;
+
+    void (*orig_destruct)(struct AVPacket *) = mPacket->destruct;
+    // copy all data members, including data and size.
+    *mPacket = *pkt;
+    mPacket->destruct = orig_destruct;
+
+    // The buffer owns the payload now; make sure av_free_packet
+    // doesn't free it out from under us.
+    pkt->data = 0;
+    pkt->size = 0;
+
+    // And assume we're now complete.
+    setComplete(true, mPacket->size);
+  }
+
   void
   Packet :: reset()
   {
@@ -405,4 +446,39 @@ namespace com { namespace xuggle { namespace xuggler
   {
     if (mPacket) mPacket->convergence_duration = duration;
   }
+
+  void
+  Packet :: setPool(MediaDataPool* pool)
+  {
+    if (pool)
+      pool->acquire();
+    if (mPool)
+      mPool->release();
+    mPool = pool;
+  }
+
+  bool
+  Packet :: recycle()
+  {
+    if (!mPacket)
+      return false;
+    reset();
+    mPacket->data = 0;
+    mPacket->size = 0;
+    mTimeBase = 0;
+    // someone else can still see the payload; don't write over it
+    if (mBuffer && mBuffer->getCurrentRefCount() > 1)
+      mBuffer = 0;
+    return true;
+  }
+
+  void
+  Packet :: destroy()
+  {
+    // go back to our pool if it'll have us
+    MediaDataPool* pool = mPool;
+    mPool = 0;
+    if (!pool || !pool->reclaim(this))
+      RefCounted::destroy();
+  }
   }}}
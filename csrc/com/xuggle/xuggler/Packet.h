@@ -27,6 +27,8 @@
 
 namespace com { namespace xuggle { namespace xuggler
 {
+  class MediaDataPool;
+
   class Packet : public IPacket
   {
   public:
@@ -86,18 +88,41 @@ namespace com { namespace xuggle { namespace xuggler
      * our own buffer state.
      */
     void wrapAVPacket(AVPacket* pkt);
+    /*
+     * Like wrapAVPacket, but if FFmpeg allocated the payload
+     * we take ownership of it instead of copying it.  On
+     * return pkt no longer references the payload, but
+     * av_free_packet must still be called on it.
+     */
+    void adoptAVPacket(AVPacket* pkt);
     void wrapBuffer(com::xuggle::ferry::IBuffer *buffer);
     // Used by the IBuffer to free buffers.
     static void freeAVBuffer(void *buf, void *closure);
 
+    /**
+     * Set the pool this packet came from; while set, releasing its last
+     * reference hands it back to the pool instead of deleting it.
+     * Called by MediaDataPool.
+     */
+    void setPool(MediaDataPool* pool);
+    /**
+     * Put this packet back the way make() left it, keeping its payload buffer
+     * unless someone else still holds it.  Called by MediaDataPool.
+     * @return false if it can't be reused.
+     */
+    bool recycle();
+
   protected:
     Packet();
     virtual ~Packet();
+    virtual void destroy();
   private:
     AVPacket* mPacket;
     com::xuggle::ferry::RefPointer<com::xuggle::ferry::IBuffer> mBuffer;
     com::xuggle::ferry::RefPointer<IRational> mTimeBase;
     bool mIsComplete;
+    // the pool we came from, if any; we hold a reference to it
+    MediaDataPool* mPool;
   };
 
 }}}
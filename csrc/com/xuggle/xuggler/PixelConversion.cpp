@@ -0,0 +1,254 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <vector>
+
+#include <com/xuggle/xuggler/PixelConversion.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+namespace {
+
+// BT.601 studio-swing YUV to RGB, in 1/64ths
+const int16_t PixelConversion_kY = 75;   // 1.164
+const int16_t PixelConversion_kRV = 102; // 1.596
+const int16_t PixelConversion_kGU = 25;  // 0.391
+const int16_t PixelConversion_kGV = 52;  // 0.813
+const int16_t PixelConversion_kBU = 129; // 2.018
+
+inline uint8_t
+PixelConversion_clamp(int32_t value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : (uint8_t)value);
+}
+
+/*
+ * Converts one row to planar R, G and B.  The SSE2 and scalar paths
+ * do the same 16-bit arithmetic (the SSE2 path saturates only where the
+ * result would clamp to 255 anyway) so they produce identical output.
+ */
+void
+PixelConversion_yuvRowToRgb(const uint8_t* y, const uint8_t* u,
+    const uint8_t* v, int32_t width, uint8_t* r, uint8_t* g, uint8_t* b)
+{
+  int32_t x = 0;
+#ifdef __SSE2__
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i yOffset = _mm_set1_epi16(16);
+  const __m128i cOffset = _mm_set1_epi16(128);
+  const __m128i rounding = _mm_set1_epi16(32);
+  const __m128i kY = _mm_set1_epi16(PixelConversion_kY);
+  const __m128i kRV = _mm_set1_epi16(PixelConversion_kRV);
+  const __m128i kGU = _mm_set1_epi16(PixelConversion_kGU);
+  const __m128i kGV = _mm_set1_epi16(PixelConversion_kGV);
+  const __m128i kBU = _mm_set1_epi16(PixelConversion_kBU);
+  for(; x + 16 <= width; x += 16)
+  {
+    __m128i ys = _mm_loadu_si128((const __m128i*)(y + x));
+    __m128i us = _mm_loadl_epi64((const __m128i*)(u + x/2));
+    __m128i vs = _mm_loadl_epi64((const __m128i*)(v + x/2));
+    // each chroma sample covers two pixels
+    us = _mm_unpacklo_epi8(us, us);
+    vs = _mm_unpacklo_epi8(vs, vs);
+
+    __m128i rgb[3][2];
+    for(int half = 0; half < 2; half++)
+    {
+      __m128i yw = half ? _mm_unpackhi_epi8(ys, zero) : _mm_unpacklo_epi8(ys, zero);
+      __m128i uw = half ? _mm_unpackhi_epi8(us, zero) : _mm_unpacklo_epi8(us, zero);
+      __m128i vw = half ? _mm_unpackhi_epi8(vs, zero) : _mm_unpacklo_epi8(vs, zero);
+      yw = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(yw, yOffset), kY),
+          rounding);
+      uw = _mm_sub_epi16(uw, cOffset);
+      vw = _mm_sub_epi16(vw, cOffset);
+      rgb[0][half] = _mm_srai_epi16(
+          _mm_adds_epi16(yw, _mm_mullo_epi16(vw, kRV)), 6);
+      rgb[1][half] = _mm_srai_epi16(
+          _mm_subs_epi16(_mm_subs_epi16(yw, _mm_mullo_epi16(uw, kGU)),
+              _mm_mullo_epi16(vw, kGV)), 6);
+      rgb[2][half] = _mm_srai_epi16(
+          _mm_adds_epi16(yw, _mm_mullo_epi16(uw, kBU)), 6);
+    }
+    _mm_storeu_si128((__m128i*)(r + x), _mm_packus_epi16(rgb[0][0], rgb[0][1]));
+    _mm_storeu_si128((__m128i*)(g + x), _mm_packus_epi16(rgb[1][0], rgb[1][1]));
+    _mm_storeu_si128((__m128i*)(b + x), _mm_packus_epi16(rgb[2][0], rgb[2][1]));
+  }
+#endif
+  for(; x < width; x++)
+  {
+    int32_t yy = (y[x] - 16) * PixelConversion_kY + 32;
+    int32_t uu = u[x/2] - 128;
+    int32_t vv = v[x/2] - 128;
+    r[x] = PixelConversion_clamp((yy + PixelConversion_kRV * vv) >> 6);
+    g[x] = PixelConversion_clamp(
+        (yy - PixelConversion_kGU * uu - PixelConversion_kGV * vv) >> 6);
+    b[x] = PixelConversion_clamp((yy + PixelConversion_kBU * uu) >> 6);
+  }
+}
+
+void
+PixelConversion_packBgr24(const uint8_t* r, const uint8_t* g,
+    const uint8_t* b, int32_t width, uint8_t* dst)
+{
+  for(int32_t x = 0; x < width; x++)
+  {
+    dst[0] = b[x];
+    dst[1] = g[x];
+    dst[2] = r[x];
+    dst += 3;
+  }
+}
+
+void
+PixelConversion_packArgb(const uint8_t* r, const uint8_t* g,
+    const uint8_t* b, int32_t width, uint8_t* dst)
+{
+  uint32_t* out = (uint32_t*)dst;
+  int32_t x = 0;
+#if defined(__SSE2__)
+  // x86 is little endian, so 0xAARRGGBB is stored B, G, R, A
+  const __m128i alpha = _mm_set1_epi8((char)0xFF);
+  for(; x + 16 <= width; x += 16)
+  {
+    __m128i bs = _mm_loadu_si128((const __m128i*)(b + x));
+    __m128i gs = _mm_loadu_si128((const __m128i*)(g + x));
+    __m128i rs = _mm_loadu_si128((const __m128i*)(r + x));
+    __m128i bgLo = _mm_unpacklo_epi8(bs, gs);
+    __m128i bgHi = _mm_unpackhi_epi8(bs, gs);
+    __m128i raLo = _mm_unpacklo_epi8(rs, alpha);
+    __m128i raHi = _mm_unpackhi_epi8(rs, alpha);
+    _mm_storeu_si128((__m128i*)(out + x), _mm_unpacklo_epi16(bgLo, raLo));
+    _mm_storeu_si128((__m128i*)(out + x + 4), _mm_unpackhi_epi16(bgLo, raLo));
+    _mm_storeu_si128((__m128i*)(out + x + 8), _mm_unpacklo_epi16(bgHi, raHi));
+    _mm_storeu_si128((__m128i*)(out + x + 12), _mm_unpackhi_epi16(bgHi, raHi));
+  }
+#endif
+  for(; x < width; x++)
+    out[x] = 0xFF000000U | ((uint32_t)r[x] << 16) | ((uint32_t)g[x] << 8) | b[x];
+}
+
+inline void
+PixelConversion_unpack(PixelConversion::PackedFormat format,
+    const uint8_t* row, int32_t x, int32_t& r, int32_t& g, int32_t& b)
+{
+  if (format == PixelConversion::PACKED_BGR24)
+  {
+    const uint8_t* p = row + 3*x;
+    b = p[0];
+    g = p[1];
+    r = p[2];
+  }
+  else
+  {
+    uint32_t p = ((const uint32_t*)row)[x];
+    r = (p >> 16) & 0xFF;
+    g = (p >> 8) & 0xFF;
+    b = p & 0xFF;
+  }
+}
+
+inline uint8_t
+PixelConversion_rgbToY(int32_t r, int32_t g, int32_t b)
+{
+  return (uint8_t)(((66*r + 129*g + 25*b + 128) >> 8) + 16);
+}
+
+}
+
+int32_t
+PixelConversion :: getBytesPerPixel(PackedFormat format)
+{
+  return format == PACKED_BGR24 ? 3 : 4;
+}
+
+void
+PixelConversion :: yuv420pToPacked(PackedFormat format,
+    const uint8_t* const planes[3], const int32_t strides[3],
+    int32_t width, int32_t height,
+    uint8_t* dst, int32_t dstStride)
+{
+  if (width <= 0 || height <= 0)
+    return;
+  std::vector<uint8_t> rgb(3*width);
+  uint8_t* r = &rgb[0];
+  uint8_t* g = r + width;
+  uint8_t* b = g + width;
+  for(int32_t row = 0; row < height; row++)
+  {
+    PixelConversion_yuvRowToRgb(
+        planes[0] + row*strides[0],
+        planes[1] + (row/2)*strides[1],
+        planes[2] + (row/2)*strides[2],
+        width, r, g, b);
+    if (format == PACKED_BGR24)
+      PixelConversion_packBgr24(r, g, b, width, dst + row*dstStride);
+    else
+      PixelConversion_packArgb(r, g, b, width, dst + row*dstStride);
+  }
+}
+
+void
+PixelConversion :: packedToYuv420p(PackedFormat format,
+    const uint8_t* src, int32_t srcStride,
+    int32_t width, int32_t height,
+    uint8_t* const planes[3], const int32_t strides[3])
+{
+  for(int32_t row = 0; row < height; row += 2)
+  {
+    const uint8_t* top = src + row*srcStride;
+    // repeat the last row of odd height images
+    const uint8_t* bottom = row + 1 < height ? top + srcStride : top;
+    uint8_t* yTop = planes[0] + row*strides[0];
+    uint8_t* yBottom = row + 1 < height ? yTop + strides[0] : 0;
+    uint8_t* u = planes[1] + (row/2)*strides[1];
+    uint8_t* v = planes[2] + (row/2)*strides[2];
+    for(int32_t x = 0; x < width; x += 2)
+    {
+      int32_t x1 = x + 1 < width ? x + 1 : x;
+      int32_t r0, g0, b0, r1, g1, b1, r2, g2, b2, r3, g3, b3;
+      PixelConversion_unpack(format, top, x, r0, g0, b0);
+      PixelConversion_unpack(format, top, x1, r1, g1, b1);
+      PixelConversion_unpack(format, bottom, x, r2, g2, b2);
+      PixelConversion_unpack(format, bottom, x1, r3, g3, b3);
+
+      yTop[x] = PixelConversion_rgbToY(r0, g0, b0);
+      if (x1 != x)
+        yTop[x1] = PixelConversion_rgbToY(r1, g1, b1);
+      if (yBottom)
+      {
+        yBottom[x] = PixelConversion_rgbToY(r2, g2, b2);
+        if (x1 != x)
+          yBottom[x1] = PixelConversion_rgbToY(r3, g3, b3);
+      }
+
+      int32_t r = (r0 + r1 + r2 + r3 + 2) >> 2;
+      int32_t g = (g0 + g1 + g2 + g3 + 2) >> 2;
+      int32_t b = (b0 + b1 + b2 + b3 + 2) >> 2;
+      u[x/2] = (uint8_t)(((-38*r - 74*g + 112*b + 128) >> 8) + 128);
+      v[x/2] = (uint8_t)(((112*r - 94*g - 18*b + 128) >> 8) + 128);
+    }
+  }
+}
+
+}}}
@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PIXELCONVERSION_H_
+#define PIXELCONVERSION_H_
+
+#include <inttypes.h>
+#include <com/xuggle/xuggler/Xuggler.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * Hand-tuned kernels that convert YUV420P pictures straight to and
+   * from the packed layouts java.awt.image.BufferedImage uses, in one
+   * pass and without an intermediate picture.  They use SSE2 where the
+   * compiler targets it and portable C++ elsewhere; both produce the
+   * same bytes.
+   * </p><p>
+   * Colors use the ITU-R BT.601 studio-swing matrix, like swscale's
+   * default, in 6-bit fixed point; results can differ from swscale's by
+   * a level or two per channel.
+   * </p><p>
+   * None of these functions allocate or call into Java, so they are
+   * safe to call with a pinned Java array.
+   * </p>
+   */
+  class VS_API_XUGGLER PixelConversion
+  {
+  public:
+    typedef enum PackedFormat {
+      /** 3 bytes per pixel, in B, G, R order (BufferedImage.TYPE_3BYTE_BGR) */
+      PACKED_BGR24,
+      /**
+       * one native-endian 32-bit 0xAARRGGBB int per pixel
+       * (BufferedImage.TYPE_INT_ARGB)
+       */
+      PACKED_INT_ARGB,
+    } PackedFormat;
+
+    /**
+     * @return the bytes one pixel takes in format.
+     */
+    static int32_t getBytesPerPixel(PackedFormat format);
+
+    /**
+     * Convert a YUV420P image to a packed one.
+     * @param format the packed format to write.
+     * @param planes the Y, U and V planes.
+     * @param strides the bytes between rows of each plane.
+     * @param width image width.
+     * @param height image height.
+     * @param dst where to write the first packed row.
+     * @param dstStride the bytes between packed rows.
+     */
+    static void yuv420pToPacked(PackedFormat format,
+        const uint8_t* const planes[3], const int32_t strides[3],
+        int32_t width, int32_t height,
+        uint8_t* dst, int32_t dstStride);
+
+    /**
+     * Convert a packed image to YUV420P.  Chroma is the average of each
+     * 2x2 block.
+     * @param format the packed format to read.
+     * @param src the first packed row.
+     * @param srcStride the bytes between packed rows.
+     * @param width image width.
+     * @param height image height.
+     * @param planes the Y, U and V planes to write.
+     * @param strides the bytes between rows of each plane.
+     */
+    static void packedToYuv420p(PackedFormat format,
+        const uint8_t* src, int32_t srcStride,
+        int32_t width, int32_t height,
+        uint8_t* const planes[3], const int32_t strides[3]);
+
+  private:
+    PixelConversion();
+  };
+
+}}}
+
+#endif /*PIXELCONVERSION_H_*/
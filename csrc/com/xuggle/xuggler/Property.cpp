@@ -20,6 +20,7 @@
 #include <com/xuggle/xuggler/Property.h>
 #include <com/xuggle/xuggler/MetaData.h>
 #include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/ferry/SpinMutex.h>
 #include <com/xuggle/xuggler/Property.h>
 extern "C" {
 #include "FfmpegIncludes.h"
@@ -28,11 +29,74 @@ extern "C" {
 
 #include <stdexcept>
 #include <cstring>
+#include <map>
+#include <vector>
 
 VS_LOG_SETUP(VS_CPP_PACKAGE);
 
+using namespace com::xuggle::ferry;
+
 namespace com { namespace xuggle { namespace xuggler {
 
+  namespace {
+    /**
+     * The settable (non-constant) options of one AVClass, in the order
+     * av_opt_next returns them.
+     */
+    struct PropertyTable
+    {
+      const AVOption* start;
+      std::vector<const AVOption*> options;
+    };
+  }
+
+  static SpinMutex sPropertyTableLock;
+  // Option lists are static data in FFmpeg, so a table, once built,
+  // stays valid for the life of the process and is never freed.
+  static std::map<const AVClass*, PropertyTable*> sPropertyTables;
+
+  /**
+   * Get the table of options for the AVClass of context, building it
+   * the first time that class is seen.
+   */
+  static const PropertyTable*
+  Property_getTable(void* context)
+  {
+    if (!context)
+      return 0;
+    const AVClass* avClass = *(const AVClass**)context;
+    if (!avClass)
+      return 0;
+
+    PropertyTable* retval = 0;
+    sPropertyTableLock.lock();
+    std::map<const AVClass*, PropertyTable*>::iterator it =
+        sPropertyTables.find(avClass);
+    if (it != sPropertyTables.end())
+      retval = it->second;
+    sPropertyTableLock.unlock();
+    if (retval)
+      return retval;
+
+    // build it outside the lock; if another thread beats us to it we
+    // use theirs and drop ours.
+    PropertyTable* table = new PropertyTable();
+    const AVOption* last = 0;
+    table->start = av_opt_next(&avClass, 0);
+    while ((last = av_opt_next(&avClass, last)))
+      if (last->type != AV_OPT_TYPE_CONST)
+        table->options.push_back(last);
+
+    sPropertyTableLock.lock();
+    std::pair<std::map<const AVClass*, PropertyTable*>::iterator, bool> added =
+        sPropertyTables.insert(std::make_pair(avClass, table));
+    retval = added.first->second;
+    sPropertyTableLock.unlock();
+    if (!added.second)
+      delete table;
+    return retval;
+  }
+
   Property :: Property()
   {
     mOption=0;
@@ -113,50 +177,24 @@ namespace com { namespace xuggle { namespace xuggler {
   int32_t
   Property :: getNumProperties(void *aContext)
   {
-    int32_t retval=0;
-    const AVOption* last = 0;
-    if (aContext)
-    {
-      do {
-        last = av_opt_next(aContext, last);
-        if (last)
-        {
-          if (last->type != AV_OPT_TYPE_CONST)
-            ++retval;
-        }
-      } while (last);
-    }
-    return retval;
+    const PropertyTable* table = Property_getTable(aContext);
+    return table ? table->options.size() : 0;
   }
   
   IProperty*
   Property :: getPropertyMetaData(void *aContext, int32_t aPropertyNo)
   {
     IProperty *retval = 0;
-    const AVOption* last = 0;
 
     try
     {
       if (!aContext)
         throw std::runtime_error("no context passed in");
 
-      int32_t optionNo=-1;
-      do {
-        last = av_opt_next(aContext, last);
-        if (last)
-        {
-          if (last->type != AV_OPT_TYPE_CONST)
-          {
-            ++optionNo;
-            // now see if this option position matches the property asked for
-            if (optionNo == aPropertyNo)
-            {
-              retval = Property::make(av_opt_next(aContext, 0), last);
-              break;
-            }
-          }
-        }
-      } while (last);
+      const PropertyTable* table = Property_getTable(aContext);
+      if (table && aPropertyNo >= 0 &&
+          (size_t)aPropertyNo < table->options.size())
+        retval = Property::make(table->start, table->options[aPropertyNo]);
     }
     catch (std::exception & e)
     {
@@ -0,0 +1,347 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
+
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/xuggler/Property.h>
+#include <com/xuggle/xuggler/PropertyHandle.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+using namespace com::xuggle::ferry;
+
+namespace com { namespace xuggle { namespace xuggler {
+
+  PropertyHandle :: PropertyHandle()
+  {
+    mContext = 0;
+    mRoot = 0;
+    mTarget = 0;
+    mTargetClass = 0;
+    mOption = 0;
+  }
+
+  PropertyHandle :: ~PropertyHandle()
+  {
+  }
+
+  PropertyHandle*
+  PropertyHandle :: make(RefCounted* owner, void** context, const char* name)
+  {
+    PropertyHandle* retval = 0;
+    if (!owner || !context || !*context || !name || !*name)
+      return 0;
+    retval = PropertyHandle::make();
+    if (retval)
+    {
+      retval->mOwner.reset(owner, true);
+      retval->mContext = context;
+      retval->mName = name;
+      if (!retval->getTarget())
+        VS_REF_RELEASE(retval);
+    }
+    return retval;
+  }
+
+  void
+  PropertyHandle :: resolve(void* root)
+  {
+    void* target = 0;
+    const AVOption* option = 0;
+    if (root)
+      option = av_opt_find2(root, mName.c_str(), 0, 0,
+          AV_OPT_SEARCH_CHILDREN, &target);
+    mRoot = root;
+    if (option && target && option->type != AV_OPT_TYPE_CONST)
+    {
+      mTarget = target;
+      mTargetClass = *(const AVClass**)target;
+      mOption = option;
+    }
+    else
+    {
+      mTarget = 0;
+      mTargetClass = 0;
+      mOption = 0;
+    }
+  }
+
+  void*
+  PropertyHandle :: getTarget()
+  {
+    void* root = *mContext;
+    if (root && root == mRoot && mOption)
+    {
+      if (mTarget == root)
+      {
+        if (*(const AVClass**)root == mTargetClass)
+          return mTarget;
+      }
+      else
+      {
+        void* child = 0;
+        while ((child = av_opt_child_next(root, child)))
+          if (child == mTarget)
+          {
+            if (*(const AVClass**)child == mTargetClass)
+              return mTarget;
+            break;
+          }
+      }
+    }
+    resolve(root);
+    return mTarget;
+  }
+
+  const char*
+  PropertyHandle :: getName()
+  {
+    return mName.c_str();
+  }
+
+  bool
+  PropertyHandle :: isValid()
+  {
+    return getTarget() != 0;
+  }
+
+  IProperty*
+  PropertyHandle :: getPropertyMetaData()
+  {
+    void* target = getTarget();
+    if (!target)
+      return 0;
+    return Property::make(av_opt_next(target, 0), mOption);
+  }
+
+  int32_t
+  PropertyHandle :: setNumber(double num, int den, int64_t intnum)
+  {
+    // the same range check and conversions av_opt_set_number does, minus
+    // the search for the option.
+    void* target = getTarget();
+    if (!target)
+      return -1;
+    const AVOption* o = mOption;
+    if (o->max*den < num*intnum || o->min*den > num*intnum)
+    {
+      VS_LOG_DEBUG("Value %f for property \"%s\" out of range",
+          num*intnum/den, o->name);
+      return AVERROR(ERANGE);
+    }
+    void* dst = (uint8_t*)target + o->offset;
+    switch(o->type)
+    {
+      case AV_OPT_TYPE_FLAGS:
+      case AV_OPT_TYPE_INT:
+        *(int*)dst = llrint(num/den)*intnum;
+        break;
+      case AV_OPT_TYPE_INT64:
+        *(int64_t*)dst = llrint(num/den)*intnum;
+        break;
+      case AV_OPT_TYPE_FLOAT:
+        *(float*)dst = num*intnum/den;
+        break;
+      case AV_OPT_TYPE_DOUBLE:
+        *(double*)dst = num*intnum/den;
+        break;
+      case AV_OPT_TYPE_RATIONAL:
+        if ((int)num == num)
+        {
+          AVRational* q = (AVRational*)dst;
+          q->num = num*intnum;
+          q->den = den;
+        }
+        else
+          *(AVRational*)dst = av_d2q(num*intnum/den, 1<<24);
+        break;
+      default:
+        return AVERROR(EINVAL);
+    }
+    return 0;
+  }
+
+  bool
+  PropertyHandle :: getNumber(double* num, int* den, int64_t* intnum)
+  {
+    *num = 1;
+    *den = 1;
+    *intnum = 1;
+    void* target = getTarget();
+    if (!target)
+      return false;
+    void* src = (uint8_t*)target + mOption->offset;
+    switch(mOption->type)
+    {
+      case AV_OPT_TYPE_FLAGS:
+        *intnum = *(unsigned int*)src;
+        break;
+      case AV_OPT_TYPE_INT:
+        *intnum = *(int*)src;
+        break;
+      case AV_OPT_TYPE_INT64:
+        *intnum = *(int64_t*)src;
+        break;
+      case AV_OPT_TYPE_FLOAT:
+        *num = *(float*)src;
+        break;
+      case AV_OPT_TYPE_DOUBLE:
+        *num = *(double*)src;
+        break;
+      case AV_OPT_TYPE_RATIONAL:
+        *intnum = ((AVRational*)src)->num;
+        *den = ((AVRational*)src)->den;
+        break;
+      default:
+        return false;
+    }
+    return true;
+  }
+
+  int32_t
+  PropertyHandle :: setValue(const char* value)
+  {
+    void* target = getTarget();
+    if (!target)
+      return -1;
+    if (mOption->type == AV_OPT_TYPE_STRING)
+    {
+      char** dst = (char**)((uint8_t*)target + mOption->offset);
+      av_freep(dst);
+      if (value)
+      {
+        *dst = av_strdup(value);
+        if (!*dst)
+          return AVERROR(ENOMEM);
+      }
+      return 0;
+    }
+    // numbers and flags given as strings need FFmpeg's parser; we at
+    // least skip searching the children for it.
+    return av_opt_set(target, mOption->name, value, 0);
+  }
+
+  int32_t
+  PropertyHandle :: setValue(double value)
+  {
+    return setNumber(value, 1, 1);
+  }
+
+  int32_t
+  PropertyHandle :: setValue(int64_t value)
+  {
+    return setNumber(1, 1, value);
+  }
+
+  int32_t
+  PropertyHandle :: setValue(bool value)
+  {
+    return setValue((int64_t)value);
+  }
+
+  int32_t
+  PropertyHandle :: setValue(IRational* value)
+  {
+    if (!value)
+      return -1;
+    return setNumber(value->getNumerator(), value->getDenominator(), 1);
+  }
+
+  char*
+  PropertyHandle :: getValueAsString()
+  {
+    void* target = getTarget();
+    if (!target)
+      return 0;
+
+    char* retval = 0;
+    char* value = 0;
+    bool mustFree = false;
+    if (mOption->type == AV_OPT_TYPE_STRING)
+      value = *(char**)((uint8_t*)target + mOption->offset);
+    else if (av_opt_get(target, mOption->name, 0, (uint8_t**)&value) >= 0)
+      mustFree = true;
+
+    // like Property::getPropertyAsString, empty values come back as null
+    if (value && *value)
+    {
+      size_t valLen = strlen(value);
+      retval = (char*)malloc(valLen+1);
+      if (retval)
+        memcpy(retval, value, valLen+1);
+    }
+    if (mustFree)
+      av_free(value);
+
+    // NOTE: Caller must call free() on returned value
+    return retval;
+  }
+
+  double
+  PropertyHandle :: getValueAsDouble()
+  {
+    double num;
+    int den;
+    int64_t intnum;
+    if (!getNumber(&num, &den, &intnum))
+      return 0;
+    return num*intnum/den;
+  }
+
+  int64_t
+  PropertyHandle :: getValueAsLong()
+  {
+    double num;
+    int den;
+    int64_t intnum;
+    if (!getNumber(&num, &den, &intnum))
+      return 0;
+    return num*intnum/den;
+  }
+
+  IRational*
+  PropertyHandle :: getValueAsRational()
+  {
+    double num;
+    int den;
+    int64_t intnum;
+    if (!getNumber(&num, &den, &intnum))
+      return 0;
+    AVRational value;
+    if (num == 1.0 && (int)intnum == intnum)
+    {
+      value.num = intnum;
+      value.den = den;
+    }
+    else
+      value = av_d2q(num*intnum/den, 1<<24);
+    return IRational::make(value.num, value.den);
+  }
+
+  bool
+  PropertyHandle :: getValueAsBoolean()
+  {
+    return (bool) getValueAsLong();
+  }
+
+}}}
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PROPERTYHANDLE_H_
+#define PROPERTYHANDLE_H_
+
+#include <string>
+#include <com/xuggle/ferry/RefPointer.h>
+#include <com/xuggle/xuggler/IPropertyHandle.h>
+
+extern "C" {
+#include "FfmpegIncludes.h"
+}
+
+namespace com { namespace xuggle { namespace xuggler {
+
+  /**
+   * Internal Only.
+   * <p>
+   * The {@link IPropertyHandle} implementation.  The option is found
+   * with av_opt_find2, searching children, and from then on read and
+   * written at its offset in whichever object (the context or one of
+   * its children) it was found in.
+   * </p><p>
+   * Owners change their context pointers over time, so a handle holds
+   * the address of the owner's pointer rather than its value.  Before
+   * each access it checks that the pointer still holds the context it
+   * searched, and that the object the option was found in is still that
+   * context or one of its children, of the same class.  If not, it
+   * searches again.
+   * </p>
+   */
+  class PropertyHandle : public IPropertyHandle
+  {
+    VS_JNIUTILS_REFCOUNTED_OBJECT_PRIVATE_MAKE(PropertyHandle);
+  public:
+    /**
+     * Make a handle for the property name on *context.
+     *
+     * @param owner the object *context belongs to; the handle keeps a
+     *   reference to it so context stays valid.
+     * @param context where owner keeps its (AVClass based) context.
+     * @param name the property name.
+     *
+     * @return a new handle, or null if *context has no such property.
+     */
+    static PropertyHandle* make(com::xuggle::ferry::RefCounted* owner,
+        void** context, const char* name);
+
+    virtual const char *getName();
+    virtual bool isValid();
+    virtual IProperty *getPropertyMetaData();
+    virtual int32_t setValue(const char* value);
+    virtual int32_t setValue(double value);
+    virtual int32_t setValue(int64_t value);
+    virtual int32_t setValue(bool value);
+    virtual int32_t setValue(IRational *value);
+    virtual char *getValueAsString();
+    virtual double getValueAsDouble();
+    virtual int64_t getValueAsLong();
+    virtual IRational *getValueAsRational();
+    virtual bool getValueAsBoolean();
+
+  protected:
+    PropertyHandle();
+    virtual ~PropertyHandle();
+
+  private:
+    /**
+     * @return the object the option lives in, searching again if the
+     *   owner's context has changed, or null if it can't be found.
+     */
+    void* getTarget();
+    void resolve(void* root);
+    int32_t setNumber(double num, int den, int64_t intnum);
+    bool getNumber(double* num, int* den, int64_t* intnum);
+
+    com::xuggle::ferry::RefPointer<com::xuggle::ferry::RefCounted> mOwner;
+    void** mContext;
+    std::string mName;
+    // the context we last searched
+    void* mRoot;
+    // the object in mRoot (or mRoot itself) that has mOption
+    void* mTarget;
+    const AVClass* mTargetClass;
+    const AVOption* mOption;
+  };
+
+}}}
+#endif /* PROPERTYHANDLE_H_ */
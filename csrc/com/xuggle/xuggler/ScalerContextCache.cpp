@@ -0,0 +1,272 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <list>
+#include <vector>
+
+#include <com/xuggle/ferry/SpinMutex.h>
+#include <com/xuggle/xuggler/ScalerContextCache.h>
+
+extern "C" {
+#include <libswscale/swscale.h>
+#include <libavutil/opt.h>
+}
+
+using namespace com::xuggle::ferry;
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+/*
+ * The next two methods are to work around a break in backwards compatibility introduced
+ * in FFmpeg in September 2010
+ */
+static int handle_jpeg(enum PixelFormat *format)
+{
+    switch (*format) {
+    case PIX_FMT_YUVJ420P: *format = PIX_FMT_YUV420P; return 1;
+    case PIX_FMT_YUVJ422P: *format = PIX_FMT_YUV422P; return 1;
+    case PIX_FMT_YUVJ444P: *format = PIX_FMT_YUV444P; return 1;
+    case PIX_FMT_YUVJ440P: *format = PIX_FMT_YUV440P; return 1;
+    default:                                          return 0;
+    }
+}
+
+static SwsContext *xuggleSws_getContext(int srcW, int srcH, enum PixelFormat srcFormat,
+                           int dstW, int dstH, enum PixelFormat dstFormat, int flags,
+                           SwsFilter *srcFilter, SwsFilter *dstFilter, const double *param)
+{
+    SwsContext *c;
+    const int *coeff;
+    int srcRange=handle_jpeg(&srcFormat);
+    int dstRange=handle_jpeg(&dstFormat);
+
+    if(!(c=sws_alloc_context()))
+        return NULL;
+
+    av_opt_set_int(c, "sws_flags", flags, 0);
+    av_opt_set_int(c, "srcw", srcW, 0);
+    av_opt_set_int(c, "srch", srcH, 0);
+    av_opt_set_int(c, "dstw", dstW, 0);
+    av_opt_set_int(c, "dsth", dstH, 0);
+    av_opt_set_int(c, "src_range", srcRange, 0);
+    av_opt_set_int(c, "dst_range", dstRange, 0);
+    av_opt_set_int(c, "src_format", srcFormat, 0);
+    av_opt_set_int(c, "dst_format", dstFormat, 0);
+
+    if (param) {
+        av_opt_set_double(c, "param0", param[0], 0);
+        av_opt_set_double(c, "param1", param[1], 0);
+    }
+
+    coeff = sws_getCoefficients(SWS_CS_DEFAULT);
+    sws_setColorspaceDetails(c, coeff, srcRange, coeff /* FIXME*/, dstRange, 0, 1<<16, 1<<16);
+
+    if(sws_init_context(c, srcFilter, dstFilter) < 0){
+        sws_freeContext(c);
+        return NULL;
+    }
+
+    return c;
+}
+
+namespace {
+  struct Key
+  {
+    int32_t values[7];
+    bool operator==(const Key& other) const
+    {
+      for(int i = 0; i < 7; i++)
+        if (values[i] != other.values[i])
+          return false;
+      return true;
+    }
+  };
+  typedef std::pair<Key, SwsContext*> Entry;
+
+  Key makeKey(int32_t inputWidth, int32_t inputHeight, int32_t inputFmt,
+      int32_t outputWidth, int32_t outputHeight, int32_t outputFmt,
+      int32_t flags)
+  {
+    Key key = { { inputWidth, inputHeight, inputFmt,
+        outputWidth, outputHeight, outputFmt, flags } };
+    return key;
+  }
+}
+
+static SpinMutex sLock;
+// most recently returned at the front
+static std::list<Entry> sIdle;
+static int32_t sMaxIdle = 16;
+static int64_t sHits = 0;
+static int64_t sMisses = 0;
+static int64_t sEvictions = 0;
+
+SwsContext*
+ScalerContextCache :: get(
+    int32_t inputWidth, int32_t inputHeight, int32_t inputFmt,
+    int32_t outputWidth, int32_t outputHeight, int32_t outputFmt,
+    int32_t flags)
+{
+  Key key = makeKey(inputWidth, inputHeight, inputFmt,
+      outputWidth, outputHeight, outputFmt, flags);
+  SwsContext* retval = 0;
+
+  sLock.lock();
+  for(std::list<Entry>::iterator it = sIdle.begin(); it != sIdle.end(); ++it)
+  {
+    if (it->first == key)
+    {
+      retval = it->second;
+      sIdle.erase(it);
+      break;
+    }
+  }
+  if (retval)
+    ++sHits;
+  else
+    ++sMisses;
+  sLock.unlock();
+
+  if (!retval)
+    // build outside the lock; it's the slow part
+    retval = xuggleSws_getContext(
+        inputWidth, inputHeight, (PixelFormat)inputFmt,
+        outputWidth, outputHeight, (PixelFormat)outputFmt,
+        flags, 0, 0, 0);
+  return retval;
+}
+
+void
+ScalerContextCache :: put(SwsContext* context,
+    int32_t inputWidth, int32_t inputHeight, int32_t inputFmt,
+    int32_t outputWidth, int32_t outputHeight, int32_t outputFmt,
+    int32_t flags)
+{
+  if (!context)
+    return;
+  Key key = makeKey(inputWidth, inputHeight, inputFmt,
+      outputWidth, outputHeight, outputFmt, flags);
+  SwsContext* evicted = 0;
+
+  sLock.lock();
+  if (sMaxIdle > 0)
+  {
+    sIdle.push_front(Entry(key, context));
+    if ((int32_t)sIdle.size() > sMaxIdle)
+    {
+      evicted = sIdle.back().second;
+      sIdle.pop_back();
+      ++sEvictions;
+    }
+  }
+  else
+    evicted = context;
+  sLock.unlock();
+
+  if (evicted)
+    sws_freeContext(evicted);
+}
+
+int32_t
+ScalerContextCache :: setMaxIdle(int32_t maxIdle)
+{
+  if (maxIdle < 0)
+    return -1;
+  std::vector<SwsContext*> evicted;
+  sLock.lock();
+  sMaxIdle = maxIdle;
+  while((int32_t)sIdle.size() > sMaxIdle)
+  {
+    evicted.push_back(sIdle.back().second);
+    sIdle.pop_back();
+    ++sEvictions;
+  }
+  sLock.unlock();
+
+  for(size_t i = 0; i < evicted.size(); i++)
+    sws_freeContext(evicted[i]);
+  return 0;
+}
+
+int32_t
+ScalerContextCache :: getMaxIdle()
+{
+  return sMaxIdle;
+}
+
+int32_t
+ScalerContextCache :: getNumIdle()
+{
+  sLock.lock();
+  int32_t retval = (int32_t)sIdle.size();
+  sLock.unlock();
+  return retval;
+}
+
+int64_t
+ScalerContextCache :: getHits()
+{
+  sLock.lock();
+  int64_t retval = sHits;
+  sLock.unlock();
+  return retval;
+}
+
+int64_t
+ScalerContextCache :: getMisses()
+{
+  sLock.lock();
+  int64_t retval = sMisses;
+  sLock.unlock();
+  return retval;
+}
+
+int64_t
+ScalerContextCache :: getEvictions()
+{
+  sLock.lock();
+  int64_t retval = sEvictions;
+  sLock.unlock();
+  return retval;
+}
+
+void
+ScalerContextCache :: resetStatistics()
+{
+  sLock.lock();
+  sHits = 0;
+  sMisses = 0;
+  sEvictions = 0;
+  sLock.unlock();
+}
+
+void
+ScalerContextCache :: clear()
+{
+  std::list<Entry> idle;
+  sLock.lock();
+  idle.swap(sIdle);
+  sLock.unlock();
+
+  for(std::list<Entry>::iterator it = idle.begin(); it != idle.end(); ++it)
+    sws_freeContext(it->second);
+}
+
+}}}
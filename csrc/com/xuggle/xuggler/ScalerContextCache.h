@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef SCALERCONTEXTCACHE_H_
+#define SCALERCONTEXTCACHE_H_
+
+#include <inttypes.h>
+#include <com/xuggle/xuggler/Xuggler.h>
+
+/*
+ * Opaque, like VideoResampler.h; only the .cpp file includes swscale.
+ */
+struct SwsContext;
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * A process-wide cache of initialized, idle swscale contexts.
+   * </p><p>
+   * Setting up a scaler computes filter coefficients for every output
+   * row and column, which costs far more than scaling a frame or two,
+   * and converters get re-created every time a stream changes.  So
+   * rather than free a context when a VideoResampler is done with it,
+   * the resampler hands it back here, and the next request for the same
+   * input and output sizes, pixel formats and flags gets it without
+   * another sws_init_context().
+   * </p><p>
+   * Contexts are lent out exclusively; swscale contexts keep scratch
+   * buffers and must never be used by two threads at once.  When more
+   * than #getMaxIdle() contexts are idle the least recently returned
+   * are freed.  All methods are thread safe.
+   * </p>
+   */
+  class VS_API_XUGGLER ScalerContextCache
+  {
+  public:
+    /**
+     * Get an initialized context, from the cache if one is idle there.
+     * @return a context the caller owns until it calls #put or frees
+     *   it, or null if swscale won't do this conversion.
+     */
+    static SwsContext* get(
+        int32_t inputWidth, int32_t inputHeight, int32_t inputFmt,
+        int32_t outputWidth, int32_t outputHeight, int32_t outputFmt,
+        int32_t flags);
+
+    /**
+     * Hand back a context from #get, with the same arguments it was got
+     * with.  Contexts whose options were changed since must be freed
+     * with sws_freeContext() instead.
+     */
+    static void put(SwsContext* context,
+        int32_t inputWidth, int32_t inputHeight, int32_t inputFmt,
+        int32_t outputWidth, int32_t outputHeight, int32_t outputFmt,
+        int32_t flags);
+
+    /**
+     * Set the most idle contexts to keep; 0 disables caching.
+     * @return >= 0 on success; < 0 if maxIdle < 0.
+     */
+    static int32_t setMaxIdle(int32_t maxIdle);
+    /** @return the most idle contexts kept. */
+    static int32_t getMaxIdle();
+    /** @return the number of contexts idle right now. */
+    static int32_t getNumIdle();
+    /** @return the number of #get calls satisfied from the cache. */
+    static int64_t getHits();
+    /** @return the number of #get calls that built a new context. */
+    static int64_t getMisses();
+    /** @return the number of idle contexts freed to make room. */
+    static int64_t getEvictions();
+    /** Set the hit, miss and eviction counts back to zero. */
+    static void resetStatistics();
+    /** Free all idle contexts. */
+    static void clear();
+
+  private:
+    ScalerContextCache();
+  };
+
+}}}
+
+#endif /*SCALERCONTEXTCACHE_H_*/
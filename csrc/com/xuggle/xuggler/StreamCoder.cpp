@@ -27,16 +27,20 @@
 
 #include <com/xuggle/xuggler/Global.h>
 #include <com/xuggle/xuggler/StreamCoder.h>
+#include <com/xuggle/xuggler/Container.h>
 #include <com/xuggle/xuggler/Codec.h>
 #include <com/xuggle/xuggler/Rational.h>
 #include <com/xuggle/xuggler/AudioSamples.h>
 #include <com/xuggle/xuggler/VideoPicture.h>
 #include <com/xuggle/xuggler/Packet.h>
 #include <com/xuggle/xuggler/Property.h>
+#include <com/xuggle/xuggler/PropertyHandle.h>
 #include <com/xuggle/xuggler/MetaData.h>
 
 extern "C" {
 #include <libavutil/dict.h>
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 }
 VS_LOG_SETUP(VS_CPP_PACKAGE);
 
@@ -68,6 +72,12 @@ StreamCoder::StreamCoder() :
   {
     mPtsBuffer[i] = Global::NO_PTS;
   }
+  mAudioDecodeTarget = 0;
+  mDecodeKeyFramesOnly = false;
+  mSavedSkipFrame = AVDISCARD_DEFAULT;
+  mSavedSkipIdct = AVDISCARD_DEFAULT;
+  mSavedSkipLoopFilter = AVDISCARD_DEFAULT;
+  mForceKeyFrame = false;
 }
 
 StreamCoder::~StreamCoder()
@@ -86,6 +96,251 @@ StreamCoder::resetOptions(AVCodecContext* ctx)
   av_freep(&ctx->priv_data);
 }
 
+int
+StreamCoder::getVideoBuffer(AVCodecContext* ctx, AVFrame* frame)
+{
+  if (frame->data[0])
+  {
+    VS_LOG_ERROR("asked for a buffer for a picture that already has one");
+    return -1;
+  }
+  const AVPixFmtDescriptor* desc = ctx->pix_fmt >= 0 && ctx->pix_fmt < PIX_FMT_NB
+      ? &av_pix_fmt_descriptors[ctx->pix_fmt] : 0;
+  // Leave palettes and hardware surfaces to ffmpeg; they're rare and
+  // need special set up we don't want to duplicate.
+  if (!desc
+      || (desc->flags & (PIX_FMT_PAL | PIX_FMT_PSEUDOPAL | PIX_FMT_HWACCEL))
+      || av_image_check_size(ctx->width, ctx->height, 0, ctx) < 0)
+    return avcodec_default_get_buffer(ctx, frame);
+
+  // Lay the planes out exactly as avcodec_default_get_buffer would,
+  // including the edges codecs draw around reference frames, but
+  // back them all with one IBuffer.
+  int w = ctx->width;
+  int h = ctx->height;
+  int strideAlign[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(ctx, &w, &h, strideAlign);
+  const int edge = (ctx->flags & CODEC_FLAG_EMU_EDGE) ? 0
+      : avcodec_get_edge_width();
+  w += 2 * edge;
+  h += 2 * edge;
+
+  int linesize[4];
+  int unaligned;
+  do
+  {
+    // align all planes together; some codecs assume
+    // linesize[0] == 2*linesize[1]
+    av_image_fill_linesizes(linesize, ctx->pix_fmt, w);
+    w += w & ~(w - 1);
+    unaligned = 0;
+    for (int i = 0; i < 4; i++)
+      unaligned |= linesize[i] % strideAlign[i];
+  } while (unaligned);
+
+  uint8_t* planes[4];
+  int totalSize = av_image_fill_pointers(planes, ctx->pix_fmt, h, 0, linesize);
+  if (totalSize < 0)
+    return -1;
+  int planeSize[4] = { 0, 0, 0, 0 };
+  int numPlanes = 0;
+  for (; numPlanes < 3 && planes[numPlanes + 1]; numPlanes++)
+    planeSize[numPlanes] = planes[numPlanes + 1] - planes[numPlanes];
+  planeSize[numPlanes] = totalSize - (planes[numPlanes] - planes[0]);
+  numPlanes++;
+
+  // every plane gets 16 bytes of slop for SIMD over-reads, plus
+  // enough to realign its start.
+  int32_t bufSize = strideAlign[0];
+  for (int i = 0; i < numPlanes; i++)
+    bufSize += planeSize[i] + 16 + strideAlign[i];
+
+  StreamCoder* coder = static_cast<StreamCoder*>(ctx->opaque);
+  IBuffer* buffer = IBuffer::make(coder, bufSize);
+  if (!buffer)
+    return -1;
+  uint8_t* bytes = (uint8_t*) buffer->getBytes(0, bufSize);
+  if (!bytes)
+  {
+    VS_REF_RELEASE(buffer);
+    return -1;
+  }
+
+  int hShift = 0;
+  int vShift = 0;
+  avcodec_get_chroma_sub_sample(ctx->pix_fmt, &hShift, &vShift);
+  const int pixelSize = desc->comp[0].step_minus1 + 1;
+  // edges only exist around planar YUV pictures
+  const bool hasEdges = edge && planeSize[2];
+
+  uint8_t* base = bytes;
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+  {
+    if (i >= numPlanes)
+    {
+      frame->base[i] = frame->data[i] = 0;
+      frame->linesize[i] = 0;
+      continue;
+    }
+    const int planeHShift = i == 0 ? 0 : hShift;
+    const int planeVShift = i == 0 ? 0 : vShift;
+    base = (uint8_t*) FFALIGN((uintptr_t) base, (uintptr_t) strideAlign[i]);
+    frame->base[i] = base;
+    frame->data[i] = base;
+    if (hasEdges)
+      frame->data[i] += FFALIGN((linesize[i] * edge >> planeVShift)
+          + (pixelSize * edge >> planeHShift), strideAlign[i]);
+    frame->linesize[i] = linesize[i];
+    base += planeSize[i] + 16;
+  }
+  frame->extended_data = frame->data;
+  frame->type = FF_BUFFER_TYPE_USER;
+  // this reference is given back in releaseVideoBuffer
+  frame->opaque = buffer;
+
+  if (ctx->pkt)
+  {
+    frame->pkt_pts = ctx->pkt->pts;
+    frame->pkt_pos = ctx->pkt->pos;
+  }
+  else
+  {
+    frame->pkt_pts = AV_NOPTS_VALUE;
+    frame->pkt_pos = -1;
+  }
+  frame->reordered_opaque = ctx->reordered_opaque;
+  frame->sample_aspect_ratio = ctx->sample_aspect_ratio;
+  frame->width = ctx->width;
+  frame->height = ctx->height;
+  frame->format = ctx->pix_fmt;
+  return 0;
+}
+
+void
+StreamCoder::releaseVideoBuffer(AVCodecContext* ctx, AVFrame* frame)
+{
+  if (frame->type != FF_BUFFER_TYPE_USER)
+  {
+    avcodec_default_release_buffer(ctx, frame);
+    return;
+  }
+  IBuffer* buffer = static_cast<IBuffer*>(frame->opaque);
+  frame->opaque = 0;
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+    frame->base[i] = frame->data[i] = 0;
+  // Any VideoPicture sharing this picture keeps its own reference.
+  VS_REF_RELEASE(buffer);
+}
+
+int
+StreamCoder::regetVideoBuffer(AVCodecContext* ctx, AVFrame* frame)
+{
+  // Decoders that only redraw what changed (msrle, flashsv, cinepak and
+  // the like) ask for their last picture back.  ffmpeg's default copies
+  // anything that isn't its own buffer, and handles the first picture
+  // and size changes, so we only step in for our own buffers.
+  if (frame->type != FF_BUFFER_TYPE_USER
+      || !frame->data[0]
+      || frame->width != ctx->width
+      || frame->height != ctx->height
+      || frame->format != ctx->pix_fmt)
+    return avcodec_default_reget_buffer(ctx, frame);
+
+  IBuffer* buffer = static_cast<IBuffer*>(frame->opaque);
+  if (buffer && buffer->getCurrentRefCount() <= 1)
+  {
+    // No picture we returned shares it, so the codec can draw in place.
+    if (ctx->pkt)
+    {
+      frame->pkt_pts = ctx->pkt->pts;
+      frame->pkt_pos = ctx->pkt->pos;
+    }
+    else
+    {
+      frame->pkt_pts = AV_NOPTS_VALUE;
+      frame->pkt_pos = -1;
+    }
+    frame->reordered_opaque = ctx->reordered_opaque;
+    return 0;
+  }
+
+  // A picture still holds it; the codec draws over a copy instead.
+  AVFrame old = *frame;
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+    frame->base[i] = frame->data[i] = 0;
+  frame->opaque = 0;
+  if (getVideoBuffer(ctx, frame) < 0)
+  {
+    *frame = old;
+    return -1;
+  }
+  av_picture_copy((AVPicture*)frame, (AVPicture*)&old, ctx->pix_fmt,
+      ctx->width, ctx->height);
+  releaseVideoBuffer(ctx, &old);
+  return 0;
+}
+
+int
+StreamCoder::getAudioBuffer(AVCodecContext* ctx, AVFrame* frame)
+{
+  StreamCoder* coder = static_cast<StreamCoder*>(ctx->opaque);
+  AudioSamples* samples = coder ? coder->mAudioDecodeTarget : 0;
+  const int channels = ctx->channels;
+  const int planar = av_sample_fmt_is_planar(ctx->sample_fmt);
+  int planeSize = 0;
+  const int dataSize = samples ? av_samples_get_buffer_size(&planeSize,
+      channels, frame->nb_samples, ctx->sample_fmt, 1) : -1;
+  uint8_t* outBuf = samples ? (uint8_t*) samples->getRawSamples(0) : 0;
+
+  // Only render directly when the planes we lay back to back land
+  // where ffmpeg's own allocator would put them: every plane 32-byte
+  // aligned (so the buffer starts on 32 bytes and each plane is a
+  // multiple of 32 long) and no more planes than fit in AVFrame.data.
+  // Anything else is rare enough to decode into ffmpeg's buffer and
+  // copy.
+  if (!outBuf
+      || dataSize < 0
+      || (uint32_t) dataSize > samples->getMaxBufferSize()
+      || ((uintptr_t) outBuf & 31)
+      || (planar && channels > 1
+          && (channels > AV_NUM_DATA_POINTERS || planeSize % 32)))
+    return avcodec_default_get_buffer(ctx, frame);
+
+  int retval = avcodec_fill_audio_frame(frame, channels, ctx->sample_fmt,
+      outBuf, dataSize, 1);
+  if (retval < 0)
+    return retval;
+  frame->type = FF_BUFFER_TYPE_USER;
+  frame->opaque = samples;
+  if (ctx->pkt)
+  {
+    frame->pkt_pts = ctx->pkt->pts;
+    frame->pkt_pos = ctx->pkt->pos;
+  }
+  else
+  {
+    frame->pkt_pts = AV_NOPTS_VALUE;
+    frame->pkt_pos = -1;
+  }
+  frame->reordered_opaque = ctx->reordered_opaque;
+  return 0;
+}
+
+void
+StreamCoder::releaseAudioBuffer(AVCodecContext* ctx, AVFrame* frame)
+{
+  // Audio decoders give their buffer up when avcodec_decode_audio4
+  // returns and don't call this, but be safe if one ever does.
+  if (frame->type != FF_BUFFER_TYPE_USER)
+  {
+    avcodec_default_release_buffer(ctx, frame);
+    return;
+  }
+  frame->opaque = 0;
+  for (int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+    frame->data[i] = 0;
+}
+
 void
 StreamCoder::reset()
 {
@@ -776,6 +1031,38 @@ StreamCoder::open(IMetaData* aOptions, IMetaData* aUnsetOptions)
        * an error if it changed for some reason.
        */
       AVCodec* cachedCodec = mCodecContext->codec;
+
+      // Have video decoders that can render into our memory do so;
+      // the pictures they return can then share it with no copy.
+      // Must be set before opening so frame threads pick it up.
+      // We leave thread_safe_callbacks alone since allocating an IBuffer
+      // may call into Java; ffmpeg will run these on our thread instead.
+      if (mDirection == DECODING
+          && mCodec->getAVCodec()->type == AVMEDIA_TYPE_VIDEO
+          && (mCodec->getAVCodec()->capabilities & CODEC_CAP_DR1))
+      {
+        mCodecContext->opaque = this;
+        mCodecContext->get_buffer = StreamCoder::getVideoBuffer;
+        mCodecContext->release_buffer = StreamCoder::releaseVideoBuffer;
+        mCodecContext->reget_buffer = StreamCoder::regetVideoBuffer;
+      }
+      // Likewise audio decoders can decode straight into the samples
+      // passed to decodeAudio.
+      else if (mDirection == DECODING
+          && mCodec->getAVCodec()->type == AVMEDIA_TYPE_AUDIO
+          && (mCodec->getAVCodec()->capabilities & CODEC_CAP_DR1))
+      {
+        mCodecContext->opaque = this;
+        mCodecContext->get_buffer = StreamCoder::getAudioBuffer;
+        mCodecContext->release_buffer = StreamCoder::releaseAudioBuffer;
+      }
+      else if (mCodecContext->get_buffer == StreamCoder::getVideoBuffer
+          || mCodecContext->get_buffer == StreamCoder::getAudioBuffer)
+      {
+        mCodecContext->get_buffer = avcodec_default_get_buffer;
+        mCodecContext->release_buffer = avcodec_default_release_buffer;
+        mCodecContext->reget_buffer = avcodec_default_reget_buffer;
+      }
       mCodecContext->codec = 0;
       retval = avcodec_open2(mCodecContext, mCodec->getAVCodec(), &tmp);
 
@@ -791,13 +1078,7 @@ StreamCoder::open(IMetaData* aOptions, IMetaData* aUnsetOptions)
     }
     mOpened = true;
 
-    mNumDroppedFrames = 0;
-    mSamplesCoded = mSamplesForEncoding = mLastExternallySetTimeStamp = 0;
-    mFakeCurrPts = mFakeNextPts = mLastPtsEncoded = Global::NO_PTS;
-    for(uint32_t i = 0; i < sizeof(mPtsBuffer)/sizeof(mPtsBuffer[0]); i++)
-    {
-      mPtsBuffer[i] = Global::NO_PTS;
-    }
+    resetCodingState();
 
     // Do any post open initialization here.
     if (this->getCodecType() == ICodec::CODEC_TYPE_AUDIO)
@@ -836,6 +1117,31 @@ StreamCoder::open(IMetaData* aOptions, IMetaData* aUnsetOptions)
   return retval;
 }
 
+void
+StreamCoder::resetCodingState()
+{
+  mNumDroppedFrames = 0;
+  mSamplesCoded = mSamplesForEncoding = mLastExternallySetTimeStamp = 0;
+  mFakeCurrPts = mFakeNextPts = mLastPtsEncoded = Global::NO_PTS;
+  for(uint32_t i = 0; i < sizeof(mPtsBuffer)/sizeof(mPtsBuffer[0]); i++)
+  {
+    mPtsBuffer[i] = Global::NO_PTS;
+  }
+}
+
+int32_t
+StreamCoder::flush()
+{
+  if (!mCodecContext || !mOpened)
+    return -1;
+  avcodec_flush_buffers(mCodecContext);
+  resetCodingState();
+  mBytesInFrameBuffer = 0;
+  // whoever gets this encoder next starts a new stream
+  mForceKeyFrame = mDirection == ENCODING;
+  return 0;
+}
+
 int32_t
 StreamCoder::close()
 {
@@ -938,7 +1244,11 @@ StreamCoder::decodeAudio(IAudioSamples *pOutSamples, IPacket *pPacket,
 
         avcodec_get_frame_defaults(&frame);
 
+        // If the decoder renders directly (see getAudioBuffer) it
+        // writes into samples and there is nothing left to copy.
+        mAudioDecodeTarget = samples;
         retval = avcodec_decode_audio4(mCodecContext, &frame, &got_frame, &pkt);
+        mAudioDecodeTarget = 0;
         // the API for decoding audio changed ot support planar audio and we
         // need to back-port
         if (retval >= 0 && got_frame) {
@@ -949,7 +1259,20 @@ StreamCoder::decodeAudio(IAudioSamples *pOutSamples, IPacket *pPacket,
             frame.nb_samples,
             mCodecContext->sample_fmt,
             1);
-          if (outBufSize < data_size) {
+          if (frame.type == FF_BUFFER_TYPE_USER
+              && frame.extended_data[0] == (uint8_t*)outBuf) {
+            // Decoded in place.  A decoder may return fewer samples
+            // than it asked for room for, in which case planes after
+            // the first have to slide down to sit back to back.
+            if (planar && frame.linesize[0] != plane_size) {
+              uint8_t *out = ((uint8_t*)outBuf)+plane_size;
+              for(ch = 1; ch < mCodecContext->channels; ch++) {
+                memmove(out, frame.extended_data[ch], plane_size);
+                out += plane_size;
+              }
+            }
+            outBufSize = data_size;
+          } else if (outBufSize < data_size) {
             VS_LOG_ERROR("Output buffer is not large enough; no audio actually returned");
             outBufSize = 0;
           } else {
@@ -1104,6 +1427,10 @@ StreamCoder::decodeVideo(IVideoPicture *pOutFrame, IPacket *pPacket,
     VS_LOG_WARN("Attempting to decode when not ready; codec set is not a video codec");
     return retval;
   }
+  if (mDecodeKeyFramesOnly && packet->getSize() > byteOffset
+      && !packet->isKeyPacket())
+    // drop it before the decoder ever sees it
+    return packet->getSize() - byteOffset;
 
   AVFrame *avFrame = avcodec_alloc_frame();
   if (avFrame)
@@ -1115,13 +1442,22 @@ StreamCoder::decodeVideo(IVideoPicture *pOutFrame, IPacket *pPacket,
 
     inBufSize = packet->getSize() - byteOffset;
 
-    VS_ASSERT(buffer, "no buffer in packet?");
-    if (buffer)
+    if (buffer && inBufSize > 0)
       inBuf = (uint8_t*) buffer->getBytes(byteOffset, inBufSize);
 
-    VS_ASSERT(inBuf, "incorrect size or no data in packet");
+    // Decoders with delay (including any using frame threading) need
+    // empty packets at the end of a stream to give up the pictures
+    // they are holding on to.
+    bool flushing = !inBuf
+        && ((mCodecContext->codec->capabilities & CODEC_CAP_DELAY)
+            || (mCodecContext->active_thread_type & FF_THREAD_FRAME));
+    if (!flushing)
+    {
+      VS_ASSERT(buffer, "no buffer in packet?");
+      VS_ASSERT(inBuf, "incorrect size or no data in packet");
+    }
 
-    if (inBufSize > 0 && inBuf)
+    if ((inBufSize > 0 && inBuf) || flushing)
     {
       VS_LOG_TRACE("Attempting decodeVideo(%p, %p, %d, %p, %d);",
           mCodecContext,
@@ -1135,7 +1471,7 @@ StreamCoder::decodeVideo(IVideoPicture *pOutFrame, IPacket *pPacket,
         pkt = *packet->getAVPacket();
       // copy in our buffer
       pkt.data = inBuf;
-      pkt.size = inBufSize;
+      pkt.size = inBuf ? inBufSize : 0;
 
       mCodecContext->reordered_opaque = packet->getPts();
       retval = avcodec_decode_video2(mCodecContext, avFrame, &frameFinished,
@@ -1149,20 +1485,45 @@ StreamCoder::decodeVideo(IVideoPicture *pOutFrame, IPacket *pPacket,
           inBufSize);
       if (frameFinished)
       {
-        // copy FFMPEG's buffer into our buffer; don't try to get efficient
-        // and reuse the buffer FFMPEG is using; in order to allow our
-        // buffers to be thread safe, we must do a copy here.
-        frame->copyAVFrame(avFrame, getPixelType(), getWidth(), getHeight());
+        // If ffmpeg decoded into one of our own buffers (see
+        // getVideoBuffer) the picture just takes a reference to it.
+        // Otherwise ffmpeg's internal buffers are not thread safe, so we
+        // must copy them into our own buffer.
+        IBuffer* decoded = 0;
+        if (avFrame->type == FF_BUFFER_TYPE_USER
+            && mCodecContext->get_buffer == StreamCoder::getVideoBuffer
+            && avFrame->width == getWidth()
+            && avFrame->height == getHeight()
+            && avFrame->format == (int) getPixelType())
+        {
+          decoded = static_cast<IBuffer*>(avFrame->opaque);
+          int32_t decodedSize = decoded ? decoded->getBufferSize() : 0;
+          uint8_t* bytes = decoded ?
+              (uint8_t*) decoded->getBytes(0, decodedSize) : 0;
+          if (!bytes || avFrame->data[0] < bytes
+              || avFrame->data[0] >= bytes + decodedSize)
+            decoded = 0;
+        }
+        if (decoded)
+          frame->shareAVFrame(avFrame, decoded, getPixelType(), getWidth(),
+              getHeight());
+        else
+          frame->copyAVFrame(avFrame, getPixelType(), getWidth(), getHeight());
         RefPointer<IRational> timeBase = 0;
         timeBase = this->mStream ? this->mStream->getTimeBase() : 0;
         if (!timeBase)
           timeBase = this->getTimeBase();
 
+        // With frame threading or B-frame delay, the picture returned
+        // may have come from an earlier packet than the one we passed in,
+        // so only use timestamps the decoder carried along with the
+        // picture, never the ones on the current packet.
         int64_t packetTs = avFrame->reordered_opaque;
-        // if none, assume this packet's decode time, since
-        // it's presentation time should have been in reordered_opaque
+        // if none, assume the decode time of the packet this picture
+        // came from, since it's presentation time should have been in
+        // reordered_opaque
         if (packetTs == Global::NO_PTS)
-          packetTs = packet->getDts();
+          packetTs = avFrame->pkt_dts;
 
         if (packetTs != Global::NO_PTS)
         {
@@ -1177,8 +1538,8 @@ StreamCoder::decodeVideo(IVideoPicture *pOutFrame, IPacket *pPacket,
             // See: http://code.google.com/p/xuggle/issues/detail?id=165
             // in this way we enforce that timestamps are always
             // increasing
-            if (nextPts < mFakeNextPts && packet->getPts() != Global::NO_PTS)
-              nextPts = mFakePtsTimeBase->rescale(packet->getPts(),
+            if (nextPts < mFakeNextPts && avFrame->pkt_pts != Global::NO_PTS)
+              nextPts = mFakePtsTimeBase->rescale(avFrame->pkt_pts,
                   timeBase.value());
             mFakeNextPts = nextPts;
           }
@@ -1337,6 +1698,12 @@ StreamCoder::encodeVideo(IPacket *pOutPacket, IVideoPicture *pFrame,
 
         if (!dropFrame)
         {
+          if (avFrame && mForceKeyFrame)
+          {
+            avFrame->pict_type = AV_PICTURE_TYPE_I;
+            avFrame->key_frame = 1;
+            mForceKeyFrame = false;
+          }
           VS_LOG_TRACE("Attempting encodeVideo(%p, %p, %d, %p)",
               mCodecContext,
               buf,
@@ -1524,10 +1891,14 @@ StreamCoder::encodeAudio(IPacket * pOutPacket, IAudioSamples* pSamples,
      * NULL as the pInSamples, and we just silently drop the incomplete
      * frame.
      *
-     * To simplify coding here (and hence open for optimization if
-     * this ends up being a bottleneck), I always copy audio samples
-     * into a frame buffer, and then only encode from the frame buffer
-     * in this class.
+     * Copying is only needed for frames that straddle two calls.  If
+     * nothing is cached and the caller has at least a whole frame, we
+     * encode straight out of the caller's samples; otherwise we copy
+     * into our frame buffer until it holds a whole frame.  So a caller
+     * that hands us big buffers only ever has the trailing partial
+     * frame of each buffer (and the start of the next that completes
+     * it) copied.  StreamCoderTest checks both routes produce the
+     * same packets.
      */
     frameSize = getAudioFrameSize();
     frameBytes = frameSize * bytesPerSample;
@@ -1557,6 +1928,7 @@ StreamCoder::encodeAudio(IPacket * pOutPacket, IAudioSamples* pSamples,
     {
       if (availableSamples >= frameSize && mBytesInFrameBuffer == 0)
       {
+        // whole frame, nothing cached: no copy
         VS_LOG_TRACE("audioEncode: Using passed in buffer: %d, %d, %d",
             availableSamples, frameSize, mBytesInFrameBuffer);
         frameBuffer = (unsigned char*) avSamples;
@@ -1970,6 +2342,12 @@ StreamCoder::getPropertyAsBoolean(const char *aName)
   return Property::getPropertyAsBoolean(mCodecContext, aName);
 }
 
+IPropertyHandle*
+StreamCoder::getPropertyHandle(const char *aName)
+{
+  return PropertyHandle::make(this, (void**)&mCodecContext, aName);
+}
+
 bool
 StreamCoder::isOpen()
 {
@@ -2107,6 +2485,160 @@ StreamCoder :: setStandardsCompliance(CodecStandardsCompliance compliance)
   mCodecContext->strict_std_compliance = compliance;
   return 0;
 }
+
+int32_t
+StreamCoder :: setNumThreads(int32_t numThreads)
+{
+  if (!mCodecContext || mOpened || numThreads < 0)
+    return -1;
+  mCodecContext->thread_count = numThreads;
+  return 0;
+}
+
+int32_t
+StreamCoder :: getNumThreads()
+{
+  return mCodecContext ? mCodecContext->thread_count : 1;
+}
+
+int32_t
+StreamCoder :: setThreadType(ThreadType type)
+{
+  if (!mCodecContext || mOpened)
+    return -1;
+  mCodecContext->thread_type = type & (FF_THREAD_FRAME|FF_THREAD_SLICE);
+  return 0;
+}
+
+IStreamCoder::ThreadType
+StreamCoder :: getThreadType()
+{
+  if (mCodecContext)
+    return (ThreadType) mCodecContext->thread_type;
+  return THREAD_TYPE_NONE;
+}
+
+IStreamCoder::ThreadType
+StreamCoder :: getActiveThreadType()
+{
+  if (mCodecContext && mOpened)
+    return (ThreadType) mCodecContext->active_thread_type;
+  return THREAD_TYPE_NONE;
+}
+
+void
+StreamCoder :: setDecodeKeyFramesOnly(bool value)
+{
+  if (!mCodecContext || value == mDecodeKeyFramesOnly)
+    return;
+  if (value)
+  {
+    mSavedSkipFrame = mCodecContext->skip_frame;
+    mSavedSkipIdct = mCodecContext->skip_idct;
+    mSavedSkipLoopFilter = mCodecContext->skip_loop_filter;
+    mCodecContext->skip_frame = AVDISCARD_NONKEY;
+    mCodecContext->skip_idct = AVDISCARD_NONKEY;
+    mCodecContext->skip_loop_filter = AVDISCARD_ALL;
+  }
+  else
+  {
+    mCodecContext->skip_frame = mSavedSkipFrame;
+    mCodecContext->skip_idct = mSavedSkipIdct;
+    mCodecContext->skip_loop_filter = mSavedSkipLoopFilter;
+  }
+  mDecodeKeyFramesOnly = value;
+}
+
+bool
+StreamCoder :: getDecodeKeyFramesOnly()
+{
+  return mDecodeKeyFramesOnly;
+}
+
+int32_t
+StreamCoder :: decodeVideoKeyFrame(IVideoPicture* pOutFrame, int64_t timeStamp)
+{
+  int32_t retval = -1;
+  VideoPicture* frame = dynamic_cast<VideoPicture*> (pOutFrame);
+  if (!frame) {
+    VS_LOG_WARN("Attempting to decode keyframe when not ready; no frame");
+    return retval;
+  }
+  if (!mOpened || mDirection != DECODING
+      || getCodecType() != ICodec::CODEC_TYPE_VIDEO) {
+    VS_LOG_WARN("Attempting to decode keyframe when not ready; not an open video decoder");
+    return retval;
+  }
+  RefPointer<IContainer> iContainer = mStream ? mStream->getContainer() : 0;
+  Container* container = dynamic_cast<Container*> (iContainer.value());
+  AVFormatContext* formatContext = container ?
+      container->getFormatContext() : 0;
+  if (!formatContext || container->getType() != IContainer::READ) {
+    VS_LOG_WARN("Attempting to decode keyframe when not ready; stream is not in a container being read");
+    return retval;
+  }
+  int32_t streamIndex = mStream->getIndex();
+
+  // Let the demuxer drop what it can before we even see it: every other
+  // stream, and (if it knows how) this stream's non-keyframes.
+  std::vector<enum AVDiscard> discards(formatContext->nb_streams);
+  for(uint32_t i = 0; i < formatContext->nb_streams; i++)
+  {
+    AVStream* stream = formatContext->streams[i];
+    discards[i] = stream->discard;
+    stream->discard = (int32_t)i == streamIndex ? AVDISCARD_NONKEY :
+        AVDISCARD_ALL;
+  }
+  bool keyFramesOnly = mDecodeKeyFramesOnly;
+  setDecodeKeyFramesOnly(true);
+
+  frame->setComplete(false, IPixelFormat::NONE, -1, -1, Global::NO_PTS);
+  retval = container->seekKeyFrame(streamIndex, timeStamp,
+      IContainer::SEEK_FLAG_BACKWARDS);
+  if (retval >= 0)
+  {
+    // Decoders that hold pictures back give them up on empty packets
+    bool canDrain = (mCodecContext->codec->capabilities & CODEC_CAP_DELAY)
+        || (mCodecContext->active_thread_type & FF_THREAD_FRAME);
+    RefPointer<IPacket> packet = IPacket::make();
+    RefPointer<IPacket> emptyPacket = IPacket::make();
+    while (packet && emptyPacket && !frame->isComplete())
+    {
+      retval = container->readNextPacket(packet.value());
+      if (retval < 0)
+        break;
+      if (packet->getStreamIndex() != streamIndex || !packet->isKeyPacket())
+        continue;
+
+      flush();
+      int32_t offset = 0;
+      while (offset < packet->getSize() && !frame->isComplete())
+      {
+        int32_t bytesDecoded = decodeVideo(frame, packet.value(), offset);
+        if (bytesDecoded <= 0)
+          // a damaged keyframe; try the next one
+          break;
+        offset += bytesDecoded;
+      }
+      for(int32_t i = 0; canDrain && !frame->isComplete()
+          && i <= MAX_REORDER_DELAY + mCodecContext->thread_count; i++)
+        if (decodeVideo(frame, emptyPacket.value(), 0) < 0)
+          break;
+    }
+    // and leave nothing half decoded behind for the next caller
+    flush();
+  }
+
+  for(uint32_t i = 0; i < formatContext->nb_streams && i < discards.size(); i++)
+    formatContext->streams[i]->discard = discards[i];
+  setDecodeKeyFramesOnly(keyFramesOnly);
+
+  if (frame->isComplete())
+    retval = 0;
+  else if (retval >= 0)
+    retval = -1;
+  return retval;
+}
 }
 }
 }
@@ -30,6 +30,7 @@
 namespace com { namespace xuggle { namespace xuggler
 {
   class Packet;
+  class AudioSamples;
 
   class StreamCoder : public IStreamCoder
   {
@@ -176,6 +177,36 @@ namespace com { namespace xuggle { namespace xuggler
     virtual int32_t open(IMetaData *options, IMetaData* unsetOptions);
     virtual int32_t setProperty(IMetaData* valuesToSet, IMetaData* valuesNotFound);
 
+    virtual int32_t setNumThreads(int32_t numThreads);
+    virtual int32_t getNumThreads();
+    virtual int32_t setThreadType(ThreadType type);
+    virtual ThreadType getThreadType();
+    virtual ThreadType getActiveThreadType();
+    virtual void setDecodeKeyFramesOnly(bool value);
+    virtual bool getDecodeKeyFramesOnly();
+    virtual int32_t decodeVideoKeyFrame(IVideoPicture* pOutFrame,
+        int64_t timeStamp);
+    virtual IPropertyHandle* getPropertyHandle(const char* name);
+
+    /**
+     * Throw away anything buffered inside an open coder and reset
+     * our time stamp bookkeeping, leaving the coder open and ready
+     * for a new, unrelated stream of data.  Much cheaper than a
+     * close() and open() pair.
+     * <p>
+     * FFmpeg cannot discard frames an encoder is still holding, so
+     * drain encoders (encode null until no more packets come out)
+     * before flushing them.  The next picture a flushed encoder gets
+     * is coded as a keyframe; rate control state the encoder keeps
+     * internally still carries over.
+     * </p>
+     * @return >= 0 on success; <0 if the coder is not open.
+     */
+    int32_t flush();
+
+    // Not for calling from Java
+    AVCodecContext* getCodecContext() { return mCodecContext; }
+
   protected:
     StreamCoder();
     virtual ~StreamCoder();
@@ -202,8 +233,19 @@ namespace com { namespace xuggle { namespace xuggler
     int64_t mNumDroppedFrames;
     bool mAutomaticallyStampPacketsForStream;
     int64_t mPtsBuffer[MAX_REORDER_DELAY+1];
+    // The samples decodeAudio is decoding into right now; only valid
+    // during a decodeAudio call.  Not refcounted.
+    AudioSamples* mAudioDecodeTarget;
+    bool mDecodeKeyFramesOnly;
+    // what the skip settings were before decoding only keyframes
+    enum AVDiscard mSavedSkipFrame;
+    enum AVDiscard mSavedSkipIdct;
+    enum AVDiscard mSavedSkipLoopFilter;
+    // set by flush() so an encoder's next picture is a keyframe
+    bool mForceKeyFrame;
     
     void reset();
+    void resetCodingState();
     void setPacketParameters(Packet *packet, int32_t size,
         int64_t dts,
         IRational * timebase,
@@ -221,6 +263,27 @@ namespace com { namespace xuggle { namespace xuggler
         AVCodecContext *avContext,
         AVCodec *avCodec);
     static void resetOptions(AVCodecContext*);
+
+    /**
+     * get_buffer/release_buffer callbacks we install on video
+     * decoders that support direct rendering.  Each picture ffmpeg
+     * decodes lands in a refcounted IBuffer (held in AVFrame::opaque)
+     * that the resulting VideoPicture can share instead of copying.
+     * reget_buffer hands a codec that redraws its last picture a copy
+     * whenever a VideoPicture still shares that picture's IBuffer.
+     */
+    static int getVideoBuffer(AVCodecContext*, AVFrame*);
+    static void releaseVideoBuffer(AVCodecContext*, AVFrame*);
+    static int regetVideoBuffer(AVCodecContext*, AVFrame*);
+
+    /**
+     * get_buffer/release_buffer callbacks we install on audio
+     * decoders that support direct rendering.  ffmpeg decodes straight
+     * into the IAudioSamples passed to decodeAudio, in the same layout
+     * (planes back to back for planar formats) we used to copy into.
+     */
+    static int getAudioBuffer(AVCodecContext*, AVFrame*);
+    static void releaseAudioBuffer(AVCodecContext*, AVFrame*);
   };
 
 }}}
@@ -0,0 +1,289 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstdio>
+#include <stdexcept>
+
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/xuggler/StreamCoderPool.h>
+#include <com/xuggle/xuggler/StreamCoder.h>
+#include <com/xuggle/xuggler/MetaData.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace com { namespace xuggle { namespace xuggler
+{
+using namespace com::xuggle::ferry;
+
+StreamCoderPool :: StreamCoderPool()
+{
+  mMaxIdleCoders = 0;
+  mHits = 0;
+  mMisses = 0;
+  mEvictions = 0;
+}
+
+StreamCoderPool :: ~StreamCoderPool()
+{
+  clear();
+  // coders still checked out belong to their callers now
+  mCheckedOut.clear();
+}
+
+StreamCoderPool*
+StreamCoderPool :: make(int32_t maxIdleCoders)
+{
+  if (maxIdleCoders < 0)
+    return 0;
+  StreamCoderPool* retval = make();
+  if (retval)
+    retval->mMaxIdleCoders = maxIdleCoders;
+  return retval;
+}
+
+static void
+StreamCoderPool_addOptions(std::string& key, void* obj)
+{
+  // obj must start with an AVClass*; codecs without private options
+  // leave priv_data null or classless
+  if (!obj || !*(const AVClass**)obj)
+    return;
+  const AVOption* option = 0;
+  while((option = av_opt_next(obj, option)))
+  {
+    if (option->type == AV_OPT_TYPE_CONST)
+      continue;
+    uint8_t* value = 0;
+    if (av_opt_get(obj, option->name, 0, &value) < 0 || !value)
+      continue;
+    key += '|';
+    key += option->name;
+    key += '=';
+    key += (const char*)value;
+    av_free(value);
+  }
+}
+
+std::string
+StreamCoderPool :: makeKey(StreamCoder* prototype, IMetaData* aOptions)
+{
+  AVCodecContext* ctx = prototype->getCodecContext();
+  RefPointer<ICodec> codec = prototype->getCodec();
+  if (!ctx || !codec)
+    throw std::runtime_error("prototype coder has no codec");
+
+  // FNV-1a of the extra data; decoders like h264 need it to match
+  uint64_t extraHash = 14695981039346656037ULL;
+  for(int i = 0; ctx->extradata && i < ctx->extradata_size; i++)
+    extraHash = (extraHash ^ ctx->extradata[i]) * 1099511628211ULL;
+
+  // what isn't an AVOption; everything else, including settings made
+  // with setProperty, comes from the codec's options below
+  char buf[256];
+  snprintf(buf, sizeof(buf),
+      "%d|%d|%d|%dx%d|%d|%d|%d|%d|%d/%d|%d|%llx|",
+      (int)prototype->getDirection(),
+      (int)codec->getID(),
+      ctx->codec_tag,
+      ctx->width, ctx->height,
+      (int)ctx->pix_fmt,
+      ctx->sample_rate,
+      ctx->channels,
+      (int)ctx->sample_fmt,
+      ctx->time_base.num, ctx->time_base.den,
+      ctx->extradata_size,
+      (unsigned long long)extraHash);
+  std::string key(buf);
+  // the codec name too, since several codecs can share an id
+  key += codec->getName();
+  StreamCoderPool_addOptions(key, ctx);
+  StreamCoderPool_addOptions(key, ctx->priv_data);
+
+  MetaData* options = dynamic_cast<MetaData*>(aOptions);
+  AVDictionary* dict = options ? options->getDictionary() : 0;
+  AVDictionaryEntry* entry = 0;
+  key += "|options";
+  while(dict && (entry = av_dict_get(dict, "", entry, AV_DICT_IGNORE_SUFFIX)))
+  {
+    key += '|';
+    key += entry->key;
+    key += '=';
+    key += entry->value;
+  }
+  return key;
+}
+
+IStreamCoder*
+StreamCoderPool :: getCoder(IStreamCoder* aPrototype, IMetaData* options)
+{
+  StreamCoder* prototype = dynamic_cast<StreamCoder*>(aPrototype);
+  RefPointer<StreamCoder> retval;
+  std::string key;
+  try
+  {
+    if (!prototype)
+      throw std::runtime_error("no prototype coder");
+    key = makeKey(prototype, options);
+
+    {
+      SpinMutex::Guard guard(mLock);
+      for(std::list<Entry>::iterator it = mIdle.begin(); it != mIdle.end(); ++it)
+      {
+        if (it->first == key)
+        {
+          retval = it->second;
+          mIdle.erase(it);
+          break;
+        }
+      }
+      if (retval)
+      {
+        ++mHits;
+        mCheckedOut[retval.value()] = Entry(key, retval);
+      }
+      else
+        ++mMisses;
+    }
+
+    if (!retval)
+    {
+      // open outside the lock; it's the slow part
+      retval = StreamCoder::make(prototype->getDirection(), prototype);
+      if (!retval)
+        throw std::bad_alloc();
+      if (retval->open(options, 0) < 0)
+        throw std::runtime_error("could not open coder");
+      SpinMutex::Guard guard(mLock);
+      mCheckedOut[retval.value()] = Entry(key, retval);
+    }
+  }
+  catch (std::bad_alloc & e)
+  {
+    throw e;
+  }
+  catch (std::exception & e)
+  {
+    VS_LOG_DEBUG("Error: %s", e.what());
+    retval = 0;
+  }
+  return retval.get();
+}
+
+void
+StreamCoderPool :: returnCoder(IStreamCoder* aCoder)
+{
+  RefPointer<StreamCoder> coder = dynamic_cast<StreamCoder*>(aCoder);
+  if (!coder)
+    return;
+  // take a reference for ourselves; the caller still owns theirs
+  coder->acquire();
+
+  std::string key;
+  bool known = false;
+  {
+    SpinMutex::Guard guard(mLock);
+    std::map<StreamCoder*, Entry>::iterator found =
+      mCheckedOut.find(coder.value());
+    if (found != mCheckedOut.end())
+    {
+      // erasing drops our checked-out reference; coder still holds one
+      key = found->second.first;
+      mCheckedOut.erase(found);
+      known = true;
+    }
+  }
+
+  if (!known || !coder->isOpen() || coder->flush() < 0 || !mMaxIdleCoders)
+  {
+    if (known)
+      coder->close();
+    return;
+  }
+
+  // build the entry outside the lock and splice it in, which can't throw
+  std::list<Entry> returned(1, Entry(key, coder));
+  RefPointer<StreamCoder> evicted;
+  {
+    SpinMutex::Guard guard(mLock);
+    mIdle.splice(mIdle.begin(), returned);
+    if ((int32_t)mIdle.size() > mMaxIdleCoders)
+    {
+      evicted = mIdle.back().second;
+      mIdle.pop_back();
+      ++mEvictions;
+    }
+  }
+  if (evicted)
+    evicted->close();
+}
+
+void
+StreamCoderPool :: clear()
+{
+  std::list<Entry> idle;
+  mLock.lock();
+  idle.swap(mIdle);
+  mLock.unlock();
+  for(std::list<Entry>::iterator it = idle.begin(); it != idle.end(); ++it)
+    it->second->close();
+}
+
+int32_t
+StreamCoderPool :: getNumIdleCoders()
+{
+  mLock.lock();
+  int32_t retval = (int32_t)mIdle.size();
+  mLock.unlock();
+  return retval;
+}
+
+int32_t
+StreamCoderPool :: getMaxIdleCoders()
+{
+  return mMaxIdleCoders;
+}
+
+int64_t
+StreamCoderPool :: getHits()
+{
+  mLock.lock();
+  int64_t retval = mHits;
+  mLock.unlock();
+  return retval;
+}
+
+int64_t
+StreamCoderPool :: getMisses()
+{
+  mLock.lock();
+  int64_t retval = mMisses;
+  mLock.unlock();
+  return retval;
+}
+
+int64_t
+StreamCoderPool :: getEvictions()
+{
+  mLock.lock();
+  int64_t retval = mEvictions;
+  mLock.unlock();
+  return retval;
+}
+
+}}}
@@ -0,0 +1,143 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef STREAMCODERPOOL_H_
+#define STREAMCODERPOOL_H_
+
+#include <list>
+#include <map>
+#include <string>
+
+#include <com/xuggle/ferry/RefPointer.h>
+#include <com/xuggle/ferry/SpinMutex.h>
+#include <com/xuggle/xuggler/IStreamCoder.h>
+#include <com/xuggle/xuggler/IMetaData.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+  class StreamCoder;
+
+  /**
+   * Internal Only.
+   * <p>
+   * A pool of open, idle {@link IStreamCoder} objects.
+   * </p><p>
+   * Opening a coder (and especially an encoder like libx264 with
+   * lookahead) can cost more than coding a short clip with it.  Rather
+   * than closing a coder when done, return it to the pool: it is
+   * flushed (see StreamCoder#flush()) and kept open, and the next
+   * request for a coder with the same codec, direction, dimensions,
+   * pixel and sample formats, time base, extra data, codec options
+   * (everything settable with setProperty) and open options gets it
+   * back without another avcodec_open2().  A reused encoder codes its
+   * next picture as a keyframe.
+   * </p><p>
+   * Coders handed out by the pool are not attached to any stream.
+   * A pool is safe to share between threads.
+   * </p>
+   */
+  class VS_API_XUGGLER StreamCoderPool : public com::xuggle::ferry::RefCounted
+  {
+    VS_JNIUTILS_REFCOUNTED_OBJECT_PRIVATE_MAKE(StreamCoderPool);
+  public:
+    /**
+     * Create a pool.
+     * @param maxIdleCoders the most idle coders to keep open; when
+     *   more are returned the least recently used are closed.
+     * @return a new pool, or null if maxIdleCoders < 0.
+     */
+    static StreamCoderPool* make(int32_t maxIdleCoders);
+
+    /**
+     * Get an open coder set up like prototype.
+     * @param prototype a coder (open or not) with the codec and settings
+     *   you want; it is only read.
+     * @param options options to open a new coder with, or null.  These
+     *   are part of the key, so coders opened with different options
+     *   are never mixed up.
+     * @return an open coder the caller now owns a reference to, or null
+     *   if one could not be opened.  The pool also keeps a reference
+     *   until the coder is returned with #returnCoder or the pool is
+     *   destroyed, so a coder that is never returned stays open until
+     *   then.
+     */
+    IStreamCoder* getCoder(IStreamCoder* prototype, IMetaData* options);
+
+    /**
+     * Hand a coder got from #getCoder back to the pool.  The caller
+     * should drop its reference afterwards and must not use it again.
+     * <p>
+     * Encoders must be drained first; see StreamCoder#flush().
+     * Coders not from this pool, or that were closed, are ignored.
+     * </p>
+     * @param coder the coder to return.
+     */
+    void returnCoder(IStreamCoder* coder);
+
+    /**
+     * Close all idle coders.
+     */
+    void clear();
+
+    /**
+     * @return the number of idle coders in the pool.
+     */
+    int32_t getNumIdleCoders();
+    /**
+     * @return the maximum number of idle coders the pool keeps.
+     */
+    int32_t getMaxIdleCoders();
+    /**
+     * @return the number of #getCoder calls satisfied from the pool.
+     */
+    int64_t getHits();
+    /**
+     * @return the number of #getCoder calls that had to open a coder.
+     */
+    int64_t getMisses();
+    /**
+     * @return the number of idle coders closed to make room.
+     */
+    int64_t getEvictions();
+
+  protected:
+    StreamCoderPool();
+    virtual ~StreamCoderPool();
+
+  private:
+    typedef std::pair<std::string,
+        com::xuggle::ferry::RefPointer<StreamCoder> > Entry;
+
+    static std::string makeKey(StreamCoder* prototype, IMetaData* options);
+
+    com::xuggle::ferry::SpinMutex mLock;
+    int32_t mMaxIdleCoders;
+    // most recently returned at the front
+    std::list<Entry> mIdle;
+    // coders we've handed out, with their keys; we hold a reference so
+    // a freed coder's address can't be mistaken for one of ours
+    std::map<StreamCoder*, Entry> mCheckedOut;
+    int64_t mHits;
+    int64_t mMisses;
+    int64_t mEvictions;
+  };
+
+}}}
+
+#endif /*STREAMCODERPOOL_H_*/
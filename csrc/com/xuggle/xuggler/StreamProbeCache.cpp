@@ -0,0 +1,340 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstring>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/ferry/SpinMutex.h>
+#include <com/xuggle/xuggler/StreamProbeCache.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+using namespace com::xuggle::ferry;
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  namespace {
+    struct StreamState
+    {
+      int id;
+      AVRational timeBase;
+      AVRational rFrameRate;
+      AVRational avgFrameRate;
+      AVRational sampleAspectRatio;
+      int64_t startTime;
+      int64_t duration;
+      int64_t numFrames;
+
+      enum AVMediaType codecType;
+      enum CodecID codecId;
+      unsigned int codecTag;
+      int bitRate;
+      AVRational codecTimeBase;
+      int ticksPerFrame;
+      int width;
+      int height;
+      int codedWidth;
+      int codedHeight;
+      enum PixelFormat pixFmt;
+      AVRational codecSampleAspectRatio;
+      int hasBFrames;
+      int sampleRate;
+      int channels;
+      uint64_t channelLayout;
+      enum AVSampleFormat sampleFmt;
+      int frameSize;
+      int blockAlign;
+      int bitsPerCodedSample;
+      int bitsPerRawSample;
+      int profile;
+      int level;
+      std::vector<uint8_t> extradata;
+    };
+
+    struct Entry
+    {
+      std::string url;
+      int64_t size;
+      int64_t mtime;
+      std::string format;
+      int64_t startTime;
+      int64_t duration;
+      int bitRate;
+      std::vector<StreamState> streams;
+    };
+  }
+
+  static SpinMutex sStreamProbeCacheLock;
+  // most recently used first
+  static std::list<Entry> sStreamProbeCacheEntries;
+
+  /**
+   * Find the size and modification time, in nanoseconds where the
+   * platform keeps them, of the file url names.
+   * @return false if url isn't a file we can stat.
+   */
+  static bool
+  StreamProbeCache_getKey(const char* url, AVFormatContext* context,
+      int64_t* size, int64_t* mtime)
+  {
+    if (!url || !*url || !context || !context->iformat || !context->pb)
+      return false;
+    if (context->iformat->flags & AVFMT_NOFILE)
+      return false;
+    const char* path = url;
+    if (!strncmp(path, "file:", 5))
+      path += 5;
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISREG(info.st_mode))
+      return false;
+    *size = avio_size(context->pb);
+    if (*size < 0 || *size != (int64_t)info.st_size)
+      return false;
+    // whole seconds would miss a same-size rewrite within a second
+#if defined(_WIN32)
+    *mtime = (int64_t)info.st_mtime * 1000000000LL;
+#elif defined(__APPLE__)
+    *mtime = (int64_t)info.st_mtimespec.tv_sec * 1000000000LL +
+        info.st_mtimespec.tv_nsec;
+#else
+    *mtime = (int64_t)info.st_mtim.tv_sec * 1000000000LL +
+        info.st_mtim.tv_nsec;
+#endif
+    return true;
+  }
+
+  static void
+  StreamProbeCache_save(StreamState& state, const AVStream* stream)
+  {
+    const AVCodecContext* codec = stream->codec;
+    state.id = stream->id;
+    state.timeBase = stream->time_base;
+    state.rFrameRate = stream->r_frame_rate;
+    state.avgFrameRate = stream->avg_frame_rate;
+    state.sampleAspectRatio = stream->sample_aspect_ratio;
+    state.startTime = stream->start_time;
+    state.duration = stream->duration;
+    state.numFrames = stream->nb_frames;
+
+    state.codecType = codec->codec_type;
+    state.codecId = codec->codec_id;
+    state.codecTag = codec->codec_tag;
+    state.bitRate = codec->bit_rate;
+    state.codecTimeBase = codec->time_base;
+    state.ticksPerFrame = codec->ticks_per_frame;
+    state.width = codec->width;
+    state.height = codec->height;
+    state.codedWidth = codec->coded_width;
+    state.codedHeight = codec->coded_height;
+    state.pixFmt = codec->pix_fmt;
+    state.codecSampleAspectRatio = codec->sample_aspect_ratio;
+    state.hasBFrames = codec->has_b_frames;
+    state.sampleRate = codec->sample_rate;
+    state.channels = codec->channels;
+    state.channelLayout = codec->channel_layout;
+    state.sampleFmt = codec->sample_fmt;
+    state.frameSize = codec->frame_size;
+    state.blockAlign = codec->block_align;
+    state.bitsPerCodedSample = codec->bits_per_coded_sample;
+    state.bitsPerRawSample = codec->bits_per_raw_sample;
+    state.profile = codec->profile;
+    state.level = codec->level;
+    if (codec->extradata && codec->extradata_size > 0)
+      state.extradata.assign(codec->extradata,
+          codec->extradata + codec->extradata_size);
+    else
+      state.extradata.clear();
+  }
+
+  /**
+   * @return true if what the demuxer put in stream when it read the header
+   *   agrees with state.
+   */
+  static bool
+  StreamProbeCache_matches(const StreamState& state, const AVStream* stream)
+  {
+    const AVCodecContext* codec = stream->codec;
+    if (stream->id != state.id)
+      return false;
+    if (codec->codec_type != AVMEDIA_TYPE_UNKNOWN &&
+        codec->codec_type != state.codecType)
+      return false;
+    if (codec->codec_id != CODEC_ID_NONE && codec->codec_id != state.codecId)
+      return false;
+    return true;
+  }
+
+  static bool
+  StreamProbeCache_restore(const StreamState& state, AVStream* stream)
+  {
+    AVCodecContext* codec = stream->codec;
+    uint8_t* extradata = 0;
+    if (!state.extradata.empty())
+    {
+      extradata = (uint8_t*)av_mallocz(state.extradata.size() +
+          FF_INPUT_BUFFER_PADDING_SIZE);
+      if (!extradata)
+        return false;
+      memcpy(extradata, &state.extradata[0], state.extradata.size());
+    }
+    av_free(codec->extradata);
+    codec->extradata = extradata;
+    codec->extradata_size = state.extradata.size();
+
+    stream->time_base = state.timeBase;
+    stream->r_frame_rate = state.rFrameRate;
+    stream->avg_frame_rate = state.avgFrameRate;
+    stream->sample_aspect_ratio = state.sampleAspectRatio;
+    stream->start_time = state.startTime;
+    stream->duration = state.duration;
+    stream->nb_frames = state.numFrames;
+
+    codec->codec_type = state.codecType;
+    codec->codec_id = state.codecId;
+    codec->codec_tag = state.codecTag;
+    codec->bit_rate = state.bitRate;
+    codec->time_base = state.codecTimeBase;
+    codec->ticks_per_frame = state.ticksPerFrame;
+    codec->width = state.width;
+    codec->height = state.height;
+    codec->coded_width = state.codedWidth;
+    codec->coded_height = state.codedHeight;
+    codec->pix_fmt = state.pixFmt;
+    codec->sample_aspect_ratio = state.codecSampleAspectRatio;
+    codec->has_b_frames = state.hasBFrames;
+    codec->sample_rate = state.sampleRate;
+    codec->channels = state.channels;
+    codec->channel_layout = state.channelLayout;
+    codec->sample_fmt = state.sampleFmt;
+    codec->frame_size = state.frameSize;
+    codec->block_align = state.blockAlign;
+    codec->bits_per_coded_sample = state.bitsPerCodedSample;
+    codec->bits_per_raw_sample = state.bitsPerRawSample;
+    codec->profile = state.profile;
+    codec->level = state.level;
+    return true;
+  }
+
+  bool
+  StreamProbeCache :: store(const char* url, AVFormatContext* context,
+      uint32_t numHeaderStreams)
+  {
+    int64_t size = -1;
+    int64_t mtime = -1;
+    if (!StreamProbeCache_getKey(url, context, &size, &mtime))
+      return false;
+    if (context->ctx_flags & AVFMTCTX_NOHEADER ||
+        context->nb_streams != numHeaderStreams)
+      // the probe found streams we couldn't make again on restore
+      return false;
+
+    // build the entry outside the lock, and splice it in, which can't
+    // throw
+    std::list<Entry> added(1);
+    Entry& entry = added.front();
+    entry.url = url;
+    entry.size = size;
+    entry.mtime = mtime;
+    entry.format = context->iformat->name;
+    entry.startTime = context->start_time;
+    entry.duration = context->duration;
+    entry.bitRate = context->bit_rate;
+    entry.streams.resize(context->nb_streams);
+    for(uint32_t i = 0; i < context->nb_streams; i++)
+      StreamProbeCache_save(entry.streams[i], context->streams[i]);
+
+    SpinMutex::Guard guard(sStreamProbeCacheLock);
+    for(std::list<Entry>::iterator it = sStreamProbeCacheEntries.begin();
+        it != sStreamProbeCacheEntries.end(); ++it)
+      if (it->url == entry.url)
+      {
+        sStreamProbeCacheEntries.erase(it);
+        break;
+      }
+    sStreamProbeCacheEntries.splice(sStreamProbeCacheEntries.begin(), added);
+    if (sStreamProbeCacheEntries.size() > MAX_ENTRIES)
+      sStreamProbeCacheEntries.pop_back();
+    VS_LOG_TRACE("Cached probe result for %s", url);
+    return true;
+  }
+
+  bool
+  StreamProbeCache :: restore(const char* url, AVFormatContext* context)
+  {
+    int64_t size = -1;
+    int64_t mtime = -1;
+    if (!StreamProbeCache_getKey(url, context, &size, &mtime))
+      return false;
+
+    // restore straight from the cached entry rather than copying it
+    // out; the guard releases the lock however we leave
+    SpinMutex::Guard guard(sStreamProbeCacheLock);
+    bool found = false;
+    for(std::list<Entry>::iterator it = sStreamProbeCacheEntries.begin();
+        it != sStreamProbeCacheEntries.end(); ++it)
+      if (it->url == url)
+      {
+        if (it->size == size && it->mtime == mtime)
+        {
+          // move it to the front; splice doesn't copy
+          sStreamProbeCacheEntries.splice(sStreamProbeCacheEntries.begin(),
+              sStreamProbeCacheEntries, it);
+          found = true;
+        }
+        else
+          // the file changed since
+          sStreamProbeCacheEntries.erase(it);
+        break;
+      }
+    if (!found)
+      return false;
+
+    const Entry& entry = sStreamProbeCacheEntries.front();
+    if (entry.format != context->iformat->name ||
+        entry.streams.size() != context->nb_streams)
+      return false;
+    for(uint32_t i = 0; i < context->nb_streams; i++)
+      if (!StreamProbeCache_matches(entry.streams[i], context->streams[i]))
+        return false;
+
+    for(uint32_t i = 0; i < context->nb_streams; i++)
+      if (!StreamProbeCache_restore(entry.streams[i], context->streams[i]))
+        return false;
+    context->start_time = entry.startTime;
+    context->duration = entry.duration;
+    context->bit_rate = entry.bitRate;
+    VS_LOG_TRACE("Restored cached probe result for %s", url);
+    return true;
+  }
+
+  void
+  StreamProbeCache :: clear()
+  {
+    sStreamProbeCacheLock.lock();
+    sStreamProbeCacheEntries.clear();
+    sStreamProbeCacheLock.unlock();
+  }
+
+}}}
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef STREAMPROBECACHE_H_
+#define STREAMPROBECACHE_H_
+
+#include <inttypes.h>
+#include <com/xuggle/xuggler/Xuggler.h>
+#include <com/xuggle/xuggler/FfmpegIncludes.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+  /**
+   * Internal Only.
+   * <p>
+   * A process-wide cache of what avformat_find_stream_info learned about
+   * the streams in a file, so a {@link Container} that opens the same file
+   * again can put it back onto its streams instead of decoding frames to
+   * find it out all over.
+   * </p><p>
+   * Entries are keyed by url, file size and modification time, and only
+   * local files (ones we can stat) are cached.  Each entry holds, for
+   * every stream, its time bases, frame rates, start time and duration,
+   * and the codec parameters the probe fills in (codec id and tag, bit
+   * rate, dimensions, pixel and sample formats, sample rate, channels,
+   * frame size, profile and level, and extradata), plus the container's
+   * own start time, duration and bit rate.
+   * </p><p>
+   * Only files whose header declares every stream can be restored: the
+   * streams the demuxer made on open must match the cached ones one for
+   * one, as we can't make the streams a header-less demuxer (MPEG-TS,
+   * MPEG-PS...) would have found while probing.
+   * </p><p>
+   * The cache keeps the most recently used entries, up to a fixed
+   * number, and is safe to use from any thread.
+   * </p>
+   */
+  class StreamProbeCache
+  {
+  public:
+    /**
+     * Remember what the probe found out about the streams in context.
+     *
+     * @param url the url context was opened from.
+     * @param numHeaderStreams the number of streams the demuxer made
+     *   before probing.
+     * @return true if context was cached.
+     */
+    static bool store(const char* url, AVFormatContext* context,
+        uint32_t numHeaderStreams);
+
+    /**
+     * Put a cached probe result for url back onto the streams in context,
+     * if there is one and it matches them.
+     *
+     * @return true if context was restored; false if it was not touched.
+     */
+    static bool restore(const char* url, AVFormatContext* context);
+
+    /**
+     * Forget every cached probe result.
+     */
+    static void clear();
+
+    /**
+     * The most entries the cache keeps.
+     */
+    static const uint32_t MAX_ENTRIES = 256;
+
+  private:
+    StreamProbeCache();
+  };
+
+}}}
+
+#endif /*STREAMPROBECACHE_H_*/
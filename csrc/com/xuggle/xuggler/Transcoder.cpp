@@ -0,0 +1,826 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <sys/time.h>
+
+#include <cstdio>
+#include <stdexcept>
+
+#include <com/xuggle/ferry/JNIHelper.h>
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/xuggler/Transcoder.h>
+#include <com/xuggle/xuggler/IPacket.h>
+#include <com/xuggle/xuggler/IStream.h>
+#include <com/xuggle/xuggler/IVideoPicture.h>
+#include <com/xuggle/xuggler/IAudioSamples.h>
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+using namespace com::xuggle::ferry;
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+static int64_t
+Transcoder_now()
+{
+  struct timeval now;
+  gettimeofday(&now, 0);
+  return (int64_t)now.tv_sec*1000000 + now.tv_usec;
+}
+
+Transcoder :: Transcoder()
+{
+  mNumThreads = 0;
+  mQueueCapacity = 8;
+  mStreamsEnded = 0;
+  mStarted = false;
+  mFinished = false;
+  mError = false;
+  mMuxQueue.mMaxDepth = 0;
+  pthread_mutex_init(&mLock, 0);
+  pthread_cond_init(&mChanged, 0);
+}
+
+Transcoder :: ~Transcoder()
+{
+  tearDown();
+  for(size_t i = 0; i < mStages.size(); i++)
+    delete mStages[i];
+  mStages.clear();
+  for(size_t i = 0; i < mMappings.size(); i++)
+    delete mMappings[i];
+  mMappings.clear();
+  pthread_cond_destroy(&mChanged);
+  pthread_mutex_destroy(&mLock);
+}
+
+Transcoder*
+Transcoder :: make(IContainer* input, IContainer* output)
+{
+  Transcoder* retval = 0;
+  try
+  {
+    if (!input || !output)
+      throw std::invalid_argument("must pass input and output containers");
+    if (!input->isOpened() || input->getType() != IContainer::READ)
+      throw std::invalid_argument("input container must be open for reading");
+    if (!output->isOpened() || output->getType() != IContainer::WRITE)
+      throw std::invalid_argument("output container must be open for writing");
+    if (output->isHeaderWritten())
+      throw std::invalid_argument("output container header already written");
+
+    retval = make();
+    if (retval)
+    {
+      retval->mInput.reset(input, true);
+      retval->mOutput.reset(output, true);
+    }
+  }
+  catch (std::bad_alloc & e)
+  {
+    VS_REF_RELEASE(retval);
+    throw e;
+  }
+  catch (std::exception & e)
+  {
+    VS_LOG_ERROR("Error: %s", e.what());
+    VS_REF_RELEASE(retval);
+  }
+  return retval;
+}
+
+int32_t
+Transcoder :: mapStream(int32_t inputStreamIndex, int32_t outputStreamIndex)
+{
+  if (mStarted)
+    return -1;
+  if (inputStreamIndex < 0 ||
+      inputStreamIndex >= mInput->getNumStreams() ||
+      outputStreamIndex < 0 ||
+      outputStreamIndex >= mOutput->getNumStreams())
+    return -1;
+  for(size_t i = 0; i < mMappings.size(); i++)
+    if (mMappings[i]->mInputIndex == inputStreamIndex ||
+        mMappings[i]->mOutputIndex == outputStreamIndex)
+      return -1;
+
+  RefPointer<IStream> inStream = mInput->getStream(inputStreamIndex);
+  RefPointer<IStream> outStream = mOutput->getStream(outputStreamIndex);
+  if (!inStream || !outStream)
+    return -1;
+  RefPointer<IStreamCoder> decoder = inStream->getStreamCoder();
+  RefPointer<IStreamCoder> encoder = outStream->getStreamCoder();
+  if (!decoder || !encoder)
+    return -1;
+  ICodec::Type type = decoder->getCodecType();
+  if (type != ICodec::CODEC_TYPE_VIDEO && type != ICodec::CODEC_TYPE_AUDIO)
+    return -1;
+  if (encoder->getCodecType() != type)
+    return -1;
+
+  Mapping* mapping = new Mapping;
+  mapping->mInputIndex = inputStreamIndex;
+  mapping->mOutputIndex = outputStreamIndex;
+  mapping->mType = type;
+  mapping->mDecoder = decoder;
+  mapping->mEncoder = encoder;
+  mapping->mOpenedDecoder = false;
+  mapping->mOpenedEncoder = false;
+  mapping->mDecodeQueue.mMaxDepth = 0;
+  mapping->mConvertQueue.mMaxDepth = 0;
+  mapping->mEncodeQueue.mMaxDepth = 0;
+  mMappings.push_back(mapping);
+  return 0;
+}
+
+int32_t
+Transcoder :: setNumThreads(int32_t numThreads)
+{
+  if (numThreads < 0 || mStarted)
+    return -1;
+  mNumThreads = numThreads;
+  return 0;
+}
+
+int32_t
+Transcoder :: getNumThreads()
+{
+  return mNumThreads;
+}
+
+int32_t
+Transcoder :: setQueueCapacity(int32_t capacity)
+{
+  if (capacity <= 0 || mStarted)
+    return -1;
+  mQueueCapacity = capacity;
+  return 0;
+}
+
+int32_t
+Transcoder :: getQueueCapacity()
+{
+  return mQueueCapacity;
+}
+
+void
+Transcoder :: addStage(StageType type, const char* name, Mapping* mapping,
+    Queue* input, Queue* output)
+{
+  Stage* stage = new Stage;
+  stage->mType = type;
+  stage->mName = name;
+  if (mapping)
+  {
+    char index[32];
+    snprintf(index, sizeof(index), ":%d", mapping->mInputIndex);
+    stage->mName += index;
+  }
+  stage->mMapping = mapping;
+  stage->mInput = input;
+  stage->mOutput = output;
+  stage->mBusy = false;
+  stage->mDone = false;
+  stage->mNumItems = 0;
+  stage->mBusyTime = 0;
+  mStages.push_back(stage);
+}
+
+int32_t
+Transcoder :: setUp()
+{
+  for(size_t i = 0; i < mMappings.size(); i++)
+  {
+    Mapping* mapping = mMappings[i];
+    IStreamCoder* decoder = mapping->mDecoder.value();
+    IStreamCoder* encoder = mapping->mEncoder.value();
+
+    // anything the caller left unset on the encoder comes from the input
+    if (mapping->mType == ICodec::CODEC_TYPE_VIDEO)
+    {
+      if (encoder->getWidth() <= 0)
+        encoder->setWidth(decoder->getWidth());
+      if (encoder->getHeight() <= 0)
+        encoder->setHeight(decoder->getHeight());
+      if (encoder->getPixelType() == IPixelFormat::NONE)
+        encoder->setPixelType(decoder->getPixelType());
+    }
+    else
+    {
+      if (encoder->getChannels() <= 0)
+        encoder->setChannels(decoder->getChannels());
+      if (encoder->getSampleRate() <= 0)
+        encoder->setSampleRate(decoder->getSampleRate());
+    }
+
+    if (!decoder->isOpen())
+    {
+      if (decoder->open() < 0)
+      {
+        VS_LOG_ERROR("could not open decoder for input stream %d",
+            mapping->mInputIndex);
+        return -1;
+      }
+      mapping->mOpenedDecoder = true;
+    }
+    if (!encoder->isOpen())
+    {
+      if (encoder->open() < 0)
+      {
+        VS_LOG_ERROR("could not open encoder for output stream %d",
+            mapping->mOutputIndex);
+        return -1;
+      }
+      mapping->mOpenedEncoder = true;
+    }
+
+    if (mapping->mType == ICodec::CODEC_TYPE_VIDEO)
+    {
+      if (encoder->getWidth() != decoder->getWidth() ||
+          encoder->getHeight() != decoder->getHeight() ||
+          encoder->getPixelType() != decoder->getPixelType())
+      {
+        mapping->mVideoResampler = IVideoResampler::make(
+            encoder->getWidth(), encoder->getHeight(),
+            encoder->getPixelType(),
+            decoder->getWidth(), decoder->getHeight(),
+            decoder->getPixelType());
+        if (!mapping->mVideoResampler)
+        {
+          VS_LOG_ERROR("could not convert video from input stream %d",
+              mapping->mInputIndex);
+          return -1;
+        }
+      }
+    }
+    else
+    {
+      if (encoder->getChannels() != decoder->getChannels() ||
+          encoder->getSampleRate() != decoder->getSampleRate())
+      {
+        mapping->mAudioResampler = IAudioResampler::make(
+            encoder->getChannels(), decoder->getChannels(),
+            encoder->getSampleRate(), decoder->getSampleRate());
+        if (!mapping->mAudioResampler)
+        {
+          VS_LOG_ERROR("could not convert audio from input stream %d",
+              mapping->mInputIndex);
+          return -1;
+        }
+      }
+    }
+  }
+
+  pthread_mutex_lock(&mLock);
+  addStage(STAGE_DEMUX, "demux", 0, 0, 0);
+  for(size_t i = 0; i < mMappings.size(); i++)
+  {
+    Mapping* mapping = mMappings[i];
+    addStage(STAGE_DECODE, "decode", mapping,
+        &mapping->mDecodeQueue, &mapping->mConvertQueue);
+    addStage(STAGE_CONVERT, "convert", mapping,
+        &mapping->mConvertQueue, &mapping->mEncodeQueue);
+    addStage(STAGE_ENCODE, "encode", mapping,
+        &mapping->mEncodeQueue, &mMuxQueue);
+  }
+  addStage(STAGE_MUX, "mux", 0, &mMuxQueue, 0);
+  pthread_mutex_unlock(&mLock);
+
+  if (mOutput->writeHeader() < 0)
+  {
+    VS_LOG_ERROR("could not write output header");
+    return -1;
+  }
+  return 0;
+}
+
+void
+Transcoder :: tearDown()
+{
+  // drop anything still waiting
+  for(size_t i = 0; i < mMappings.size(); i++)
+  {
+    Mapping* mapping = mMappings[i];
+    Queue* queues[] = {
+        &mapping->mDecodeQueue,
+        &mapping->mConvertQueue,
+        &mapping->mEncodeQueue
+    };
+    for(size_t j = 0; j < sizeof(queues)/sizeof(*queues); j++)
+    {
+      while(!queues[j]->mItems.empty())
+      {
+        RefCounted* item = queues[j]->mItems.front();
+        queues[j]->mItems.pop_front();
+        VS_REF_RELEASE(item);
+      }
+    }
+    if (mapping->mOpenedDecoder)
+      mapping->mDecoder->close();
+    if (mapping->mOpenedEncoder)
+      mapping->mEncoder->close();
+    mapping->mOpenedDecoder = false;
+    mapping->mOpenedEncoder = false;
+  }
+  while(!mMuxQueue.mItems.empty())
+  {
+    RefCounted* item = mMuxQueue.mItems.front();
+    mMuxQueue.mItems.pop_front();
+    VS_REF_RELEASE(item);
+  }
+}
+
+int32_t
+Transcoder :: run()
+{
+  if (mStarted || mMappings.empty())
+    return -1;
+  mStarted = true;
+
+  int32_t retval = setUp();
+  if (retval >= 0)
+  {
+    int32_t numThreads = mNumThreads > 0 ? mNumThreads :
+      (int32_t)mStages.size();
+    std::vector<pthread_t> threads;
+    for(int32_t i = 0; i < numThreads; i++)
+    {
+      pthread_t thread;
+      if (pthread_create(&thread, 0, Transcoder::runWorker, this) == 0)
+        threads.push_back(thread);
+    }
+    if (threads.empty())
+    {
+      VS_LOG_ERROR("could not start any transcoding threads");
+      retval = -1;
+    }
+    else
+    {
+      for(size_t i = 0; i < threads.size(); i++)
+        pthread_join(threads[i], 0);
+      if (mError)
+        retval = -1;
+    }
+  }
+  if (retval >= 0)
+    retval = mOutput->writeTrailer();
+  tearDown();
+  return retval;
+}
+
+void*
+Transcoder :: runWorker(void* arg)
+{
+  // a daemon thread, so we never keep the Java virtual machine alive
+  JavaVM* vm = JNIHelper::sGetVM();
+  if (vm)
+  {
+    JNIEnv* env = 0;
+    vm->AttachCurrentThreadAsDaemon((void**)(void*)&env, 0);
+  }
+  ((Transcoder*)arg)->work();
+  if (vm)
+    vm->DetachCurrentThread();
+  return 0;
+}
+
+bool
+Transcoder :: isRunnable(Stage* stage)
+{
+  if (stage->mBusy || stage->mDone)
+    return false;
+  switch(stage->mType)
+  {
+    case STAGE_DEMUX:
+      // we don't know which stream the next packet is for
+      for(size_t i = 0; i < mMappings.size(); i++)
+        if ((int32_t)mMappings[i]->mDecodeQueue.mItems.size() >=
+            mQueueCapacity)
+          return false;
+      return true;
+    case STAGE_MUX:
+      return !stage->mInput->mItems.empty();
+    default:
+      return !stage->mInput->mItems.empty() &&
+        (int32_t)stage->mOutput->mItems.size() < mQueueCapacity;
+  }
+}
+
+Transcoder::Stage*
+Transcoder :: findRunnableStage()
+{
+  // prefer stages nearer the output, so that work in flight finishes
+  // before we read more
+  for(size_t i = mStages.size(); i > 0; i--)
+    if (isRunnable(mStages[i-1]))
+      return mStages[i-1];
+  return 0;
+}
+
+void
+Transcoder :: work()
+{
+  pthread_mutex_lock(&mLock);
+  while(!mFinished && !mError)
+  {
+    Stage* stage = findRunnableStage();
+    if (!stage)
+    {
+      pthread_cond_wait(&mChanged, &mLock);
+      continue;
+    }
+    RefCounted* item = 0;
+    if (stage->mInput)
+    {
+      item = stage->mInput->mItems.front();
+      stage->mInput->mItems.pop_front();
+    }
+    stage->mBusy = true;
+    pthread_mutex_unlock(&mLock);
+
+    Outputs outputs;
+    bool done = false;
+    int64_t start = Transcoder_now();
+    int32_t result = step(stage, item, &outputs, &done);
+    int64_t busyTime = Transcoder_now() - start;
+
+    pthread_mutex_lock(&mLock);
+    for(size_t i = 0; i < outputs.size(); i++)
+      push(outputs[i].first, outputs[i].second);
+    stage->mBusy = false;
+    stage->mDone = done;
+    ++stage->mNumItems;
+    stage->mBusyTime += busyTime;
+    if (result < 0)
+    {
+      VS_LOG_ERROR("transcoding stage %s failed", stage->mName.c_str());
+      mError = true;
+    }
+    if (stage->mType == STAGE_MUX && done)
+      mFinished = true;
+    pthread_cond_broadcast(&mChanged);
+  }
+  pthread_mutex_unlock(&mLock);
+}
+
+void
+Transcoder :: push(Queue* queue, RefCounted* item)
+{
+  queue->mItems.push_back(item);
+  if ((int32_t)queue->mItems.size() > queue->mMaxDepth)
+    queue->mMaxDepth = (int32_t)queue->mItems.size();
+}
+
+int32_t
+Transcoder :: step(Stage* stage, RefCounted* item, Outputs* outputs,
+    bool* done)
+{
+  int32_t retval = -1;
+  try
+  {
+    switch(stage->mType)
+    {
+      case STAGE_DEMUX:
+        retval = demux(outputs, done);
+        break;
+      case STAGE_DECODE:
+        retval = decode(stage->mMapping, item, outputs);
+        break;
+      case STAGE_CONVERT:
+        retval = convert(stage->mMapping, item, outputs);
+        break;
+      case STAGE_ENCODE:
+        retval = encode(stage->mMapping, item, outputs);
+        break;
+      case STAGE_MUX:
+        retval = mux(item, done);
+        break;
+    }
+    // everything but the demuxer and muxer are done once they pass on the
+    // end of their stream
+    if (!item && stage->mInput && stage->mType != STAGE_MUX)
+      *done = true;
+  }
+  catch (std::exception & e)
+  {
+    VS_LOG_ERROR("Error: %s", e.what());
+    retval = -1;
+  }
+  VS_REF_RELEASE(item);
+  return retval;
+}
+
+int32_t
+Transcoder :: demux(Outputs* outputs, bool* done)
+{
+  RefPointer<IPacket> packet = IPacket::make();
+  if (!packet)
+    return -1;
+  if (mInput->readNextPacket(packet.value()) < 0)
+  {
+    // end of file (or a read error we can't recover from); either way
+    // flush everything we have
+    for(size_t i = 0; i < mMappings.size(); i++)
+      outputs->push_back(std::make_pair(&mMappings[i]->mDecodeQueue,
+          (RefCounted*)0));
+    *done = true;
+    return 0;
+  }
+  for(size_t i = 0; i < mMappings.size(); i++)
+    if (mMappings[i]->mInputIndex == packet->getStreamIndex())
+    {
+      outputs->push_back(std::make_pair(&mMappings[i]->mDecodeQueue,
+          (RefCounted*)packet.get()));
+      break;
+    }
+  return 0;
+}
+
+int32_t
+Transcoder :: decode(Mapping* mapping, RefCounted* item, Outputs* outputs)
+{
+  IStreamCoder* decoder = mapping->mDecoder.value();
+  Queue* output = &mapping->mConvertQueue;
+  IPacket* packet = dynamic_cast<IPacket*>(item);
+  if (item && !packet)
+    return -1;
+
+  if (mapping->mType == ICodec::CODEC_TYPE_VIDEO)
+  {
+    if (!packet)
+    {
+      // get out any pictures the decoder is holding on to
+      RefPointer<IPacket> empty = IPacket::make();
+      for(;;)
+      {
+        RefPointer<IVideoPicture> picture = IVideoPicture::make(
+            decoder->getPixelType(),
+            decoder->getWidth(), decoder->getHeight());
+        if (decoder->decodeVideo(picture.value(), empty.value(), 0) < 0 ||
+            !picture->isComplete())
+          break;
+        outputs->push_back(std::make_pair(output,
+            (RefCounted*)picture.get()));
+      }
+    }
+    else
+    {
+      int32_t offset = 0;
+      while(offset < packet->getSize())
+      {
+        RefPointer<IVideoPicture> picture = IVideoPicture::make(
+            decoder->getPixelType(),
+            decoder->getWidth(), decoder->getHeight());
+        int32_t bytesDecoded = decoder->decodeVideo(picture.value(), packet,
+            offset);
+        if (bytesDecoded < 0)
+          return bytesDecoded;
+        if (picture->isComplete())
+          outputs->push_back(std::make_pair(output,
+              (RefCounted*)picture.get()));
+        if (bytesDecoded == 0)
+          break;
+        offset += bytesDecoded;
+      }
+    }
+  }
+  else if (packet)
+  {
+    int32_t offset = 0;
+    while(offset < packet->getSize())
+    {
+      RefPointer<IAudioSamples> samples = IAudioSamples::make(1024,
+          decoder->getChannels());
+      int32_t bytesDecoded = decoder->decodeAudio(samples.value(), packet,
+          offset);
+      if (bytesDecoded < 0)
+        return bytesDecoded;
+      if (samples->isComplete() && samples->getNumSamples() > 0)
+        outputs->push_back(std::make_pair(output,
+            (RefCounted*)samples.get()));
+      if (bytesDecoded == 0)
+        break;
+      offset += bytesDecoded;
+    }
+  }
+  if (!packet)
+    outputs->push_back(std::make_pair(output, (RefCounted*)0));
+  return 0;
+}
+
+int32_t
+Transcoder :: convert(Mapping* mapping, RefCounted* item, Outputs* outputs)
+{
+  Queue* output = &mapping->mEncodeQueue;
+  if (!item)
+  {
+    outputs->push_back(std::make_pair(output, (RefCounted*)0));
+    return 0;
+  }
+  if (mapping->mType == ICodec::CODEC_TYPE_VIDEO)
+  {
+    IVideoPicture* picture = dynamic_cast<IVideoPicture*>(item);
+    if (!picture)
+      return -1;
+    if (!mapping->mVideoResampler)
+    {
+      picture->acquire();
+      outputs->push_back(std::make_pair(output, (RefCounted*)picture));
+      return 0;
+    }
+    IStreamCoder* encoder = mapping->mEncoder.value();
+    RefPointer<IVideoPicture> resampled = IVideoPicture::make(
+        encoder->getPixelType(), encoder->getWidth(), encoder->getHeight());
+    int32_t retval = mapping->mVideoResampler->resample(resampled.value(),
+        picture);
+    if (retval < 0)
+      return retval;
+    outputs->push_back(std::make_pair(output, (RefCounted*)resampled.get()));
+  }
+  else
+  {
+    IAudioSamples* samples = dynamic_cast<IAudioSamples*>(item);
+    if (!samples)
+      return -1;
+    if (!mapping->mAudioResampler)
+    {
+      samples->acquire();
+      outputs->push_back(std::make_pair(output, (RefCounted*)samples));
+      return 0;
+    }
+    int32_t numSamples = mapping->mAudioResampler->
+      getMinimumNumSamplesRequiredInOutputSamples(samples);
+    RefPointer<IAudioSamples> resampled = IAudioSamples::make(
+        numSamples > 0 ? numSamples : 1024,
+        mapping->mEncoder->getChannels());
+    int32_t retval = mapping->mAudioResampler->resample(resampled.value(),
+        samples, 0);
+    if (retval < 0)
+      return retval;
+    if (resampled->getNumSamples() > 0)
+      outputs->push_back(std::make_pair(output,
+          (RefCounted*)resampled.get()));
+  }
+  return 0;
+}
+
+int32_t
+Transcoder :: encode(Mapping* mapping, RefCounted* item, Outputs* outputs)
+{
+  IStreamCoder* encoder = mapping->mEncoder.value();
+  Queue* output = &mMuxQueue;
+  RefPointer<IPacket> packet = IPacket::make();
+  if (!packet)
+    return -1;
+
+  if (mapping->mType == ICodec::CODEC_TYPE_VIDEO)
+  {
+    IVideoPicture* picture = dynamic_cast<IVideoPicture*>(item);
+    if (item && !picture)
+      return -1;
+    do
+    {
+      int32_t retval = encoder->encodeVideo(packet.value(), picture,
+          picture ? -1 : 0);
+      if (retval < 0)
+        return retval;
+      if (!packet->isComplete())
+        break;
+      outputs->push_back(std::make_pair(output, (RefCounted*)packet.get()));
+      packet = IPacket::make();
+      // when flushing, keep going until the encoder has nothing left
+    } while (!picture);
+  }
+  else
+  {
+    IAudioSamples* samples = dynamic_cast<IAudioSamples*>(item);
+    if (item && !samples)
+      return -1;
+    uint32_t samplesConsumed = 0;
+    do
+    {
+      int32_t retval = encoder->encodeAudio(packet.value(), samples,
+          samplesConsumed);
+      if (retval < 0)
+        return retval;
+      samplesConsumed += retval;
+      if (packet->isComplete())
+      {
+        outputs->push_back(std::make_pair(output,
+            (RefCounted*)packet.get()));
+        packet = IPacket::make();
+      }
+      else if (!samples)
+        break;
+    } while (!samples || samplesConsumed < samples->getNumSamples());
+  }
+  if (!item)
+    outputs->push_back(std::make_pair(output, (RefCounted*)0));
+  return 0;
+}
+
+int32_t
+Transcoder :: mux(RefCounted* item, bool* done)
+{
+  if (!item)
+  {
+    // mux is only ever run by one thread at a time
+    ++mStreamsEnded;
+    if (mStreamsEnded == (int32_t)mMappings.size())
+      *done = true;
+    return 0;
+  }
+  IPacket* packet = dynamic_cast<IPacket*>(item);
+  if (!packet)
+    return -1;
+  return mOutput->writePacket(packet, true);
+}
+
+int32_t
+Transcoder :: getNumStages()
+{
+  pthread_mutex_lock(&mLock);
+  int32_t retval = (int32_t)mStages.size();
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+const char*
+Transcoder :: getStageName(int32_t stage)
+{
+  const char* retval = 0;
+  pthread_mutex_lock(&mLock);
+  if (stage >= 0 && stage < (int32_t)mStages.size())
+    retval = mStages[stage]->mName.c_str();
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int64_t
+Transcoder :: getStageNumItems(int32_t stage)
+{
+  int64_t retval = -1;
+  pthread_mutex_lock(&mLock);
+  if (stage >= 0 && stage < (int32_t)mStages.size())
+    retval = mStages[stage]->mNumItems;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int64_t
+Transcoder :: getStageBusyTime(int32_t stage)
+{
+  int64_t retval = -1;
+  pthread_mutex_lock(&mLock);
+  if (stage >= 0 && stage < (int32_t)mStages.size())
+    retval = mStages[stage]->mBusyTime;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int32_t
+Transcoder :: getStageQueueDepth(int32_t stage)
+{
+  int32_t retval = -1;
+  pthread_mutex_lock(&mLock);
+  if (stage >= 0 && stage < (int32_t)mStages.size())
+  {
+    Queue* input = mStages[stage]->mInput;
+    retval = input ? (int32_t)input->mItems.size() : 0;
+  }
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int32_t
+Transcoder :: getStageMaxQueueDepth(int32_t stage)
+{
+  int32_t retval = -1;
+  pthread_mutex_lock(&mLock);
+  if (stage >= 0 && stage < (int32_t)mStages.size())
+  {
+    Queue* input = mStages[stage]->mInput;
+    retval = input ? input->mMaxDepth : 0;
+  }
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+}}}
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef TRANSCODER_H_
+#define TRANSCODER_H_
+
+#include <pthread.h>
+
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <com/xuggle/ferry/RefPointer.h>
+#include <com/xuggle/xuggler/ITranscoder.h>
+#include <com/xuggle/xuggler/IStreamCoder.h>
+#include <com/xuggle/xuggler/IVideoResampler.h>
+#include <com/xuggle/xuggler/IAudioResampler.h>
+
+namespace com { namespace xuggle { namespace xuggler
+{
+
+class Transcoder : public ITranscoder
+{
+  VS_JNIUTILS_REFCOUNTED_OBJECT_PRIVATE_MAKE(Transcoder);
+public:
+  static Transcoder* make(IContainer* input, IContainer* output);
+
+  virtual int32_t mapStream(int32_t inputStreamIndex,
+      int32_t outputStreamIndex);
+  virtual int32_t setNumThreads(int32_t numThreads);
+  virtual int32_t getNumThreads();
+  virtual int32_t setQueueCapacity(int32_t capacity);
+  virtual int32_t getQueueCapacity();
+  virtual int32_t run();
+  virtual int32_t getNumStages();
+  virtual const char* getStageName(int32_t stage);
+  virtual int64_t getStageNumItems(int32_t stage);
+  virtual int64_t getStageBusyTime(int32_t stage);
+  virtual int32_t getStageQueueDepth(int32_t stage);
+  virtual int32_t getStageMaxQueueDepth(int32_t stage);
+
+protected:
+  Transcoder();
+  virtual ~Transcoder();
+
+private:
+  typedef enum StageType {
+    STAGE_DEMUX,
+    STAGE_DECODE,
+    STAGE_CONVERT,
+    STAGE_ENCODE,
+    STAGE_MUX,
+  } StageType;
+
+  /**
+   * A queue of items between two stages.  Each item holds one reference;
+   * a null item marks the end of a stream.
+   */
+  struct Queue
+  {
+    std::deque<com::xuggle::ferry::RefCounted*> mItems;
+    int32_t mMaxDepth;
+  };
+  typedef std::vector<std::pair<Queue*, com::xuggle::ferry::RefCounted*> >
+    Outputs;
+
+  struct Mapping
+  {
+    int32_t mInputIndex;
+    int32_t mOutputIndex;
+    ICodec::Type mType;
+    com::xuggle::ferry::RefPointer<IStreamCoder> mDecoder;
+    com::xuggle::ferry::RefPointer<IStreamCoder> mEncoder;
+    com::xuggle::ferry::RefPointer<IVideoResampler> mVideoResampler;
+    com::xuggle::ferry::RefPointer<IAudioResampler> mAudioResampler;
+    bool mOpenedDecoder;
+    bool mOpenedEncoder;
+    Queue mDecodeQueue;
+    Queue mConvertQueue;
+    Queue mEncodeQueue;
+  };
+
+  struct Stage
+  {
+    StageType mType;
+    std::string mName;
+    Mapping* mMapping;
+    Queue* mInput;
+    Queue* mOutput;
+    bool mBusy;
+    bool mDone;
+    int64_t mNumItems;
+    int64_t mBusyTime;
+  };
+
+  int32_t setUp();
+  void tearDown();
+  void addStage(StageType type, const char* name, Mapping* mapping,
+      Queue* input, Queue* output);
+  bool isRunnable(Stage* stage);
+  Stage* findRunnableStage();
+  static void* runWorker(void*);
+  void work();
+  int32_t step(Stage* stage, com::xuggle::ferry::RefCounted* item,
+      Outputs* outputs, bool* done);
+  int32_t demux(Outputs* outputs, bool* done);
+  int32_t decode(Mapping* mapping, com::xuggle::ferry::RefCounted* item,
+      Outputs* outputs);
+  int32_t convert(Mapping* mapping, com::xuggle::ferry::RefCounted* item,
+      Outputs* outputs);
+  int32_t encode(Mapping* mapping, com::xuggle::ferry::RefCounted* item,
+      Outputs* outputs);
+  int32_t mux(com::xuggle::ferry::RefCounted* item, bool* done);
+  void push(Queue* queue, com::xuggle::ferry::RefCounted* item);
+
+  com::xuggle::ferry::RefPointer<IContainer> mInput;
+  com::xuggle::ferry::RefPointer<IContainer> mOutput;
+  std::vector<Mapping*> mMappings;
+  std::vector<Stage*> mStages;
+  Queue mMuxQueue;
+  int32_t mNumThreads;
+  int32_t mQueueCapacity;
+  int32_t mStreamsEnded;
+  bool mStarted;
+  bool mFinished;
+  bool mError;
+
+  // guards the queues, the stages and the flags above
+  pthread_mutex_t mLock;
+  pthread_cond_t mChanged;
+};
+
+}}}
+
+#endif /* TRANSCODER_H_ */
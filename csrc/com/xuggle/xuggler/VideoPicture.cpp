@@ -23,7 +23,11 @@
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/ferry/RefPointer.h>
 #include <com/xuggle/xuggler/Global.h>
+extern "C" {
+#include <libavutil/imgutils.h>
+}
 #include "com/xuggle/xuggler/VideoPicture.h"
+#include "com/xuggle/xuggler/MediaDataPool.h"
 
 VS_LOG_SETUP(VS_CPP_PACKAGE);
 
@@ -33,6 +37,7 @@ namespace com { namespace xuggle { namespace xuggler
   VideoPicture :: VideoPicture()
   {
     mIsComplete = false;
+    mSharesDecoderBuffer = false;
     mFrame = avcodec_alloc_frame();
     if (!mFrame)
       throw std::bad_alloc();
@@ -43,6 +48,7 @@ namespace com { namespace xuggle { namespace xuggler
 
     mFrame->format = (int) IPixelFormat::NONE;
     mTimeBase = IRational::make(1, 1000000);
+    mPool = 0;
   }
 
   VideoPicture :: ~VideoPicture()
@@ -128,6 +134,7 @@ namespace com { namespace xuggle { namespace xuggler
     if (!buffer) return;
     /** Use the buffer */
     mBuffer.reset(buffer, true);
+    mSharesDecoderBuffer = false;
   }
   
   bool
@@ -149,12 +156,23 @@ namespace com { namespace xuggle { namespace xuggler
       // now copy the data
       allocInternalFrameBuffer();
 
-      // get the raw buffers
-      unsigned char* srcBuffer = (unsigned char*)src->mBuffer->getBytes(0, src->getSize());
-      unsigned char* dstBuffer = (unsigned char*)mBuffer->getBytes(0, getSize());
-      if (!srcBuffer || !dstBuffer)
-        throw std::runtime_error("could not get buffer to copy");
-      memcpy(dstBuffer, srcBuffer, getSize());
+      if (src->mSharesDecoderBuffer)
+      {
+        // the source planes are laid out the way the decoder wanted
+        // them, so copy plane by plane into our packed buffer.
+        av_picture_copy((AVPicture*)mFrame, (AVPicture*)src->mFrame,
+            (PixelFormat)src->mFrame->format,
+            src->mFrame->width, src->mFrame->height);
+      }
+      else
+      {
+        // get the raw buffers
+        unsigned char* srcBuffer = (unsigned char*)src->mBuffer->getBytes(0, src->getSize());
+        unsigned char* dstBuffer = (unsigned char*)mBuffer->getBytes(0, getSize());
+        if (!srcBuffer || !dstBuffer)
+          throw std::runtime_error("could not get buffer to copy");
+        memcpy(dstBuffer, srcBuffer, getSize());
+      }
 
       this->setComplete(true,
           srcFrame->getPixelType(),
@@ -177,6 +195,8 @@ namespace com { namespace xuggle { namespace xuggler
     com::xuggle::ferry::IBuffer *retval = 0;
     try {
       if (getSize() > 0) {
+        // callers expect the packed layout, and may write to it
+        unshareBuffer(true);
         if (!mBuffer || mBuffer->getBufferSize() < getSize())
         {
           allocInternalFrameBuffer();
@@ -200,6 +220,14 @@ namespace com { namespace xuggle { namespace xuggler
   void
   VideoPicture :: fillAVFrame(AVFrame *frame)
   {
+    if (mSharesDecoderBuffer)
+    {
+      // our planes already point at valid (if padded) memory
+      memcpy(frame, mFrame, sizeof(AVFrame));
+      frame->quality = getQuality();
+      frame->type = FF_BUFFER_TYPE_USER;
+      return;
+    }
     if (!mBuffer || mBuffer->getBufferSize() < getSize())
       allocInternalFrameBuffer();
     unsigned char* buffer = (unsigned char*)mBuffer->getBytes(0, getSize());
@@ -233,7 +261,8 @@ namespace com { namespace xuggle { namespace xuggler
       if (bufSize <= 0)
         throw std::runtime_error("invalid size for frame");
 
-      if (!mBuffer || mBuffer->getBufferSize() < bufSize)
+      if (mSharesDecoderBuffer
+          || !mBuffer || mBuffer->getBufferSize() < bufSize)
         // reuse buffers if we can.
         allocInternalFrameBuffer();
 
@@ -264,9 +293,58 @@ namespace com { namespace xuggle { namespace xuggler
     }
   }
 
+  void
+  VideoPicture :: shareAVFrame(AVFrame* frame,
+      com::xuggle::ferry::IBuffer* buffer,
+      IPixelFormat::Type pixel, int32_t width, int32_t height)
+  {
+    VS_ASSERT(frame, "no frame?");
+    VS_ASSERT(buffer, "no buffer?");
+    VS_ASSERT(frame->data[0], "no data in frame");
+
+    mFrame->width = width;
+    mFrame->height = height;
+    mFrame->format = (int)pixel;
+
+    // take our reference before dropping whatever we held previously;
+    // it may be the same buffer
+    mBuffer.reset(buffer, true);
+    mSharesDecoderBuffer = true;
+    for(int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+    {
+      mFrame->data[i] = frame->data[i];
+      mFrame->linesize[i] = frame->linesize[i];
+    }
+    mFrame->type = FF_BUFFER_TYPE_USER;
+    mFrame->key_frame = frame->key_frame;
+  }
+
+  void
+  VideoPicture :: unshareBuffer(bool preserveData)
+  {
+    if (!mSharesDecoderBuffer)
+      return;
+
+    // Hold the decoder's memory until we're done copying out of it.
+    com::xuggle::ferry::RefPointer<com::xuggle::ferry::IBuffer> shared =
+      mBuffer;
+    AVPicture src = *(AVPicture*)mFrame;
+
+    mBuffer.reset();
+    mSharesDecoderBuffer = false;
+    if (preserveData && getSize() > 0)
+    {
+      allocInternalFrameBuffer();
+      av_picture_copy((AVPicture*)mFrame, &src,
+          (PixelFormat)mFrame->format, mFrame->width, mFrame->height);
+    }
+  }
+
   AVFrame*
   VideoPicture :: getAVFrame()
   {
+    if (mSharesDecoderBuffer)
+      return mFrame;
     if (!mBuffer || mBuffer->getBufferSize() < getSize())
     {
       // reuse buffers if we can.
@@ -279,9 +357,20 @@ namespace com { namespace xuggle { namespace xuggler
   VideoPicture :: getDataLineSize(int lineNo)
   {
     int retval = -1;
-    if (getAVFrame()
-        && lineNo >= 0
-        && (unsigned int) lineNo < (sizeof(mFrame->linesize)/sizeof(mFrame->linesize[0])))
+    if (lineNo < 0
+        || (unsigned int) lineNo >= (sizeof(mFrame->linesize)/sizeof(mFrame->linesize[0])))
+      return retval;
+    if (mSharesDecoderBuffer)
+    {
+      // report the packed layout that getData() will hand back, without
+      // forcing the copy until someone actually asks for the bytes.
+      int linesizes[4] = { 0, 0, 0, 0 };
+      retval = 0;
+      if (lineNo < 4 && av_image_fill_linesizes(linesizes,
+          (PixelFormat)mFrame->format, mFrame->width) >= 0)
+        retval = linesizes[lineNo];
+    }
+    else if (getAVFrame())
       retval = mFrame->linesize[lineNo];
     return retval;
   }
@@ -339,6 +428,11 @@ namespace com { namespace xuggle { namespace xuggler
     try {
       mIsComplete = aIsComplete;
 
+      // Someone is about to put new data in this picture; let go of
+      // any decoder's memory rather than writing into it.
+      if (!mIsComplete)
+        unshareBuffer(false);
+
       if (mIsComplete)
       {
         setPts(pts);
@@ -375,6 +469,13 @@ namespace com { namespace xuggle { namespace xuggler
     if (bufSize <= 0)
       throw std::runtime_error("invalid size for frame");
 
+    // never write into memory a decoder may still be referencing
+    if (mSharesDecoderBuffer)
+    {
+      mBuffer.reset();
+      mSharesDecoderBuffer = false;
+    }
+
     // reuse buffers if we can.
     if (!mBuffer || mBuffer->getBufferSize() < bufSize)
     {
@@ -437,4 +538,60 @@ namespace com { namespace xuggle { namespace xuggler
     if (mFrame)
       mFrame->pict_type = (enum AVPictureType) type;
   }
+
+  void
+  VideoPicture :: setPool(MediaDataPool* pool)
+  {
+    if (pool)
+      pool->acquire();
+    if (mPool)
+      mPool->release();
+    mPool = pool;
+  }
+
+  bool
+  VideoPicture :: recycle()
+  {
+    if (!mFrame)
+      return false;
+    unshareBuffer(false);
+    // someone else can still see the pixels; don't write over them
+    if (mBuffer && mBuffer->getCurrentRefCount() > 1)
+      mBuffer.reset();
+
+    // reset everything but the shape, and the planes if we keep the
+    // buffer they point into
+    AVPicture planes = *(AVPicture*)mFrame;
+    int format = mFrame->format;
+    int width = mFrame->width;
+    int height = mFrame->height;
+    int type = mFrame->type;
+    avcodec_get_frame_defaults(mFrame);
+    if (mBuffer)
+    {
+      *(AVPicture*)mFrame = planes;
+      mFrame->type = type;
+    }
+    mFrame->opaque = this;
+    mFrame->format = format;
+    mFrame->width = width;
+    mFrame->height = height;
+    mIsComplete = false;
+    setKeyFrame(true);
+    if (!mTimeBase || mTimeBase->getCurrentRefCount() > 1 ||
+        mTimeBase->getNumerator() != 1 ||
+        mTimeBase->getDenominator() != 1000000)
+      mTimeBase = IRational::make(1, 1000000);
+    return true;
+  }
+
+  void
+  VideoPicture :: destroy()
+  {
+    // go back to our pool if it'll have us
+    MediaDataPool* pool = mPool;
+    mPool = 0;
+    if (!pool || !pool->reclaim(this))
+      com::xuggle::ferry::RefCounted::destroy();
+  }
 }}}
@@ -29,6 +29,7 @@
 
 namespace com { namespace xuggle { namespace xuggler
 {
+  class MediaDataPool;
 
   class VideoPicture : public IVideoPicture
   {
@@ -85,6 +86,32 @@ namespace com { namespace xuggle { namespace xuggler
      */
     void copyAVFrame(AVFrame *frame, IPixelFormat::Type pixel,
         int32_t width, int32_t height);
+
+    /**
+     * Called by the StreamCoder once it's done decoding, when ffmpeg
+     * decoded directly into a buffer the StreamCoder handed it.
+     * 
+     * Rather than copying, we take a reference to that buffer and
+     * point our planes at the decoder's layout.  The decoder may still
+     * use the picture as a reference frame, so the shared memory is
+     * treated as read-only: the first caller that asks for the packed
+     * data (see {@link #getData()}) or that reuses this picture for
+     * new output gets a private copy instead.
+     * 
+     * @param frame The AVFrame that ffmpeg filled in.
+     * @param buffer The buffer that backs frame's planes.
+     * @param pixel The pixel type
+     * @param width The width of the AVFrame
+     * @param height The height of the AVFrame
+     */
+    void shareAVFrame(AVFrame *frame, com::xuggle::ferry::IBuffer* buffer,
+        IPixelFormat::Type pixel, int32_t width, int32_t height);
+
+    /**
+     * @return true if this picture is currently sharing a buffer with
+     *   a decoder, rather than owning a packed copy of its data.
+     */
+    bool isSharingDecoderBuffer() { return mSharesDecoderBuffer; }
     
     /**
      * Call to get the raw underlying AVFrame we manage; don't
@@ -116,20 +143,40 @@ namespace com { namespace xuggle { namespace xuggler
     static VideoPicture* make(com::xuggle::ferry::IBuffer* buffer,
         IPixelFormat::Type format, int width, int height);
 
+    /**
+     * Set the pool this picture came from; while set, releasing its last
+     * reference hands it back to the pool instead of deleting it.
+     * Called by MediaDataPool.
+     */
+    void setPool(MediaDataPool* pool);
+    /**
+     * Put this picture back the way make() left it, keeping its frame buffer
+     * unless someone else still holds it.  Called by MediaDataPool.
+     * @return false if it can't be reused.
+     */
+    bool recycle();
+
   protected:
     VideoPicture();
     virtual ~VideoPicture();
+    virtual void destroy();
     
   private:
     void allocInternalFrameBuffer();
+    void unshareBuffer(bool preserveData);
     
     // This is where frame information is kept
     // about a decoded frame.
     AVFrame * mFrame;
     bool mIsComplete;
+    // true if mBuffer belongs to a decoder and mFrame points into it
+    // with the decoder's (padded) line sizes.
+    bool mSharesDecoderBuffer;
 
     com::xuggle::ferry::RefPointer<com::xuggle::ferry::IBuffer> mBuffer;
     com::xuggle::ferry::RefPointer<IRational> mTimeBase;
+    // the pool we came from, if any; we hold a reference to it
+    MediaDataPool* mPool;
   };
 
 }}}
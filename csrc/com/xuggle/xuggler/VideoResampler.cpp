@@ -25,9 +25,10 @@
 #include <com/xuggle/xuggler/VideoPicture.h>
 #include <com/xuggle/xuggler/Rational.h>
 #include <com/xuggle/xuggler/Property.h>
+#include <com/xuggle/xuggler/ScalerContextCache.h>
 
-// This is the only place we include this to limit
-// how much it pollutes our code, and make it
+// This and ScalerContextCache.cpp are the only places we include this
+// to limit how much it pollutes our code, and make it
 // easier to yank later.
 extern "C" {
 #include <libswscale/swscale.h>
@@ -48,13 +49,19 @@ namespace com { namespace xuggle { namespace xuggler
     mOWidth = 0;
     mIPixelFmt = IPixelFormat::NONE;
     mOPixelFmt = IPixelFormat::NONE;
+    mFlags = 0;
     mContext = 0;
+    mContextModified = false;
   }
 
   VideoResampler :: ~VideoResampler()
   {
-    if (mContext)
+    // scalers we've set properties on no longer match their cache key
+    if (mContext && mContextModified)
       sws_freeContext(mContext);
+    else
+      ScalerContextCache::put(mContext, mIWidth, mIHeight, mIPixelFmt,
+          mOWidth, mOHeight, mOPixelFmt, mFlags);
     mContext = 0;
   }
   
@@ -169,58 +176,6 @@ namespace com { namespace xuggle { namespace xuggler
     return retval;
   }
   
-/*
- * The next two methods are to work around a break in backwards compatibility introduced
- * in FFmpeg in September 2010
- */
-static int handle_jpeg(enum PixelFormat *format)
-{
-    switch (*format) {
-    case PIX_FMT_YUVJ420P: *format = PIX_FMT_YUV420P; return 1;
-    case PIX_FMT_YUVJ422P: *format = PIX_FMT_YUV422P; return 1;
-    case PIX_FMT_YUVJ444P: *format = PIX_FMT_YUV444P; return 1;
-    case PIX_FMT_YUVJ440P: *format = PIX_FMT_YUV440P; return 1;
-    default:                                          return 0;
-    }
-}
-
-static SwsContext *xuggleSws_getContext(int srcW, int srcH, enum PixelFormat srcFormat,
-                           int dstW, int dstH, enum PixelFormat dstFormat, int flags,
-                           SwsFilter *srcFilter, SwsFilter *dstFilter, const double *param)
-{
-    SwsContext *c;
-    const int *coeff;
-    int srcRange=handle_jpeg(&srcFormat);
-    int dstRange=handle_jpeg(&dstFormat);
-
-    if(!(c=sws_alloc_context()))
-        return NULL;
-
-    av_opt_set_int(c, "sws_flags", flags, 0);
-    av_opt_set_int(c, "srcw", srcW, 0);
-    av_opt_set_int(c, "srch", srcH, 0);
-    av_opt_set_int(c, "dstw", dstW, 0);
-    av_opt_set_int(c, "dsth", dstH, 0);
-    av_opt_set_int(c, "src_range", srcRange, 0);
-    av_opt_set_int(c, "dst_range", dstRange, 0);
-    av_opt_set_int(c, "src_format", srcFormat, 0);
-    av_opt_set_int(c, "dst_format", dstFormat, 0);
-
-    if (param) {
-        av_opt_set_double(c, "param0", param[0], 0);
-        av_opt_set_double(c, "param1", param[1], 0);
-    }
-
-    coeff = sws_getCoefficients(SWS_CS_DEFAULT);
-    sws_setColorspaceDetails(c, coeff, srcRange, coeff /* FIXME*/, dstRange, 0, 1<<16, 1<<16);
-
-    if(sws_init_context(c, srcFilter, dstFilter) < 0){
-        sws_freeContext(c);
-        return NULL;
-    }
-
-    return c;
-}
   VideoResampler*
   VideoResampler :: make(
           int32_t outputWidth, int32_t outputHeight,
@@ -255,25 +210,21 @@ static SwsContext *xuggleSws_getContext(int srcW, int srcH, enum PixelFormat src
         retval->mIWidth = inputWidth;
         retval->mIPixelFmt = inputFmt;
         
-        int32_t flags = 0;
         if (inputWidth < outputWidth)
           // We're upscaling
-          flags = SWS_BICUBIC;
+          retval->mFlags = SWS_BICUBIC;
         else
           // We're downscaling
-          flags = SWS_AREA;
+          retval->mFlags = SWS_AREA;
         
-        retval->mContext = xuggleSws_getContext(
+        retval->mContext = ScalerContextCache::get(
             retval->mIWidth, // src width
             retval->mIHeight, // src height
-            (PixelFormat)retval->mIPixelFmt, // src pixel type
+            retval->mIPixelFmt, // src pixel type
             retval->mOWidth, // dst width
             retval->mOHeight, // dst height
-            (PixelFormat)retval->mOPixelFmt, // dst pixel type
-            flags, // Flags
-            0, // Source Filter
-            0, // Destination Filter
-            0 // An array of parameters for filters
+            retval->mOPixelFmt, // dst pixel type
+            retval->mFlags // Flags
             );
         if (!retval->mContext)
           throw std::runtime_error("could not allocate a image rescaler");
@@ -313,6 +264,7 @@ static SwsContext *xuggleSws_getContext(int srcW, int srcH, enum PixelFormat src
   int32_t
   VideoResampler :: setProperty(IMetaData* valuesToSet, IMetaData* valuesNotFound)
   {
+    mContextModified = true;
     return Property::setProperty(mContext, valuesToSet, valuesNotFound);
   }
 
@@ -320,24 +272,28 @@ static SwsContext *xuggleSws_getContext(int srcW, int srcH, enum PixelFormat src
   int32_t
   VideoResampler :: setProperty(const char* aName, const char *aValue)
   {
+    mContextModified = true;
     return Property::setProperty(mContext, aName, aValue);
   }
 
   int32_t
   VideoResampler :: setProperty(const char* aName, double aValue)
   {
+    mContextModified = true;
     return Property::setProperty(mContext, aName, aValue);
   }
 
   int32_t
   VideoResampler :: setProperty(const char* aName, int64_t aValue)
   {
+    mContextModified = true;
     return Property::setProperty(mContext, aName, aValue);
   }
 
   int32_t
   VideoResampler :: setProperty(const char* aName, bool aValue)
   {
+    mContextModified = true;
     return Property::setProperty(mContext, aName, aValue);
   }
 
@@ -345,6 +301,7 @@ static SwsContext *xuggleSws_getContext(int srcW, int srcH, enum PixelFormat src
   int32_t
   VideoResampler :: setProperty(const char* aName, IRational *aValue)
   {
+    mContextModified = true;
     return Property::setProperty(mContext, aName, aValue);
   }
 
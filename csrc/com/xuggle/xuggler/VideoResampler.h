@@ -83,8 +83,11 @@ namespace com { namespace xuggle { namespace xuggler
     int32_t mOWidth;
     IPixelFormat::Type mIPixelFmt;
     IPixelFormat::Type mOPixelFmt;
+    int32_t mFlags;
     
     SwsContext* mContext;
+    // true once someone may have changed mContext's options
+    bool mContextModified;
   };
 
   }}}
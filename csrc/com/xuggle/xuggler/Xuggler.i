@@ -27,6 +27,7 @@
 #include <com/xuggle/xuggler/IPixelFormat.h>
 #include <com/xuggle/xuggler/ITimeValue.h>
 #include <com/xuggle/xuggler/IRational.h>
+#include <com/xuggle/xuggler/IPropertyHandle.h>
 #include <com/xuggle/xuggler/IMetaData.h>
 #include <com/xuggle/xuggler/IMediaData.h>
 #include <com/xuggle/xuggler/IAudioSamples.h>
@@ -43,6 +44,12 @@
 #include <com/xuggle/xuggler/IMediaDataWrapper.h>
 #include <com/xuggle/xuggler/Global.h>
 #include <com/xuggle/xuggler/IError.h>
+#include <com/xuggle/xuggler/ITranscoder.h>
+#include <com/xuggle/xuggler/IMediaDataPool.h>
+#include <com/xuggle/xuggler/VideoPicture.h>
+#include <com/xuggle/xuggler/PixelConversion.h>
+
+#include <vector>
 
 using namespace VS_CPP_NAMESPACE;
 /**
@@ -70,6 +77,193 @@ Java_com_xuggle_xuggler_Xuggler_init(JNIEnv *env, jclass)
   }
 }
 
+/**
+ * Batch packet reads and writes are hand-written here because SWIG has
+ * no natural mapping for arrays of our objects.  The Java side passes
+ * the native pointers of the packets, so a whole batch crosses JNI once.
+ */
+static jint
+Xuggler_IContainer_batchPackets(JNIEnv *jenv, jlong jcontainer,
+    jlongArray jpackets, jint numPackets, bool reading, bool forceInterleave)
+{
+  IContainer *container = *(IContainer **)&jcontainer;
+  if (!container || !jpackets || numPackets < 0
+      || jenv->GetArrayLength(jpackets) < numPackets)
+    return -1;
+  if (!numPackets)
+    return 0;
+  jint retval = -1;
+  try
+  {
+    std::vector<jlong> ptrs(numPackets);
+    jenv->GetLongArrayRegion(jpackets, 0, numPackets, &ptrs[0]);
+    if (jenv->ExceptionCheck())
+      return -1;
+    std::vector<IPacket*> packets(numPackets);
+    for(jint i = 0; i < numPackets; i++)
+    {
+      packets[i] = *(IPacket **)&ptrs[i];
+      if (!packets[i])
+        return -1;
+    }
+    if (reading)
+      retval = container->readNextPackets(&packets[0], numPackets);
+    else
+      retval = container->writePackets(&packets[0], numPackets,
+          forceInterleave);
+  }
+  catch(std::bad_alloc & e)
+  {
+    // we don't plan to run out of memory, so we tell Java
+    if (!jenv->ExceptionCheck())
+    {
+      com::xuggle::ferry::JNIHelper *helper =
+        com::xuggle::ferry::JNIHelper::getHelper();
+      if (helper)
+        helper->throwOutOfMemoryError();
+    }
+    retval = -1;
+  }
+  catch(std::exception & e)
+  {
+    if (!jenv->ExceptionCheck())
+    {
+      jclass cls=jenv->FindClass("java/lang/RuntimeException");
+      jenv->ThrowNew(cls, e.what());
+    }
+    retval = -1;
+  }
+  return retval;
+}
+
+SWIGEXPORT jint JNICALL
+Java_com_xuggle_xuggler_XugglerJNI_IContainer_1readNextPackets(JNIEnv *jenv,
+    jclass, jlong jarg1, jobject, jlongArray jarg2, jint jarg3)
+{
+  return Xuggler_IContainer_batchPackets(jenv, jarg1, jarg2, jarg3,
+      true, false);
+}
+
+SWIGEXPORT jint JNICALL
+Java_com_xuggle_xuggler_XugglerJNI_IContainer_1writePackets(JNIEnv *jenv,
+    jclass, jlong jarg1, jobject, jlongArray jarg2, jint jarg3,
+    jboolean jarg4)
+{
+  return Xuggler_IContainer_batchPackets(jenv, jarg1, jarg2, jarg3,
+      false, jarg4 ? true : false);
+}
+
+/**
+ * Native picture <-> BufferedImage pixel conversion, also hand-written
+ * so the image's Java array can be converted in place.  Anything that
+ * might allocate (and so maybe call into Java) happens before we pin
+ * the array.
+ */
+static jint
+Xuggler_IVideoPicture_convertPacked(JNIEnv *jenv, jlong jpicture,
+    jarray jpixels, jint offset, jint stride, jint width, jint height,
+    jlong timestamp, PixelConversion::PackedFormat format, bool toPicture)
+{
+  IVideoPicture *ipicture = *(IVideoPicture **)&jpicture;
+  VideoPicture *picture = dynamic_cast<VideoPicture*>(ipicture);
+  if (!picture || !jpixels || offset < 0)
+    return -1;
+  // strides and offsets are in array elements (bytes, or ints for ARGB)
+  const int32_t pixelElements = format == PixelConversion::PACKED_BGR24 ? 3 : 1;
+  const int32_t elementSize = format == PixelConversion::PACKED_BGR24 ? 1 : 4;
+  jint retval = -1;
+  try
+  {
+    // the planes are sized for the picture's own type and size, so
+    // only ever convert into or out of a YUV420P picture that size
+    if (picture->getPixelType() != IPixelFormat::YUV420P)
+      return -1;
+    if (toPicture)
+    {
+      if (picture->getWidth() != width || picture->getHeight() != height)
+        return -1;
+      picture->setComplete(false, IPixelFormat::YUV420P, width, height,
+          timestamp);
+    }
+    else
+    {
+      if (!picture->isComplete())
+        return -1;
+      width = picture->getWidth();
+      height = picture->getHeight();
+    }
+    const int64_t rowElements = (int64_t)width*pixelElements;
+    if (width <= 0 || height <= 0 || stride < rowElements
+        || (int64_t)offset + (int64_t)(height-1)*stride + rowElements
+          > jenv->GetArrayLength(jpixels))
+      return -1;
+
+    AVFrame *frame = picture->getAVFrame();
+    if (!frame || !frame->data[0])
+      return -1;
+    uint8_t* planes[3] = { frame->data[0], frame->data[1], frame->data[2] };
+    int32_t strides[3] = { frame->linesize[0], frame->linesize[1],
+        frame->linesize[2] };
+
+    uint8_t *pixels = (uint8_t*)jenv->GetPrimitiveArrayCritical(jpixels, 0);
+    if (!pixels)
+      return -1;
+    uint8_t *first = pixels + offset*elementSize;
+    if (toPicture)
+      PixelConversion::packedToYuv420p(format, first, stride*elementSize,
+          width, height, planes, strides);
+    else
+      PixelConversion::yuv420pToPacked(format, planes, strides,
+          width, height, first, stride*elementSize);
+    jenv->ReleasePrimitiveArrayCritical(jpixels, pixels,
+        toPicture ? JNI_ABORT : 0);
+
+    if (toPicture)
+      picture->setComplete(true, IPixelFormat::YUV420P, width, height,
+          timestamp);
+    retval = 0;
+  }
+  catch (std::exception &)
+  {
+    retval = -1;
+  }
+  return retval;
+}
+
+SWIGEXPORT jint JNICALL
+Java_com_xuggle_xuggler_XugglerJNI_IVideoPicture_1copyToBGR24(JNIEnv *jenv,
+    jclass, jlong jarg1, jobject, jbyteArray jarg2, jint jarg3, jint jarg4)
+{
+  return Xuggler_IVideoPicture_convertPacked(jenv, jarg1, jarg2, jarg3,
+      jarg4, 0, 0, 0, PixelConversion::PACKED_BGR24, false);
+}
+
+SWIGEXPORT jint JNICALL
+Java_com_xuggle_xuggler_XugglerJNI_IVideoPicture_1copyToARGB(JNIEnv *jenv,
+    jclass, jlong jarg1, jobject, jintArray jarg2, jint jarg3, jint jarg4)
+{
+  return Xuggler_IVideoPicture_convertPacked(jenv, jarg1, jarg2, jarg3,
+      jarg4, 0, 0, 0, PixelConversion::PACKED_INT_ARGB, false);
+}
+
+SWIGEXPORT jint JNICALL
+Java_com_xuggle_xuggler_XugglerJNI_IVideoPicture_1copyFromBGR24(JNIEnv *jenv,
+    jclass, jlong jarg1, jobject, jbyteArray jarg2, jint jarg3, jint jarg4,
+    jint jarg5, jint jarg6, jlong jarg7)
+{
+  return Xuggler_IVideoPicture_convertPacked(jenv, jarg1, jarg2, jarg3,
+      jarg4, jarg5, jarg6, jarg7, PixelConversion::PACKED_BGR24, true);
+}
+
+SWIGEXPORT jint JNICALL
+Java_com_xuggle_xuggler_XugglerJNI_IVideoPicture_1copyFromARGB(JNIEnv *jenv,
+    jclass, jlong jarg1, jobject, jintArray jarg2, jint jarg3, jint jarg4,
+    jint jarg5, jint jarg6, jlong jarg7)
+{
+  return Xuggler_IVideoPicture_convertPacked(jenv, jarg1, jarg2, jarg3,
+      jarg4, jarg5, jarg6, jarg7, PixelConversion::PACKED_INT_ARGB, true);
+}
+
 }
 
 
@@ -130,6 +324,14 @@ import com.xuggle.ferry.*;
   public static void noop() {
     // Here only to force JNI library to load
   }
+
+  // Hand-written batch and pixel conversion calls; see Xuggler.i
+  public final static native int IContainer_readNextPackets(long jarg1, IContainer jarg1_, long[] jarg2, int jarg3);
+  public final static native int IContainer_writePackets(long jarg1, IContainer jarg1_, long[] jarg2, int jarg3, boolean jarg4);
+  public final static native int IVideoPicture_copyToBGR24(long jarg1, IVideoPicture jarg1_, byte[] jarg2, int jarg3, int jarg4);
+  public final static native int IVideoPicture_copyToARGB(long jarg1, IVideoPicture jarg1_, int[] jarg2, int jarg3, int jarg4);
+  public final static native int IVideoPicture_copyFromBGR24(long jarg1, IVideoPicture jarg1_, byte[] jarg2, int jarg3, int jarg4, int jarg5, int jarg6, long jarg7);
+  public final static native int IVideoPicture_copyFromARGB(long jarg1, IVideoPicture jarg1_, int[] jarg2, int jarg3, int jarg4, int jarg5, int jarg6, long jarg7);
   
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<
 // Xuggler.i: End generated code
@@ -145,6 +347,7 @@ import com.xuggle.ferry.*;
 %include <com/xuggle/xuggler/IProperty.h>
 %include <com/xuggle/xuggler/IPixelFormat.h>
 %include <com/xuggle/xuggler/IRational.swg>
+%include <com/xuggle/xuggler/IPropertyHandle.h>
 %include <com/xuggle/xuggler/ITimeValue.h>
 %include <com/xuggle/xuggler/IMetaData.swg>
 %include <com/xuggle/xuggler/IMediaData.swg>
@@ -162,3 +365,5 @@ import com.xuggle.ferry.*;
 %include <com/xuggle/xuggler/IMediaDataWrapper.swg>
 %include <com/xuggle/xuggler/Global.swg>
 %include <com/xuggle/xuggler/IError.swg>
+%include <com/xuggle/xuggler/ITranscoder.h>
+%include <com/xuggle/xuggler/IMediaDataPool.swg>
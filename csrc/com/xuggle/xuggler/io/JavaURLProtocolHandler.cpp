@@ -76,11 +76,22 @@ JavaURLProtocolHandler :: JavaURLProtocolHandler(
     JavaURLProtocolManager* mgr,
     jobject aJavaProtocolHandler) : URLProtocolHandler(mgr)
 {
+  mJavaProtoHandler = 0;
+  mJavaUrlReadDirect_mid = 0;
+  mJavaUrlWriteDirect_mid = 0;
+  mJavaBufferClear_mid = 0;
+  mReadBuffer = 0;
+  mReadBufferAddress = 0;
+  mReadBufferSize = 0;
+  mWriteBuffer = 0;
+  mWriteBufferAddress = 0;
+  mWriteBufferSize = 0;
   cacheJavaMethods(aJavaProtocolHandler);
 }
 
 JavaURLProtocolHandler :: ~JavaURLProtocolHandler()
 {
+  deleteDirectBuffers();
   if (mJavaProtoHandler)
   {
     JNIHelper::sDeleteGlobalRef(mJavaProtoHandler);
@@ -114,6 +125,85 @@ JavaURLProtocolHandler :: cacheJavaMethods(jobject aProtoHandler)
   mJavaUrlIsStreamed_mid = env->GetMethodID(cls, "isStreamed",
       "(Ljava/lang/String;I)Z");
 
+  // Handlers that can take a ByteBuffer get handed FFmpeg's own memory
+  // rather than a new byte[] per call.
+  jclass directCls = env->FindClass(
+      "com/xuggle/xuggler/io/IDirectURLProtocolHandler");
+  if (!directCls)
+    env->ExceptionClear();
+  else if (env->IsInstanceOf(aProtoHandler, directCls))
+  {
+    jclass bufferCls = env->FindClass("java/nio/Buffer");
+    if (bufferCls)
+    {
+      mJavaBufferClear_mid = env->GetMethodID(bufferCls, "clear",
+          "()Ljava/nio/Buffer;");
+      mJavaUrlReadDirect_mid = env->GetMethodID(directCls, "read",
+          "(Ljava/nio/ByteBuffer;I)I");
+      mJavaUrlWriteDirect_mid = env->GetMethodID(directCls, "write",
+          "(Ljava/nio/ByteBuffer;I)I");
+      env->DeleteLocalRef(bufferCls);
+    }
+    if (env->ExceptionCheck() || !mJavaBufferClear_mid)
+    {
+      env->ExceptionClear();
+      mJavaUrlReadDirect_mid = 0;
+      mJavaUrlWriteDirect_mid = 0;
+    }
+  }
+  if (directCls)
+    env->DeleteLocalRef(directCls);
+  env->DeleteLocalRef(cls);
+}
+
+jobject
+JavaURLProtocolHandler :: getDirectBuffer(JNIEnv* env, jobject* cached,
+    void** cachedAddress, int* cachedSize,
+    void* address, int size)
+{
+  if (!*cached || *cachedAddress != address || *cachedSize != size)
+  {
+    if (*cached)
+      env->DeleteGlobalRef(*cached);
+    *cached = 0;
+    *cachedAddress = 0;
+    *cachedSize = 0;
+
+    jobject buffer = env->NewDirectByteBuffer(address, size);
+    JavaURLProtocolHandler_CheckException(env);
+    if (!buffer)
+      throw std::runtime_error("could not make direct ByteBuffer");
+    *cached = env->NewGlobalRef(buffer);
+    env->DeleteLocalRef(buffer);
+    if (!*cached)
+      throw std::bad_alloc();
+    *cachedAddress = address;
+    *cachedSize = size;
+  }
+  else
+  {
+    // reset position and limit in case the last caller moved them
+    jobject self = env->CallObjectMethod(*cached, mJavaBufferClear_mid);
+    JavaURLProtocolHandler_CheckException(env);
+    if (self)
+      env->DeleteLocalRef(self);
+  }
+  return *cached;
+}
+
+void
+JavaURLProtocolHandler :: deleteDirectBuffers()
+{
+  if (mReadBuffer)
+    JNIHelper::sDeleteGlobalRef(mReadBuffer);
+  mReadBuffer = 0;
+  mReadBufferAddress = 0;
+  mReadBufferSize = 0;
+  if (mWriteBuffer)
+    JNIHelper::sDeleteGlobalRef(mWriteBuffer);
+  mWriteBuffer = 0;
+  mWriteBufferAddress = 0;
+  mWriteBufferSize = 0;
 }
 
 int
@@ -176,6 +266,8 @@ JavaURLProtocolHandler :: url_close()
     VS_LOG_DEBUG("Got unknown exception");
     retval = -1;
   }
+  // FFmpeg frees its I/O buffers once closed
+  deleteDirectBuffers();
   XUGGLER_CHECK_INTERRUPT(retval, 1);
 
   return retval;
@@ -225,6 +317,17 @@ JavaURLProtocolHandler :: url_read(unsigned char* buf, int size)
   try
   {
     JavaURLProtocolHandler_CheckException(env);
+    if (mJavaUrlReadDirect_mid)
+    {
+      // the handler reads straight into FFmpeg's buffer
+      jobject buffer = getDirectBuffer(env, &mReadBuffer,
+          &mReadBufferAddress, &mReadBufferSize, buf, size);
+      retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlReadDirect_mid,
+          buffer, size);
+      JavaURLProtocolHandler_CheckException(env);
+      XUGGLER_CHECK_INTERRUPT(retval, retval < 0 || retval != size);
+      return retval;
+    }
     byteArray = env->NewByteArray(size);
     JavaURLProtocolHandler_CheckException(env);
     // read into the Java byte array
@@ -272,6 +375,18 @@ JavaURLProtocolHandler :: url_write(const unsigned char* buf, int size)
   try
   {
     JavaURLProtocolHandler_CheckException(env);
+    if (mJavaUrlWriteDirect_mid)
+    {
+      // the handler writes straight from FFmpeg's buffer
+      jobject buffer = getDirectBuffer(env, &mWriteBuffer,
+          &mWriteBufferAddress, &mWriteBufferSize,
+          const_cast<unsigned char*>(buf), size);
+      retval = env->CallIntMethod(mJavaProtoHandler, mJavaUrlWriteDirect_mid,
+          buffer, size);
+      JavaURLProtocolHandler_CheckException(env);
+      XUGGLER_CHECK_INTERRUPT(retval, retval < 0 || retval != size);
+      return retval;
+    }
     byteArray = env->NewByteArray(size);
     JavaURLProtocolHandler_CheckException(env);
 
@@ -44,6 +44,11 @@ namespace com { namespace xuggle { namespace xuggler { namespace io
 
   private:
     void cacheJavaMethods(jobject aProtoHandler);
+    jobject getDirectBuffer(JNIEnv* env, jobject* cached,
+        void** cachedAddress, int* cachedSize,
+        void* address, int size);
+    void deleteDirectBuffers();
+
     jobject mJavaProtoHandler;
     jmethodID mJavaUrlOpen_mid;
     jmethodID mJavaUrlClose_mid;
@@ -52,6 +57,21 @@ namespace com { namespace xuggle { namespace xuggler { namespace io
     jmethodID mJavaUrlSeek_mid;
     jmethodID mJavaUrlIsStreamed_mid;
 
+    // Only set if the Java handler is an IDirectURLProtocolHandler
+    jmethodID mJavaUrlReadDirect_mid;
+    jmethodID mJavaUrlWriteDirect_mid;
+    jmethodID mJavaBufferClear_mid;
+
+    // Direct ByteBuffers over the memory FFmpeg last asked us to read
+    // into or write from; FFmpeg almost always reuses its I/O buffer,
+    // so these are only re-made when that changes.
+    jobject mReadBuffer;
+    void* mReadBufferAddress;
+    int mReadBufferSize;
+    jobject mWriteBuffer;
+    void* mWriteBufferAddress;
+    int mWriteBufferSize;
+
   };
   }}}}
 #endif /*JAVAURLPROTOCOLHANDLER_H_*/
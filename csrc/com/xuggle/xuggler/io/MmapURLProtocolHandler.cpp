@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <com/xuggle/ferry/Logger.h>
+
+#include <com/xuggle/xuggler/io/MmapURLProtocolHandler.h>
+#include <com/xuggle/xuggler/io/MmapURLProtocolManager.h>
+
+using namespace com::xuggle::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace com { namespace xuggle{ namespace xuggler { namespace io
+{
+
+MmapURLProtocolHandler :: MmapURLProtocolHandler(
+    MmapURLProtocolManager* mgr) : URLProtocolHandler(mgr)
+{
+  mOpen = false;
+  mData = 0;
+  mSize = 0;
+  mPosition = 0;
+}
+
+MmapURLProtocolHandler :: ~MmapURLProtocolHandler()
+{
+  reset();
+}
+
+void
+MmapURLProtocolHandler :: reset()
+{
+  (void) url_close();
+}
+
+int
+MmapURLProtocolHandler :: url_open(const char *url, int flags)
+{
+  if (!url || !*url)
+    return -1;
+  reset();
+
+  if (flags != URLProtocolHandler::URL_RDONLY_MODE)
+  {
+    VS_LOG_DEBUG("mmap handler only supports reading: %s", url);
+    return -1;
+  }
+
+  // The URL MAY contain a protocol string.  Find it now.
+  char proto[256];
+  const char* protocol = URLProtocolManager::parseProtocol(proto, sizeof(proto), url);
+  if (protocol)
+  {
+    size_t protoLen = strlen(protocol);
+    // skip past it
+    url = url + protoLen;
+    if (*url == ':' || *url == ',')
+      ++url;
+  }
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(url, GENERIC_READ, FILE_SHARE_READ, 0,
+      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+  if (file == INVALID_HANDLE_VALUE)
+    return -1;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size))
+  {
+    CloseHandle(file);
+    return -1;
+  }
+  mSize = size.QuadPart;
+  if (mSize > 0)
+  {
+    HANDLE mapping = CreateFileMapping(file, 0, PAGE_READONLY, 0, 0, 0);
+    if (mapping)
+    {
+      mData = (unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      // the view keeps the mapping alive
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  int fd = open(url, O_RDONLY);
+  if (fd < 0)
+    return -1;
+  struct stat info;
+  if (fstat(fd, &info) < 0)
+  {
+    close(fd);
+    return -1;
+  }
+  mSize = info.st_size;
+  if ((uint64_t)mSize > (uint64_t)(size_t)-1)
+  {
+    // too big to map into this address space; (size_t)mSize would
+    // silently map just the start of it
+    VS_LOG_DEBUG("%s is too large to map", url);
+    close(fd);
+    mSize = 0;
+    return -1;
+  }
+  if (mSize > 0)
+  {
+    void* data = mmap(0, (size_t)mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED)
+    {
+      mData = (unsigned char*)data;
+      (void) madvise(data, (size_t)mSize, MADV_SEQUENTIAL);
+    }
+  }
+  // the mapping keeps the file alive
+  close(fd);
+#endif
+  if (mSize > 0 && !mData)
+  {
+    VS_LOG_DEBUG("could not map %s", url);
+    mSize = 0;
+    return -1;
+  }
+  mPosition = 0;
+  mOpen = true;
+  return 0;
+}
+
+int
+MmapURLProtocolHandler :: url_close()
+{
+  if (!mOpen)
+    return -1;
+  if (mData)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(mData);
+#else
+    munmap(mData, (size_t)mSize);
+#endif
+  }
+  mData = 0;
+  mSize = 0;
+  mPosition = 0;
+  mOpen = false;
+  return 0;
+}
+
+int64_t
+MmapURLProtocolHandler :: url_seek(int64_t position,
+    int whence)
+{
+  if (!mOpen)
+    return -1;
+
+  int64_t newPosition;
+  switch(whence) {
+    case SK_SEEK_SET:
+      newPosition = position;
+      break;
+    case SK_SEEK_CUR:
+      newPosition = mPosition + position;
+      break;
+    case SK_SEEK_END:
+      newPosition = mSize + position;
+      break;
+    case SK_SEEK_SIZE:
+      return mSize;
+    default:
+      return -1;
+  }
+  if (newPosition < 0)
+    return -1;
+  mPosition = newPosition;
+  return mPosition;
+}
+
+int
+MmapURLProtocolHandler :: url_read(unsigned char* buf, int size)
+{
+  if (!mOpen)
+    return -1;
+  if (size <= 0 || mPosition >= mSize)
+    return 0;
+  int64_t available = mSize - mPosition;
+  if (available < size)
+    size = (int)available;
+  memcpy(buf, mData + mPosition, size);
+  mPosition += size;
+  return size;
+}
+
+int
+MmapURLProtocolHandler :: url_write(const unsigned char*, int)
+{
+  return -1;
+}
+
+URLProtocolHandler::SeekableFlags
+MmapURLProtocolHandler :: url_seekflags( const char*, int)
+{
+  return URLProtocolHandler::SK_SEEKABLE_NORMAL;
+}
+
+}}}}
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef MMAPURLPROTOCOLHANDLER_H_
+#define MMAPURLPROTOCOLHANDLER_H_
+
+#include <com/xuggle/xuggler/io/URLProtocolHandler.h>
+
+namespace com { namespace xuggle { namespace xuggler { namespace io
+  {
+  class MmapURLProtocolManager;
+
+  /**
+   * A read-only handler that maps the whole file into memory.
+   *
+   * Reads are a copy out of the mapping, and seeking (including
+   * {@link URLProtocolHandler#SK_SEEK_SIZE}) never touches the file.
+   * We tell the operating system we will read sequentially so it
+   * can read ahead aggressively.
+   * <p>
+   * Opening for writing fails, as does opening a file too large to
+   * map into the address space (on 32-bit hosts); use a
+   * {@link StdioURLProtocolHandler} for those.
+   * </p>
+   */
+  class VS_API_XUGGLER_IO MmapURLProtocolHandler : public URLProtocolHandler
+  {
+  public:
+    MmapURLProtocolHandler(MmapURLProtocolManager* mgr);
+    virtual ~MmapURLProtocolHandler();
+
+    // Now, let's have our forwarding functions
+    virtual int url_open(const char *url, int flags);
+    virtual int url_close();
+    virtual int url_read(unsigned char* buf, int size);
+    virtual int url_write(const unsigned char* buf, int size);
+    virtual int64_t url_seek(int64_t position, int whence);
+    virtual SeekableFlags url_seekflags(const char* url, int flags);
+
+  private:
+    bool mOpen;
+    unsigned char* mData;
+    int64_t mSize;
+    int64_t mPosition;
+    void reset();
+  };
+  }}}}
+#endif /*MMAPURLPROTOCOLHANDLER_H_*/
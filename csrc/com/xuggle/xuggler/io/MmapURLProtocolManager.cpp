@@ -0,0 +1,46 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <com/xuggle/xuggler/io/MmapURLProtocolManager.h>
+
+namespace com { namespace xuggle { namespace xuggler { namespace io
+{
+
+MmapURLProtocolManager*
+MmapURLProtocolManager :: registerProtocol(const char *aProtocolName)
+{
+  MmapURLProtocolManager* mgr = new MmapURLProtocolManager(aProtocolName);
+  return dynamic_cast<MmapURLProtocolManager*>(URLProtocolManager::registerProtocol(mgr));
+}
+
+MmapURLProtocolManager :: MmapURLProtocolManager(
+    const char * aProtocolName) : URLProtocolManager(aProtocolName)
+{
+}
+
+MmapURLProtocolManager :: ~MmapURLProtocolManager()
+{
+}
+
+MmapURLProtocolHandler *
+MmapURLProtocolManager :: getHandler(const char *, int)
+{
+  return new MmapURLProtocolHandler(this);
+}
+}}}}
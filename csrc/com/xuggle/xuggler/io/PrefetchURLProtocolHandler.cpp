@@ -0,0 +1,483 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+
+#include <com/xuggle/ferry/JNIHelper.h>
+#include <com/xuggle/ferry/Logger.h>
+
+#include <com/xuggle/xuggler/io/PrefetchURLProtocolHandler.h>
+#include <com/xuggle/xuggler/io/PrefetchURLProtocolManager.h>
+
+using namespace com::xuggle::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+namespace com { namespace xuggle{ namespace xuggler { namespace io
+{
+
+PrefetchURLProtocolHandler :: PrefetchURLProtocolHandler(
+    PrefetchURLProtocolManager* mgr,
+    URLProtocolHandler* handler,
+    int32_t blockSize,
+    int32_t numBlocks) : URLProtocolHandler(mgr)
+{
+  mPrefetchManager = mgr;
+  mHandler = handler;
+  mBlockSize = blockSize > 0 ? blockSize : 64*1024;
+  mNumBlocks = numBlocks > 0 ? numBlocks : 16;
+
+  pthread_mutex_init(&mLock, 0);
+  pthread_cond_init(&mDataReady, 0);
+  pthread_cond_init(&mSpaceReady, 0);
+  pthread_mutex_init(&mHandlerLock, 0);
+  mThreadStarted = false;
+  mStopping = false;
+
+  mBlocks = 0;
+  mSpare = 0;
+  mFirstBlock = 0;
+  mFilledBlocks = 0;
+  mFirstOffset = 0;
+  mPosition = 0;
+  mFetchPosition = 0;
+  mGeneration = 0;
+  mSeekedGeneration = 0;
+  mNeedSeek = false;
+  mEOF = false;
+  mError = false;
+
+  mNumHits = 0;
+  mNumStalls = 0;
+  mNumSeeksReused = 0;
+  mNumSeeksInvalidated = 0;
+  mNumBytesPrefetched = 0;
+}
+
+PrefetchURLProtocolHandler :: ~PrefetchURLProtocolHandler()
+{
+  reset();
+  if (mBlocks)
+    for(int32_t i = 0; i < mNumBlocks; i++)
+      delete [] mBlocks[i].mData;
+  delete [] mBlocks;
+  delete [] mSpare;
+  delete mHandler;
+  pthread_mutex_destroy(&mHandlerLock);
+  pthread_cond_destroy(&mSpaceReady);
+  pthread_cond_destroy(&mDataReady);
+  pthread_mutex_destroy(&mLock);
+}
+
+void
+PrefetchURLProtocolHandler :: reset()
+{
+  if (mThreadStarted)
+    (void) url_close();
+}
+
+const char*
+PrefetchURLProtocolHandler :: getWrappedURL(const char* url)
+{
+  char proto[256];
+  const char* protocol = URLProtocolManager::parseProtocol(proto,
+      sizeof(proto), url);
+  if (!protocol)
+    return 0;
+  url = url + strlen(protocol);
+  if (*url == ':' || *url == ',')
+    ++url;
+  return url;
+}
+
+int
+PrefetchURLProtocolHandler :: url_open(const char *url, int flags)
+{
+  if (!mHandler || !url || !*url)
+    return -1;
+  reset();
+
+  // if we were found by protocol, our wrapped handler gets the rest
+  // of the url
+  if (mPrefetchManager)
+  {
+    url = getWrappedURL(url);
+    if (!url || !*url)
+      return -1;
+  }
+  int retval = mHandler->url_open(url, flags);
+  if (retval < 0 || flags != URLProtocolHandler::URL_RDONLY_MODE)
+    return retval;
+
+  mNumHits = 0;
+  mNumStalls = 0;
+  mNumSeeksReused = 0;
+  mNumSeeksInvalidated = 0;
+  mNumBytesPrefetched = 0;
+  if (!start())
+    VS_LOG_DEBUG("Could not start read-ahead thread; reading directly");
+  return retval;
+}
+
+bool
+PrefetchURLProtocolHandler :: start()
+{
+  if (!mBlocks)
+  {
+    mBlocks = new Block[mNumBlocks];
+    for(int32_t i = 0; i < mNumBlocks; i++)
+    {
+      mBlocks[i].mData = new unsigned char[mBlockSize];
+      mBlocks[i].mPosition = 0;
+      mBlocks[i].mLength = 0;
+    }
+    mSpare = new unsigned char[mBlockSize];
+  }
+  // the wrapped handler was just opened, so it is already where we
+  // want to start
+  clearRing(0);
+  mNeedSeek = false;
+  mSeekedGeneration = mGeneration;
+  mStopping = false;
+  mThreadStarted = pthread_create(&mThread, 0,
+      PrefetchURLProtocolHandler::runThread, this) == 0;
+  return mThreadStarted;
+}
+
+void
+PrefetchURLProtocolHandler :: stop()
+{
+  if (!mThreadStarted)
+    return;
+  pthread_mutex_lock(&mLock);
+  mStopping = true;
+  pthread_cond_broadcast(&mSpaceReady);
+  pthread_mutex_unlock(&mLock);
+  pthread_join(mThread, 0);
+  mThreadStarted = false;
+}
+
+void*
+PrefetchURLProtocolHandler :: runThread(void* arg)
+{
+  // a daemon thread, so we never keep the Java virtual machine alive
+  JavaVM* vm = JNIHelper::sGetVM();
+  if (vm)
+  {
+    JNIEnv* env = 0;
+    vm->AttachCurrentThreadAsDaemon((void**)(void*)&env, 0);
+  }
+  ((PrefetchURLProtocolHandler*)arg)->run();
+  if (vm)
+    vm->DetachCurrentThread();
+  return 0;
+}
+
+void
+PrefetchURLProtocolHandler :: run()
+{
+  pthread_mutex_lock(&mLock);
+  for(;;)
+  {
+    while(!mStopping && (mFilledBlocks == mNumBlocks || mEOF || mError))
+      pthread_cond_wait(&mSpaceReady, &mLock);
+    if (mStopping)
+      break;
+
+    int64_t generation = mGeneration;
+    int64_t position = mFetchPosition;
+    bool needSeek = mNeedSeek;
+    mNeedSeek = false;
+    pthread_mutex_unlock(&mLock);
+
+    if (needSeek)
+    {
+      // url_seek is waiting on this, so report it before reading
+      pthread_mutex_lock(&mHandlerLock);
+      bool seeked = mHandler->url_seek(position, SK_SEEK_SET) >= 0;
+      pthread_mutex_unlock(&mHandlerLock);
+
+      pthread_mutex_lock(&mLock);
+      if (generation == mGeneration)
+      {
+        mSeekedGeneration = generation;
+        if (!seeked)
+          mError = true;
+        pthread_cond_broadcast(&mDataReady);
+      }
+      continue;
+    }
+
+    // mSpare is only ever touched by this thread, so we can fill it
+    // without holding mLock
+    pthread_mutex_lock(&mHandlerLock);
+    int bytesRead = mHandler->url_read(mSpare, mBlockSize);
+    pthread_mutex_unlock(&mHandlerLock);
+
+    pthread_mutex_lock(&mLock);
+    if (generation != mGeneration)
+      // someone seeked while we were reading; throw it away
+      continue;
+    if (bytesRead > 0)
+    {
+      Block* block = &mBlocks[(mFirstBlock + mFilledBlocks) % mNumBlocks];
+      unsigned char* data = block->mData;
+      block->mData = mSpare;
+      block->mPosition = position;
+      block->mLength = bytesRead;
+      mSpare = data;
+      ++mFilledBlocks;
+      mFetchPosition += bytesRead;
+      mNumBytesPrefetched += bytesRead;
+    }
+    else if (bytesRead == 0)
+      mEOF = true;
+    else
+      mError = true;
+    pthread_cond_broadcast(&mDataReady);
+  }
+  pthread_mutex_unlock(&mLock);
+}
+
+void
+PrefetchURLProtocolHandler :: clearRing(int64_t position)
+{
+  ++mGeneration;
+  mFirstBlock = 0;
+  mFilledBlocks = 0;
+  mFirstOffset = 0;
+  mPosition = position;
+  mFetchPosition = position;
+  mNeedSeek = true;
+  mEOF = false;
+  mError = false;
+}
+
+int
+PrefetchURLProtocolHandler :: url_close()
+{
+  if (!mHandler)
+    return -1;
+  if (mThreadStarted)
+  {
+    stop();
+    if (mPrefetchManager)
+      mPrefetchManager->addStatistics(this);
+  }
+  return mHandler->url_close();
+}
+
+int
+PrefetchURLProtocolHandler :: url_read(unsigned char* buf, int size)
+{
+  if (!mHandler)
+    return -1;
+  if (!mThreadStarted)
+    return mHandler->url_read(buf, size);
+  if (size <= 0)
+    return 0;
+
+  pthread_mutex_lock(&mLock);
+  bool stalled = false;
+  while(!mFilledBlocks && !mEOF && !mError)
+  {
+    stalled = true;
+    pthread_cond_wait(&mDataReady, &mLock);
+  }
+  if (!mFilledBlocks)
+  {
+    int retval = mError ? -1 : 0;
+    pthread_mutex_unlock(&mLock);
+    return retval;
+  }
+
+  int bytesRead = 0;
+  bool freedBlock = false;
+  while(bytesRead < size && mFilledBlocks)
+  {
+    Block* block = &mBlocks[mFirstBlock];
+    int32_t bytesToCopy = block->mLength - mFirstOffset;
+    if (bytesToCopy > size - bytesRead)
+      bytesToCopy = size - bytesRead;
+    memcpy(buf + bytesRead, block->mData + mFirstOffset, bytesToCopy);
+    bytesRead += bytesToCopy;
+    mFirstOffset += bytesToCopy;
+    if (mFirstOffset == block->mLength)
+    {
+      mFirstBlock = (mFirstBlock + 1) % mNumBlocks;
+      --mFilledBlocks;
+      mFirstOffset = 0;
+      freedBlock = true;
+    }
+  }
+  mPosition += bytesRead;
+  if (stalled)
+    ++mNumStalls;
+  else
+    ++mNumHits;
+  if (freedBlock)
+    pthread_cond_signal(&mSpaceReady);
+  pthread_mutex_unlock(&mLock);
+  return bytesRead;
+}
+
+int
+PrefetchURLProtocolHandler :: url_write(const unsigned char* buf, int size)
+{
+  if (!mHandler)
+    return -1;
+  return mHandler->url_write(buf, size);
+}
+
+int64_t
+PrefetchURLProtocolHandler :: seekInner(int64_t position, int whence)
+{
+  pthread_mutex_lock(&mHandlerLock);
+  int64_t retval = mHandler->url_seek(position, whence);
+  pthread_mutex_unlock(&mHandlerLock);
+  return retval;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: url_seek(int64_t position, int whence)
+{
+  if (!mHandler)
+    return -1;
+  if (!mThreadStarted)
+    return mHandler->url_seek(position, whence);
+
+  int64_t target;
+  switch(whence)
+  {
+    case SK_SEEK_SET:
+      target = position;
+      break;
+    case SK_SEEK_CUR:
+      pthread_mutex_lock(&mLock);
+      target = mPosition + position;
+      pthread_mutex_unlock(&mLock);
+      break;
+    case SK_SEEK_END:
+    {
+      // we need an absolute position to know if we have it buffered
+      int64_t size = seekInner(0, SK_SEEK_SIZE);
+      if (size < 0)
+        return -1;
+      target = size + position;
+      break;
+    }
+    case SK_SEEK_SIZE:
+      return seekInner(position, whence);
+    default:
+      return -1;
+  }
+  if (target < 0)
+    return -1;
+
+  pthread_mutex_lock(&mLock);
+  // a failed seek leaves nothing to read, so let the caller retry it
+  if (target != mPosition || (!mFilledBlocks && mError))
+  {
+    int64_t start = mFilledBlocks ? mBlocks[mFirstBlock].mPosition : mPosition;
+    int64_t end = mFilledBlocks ? mFetchPosition : mPosition;
+    if (mFilledBlocks && target >= start && target < end)
+    {
+      // skip whole blocks in front of the target, then into the one
+      // that holds it
+      bool freedBlock = false;
+      while(target >= mBlocks[mFirstBlock].mPosition +
+          mBlocks[mFirstBlock].mLength)
+      {
+        mFirstBlock = (mFirstBlock + 1) % mNumBlocks;
+        --mFilledBlocks;
+        freedBlock = true;
+      }
+      mFirstOffset = (int32_t)(target - mBlocks[mFirstBlock].mPosition);
+      mPosition = target;
+      ++mNumSeeksReused;
+      if (freedBlock)
+        pthread_cond_signal(&mSpaceReady);
+    }
+    else
+    {
+      clearRing(target);
+      ++mNumSeeksInvalidated;
+      pthread_cond_signal(&mSpaceReady);
+      // wait for the wrapped handler to get there, so a bad seek
+      // fails here rather than on the next read
+      while(mSeekedGeneration != mGeneration)
+        pthread_cond_wait(&mDataReady, &mLock);
+      if (mError)
+        target = -1;
+    }
+  }
+  pthread_mutex_unlock(&mLock);
+  return target;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: getStatistic(int64_t* statistic)
+{
+  pthread_mutex_lock(&mLock);
+  int64_t retval = *statistic;
+  pthread_mutex_unlock(&mLock);
+  return retval;
+}
+
+int64_t
+PrefetchURLProtocolHandler :: getNumHits()
+{
+  return getStatistic(&mNumHits);
+}
+
+int64_t
+PrefetchURLProtocolHandler :: getNumStalls()
+{
+  return getStatistic(&mNumStalls);
+}
+
+int64_t
+PrefetchURLProtocolHandler :: getNumSeeksReused()
+{
+  return getStatistic(&mNumSeeksReused);
+}
+
+int64_t
+PrefetchURLProtocolHandler :: getNumSeeksInvalidated()
+{
+  return getStatistic(&mNumSeeksInvalidated);
+}
+
+int64_t
+PrefetchURLProtocolHandler :: getNumBytesPrefetched()
+{
+  return getStatistic(&mNumBytesPrefetched);
+}
+
+URLProtocolHandler::SeekableFlags
+PrefetchURLProtocolHandler :: url_seekflags(const char* url, int flags)
+{
+  if (!mHandler)
+    return URLProtocolHandler::SK_NOT_SEEKABLE;
+  if (mPrefetchManager && url)
+    url = getWrappedURL(url);
+  return mHandler->url_seekflags(url, flags);
+}
+
+}}}}
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PREFETCHURLPROTOCOLHANDLER_H_
+#define PREFETCHURLPROTOCOLHANDLER_H_
+
+#include <pthread.h>
+
+#include <com/xuggle/xuggler/io/URLProtocolHandler.h>
+
+namespace com { namespace xuggle { namespace xuggler { namespace io
+  {
+  class PrefetchURLProtocolManager;
+
+  /**
+   * A handler that reads ahead of its caller.
+   *
+   * This wraps another {@link URLProtocolHandler} and, when opened for
+   * reading, starts a background thread that reads from the wrapped
+   * handler into a bounded ring of fixed-size blocks.  {@link #url_read}
+   * is then served out of the ring and only blocks when the ring is
+   * empty.
+   * <p>
+   * A seek to a position that is still in the ring just drops the blocks
+   * in front of it; any other seek throws away everything that was read
+   * ahead, waits for the wrapped handler to seek to the new position,
+   * and restarts reading there.
+   * </p>
+   * <p>
+   * Handlers opened for writing pass everything through to the wrapped
+   * handler.
+   * </p>
+   */
+  class VS_API_XUGGLER_IO PrefetchURLProtocolHandler : public URLProtocolHandler
+  {
+  public:
+    /**
+     * Create a new handler.
+     *
+     * @param mgr The manager that created us.  May be null.
+     * @param handler The handler to read ahead from.  We take
+     *   ownership of it and delete it when we are destroyed.
+     * @param blockSize The size, in bytes, of each block to read
+     *   ahead.
+     * @param numBlocks The maximum number of blocks to read ahead.
+     */
+    PrefetchURLProtocolHandler(PrefetchURLProtocolManager* mgr,
+        URLProtocolHandler* handler,
+        int32_t blockSize,
+        int32_t numBlocks);
+    virtual ~PrefetchURLProtocolHandler();
+
+    // Now, let's have our forwarding functions
+    virtual int url_open(const char *url, int flags);
+    virtual int url_close();
+    virtual int url_read(unsigned char* buf, int size);
+    virtual int url_write(const unsigned char* buf, int size);
+    virtual int64_t url_seek(int64_t position, int whence);
+    virtual SeekableFlags url_seekflags(const char* url, int flags);
+
+    /**
+     * Number of reads that found data already in the ring.
+     */
+    int64_t getNumHits();
+    /**
+     * Number of reads that had to wait for the background thread.
+     */
+    int64_t getNumStalls();
+    /**
+     * Number of seeks that landed inside data we had already read ahead.
+     */
+    int64_t getNumSeeksReused();
+    /**
+     * Number of seeks that threw away data we had read ahead.
+     */
+    int64_t getNumSeeksInvalidated();
+    /**
+     * Number of bytes the background thread has read.
+     */
+    int64_t getNumBytesPrefetched();
+
+    /**
+     * The URL with our own protocol stripped, i.e. the URL of the
+     * handler we wrap.
+     *
+     * @return A pointer into url, or null if url has no protocol.
+     */
+    static const char* getWrappedURL(const char* url);
+
+  private:
+    struct Block {
+      unsigned char* mData;
+      int64_t mPosition;
+      int32_t mLength;
+    };
+
+    void reset();
+    bool start();
+    void stop();
+    void run();
+    static void* runThread(void*);
+    void clearRing(int64_t position);
+    int64_t seekInner(int64_t position, int whence);
+    int64_t getStatistic(int64_t* statistic);
+
+    PrefetchURLProtocolManager* mPrefetchManager;
+    URLProtocolHandler* mHandler;
+    int32_t mBlockSize;
+    int32_t mNumBlocks;
+
+    // everything below is guarded by mLock
+    pthread_mutex_t mLock;
+    pthread_cond_t mDataReady;
+    pthread_cond_t mSpaceReady;
+    // serializes calls into mHandler between us and the background thread
+    pthread_mutex_t mHandlerLock;
+    pthread_t mThread;
+    bool mThreadStarted;
+    bool mStopping;
+
+    Block* mBlocks;
+    // a spare buffer the background thread reads into
+    unsigned char* mSpare;
+    int32_t mFirstBlock;
+    int32_t mFilledBlocks;
+    // offset into the first block of the next byte to return
+    int32_t mFirstOffset;
+    // the position of the next byte to return
+    int64_t mPosition;
+    // the position the background thread reads at next
+    int64_t mFetchPosition;
+    // bumped every time the ring is thrown away
+    int64_t mGeneration;
+    // the last generation the background thread has seeked for
+    int64_t mSeekedGeneration;
+    bool mNeedSeek;
+    bool mEOF;
+    bool mError;
+
+    int64_t mNumHits;
+    int64_t mNumStalls;
+    int64_t mNumSeeksReused;
+    int64_t mNumSeeksInvalidated;
+    int64_t mNumBytesPrefetched;
+  };
+  }}}}
+#endif /*PREFETCHURLPROTOCOLHANDLER_H_*/
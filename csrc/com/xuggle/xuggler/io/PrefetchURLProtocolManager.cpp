@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <com/xuggle/xuggler/io/PrefetchURLProtocolManager.h>
+
+namespace com { namespace xuggle { namespace xuggler { namespace io
+{
+
+PrefetchURLProtocolManager*
+PrefetchURLProtocolManager :: registerProtocol(const char *aProtocolName,
+    int32_t blockSize, int32_t numBlocks)
+{
+  PrefetchURLProtocolManager* mgr = new PrefetchURLProtocolManager(
+      aProtocolName, blockSize, numBlocks);
+  return dynamic_cast<PrefetchURLProtocolManager*>(URLProtocolManager::registerProtocol(mgr));
+}
+
+PrefetchURLProtocolManager :: PrefetchURLProtocolManager(
+    const char * aProtocolName,
+    int32_t blockSize,
+    int32_t numBlocks) : URLProtocolManager(aProtocolName)
+{
+  mBlockSize = blockSize;
+  mNumBlocks = numBlocks;
+  resetStatistics();
+}
+
+PrefetchURLProtocolManager :: ~PrefetchURLProtocolManager()
+{
+}
+
+PrefetchURLProtocolHandler *
+PrefetchURLProtocolManager :: getHandler(const char *url, int flags)
+{
+  const char* wrappedUrl = PrefetchURLProtocolHandler::getWrappedURL(url);
+  if (!wrappedUrl || !*wrappedUrl)
+    return 0;
+  URLProtocolHandler* handler = URLProtocolManager::findHandler(wrappedUrl,
+      flags, 0);
+  if (!handler)
+    return 0;
+  return new PrefetchURLProtocolHandler(this, handler, mBlockSize,
+      mNumBlocks);
+}
+
+void
+PrefetchURLProtocolManager :: resetStatistics()
+{
+  mNumHits = 0;
+  mNumStalls = 0;
+  mNumSeeksReused = 0;
+  mNumSeeksInvalidated = 0;
+  mNumBytesPrefetched = 0;
+}
+
+void
+PrefetchURLProtocolManager :: addStatistics(
+    PrefetchURLProtocolHandler* handler)
+{
+  if (!handler)
+    return;
+  __sync_fetch_and_add(&mNumHits, handler->getNumHits());
+  __sync_fetch_and_add(&mNumStalls, handler->getNumStalls());
+  __sync_fetch_and_add(&mNumSeeksReused, handler->getNumSeeksReused());
+  __sync_fetch_and_add(&mNumSeeksInvalidated,
+      handler->getNumSeeksInvalidated());
+  __sync_fetch_and_add(&mNumBytesPrefetched,
+      handler->getNumBytesPrefetched());
+}
+
+}}}}
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PREFETCHURLPROTOCOLMANAGER_H_
+#define PREFETCHURLPROTOCOLMANAGER_H_
+
+#include <com/xuggle/xuggler/io/URLProtocolManager.h>
+#include <com/xuggle/xuggler/io/PrefetchURLProtocolHandler.h>
+
+namespace com { namespace xuggle { namespace xuggler { namespace io
+{
+  /**
+   * A protocol that reads ahead of any other protocol.
+   *
+   * Once registered as, for example, "prefetch", a URL such as
+   * "prefetch:file:/tmp/foo.flv" is opened by finding the handler
+   * for "file:/tmp/foo.flv" and wrapping it in a
+   * {@link PrefetchURLProtocolHandler}.
+   * <p>
+   * Statistics from every handler we create are added to our totals
+   * when that handler is closed.
+   * </p>
+   */
+  class VS_API_XUGGLER_IO PrefetchURLProtocolManager : public URLProtocolManager
+  {
+  public:
+    /**
+     * Returns a URLProtocol handler for the given url and flags
+     *
+     * @return a {@link URLProtocolHandler} or NULL if no handler
+     *   can be found for the wrapped url.
+     */
+    PrefetchURLProtocolHandler* getHandler(const char* url, int flags);
+
+    /**
+     * Convenience method that creates a PrefetchURLProtocolManager and
+     * registers with the URLProtocolManager global methods.
+     *
+     * @param aProtocolName The protocol to register as.
+     * @param blockSize The size, in bytes, of each block handlers read
+     *   ahead.  If <= 0 we use 64 kilobytes.
+     * @param numBlocks The maximum number of blocks each handler reads
+     *   ahead.  If <= 0 we use 16.
+     */
+    static PrefetchURLProtocolManager* registerProtocol(
+        const char *aProtocolName,
+        int32_t blockSize=0,
+        int32_t numBlocks=0);
+
+    /**
+     * Total reads, across closed handlers, that found data already
+     * read ahead.
+     */
+    int64_t getNumHits() { return mNumHits; }
+    /**
+     * Total reads, across closed handlers, that had to wait for data.
+     */
+    int64_t getNumStalls() { return mNumStalls; }
+    /**
+     * Total seeks, across closed handlers, that landed inside data
+     * already read ahead.
+     */
+    int64_t getNumSeeksReused() { return mNumSeeksReused; }
+    /**
+     * Total seeks, across closed handlers, that threw away data read
+     * ahead.
+     */
+    int64_t getNumSeeksInvalidated() { return mNumSeeksInvalidated; }
+    /**
+     * Total bytes, across closed handlers, read ahead.
+     */
+    int64_t getNumBytesPrefetched() { return mNumBytesPrefetched; }
+    /**
+     * Sets all statistics back to zero.
+     */
+    void resetStatistics();
+
+    /**
+     * Adds the statistics of a handler to our totals.  Called by
+     * handlers when they are closed.
+     */
+    void addStatistics(PrefetchURLProtocolHandler* handler);
+
+  protected:
+    PrefetchURLProtocolManager(const char *aProtocolName,
+        int32_t blockSize, int32_t numBlocks);
+    virtual ~PrefetchURLProtocolManager();
+
+  private:
+    int32_t mBlockSize;
+    int32_t mNumBlocks;
+    volatile int64_t mNumHits;
+    volatile int64_t mNumStalls;
+    volatile int64_t mNumSeeksReused;
+    volatile int64_t mNumSeeksInvalidated;
+    volatile int64_t mNumBytesPrefetched;
+  };
+}}}}
+#endif /*PREFETCHURLPROTOCOLMANAGER_H_*/
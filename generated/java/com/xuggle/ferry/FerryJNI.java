@@ -39,6 +39,26 @@ class FerryJNI {
    * Internal Only.  Do not call.
    */
   public native static void setMemoryModel(int value);
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolHits();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolMisses();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolRetainedBytes();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static long getPoolMaxRetainedBytes();
+  /**
+   * Internal Only.  Do not call.
+   */
+  public native static void setPoolMaxRetainedBytes(long value);
   
 
   public final static native long new_AtomicInteger__SWIG_0();
@@ -76,6 +96,12 @@ class FerryJNI {
   public final static native boolean Logger_isGlobalLogging(int jarg1);
   public final static native void Logger_setGlobalIsLogging(int jarg1, boolean jarg2);
   public final static native String Logger_getName(long jarg1, Logger jarg1_);
+  public final static native void Logger_setAsynchronous(boolean jarg1);
+  public final static native boolean Logger_isAsynchronous();
+  public final static native void Logger_flush();
+  public final static native long Logger_getNumDroppedRecords();
+  public final static native long Logger_getNumForwardedRecords();
+  public final static native void Logger_resetRecordCounts();
   public final static native void delete_Logger(long jarg1);
   public final static native long Mutex_make();
   public final static native void Mutex_lock(long jarg1, Mutex jarg1_);
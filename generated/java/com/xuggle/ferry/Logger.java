@@ -218,6 +218,68 @@ public class Logger {
     return FerryJNI.Logger_getName(swigCPtr, this);
   }
 
+/**
+ * Turn asynchronous logging on or off for all loggers.  
+ * <p>  
+ * When on, a thread that logs formats its message into a lock-free  
+ * queue of its own and carries on; a single background thread  
+ * forwards queued messages to Java (or standard error) in batches.  
+ * When a thread's queue is full its messages are dropped and counted  
+ * rather than making it wait.  Messages too long to queue are  
+ * logged synchronously.  
+ * </p><p>  
+ * Off by default.  Turning it off waits for queued messages to be  
+ * forwarded.  
+ * </p>  
+ * @param	value true to log asynchronously.  
+ * @since	5.5  
+ */
+  public static void setAsynchronous(boolean value) {
+    FerryJNI.Logger_setAsynchronous(value);
+  }
+
+/**
+ * @return	true if logging is asynchronous.  
+ * @since	5.5  
+ */
+  public static boolean isAsynchronous() {
+    return FerryJNI.Logger_isAsynchronous();
+  }
+
+/**
+ * Wait until every message queued so far has been forwarded.  
+ * @since	5.5  
+ */
+  public static void flush() {
+    FerryJNI.Logger_flush();
+  }
+
+/**
+ * @return	the number of messages dropped because the logging  
+ *   thread's queue was full.  
+ * @since	5.5  
+ */
+  public static long getNumDroppedRecords() {
+    return FerryJNI.Logger_getNumDroppedRecords();
+  }
+
+/**
+ * @return	the number of queued messages the background thread has  
+ *   forwarded.  
+ * @since	5.5  
+ */
+  public static long getNumForwardedRecords() {
+    return FerryJNI.Logger_getNumForwardedRecords();
+  }
+
+/**
+ * Set the dropped and forwarded message counts to zero.  
+ * @since	5.5  
+ */
+  public static void resetRecordCounts() {
+    FerryJNI.Logger_resetRecordCounts();
+  }
+
   public enum Level {
   /**
    * Different logging levels (noiseness) supported by us.
@@ -230,6 +230,72 @@ public class Global extends RefCounted {
     XugglerJNI.Global_setFFmpegLoggingLevel(level);
   }
 
+/**
+ * Get the lock manager implementation FFmpeg is currently using.  
+ * @return	the lock manager type.  
+ * @since	5.5  
+ */
+  public static Global.LockManagerType getLockManagerType() {
+    return Global.LockManagerType.swigToEnum(XugglerJNI.Global_getLockManagerType());
+  }
+
+/**
+ * Internal Only.  Choose the lock manager FFmpeg will use.  
+ * <p>  
+ * The choice is made when Xuggler is first initialized, which  
+ * happens the first time almost any Xuggler object is made, so  
+ * this must be called before that.  Afterwards FFmpeg's locks  
+ * may be held by other threads and cannot safely be replaced.  
+ * </p>  
+ * @param	type the lock manager type to use.  
+ * @return	0 on success; < 0 if Xuggler is already initialized  
+ * with a different lock manager.  
+ * @since	5.5  
+ */
+  public static int setLockManagerType(Global.LockManagerType type) {
+    return XugglerJNI.Global_setLockManagerType(type.swigValue());
+  }
+
+/**
+ * Get the number of times FFmpeg has obtained a lock from  
+ * the lock manager.  
+ * @return	the number of lock obtains.  
+ * @since	5.5  
+ */
+  public static long getLockManagerObtainCount() {
+    return XugglerJNI.Global_getLockManagerObtainCount();
+  }
+
+/**
+ * Get the number of lock obtains that had to wait because  
+ * another thread held the lock.  Only the  
+ * {@link LockManagerType#LOCK_MANAGER_NATIVE} lock manager can tell,  
+ * so this stays zero with {@link LockManagerType#LOCK_MANAGER_JAVA}.  
+ * @return	the number of contended lock obtains.  
+ * @since	5.5  
+ */
+  public static long getLockManagerContendedCount() {
+    return XugglerJNI.Global_getLockManagerContendedCount();
+  }
+
+/**
+ * Get the total time threads have spent waiting to obtain  
+ * a lock from the lock manager.  
+ * @return	the time spent waiting, in microseconds.  
+ * @since	5.5  
+ */
+  public static long getLockManagerWaitTime() {
+    return XugglerJNI.Global_getLockManagerWaitTime();
+  }
+
+/**
+ * Reset all of the lock manager counters to zero.  
+ * @since	5.5  
+ */
+  public static void resetLockManagerStatistics() {
+    XugglerJNI.Global_resetLockManagerStatistics();
+  }
+
 /**
  * A value that means no time stamp is set for a given object.  
  * if the {@link IMediaData#getTimeStamp()} method of an  
@@ -242,4 +308,58 @@ public class Global extends RefCounted {
  * This means that 1 tick of a time stamp is 1 Microsecond.  
  */
   public final static long DEFAULT_PTS_PER_SECOND = XugglerJNI.Global_DEFAULT_PTS_PER_SECOND_get();
+
+  public enum LockManagerType {
+  /**
+   * The implementations of the lock manager that FFmpeg uses  
+   * to serialize codec opens and closes.  
+   * Native mutexes that never touch the Java virtual machine.  
+   * The default.  
+   */
+    LOCK_MANAGER_NATIVE(XugglerJNI.Global_LOCK_MANAGER_NATIVE_get()),
+  /**
+   * Java monitors (the behaviour before 5.5).  Every codec open  
+   * and close attaches the calling thread to the Java virtual  
+   * machine.  
+   */
+    LOCK_MANAGER_JAVA(XugglerJNI.Global_LOCK_MANAGER_JAVA_get());
+
+    public final int swigValue() {
+      return swigValue;
+    }
+
+    public static LockManagerType swigToEnum(int swigValue) {
+      LockManagerType[] swigValues = LockManagerType.class.getEnumConstants();
+      if (swigValue < swigValues.length && swigValue >= 0 && swigValues[swigValue].swigValue == swigValue)
+        return swigValues[swigValue];
+      for (LockManagerType swigEnum : swigValues)
+        if (swigEnum.swigValue == swigValue)
+          return swigEnum;
+      throw new IllegalArgumentException("No enum " + LockManagerType.class + " with value " + swigValue);
+    }
+
+    @SuppressWarnings("unused")
+    private LockManagerType() {
+      this.swigValue = SwigNext.next++;
+    }
+
+    @SuppressWarnings("unused")
+    private LockManagerType(int swigValue) {
+      this.swigValue = swigValue;
+      SwigNext.next = swigValue+1;
+    }
+
+    @SuppressWarnings("unused")
+    private LockManagerType(LockManagerType swigEnum) {
+      this.swigValue = swigEnum.swigValue;
+      SwigNext.next = this.swigValue+1;
+    }
+
+    private final int swigValue;
+
+    private static class SwigNext {
+      private static int next = 0;
+    }
+  }
+
 }
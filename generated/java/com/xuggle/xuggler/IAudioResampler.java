@@ -11,6 +11,12 @@ import com.xuggle.ferry.*;
 /**
  * Used to resample {@link IAudioSamples} to different sample rates 
  * or number of channels.  
+ * <p>  
+ * Any number of channels, and any {@link IAudioSamples.Format}, packed 
+ * or planar, may be converted in one pass. Channels are assumed to be 
+ * in FFmpeg's default layout for their count (e.g. 6 channels is 5.1) 
+ * and are mixed down or up accordingly.  
+ * </p>  
  */
 public class IAudioResampler extends RefCounted {
   // JNIHelper.swg: Start generated code
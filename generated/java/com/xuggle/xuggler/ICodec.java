@@ -476,6 +476,31 @@ public class ICodec extends RefCounted {
     return (cPtr == 0) ? null : new ICodec(cPtr, false);
   }
 
+/**
+ * Get the number of installed codecs of the given type.  
+ * @param	type the type of codec  
+ * @return	the number of installed codecs of that type.  
+ * @since	5.5  
+ */
+  public static int getNumInstalledCodecsOfType(ICodec.Type type) {
+    return XugglerJNI.ICodec_getNumInstalledCodecsOfType(type.swigValue());
+  }
+
+/**
+ * Get the {@link ICodec} of the given type at the given index.  Codecs  
+ * of a type are listed in the same order as  
+ * {@link #getInstalledCodec(int)} lists them.  
+ * @param	type the type of codec  
+ * @param	index the index in our list of codecs of that type  
+ * @return	the codec, or null if index < 0 or index >=  
+ * {@link #getNumInstalledCodecsOfType(Type)}  
+ * @since	5.5  
+ */
+  public static ICodec getInstalledCodecOfType(ICodec.Type type, int index) {
+    long cPtr = XugglerJNI.ICodec_getInstalledCodecOfType(type.swigValue(), index);
+    return (cPtr == 0) ? null : new ICodec(cPtr, false);
+  }
+
 /**
  *  
  * Not all codecs will report this number.  
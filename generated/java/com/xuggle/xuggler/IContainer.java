@@ -519,6 +519,77 @@ public class IContainer extends RefCounted implements com.xuggle.xuggler.IConfig
     return retval;
   }
 
+  /**
+   * Reads up to <code>numPackets</code> packets from this container
+   * into the caller-owned <code>packets</code>, in one native call.
+   * <p>
+   * Each packet is read exactly as {@link #readNextPacket(IPacket)}
+   * would read it; reading stops early at the first error (including
+   * end of file).  Re-using the same array of packets from call to
+   * call avoids allocating any new packets while reading.
+   * </p>
+   * 
+   * @param packets [In/Out] The packets to read into.
+   * @param numPackets The most packets to read; must not be more than
+   *   <code>packets.length</code>.
+   * @return the number of packets read (which may be less than
+   *   <code>numPackets</code>), 0 if <code>numPackets</code> is 0, or
+   *   &lt;0 if the first read failed.
+   * @throws IllegalArgumentException if <code>packets</code> is null,
+   *   too short, or contains a null packet.
+   * @since 5.5
+   */
+  public int readNextPackets(IPacket[] packets, int numPackets)
+  {
+    return XugglerJNI.IContainer_readNextPackets(getCPtr(this), this,
+        getPacketPointers(packets, numPackets), numPackets);
+  }
+
+  /**
+   * Writes the first <code>numPackets</code> of <code>packets</code> to
+   * this container, in order, in one native call.
+   * <p>
+   * Each packet is written exactly as
+   * {@link #writePacket(IPacket, boolean)} would write it; writing stops
+   * early at the first error.
+   * </p>
+   * 
+   * @param packets [In] The packets to write.
+   * @param numPackets The number of packets to write; must not be more
+   *   than <code>packets.length</code>.
+   * @param forceInterleave [In] See
+   *   {@link #writePacket(IPacket, boolean)}.
+   * @return the number of packets written (which may be less than
+   *   <code>numPackets</code>), 0 if <code>numPackets</code> is 0, or
+   *   &lt;0 if the first write failed.
+   * @throws IllegalArgumentException if <code>packets</code> is null,
+   *   too short, or contains a null packet.
+   * @since 5.5
+   */
+  public int writePackets(IPacket[] packets, int numPackets,
+      boolean forceInterleave)
+  {
+    return XugglerJNI.IContainer_writePackets(getCPtr(this), this,
+        getPacketPointers(packets, numPackets), numPackets, forceInterleave);
+  }
+
+  private static long[] getPacketPointers(IPacket[] packets, int numPackets)
+  {
+    if (packets == null)
+      throw new IllegalArgumentException("no packets");
+    if (numPackets < 0 || numPackets > packets.length)
+      throw new IllegalArgumentException("invalid number of packets: "
+          + numPackets);
+    long[] pointers = new long[numPackets];
+    for(int i = 0; i < numPackets; i++)
+    {
+      if (packets[i] == null)
+        throw new IllegalArgumentException("null packet at index " + i);
+      pointers[i] = IPacket.getCPtr(packets[i]);
+    }
+    return pointers;
+  }
+
   
 
 /**
@@ -1523,6 +1594,231 @@ public class IContainer extends RefCounted implements com.xuggle.xuggler.IConfig
     return XugglerJNI.IContainer_open__SWIG_2(swigCPtr, this, url, type.swigValue(), IContainerFormat.getCPtr(containerFormat), containerFormat, streamsCanBeAddedDynamically, queryStreamMetaData, IMetaData.getCPtr(options), options, IMetaData.getCPtr(optionsNotSet), optionsNotSet);
   }
 
+/**
+ * Sets whether {@link #readNextPacket(IPacket)} hands the payload  
+ * FFmpeg read directly to the {@link IPacket} instead of copying it.  
+ * <p>  
+ * When true, and the demuxer allocated the payload itself, the  
+ * {@link IPacket} takes ownership of that memory and no copy is made.  
+ * Payloads the demuxer does not own (for example data still held by a  
+ * parser) are always copied.  The bytes and time stamps read are the  
+ * same either way.  
+ * </p><p>  
+ * Defaults to false.  
+ * </p>  
+ * @param	value true to read packets without copying their payloads.  
+ * @since	5.5  
+ */
+  public void setZeroCopyReads(boolean value) {
+    XugglerJNI.IContainer_setZeroCopyReads(swigCPtr, this, value);
+  }
+
+/**
+ * Get whether {@link #readNextPacket(IPacket)} avoids copying payloads.  
+ * @see	#setZeroCopyReads(boolean)  
+ * @return	true if packets are read without copying their payloads.  
+ * @since	5.5  
+ */
+  public boolean getZeroCopyReads() {
+    return XugglerJNI.IContainer_getZeroCopyReads(swigCPtr, this);
+  }
+
+/**
+ * Reads every remaining packet in this container, indexing the  
+ * keyframes of each stream, then seeks back to the start.  
+ * <p>  
+ * Demuxers for some formats, such as MPEG-TS, MPEG-PS and raw  
+ * streams, keep little or no index of their own, so seeking in them  
+ * means searching the file.  Once this container has an index,  
+ * {@link #seekKeyFrame(int, long, int)} and  
+ * {@link #seekKeyFrame(int, long, long, long, int)} look the nearest  
+ * keyframe up in it and seek straight to its byte position, and  
+ * {@link IStream#findTimeStampEntryInIndex(long, int)} sees the  
+ * entries too.  Formats that read a complete index from their header  
+ * (MP4, Matroska, AVI...) are indexed but still seek the usual way.  
+ * </p><p>  
+ * Video streams keep every keyframe; other streams keep at most one  
+ * a second.  Call this right after opening, before reading or  
+ * seeking.  The index lasts until the container is closed; use  
+ * {@link #writeKeyFrameIndex(String)} to keep it for next time.  
+ * </p>  
+ * @return	the number of keyframes indexed, or <0 on error.  
+ * @since	5.5  
+ */
+  public int buildKeyFrameIndex() {
+    return XugglerJNI.IContainer_buildKeyFrameIndex(swigCPtr, this);
+  }
+
+/**
+ * Saves the keyframe index built by {@link #buildKeyFrameIndex()} or  
+ * read by {@link #readKeyFrameIndex(String)} to a sidecar file.  
+ * @param	url Where to write the index; any url FFmpeg can open for  
+ * writing.  
+ * @return	the number of keyframes written, or <0 on error.  
+ * @since	5.5  
+ */
+  public int writeKeyFrameIndex(String url) {
+    return XugglerJNI.IContainer_writeKeyFrameIndex(swigCPtr, this, url);
+  }
+
+/**
+ * Loads a keyframe index saved by {@link #writeKeyFrameIndex(String)},  
+ * instead of building it again.  
+ * <p>  
+ * The index is rejected if it was written for a file of a different  
+ * size, or for different streams.  Like  
+ * {@link #buildKeyFrameIndex()}, call this right after opening.  
+ * </p>  
+ * @param	url Where to read the index from.  
+ * @return	the number of keyframes read, or <0 on error, in which case  
+ * this container has no index.  
+ * @since	5.5  
+ */
+  public int readKeyFrameIndex(String url) {
+    return XugglerJNI.IContainer_readKeyFrameIndex(swigCPtr, this, url);
+  }
+
+/**
+ * Sets the most bytes this container reads, when opened for reading,  
+ * to guess its format and to find out the parameters of its streams.  
+ * <p>  
+ * Smaller values make {@link #open(String, Type, IContainerFormat)}  
+ * and {@link #queryStreamMetaData()} faster, at the risk of not  
+ * finding out everything about every stream.  Takes effect on the next  
+ * open.  
+ * </p>  
+ * @param	size The most bytes to read, or 0 for FFmpeg's default.  
+ * @return	0 on success, or <0 if size is negative.  
+ * @since	5.5  
+ */
+  public int setProbeSize(int size) {
+    return XugglerJNI.IContainer_setProbeSize(swigCPtr, this, size);
+  }
+
+/**
+ * Get the most bytes read to find out about streams.  
+ * @see	#setProbeSize(int)  
+ * @return	the probe size, or 0 if FFmpeg's default is used.  
+ * @since	5.5  
+ */
+  public int getProbeSize() {
+    return XugglerJNI.IContainer_getProbeSize(swigCPtr, this);
+  }
+
+/**
+ * Sets how much of each stream, in microseconds, this container will  
+ * read to find out the stream's parameters before giving up.  
+ * Takes effect on the next open, or the next  
+ * {@link #queryStreamMetaData()} if the streams have not been queried  
+ * yet.  
+ * @param	duration The most microseconds to analyze, or 0 for  
+ *   FFmpeg's default.  
+ * @return	0 on success, or <0 if duration is negative or too large.  
+ * @since	5.5  
+ */
+  public int setAnalyzeDuration(long duration) {
+    return XugglerJNI.IContainer_setAnalyzeDuration(swigCPtr, this, duration);
+  }
+
+/**
+ * Get how much of each stream is read to find out its parameters.  
+ * @see	#setAnalyzeDuration(long)  
+ * @return	the duration in microseconds, or 0 if FFmpeg's default is  
+ *   used.  
+ * @since	5.5  
+ */
+  public long getAnalyzeDuration() {
+    return XugglerJNI.IContainer_getAnalyzeDuration(swigCPtr, this);
+  }
+
+/**
+ * Sets how many streams this container needs to know about before it  
+ * stops looking for more.  
+ * <p>  
+ * Formats with no header, such as MPEG-TS, are normally read up to  
+ * the probe size in case more streams turn up.  Once maxStreams  
+ * streams have been found, whether on open or while probing, probing  
+ * instead stops as soon as each of them has its parameters.  
+ * </p>  
+ * @param	maxStreams The number of streams that is enough, or 0 to  
+ *   always look for more.  
+ * @return	0 on success, or <0 if maxStreams is negative.  
+ * @since	5.5  
+ */
+  public int setMaxProbeStreams(int maxStreams) {
+    return XugglerJNI.IContainer_setMaxProbeStreams(swigCPtr, this, maxStreams);
+  }
+
+/**
+ * Get how many streams are enough to stop probing for more.  
+ * @see	#setMaxProbeStreams(int)  
+ * @return	the number of streams, or 0 if there is no limit.  
+ * @since	5.5  
+ */
+  public int getMaxProbeStreams() {
+    return XugglerJNI.IContainer_getMaxProbeStreams(swigCPtr, this);
+  }
+
+/**
+ * Sets whether this container shares what it finds out about the  
+ * streams in a file with other containers that open it.  
+ * <p>  
+ * When true, after {@link #queryStreamMetaData()} probes a local  
+ * file its stream parameters are remembered, keyed by url, size and  
+ * modification time.  A later container with this set that opens the  
+ * same unchanged file gets the time bases, codec parameters and  
+ * extradata put straight back onto its streams instead of decoding  
+ * frames to find them again.  Files whose streams are not all  
+ * declared in their header (such as MPEG-TS) are always probed.  
+ * </p><p>  
+ * Defaults to false.  Set before opening.  
+ * </p>  
+ * @param	value true to use cached probe results.  
+ * @since	5.5  
+ */
+  public void setCacheProbeResults(boolean value) {
+    XugglerJNI.IContainer_setCacheProbeResults(swigCPtr, this, value);
+  }
+
+/**
+ * Get whether this container uses cached probe results.  
+ * @see	#setCacheProbeResults(boolean)  
+ * @return	true if cached probe results are used.  
+ * @since	5.5  
+ */
+  public boolean getCacheProbeResults() {
+    return XugglerJNI.IContainer_getCacheProbeResults(swigCPtr, this);
+  }
+
+/**
+ * Get whether the stream parameters of this open container came from  
+ * the probe result cache rather than from probing the file.  
+ * @see	#setCacheProbeResults(boolean)  
+ * @return	true if the streams were restored from the cache.  
+ * @since	5.5  
+ */
+  public boolean isProbeResultRestored() {
+    return XugglerJNI.IContainer_isProbeResultRestored(swigCPtr, this);
+  }
+
+/**
+ * Looks up a property on this container once, and returns a handle that  
+ * can get and set it without searching for it again.  Use it for  
+ * properties changed often, such as the bit rate of a live encoder.  
+ * <p>  
+ * The handle follows this container across {@link #close()} and  
+ * reopening, but properties of the format's private options can only  
+ * be found while the container is open.  
+ * </p>  
+ * @param	name The property name, as for {@link #setProperty(String, String)}.  
+ * @return	a handle, or null if there is no property of that name.  
+ * @since	5.5  
+ */
+  public IPropertyHandle getPropertyHandle(String name) {
+    long cPtr = XugglerJNI.IContainer_getPropertyHandle(swigCPtr, this, name);
+    return (cPtr == 0) ? null : new IPropertyHandle(cPtr, false);
+  }
+
   public enum Type {
   /**
    *
@@ -0,0 +1,259 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.0
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package com.xuggle.xuggler;
+import com.xuggle.ferry.*;
+/**
+ * A pool of {@link IPacket}, {@link IVideoPicture} and  
+ * {@link IAudioSamples} objects that are reused rather than freed.  
+ * <p>  
+ * Making a packet, picture or samples object allocates the native  
+ * object, its buffer, and (from Java) a reference the garbage collector  
+ * later has to find.  Loops that make one of each per frame spend a  
+ * good part of their time doing that.  Objects got from a pool go back  
+ * to it, instead of being freed, when their last reference is released:  
+ * from Java, when you call {@link #recycle(IMediaData)} (or  
+ * {@link com.xuggle.ferry.RefCounted#delete()}) on them, or when the  
+ * garbage collector collects them.  The next request for an object of  
+ * the same shape gets one of those back, reset to the state a newly  
+ * made object is in, but keeping its buffer.  
+ * </p><p>  
+ * An object is not reused while someone else still holds its buffer  
+ * (for example a picture still sharing a decoder's memory); its buffer  
+ * is dropped instead.  Once more than {@link #getMaxFreeObjects()}  
+ * objects are waiting to be reused, the ones returned longest ago are  
+ * freed.  
+ * </p><p>  
+ * Objects keep the pool they came from alive until they are returned.  
+ * A pool is safe to share between threads.  
+ * </p>  
+ * @since	5.5  
+ */
+public class IMediaDataPool extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    IBuffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected IMediaDataPool(long cPtr, boolean cMemoryOwn) {
+    super(XugglerJNI.SWIGIMediaDataPoolUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected IMediaDataPool(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(XugglerJNI.SWIGIMediaDataPoolUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  public static long getCPtr(IMediaDataPool obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  public long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new IMediaDataPool object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public IMediaDataPool copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new IMediaDataPool(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof IMediaDataPool)
+      equal = (((IMediaDataPool)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+  /**
+   * Return an object to this pool now, rather than when the garbage
+   * collector gets around to it.  Once returned you must not use
+   * data, or any other Java reference to the same native object,
+   * again.  This is the same as calling
+   * {@link com.xuggle.ferry.RefCounted#delete()} on it.
+   *
+   * @param data the object to return; it must have been got from this
+   *   pool.  Null is ignored.
+   */
+  public void recycle(IMediaData data)
+  {
+    if (data != null)
+      data.delete();
+  }
+
+
+/**
+ * Create a new pool.  
+ * @param	maxFreeObjects The most returned objects to keep for reuse.  
+ * @return	a new pool, or null if maxFreeObjects < 0.  
+ */
+  public static IMediaDataPool make(int maxFreeObjects) {
+    long cPtr = XugglerJNI.IMediaDataPool_make(maxFreeObjects);
+    return (cPtr == 0) ? null : new IMediaDataPool(cPtr, false);
+  }
+
+/**
+ * Get a packet with room for at least payloadSize bytes, as  
+ * {@link IPacket#make(int)} would make.  
+ * @param	payloadSize The number of bytes of payload.  
+ * @return	the packet, or null on error.  
+ */
+  public IPacket getPacket(int payloadSize) {
+    long cPtr = XugglerJNI.IMediaDataPool_getPacket(swigCPtr, this, payloadSize);
+    return (cPtr == 0) ? null : new IPacket(cPtr, false);
+  }
+
+/**
+ * Get a picture, as {@link IVideoPicture#make(IPixelFormat.Type, int, int)}  
+ * would make.  
+ * @param	format The pixel format.  
+ * @param	width The width in pixels.  
+ * @param	height The height in pixels.  
+ * @return	the picture, or null on error.  
+ */
+  public IVideoPicture getVideoPicture(IPixelFormat.Type format, int width, int height) {
+    long cPtr = XugglerJNI.IMediaDataPool_getVideoPicture(swigCPtr, this, format.swigValue(), width, height);
+    return (cPtr == 0) ? null : new IVideoPicture(cPtr, false);
+  }
+
+/**
+ * Get an audio samples object with room for at least numSamples  
+ * samples, as {@link IAudioSamples#make(long, long, IAudioSamples.Format)}  
+ * would make.  
+ * @param	numSamples The number of samples (per channel).  
+ * @param	channels The number of channels.  
+ * @param	format The sample format.  
+ * @return	the samples, or null on error.  
+ */
+  public IAudioSamples getAudioSamples(int numSamples, int channels, IAudioSamples.Format format) {
+    long cPtr = XugglerJNI.IMediaDataPool_getAudioSamples(swigCPtr, this, numSamples, channels, format.swigValue());
+    return (cPtr == 0) ? null : new IAudioSamples(cPtr, false);
+  }
+
+/**
+ * Free every object waiting to be reused.  Objects handed out are  
+ * not affected.  
+ */
+  public void clear() {
+    XugglerJNI.IMediaDataPool_clear(swigCPtr, this);
+  }
+
+/**
+ * Get the most returned objects the pool keeps for reuse.  
+ * @return	the maximum number of free objects.  
+ */
+  public int getMaxFreeObjects() {
+    return XugglerJNI.IMediaDataPool_getMaxFreeObjects(swigCPtr, this);
+  }
+
+/**
+ * Get the number of returned objects waiting to be reused.  
+ * @return	the number of free objects.  
+ */
+  public int getNumFreeObjects() {
+    return XugglerJNI.IMediaDataPool_getNumFreeObjects(swigCPtr, this);
+  }
+
+/**
+ * Get the number of objects handed out and not yet returned.  
+ * @return	the number of outstanding objects.  
+ */
+  public int getNumOutstandingObjects() {
+    return XugglerJNI.IMediaDataPool_getNumOutstandingObjects(swigCPtr, this);
+  }
+
+/**
+ * Get the number of requests satisfied by reusing an object.  
+ * @return	the number of hits.  
+ */
+  public long getHits() {
+    return XugglerJNI.IMediaDataPool_getHits(swigCPtr, this);
+  }
+
+/**
+ * Get the number of requests that had to make a new object.  
+ * @return	the number of misses.  
+ */
+  public long getMisses() {
+    return XugglerJNI.IMediaDataPool_getMisses(swigCPtr, this);
+  }
+
+/**
+ * Get the number of returned objects freed because the pool was  
+ * full.  
+ * @return	the number of evictions.  
+ */
+  public long getEvictions() {
+    return XugglerJNI.IMediaDataPool_getEvictions(swigCPtr, this);
+  }
+
+}
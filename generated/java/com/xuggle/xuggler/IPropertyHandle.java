@@ -0,0 +1,252 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.0
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package com.xuggle.xuggler;
+import com.xuggle.ferry.*;
+/**
+ * A property of one object, such as an {@link IStreamCoder} or  
+ * {@link IContainer}, looked up once so it can be read and written  
+ * many times cheaply.  
+ * <p>  
+ * Setting a property by name (for example with  
+ * {@link IStreamCoder#setProperty(String, long)}) searches the object's  
+ * option list, and the option lists of any objects it contains, every  
+ * time.  A handle does that search when it is made and then reads or  
+ * writes the value directly, which makes it the better choice for  
+ * properties changed on every packet or frame, such as the bit rate  
+ * of a live encoder.  
+ * </p><p>  
+ * A handle notices if the object it belongs to has since replaced the  
+ * native object holding the property (for example when a codec is  
+ * changed, or a container is closed and reopened) and looks the  
+ * property up again.  If the property can no longer be found, the  
+ * setters return an error and the getters return 0 or null.  
+ * </p><p>  
+ * A handle keeps the object it belongs to alive.  Like the object  
+ * itself, it is not thread safe.  
+ * </p>  
+ * @since	5.5  
+ */
+public class IPropertyHandle extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    IBuffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected IPropertyHandle(long cPtr, boolean cMemoryOwn) {
+    super(XugglerJNI.SWIGIPropertyHandleUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected IPropertyHandle(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(XugglerJNI.SWIGIPropertyHandleUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  public static long getCPtr(IPropertyHandle obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  public long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new IPropertyHandle object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public IPropertyHandle copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new IPropertyHandle(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof IPropertyHandle)
+      equal = (((IPropertyHandle)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+
+/**
+ * Get the name this handle was made for.  
+ * @return	the name.  
+ */
+  public String getName() {
+    return XugglerJNI.IPropertyHandle_getName(swigCPtr, this);
+  }
+
+/**
+ * Is there currently a property of this name on the object?  
+ * @return	true if the property can be read and written.  
+ */
+  public boolean isValid() {
+    return XugglerJNI.IPropertyHandle_isValid(swigCPtr, this);
+  }
+
+/**
+ * Get the meta data for this property.  
+ * @return	the meta data, or null if {@link #isValid()} is false.  
+ */
+  public IProperty getPropertyMetaData() {
+    long cPtr = XugglerJNI.IPropertyHandle_getPropertyMetaData(swigCPtr, this);
+    return (cPtr == 0) ? null : new IProperty(cPtr, false);
+  }
+
+/**
+ * Set the property from a string, parsed the same way as  
+ * {@link IStreamCoder#setProperty(String, String)}.  
+ * @param	value the new value.  
+ * @return	>= 0 on success; <0 on error.  
+ */
+  public int setValue(String value) {
+    return XugglerJNI.IPropertyHandle_setValue__SWIG_0(swigCPtr, this, value);
+  }
+
+/**
+ * Set the property to a double value.  
+ * @param	value the new value.  
+ * @return	>= 0 on success; <0 on error, including if value is  
+ *   out of range for the property.  
+ */
+  public int setValue(double value) {
+    return XugglerJNI.IPropertyHandle_setValue__SWIG_1(swigCPtr, this, value);
+  }
+
+/**
+ * Set the property to a long value.  
+ * @param	value the new value.  
+ * @return	>= 0 on success; <0 on error, including if value is  
+ *   out of range for the property.  
+ */
+  public int setValue(long value) {
+    return XugglerJNI.IPropertyHandle_setValue__SWIG_2(swigCPtr, this, value);
+  }
+
+/**
+ * Set the property to a boolean value.  
+ * @param	value the new value.  
+ * @return	>= 0 on success; <0 on error.  
+ */
+  public int setValue(boolean value) {
+    return XugglerJNI.IPropertyHandle_setValue__SWIG_3(swigCPtr, this, value);
+  }
+
+/**
+ * Set the property to a rational value.  
+ * @param	value the new value.  
+ * @return	>= 0 on success; <0 on error, including if value is  
+ *   out of range for the property.  
+ */
+  public int setValue(IRational value) {
+    return XugglerJNI.IPropertyHandle_setValue__SWIG_4(swigCPtr, this, IRational.getCPtr(value), value);
+  }
+
+/**
+ * Get the value of the property as a string.  
+ * Note for C++ users: you must free() the returned string.  
+ * @return	the value, or null on error.  
+ */
+  public String getValueAsString() {
+    return XugglerJNI.IPropertyHandle_getValueAsString(swigCPtr, this);
+  }
+
+/**
+ * Get the value of the property as a double.  
+ * @return	the value, or 0 on error.  
+ */
+  public double getValueAsDouble() {
+    return XugglerJNI.IPropertyHandle_getValueAsDouble(swigCPtr, this);
+  }
+
+/**
+ * Get the value of the property as a long.  
+ * @return	the value, or 0 on error.  
+ */
+  public long getValueAsLong() {
+    return XugglerJNI.IPropertyHandle_getValueAsLong(swigCPtr, this);
+  }
+
+/**
+ * Get the value of the property as a rational.  
+ * @return	the value, or null on error.  
+ */
+  public IRational getValueAsRational() {
+    long cPtr = XugglerJNI.IPropertyHandle_getValueAsRational(swigCPtr, this);
+    return (cPtr == 0) ? null : new IRational(cPtr, false);
+  }
+
+/**
+ * Get the value of the property as a boolean.  
+ * @return	the value, or false on error.  
+ */
+  public boolean getValueAsBoolean() {
+    return XugglerJNI.IPropertyHandle_getValueAsBoolean(swigCPtr, this);
+  }
+
+}
@@ -0,0 +1,271 @@
+/* ----------------------------------------------------------------------------
+ * This file was automatically generated by SWIG (http://www.swig.org).
+ * Version 2.0.0
+ *
+ * Do not make changes to this file unless you know what you are doing--modify
+ * the SWIG interface file instead.
+ * ----------------------------------------------------------------------------- */
+
+package com.xuggle.xuggler;
+import com.xuggle.ferry.*;
+/**
+ * Transcodes streams from one {@link IContainer} to another, in  
+ * native code, using several threads.  
+ * <p>  
+ * The work is split into stages: one stage demultiplexes packets from  
+ * the input container; for every mapped stream a decode stage, a  
+ * convert stage (which rescales pictures or resamples audio when the  
+ * input and output coders disagree) and an encode stage; and one stage  
+ * multiplexes packets into the output container.  Stages hand work to  
+ * each other through bounded queues, and a pool of threads runs  
+ * whichever stages have work, so decoding one stream overlaps with  
+ * encoding another and with reading and writing.  
+ * </p>  
+ * <p>  
+ * To use, open the input container for reading and the output  
+ * container for writing, add streams to the output container and set up  
+ * their {@link IStreamCoder}s as you would to encode by hand, then map  
+ * input streams to output streams with {@link #mapStream(int, int)} and  
+ * call {@link #run()}.  Output coder settings you leave unset (width,  
+ * height, pixel type, sample rate, channels) are copied from the input.  
+ * Coders that are not already open are opened, and closed again when we  
+ * are done.  
+ * </p>  
+ * <p>  
+ * While (or after) {@link #run()} runs, the per-stage statistics tell  
+ * you where the time goes.  
+ * </p>  
+ * @since	5.5  
+ */
+public class ITranscoder extends RefCounted {
+  // JNIHelper.swg: Start generated code
+  // >>>>>>>>>>>>>>>>>>>>>>>>>>>
+  /**
+   * This method is only here to use some references and remove
+   * a Eclipse compiler warning.
+   */
+  @SuppressWarnings("unused")
+  private void noop()
+  {
+    IBuffer.make(null, 1);
+  }
+   
+  private volatile long swigCPtr;
+
+  /**
+   * Internal Only.
+   */
+  protected ITranscoder(long cPtr, boolean cMemoryOwn) {
+    super(XugglerJNI.SWIGITranscoderUpcast(cPtr), cMemoryOwn);
+    swigCPtr = cPtr;
+  }
+  
+  /**
+   * Internal Only.
+   */
+  protected ITranscoder(long cPtr, boolean cMemoryOwn,
+      java.util.concurrent.atomic.AtomicLong ref)
+  {
+    super(XugglerJNI.SWIGITranscoderUpcast(cPtr),
+     cMemoryOwn, ref);
+    swigCPtr = cPtr;
+  }
+    
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that obj is proxying for.
+   *   
+   * @param obj The java proxy object for a native object.
+   * @return The raw pointer obj is proxying for.
+   */
+  public static long getCPtr(ITranscoder obj) {
+    if (obj == null) return 0;
+    return obj.getMyCPtr();
+  }
+
+  /**
+   * Internal Only.  Not part of public API.
+   *
+   * Get the raw value of the native object that we're proxying for.
+   *   
+   * @return The raw pointer we're proxying for.
+   */  
+  public long getMyCPtr() {
+    if (swigCPtr == 0) throw new IllegalStateException("underlying native object already deleted");
+    return swigCPtr;
+  }
+  
+  /**
+   * Create a new ITranscoder object that is actually referring to the
+   * exact same underlying native object.
+   *
+   * @return the new Java object.
+   */
+  @Override
+  public ITranscoder copyReference() {
+    if (swigCPtr == 0)
+      return null;
+    else
+      return new ITranscoder(swigCPtr, swigCMemOwn, getJavaRefCount());
+  }
+
+  /**
+   * Compares two values, returning true if the underlying objects in native code are the same object.
+   *
+   * That means you can have two different Java objects, but when you do a comparison, you'll find out
+   * they are the EXACT same object.
+   *
+   * @return True if the underlying native object is the same.  False otherwise.
+   */
+  public boolean equals(Object obj) {
+    boolean equal = false;
+    if (obj instanceof ITranscoder)
+      equal = (((ITranscoder)obj).swigCPtr == this.swigCPtr);
+    return equal;
+  }
+  
+  /**
+   * Get a hashable value for this object.
+   *
+   * @return the hashable value.
+   */
+  public int hashCode() {
+     return (int)swigCPtr;
+  }
+  
+  // <<<<<<<<<<<<<<<<<<<<<<<<<<<
+  // JNIHelper.swg: End generated code
+  
+/**
+ * Create a new {@link ITranscoder}.  
+ * @param	input The container to read from.  It must be opened for  
+ *   reading.  
+ * @param	output The container to write to.  It must be opened for  
+ *   writing, and must not have had its header written yet.  
+ * @return	a new transcoder, or null on error.  
+ */
+  public static ITranscoder make(IContainer input, IContainer output) {
+    long cPtr = XugglerJNI.ITranscoder_make(IContainer.getCPtr(input), input, IContainer.getCPtr(output), output);
+    return (cPtr == 0) ? null : new ITranscoder(cPtr, false);
+  }
+
+/**
+ * Transcode the stream at inputStreamIndex in the input container into  
+ * the stream at outputStreamIndex in the output container.  Streams  
+ * that are not mapped are dropped.  
+ * @param	inputStreamIndex The index of an audio or video stream in  
+ *   the input container.  
+ * @param	outputStreamIndex The index of a stream of the same type in  
+ *   the output container.  
+ * @return	>= 0 on success; < 0 on error.  
+ */
+  public int mapStream(int inputStreamIndex, int outputStreamIndex) {
+    return XugglerJNI.ITranscoder_mapStream(swigCPtr, this, inputStreamIndex, outputStreamIndex);
+  }
+
+/**
+ * Set the number of threads {@link #run()} uses.  
+ * @param	numThreads The number of threads, or 0 to use one thread  
+ *   per stage.  
+ * @return	>= 0 on success; < 0 on error.  
+ */
+  public int setNumThreads(int numThreads) {
+    return XugglerJNI.ITranscoder_setNumThreads(swigCPtr, this, numThreads);
+  }
+
+/**
+ * Get the number of threads {@link #run()} uses.  
+ * @return	The number of threads, or 0 for one per stage.  
+ */
+  public int getNumThreads() {
+    return XugglerJNI.ITranscoder_getNumThreads(swigCPtr, this);
+  }
+
+/**
+ * Set how many items may wait in front of a stage before the stage  
+ * feeding it stops.  
+ * @param	capacity The capacity of each queue; must be > 0.  
+ * @return	>= 0 on success; < 0 on error.  
+ */
+  public int setQueueCapacity(int capacity) {
+    return XugglerJNI.ITranscoder_setQueueCapacity(swigCPtr, this, capacity);
+  }
+
+/**
+ * Get how many items may wait in front of a stage.  
+ * @return	The capacity of each queue.  
+ */
+  public int getQueueCapacity() {
+    return XugglerJNI.ITranscoder_getQueueCapacity(swigCPtr, this);
+  }
+
+/**
+ * Transcode everything, writing the output header and trailer.  
+ * Blocks until the input is exhausted or a stage fails.  
+ * @return	>= 0 on success; < 0 on error.  
+ */
+  public int run() {
+    return XugglerJNI.ITranscoder_run(swigCPtr, this);
+  }
+
+/**
+ * Get the number of stages.  This is only known once {@link #run()}  
+ * has started; before then it is 0.  
+ * @return	The number of stages.  
+ */
+  public int getNumStages() {
+    return XugglerJNI.ITranscoder_getNumStages(swigCPtr, this);
+  }
+
+/**
+ * Get a name for a stage, such as "demux", "decode:0" or "mux".  The  
+ * number is the input stream index the stage works on.  
+ * @param	stage The stage, from 0 to {@link #getNumStages()}-1.  
+ * @return	The name, or null if stage is out of range.  
+ */
+  public String getStageName(int stage) {
+    return XugglerJNI.ITranscoder_getStageName(swigCPtr, this, stage);
+  }
+
+/**
+ * Get the number of items a stage has taken off its queue.  For  
+ * demux stages this is the number of packets read.  
+ * @param	stage The stage, from 0 to {@link #getNumStages()}-1.  
+ * @return	The number of items, or < 0 if stage is out of range.  
+ */
+  public long getStageNumItems(int stage) {
+    return XugglerJNI.ITranscoder_getStageNumItems(swigCPtr, this, stage);
+  }
+
+/**
+ * Get the time a stage has spent working, in microseconds.  Items  
+ * divided by busy time is the throughput of the stage.  
+ * @param	stage The stage, from 0 to {@link #getNumStages()}-1.  
+ * @return	The busy time, or < 0 if stage is out of range.  
+ */
+  public long getStageBusyTime(int stage) {
+    return XugglerJNI.ITranscoder_getStageBusyTime(swigCPtr, this, stage);
+  }
+
+/**
+ * Get the number of items waiting in front of a stage right now.  
+ * @param	stage The stage, from 0 to {@link #getNumStages()}-1.  
+ * @return	The queue depth, or < 0 if stage is out of range.  
+ */
+  public int getStageQueueDepth(int stage) {
+    return XugglerJNI.ITranscoder_getStageQueueDepth(swigCPtr, this, stage);
+  }
+
+/**
+ * Get the largest number of items that have waited in front of a  
+ * stage.  A stage whose queue is often full is slower than the stages  
+ * in front of it.  
+ * @param	stage The stage, from 0 to {@link #getNumStages()}-1.  
+ * @return	The maximum queue depth, or < 0 if stage is out of range.  
+ */
+  public int getStageMaxQueueDepth(int stage) {
+    return XugglerJNI.ITranscoder_getStageMaxQueueDepth(swigCPtr, this, stage);
+  }
+
+}
@@ -143,6 +143,100 @@ public class IVideoPicture extends IMediaData {
     return result.toString();
   }
 
+  /**
+   * Convert this picture straight into packed B, G, R bytes, such as
+   * the backing array of a
+   * {@link java.awt.image.BufferedImage#TYPE_3BYTE_BGR} image, in one
+   * native pass with no intermediate picture.
+   * <p>
+   * The picture must be complete and of type
+   * {@link IPixelFormat.Type#YUV420P}.
+   * </p>
+   * 
+   * @param dest the array to fill.
+   * @param offset the index in dest of the first pixel.
+   * @param stride the number of bytes between the starts of rows.
+   * @return true on success; false if this is not a complete YUV420P
+   *   picture or dest is too small.
+   * @since 5.5
+   */
+  public boolean copyToBGR24(byte[] dest, int offset, int stride)
+  {
+    return XugglerJNI.IVideoPicture_copyToBGR24(swigCPtr, this,
+        dest, offset, stride) >= 0;
+  }
+
+  /**
+   * Convert this picture straight into 0xAARRGGBB ints, such as the
+   * backing array of a {@link java.awt.image.BufferedImage#TYPE_INT_ARGB}
+   * image, in one native pass with no intermediate picture.  Alpha is
+   * always opaque.
+   * <p>
+   * The picture must be complete and of type
+   * {@link IPixelFormat.Type#YUV420P}.
+   * </p>
+   * 
+   * @param dest the array to fill.
+   * @param offset the index in dest of the first pixel.
+   * @param stride the number of ints between the starts of rows.
+   * @return true on success; false if this is not a complete YUV420P
+   *   picture or dest is too small.
+   * @since 5.5
+   */
+  public boolean copyToARGB(int[] dest, int offset, int stride)
+  {
+    return XugglerJNI.IVideoPicture_copyToARGB(swigCPtr, this,
+        dest, offset, stride) >= 0;
+  }
+
+  /**
+   * Fill this picture from packed B, G, R bytes, such as the backing
+   * array of a {@link java.awt.image.BufferedImage#TYPE_3BYTE_BGR}
+   * image, in one native pass.  This must be a
+   * {@link IPixelFormat.Type#YUV420P} picture of the image's size; on
+   * success it becomes complete.
+   * 
+   * @param src the pixels to read.
+   * @param offset the index in src of the first pixel.
+   * @param stride the number of bytes between the starts of rows.
+   * @param width the width of the image.
+   * @param height the height of the image.
+   * @param timestamp the time stamp for this picture.
+   * @return true on success; false if src is too small or this
+   *   picture is not a YUV420P picture width by height.
+   * @since 5.5
+   */
+  public boolean copyFromBGR24(byte[] src, int offset, int stride,
+      int width, int height, long timestamp)
+  {
+    return XugglerJNI.IVideoPicture_copyFromBGR24(swigCPtr, this,
+        src, offset, stride, width, height, timestamp) >= 0;
+  }
+
+  /**
+   * Fill this picture from 0xAARRGGBB ints, such as the backing array
+   * of a {@link java.awt.image.BufferedImage#TYPE_INT_ARGB} image, in
+   * one native pass; alpha is ignored.  This must be a
+   * {@link IPixelFormat.Type#YUV420P} picture of the image's size; on
+   * success it becomes complete.
+   * 
+   * @param src the pixels to read.
+   * @param offset the index in src of the first pixel.
+   * @param stride the number of ints between the starts of rows.
+   * @param width the width of the image.
+   * @param height the height of the image.
+   * @param timestamp the time stamp for this picture.
+   * @return true on success; false if src is too small or this
+   *   picture is not a YUV420P picture width by height.
+   * @since 5.5
+   */
+  public boolean copyFromARGB(int[] src, int offset, int stride,
+      int width, int height, long timestamp)
+  {
+    return XugglerJNI.IVideoPicture_copyFromARGB(swigCPtr, this,
+        src, offset, stride, width, height, timestamp) >= 0;
+  }
+
 
 /**
  * Is this a key frame?  
@@ -368,6 +368,86 @@ public class IVideoResampler extends RefCounted implements com.xuggle.xuggler.IC
     return XugglerJNI.IVideoResampler_setProperty__SWIG_5(swigCPtr, this, IMetaData.getCPtr(valuesToSet), valuesToSet, IMetaData.getCPtr(valuesNotFound), valuesNotFound);
   }
 
+/**
+ * Set how many idle scaler contexts to keep for reuse.  
+ * <p>  
+ * Setting up a resampler's scaler is much more expensive than  
+ * resampling a picture with it, so when a resampler is deleted its  
+ * scaler is kept, and a later {@link #make} call with the same sizes  
+ * and pixel formats reuses it.  The cache is shared by the whole  
+ * process; past this size the least recently used scalers are  
+ * freed.  Resamplers that had properties set never return their  
+ * scalers to the cache.  
+ * </p>  
+ * @param	maxIdle the most scalers to keep; 0 turns off caching.  
+ *   The default is 16.  
+ * @return	>= 0 on success; < 0 if maxIdle is negative or this build  
+ *   has no resampler.  
+ * @since	5.5  
+ */
+  public static int setContextCacheSize(int maxIdle) {
+    return XugglerJNI.IVideoResampler_setContextCacheSize(maxIdle);
+  }
+
+/**
+ * @return	the most idle scaler contexts that will be kept for reuse.  
+ * @since	5.5  
+ */
+  public static int getContextCacheSize() {
+    return XugglerJNI.IVideoResampler_getContextCacheSize();
+  }
+
+/**
+ * @return	the number of idle scaler contexts now cached.  
+ * @since	5.5  
+ */
+  public static int getNumCachedContexts() {
+    return XugglerJNI.IVideoResampler_getNumCachedContexts();
+  }
+
+/**
+ * @return	the number of {@link #make} calls that reused a cached  
+ *   scaler context.  
+ * @since	5.5  
+ */
+  public static long getContextCacheHits() {
+    return XugglerJNI.IVideoResampler_getContextCacheHits();
+  }
+
+/**
+ * @return	the number of {@link #make} calls that had to set up a  
+ *   new scaler context.  
+ * @since	5.5  
+ */
+  public static long getContextCacheMisses() {
+    return XugglerJNI.IVideoResampler_getContextCacheMisses();
+  }
+
+/**
+ * @return	the number of cached scaler contexts freed to make room  
+ *   for more recently used ones.  
+ * @since	5.5  
+ */
+  public static long getContextCacheEvictions() {
+    return XugglerJNI.IVideoResampler_getContextCacheEvictions();
+  }
+
+/**
+ * Set the context cache hit, miss and eviction counts to zero.  
+ * @since	5.5  
+ */
+  public static void resetContextCacheStatistics() {
+    XugglerJNI.IVideoResampler_resetContextCacheStatistics();
+  }
+
+/**
+ * Free all cached scaler contexts.  
+ * @since	5.5  
+ */
+  public static void clearContextCache() {
+    XugglerJNI.IVideoResampler_clearContextCache();
+  }
+
   public enum Feature {
   /**
    * Features that the VideoResampler may optionally support.
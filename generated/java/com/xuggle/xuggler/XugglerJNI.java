@@ -23,6 +23,14 @@ class XugglerJNI {
   public static void noop() {
     // Here only to force JNI library to load
   }
+
+  // Hand-written batch and pixel conversion calls; see Xuggler.i
+  public final static native int IContainer_readNextPackets(long jarg1, IContainer jarg1_, long[] jarg2, int jarg3);
+  public final static native int IContainer_writePackets(long jarg1, IContainer jarg1_, long[] jarg2, int jarg3, boolean jarg4);
+  public final static native int IVideoPicture_copyToBGR24(long jarg1, IVideoPicture jarg1_, byte[] jarg2, int jarg3, int jarg4);
+  public final static native int IVideoPicture_copyToARGB(long jarg1, IVideoPicture jarg1_, int[] jarg2, int jarg3, int jarg4);
+  public final static native int IVideoPicture_copyFromBGR24(long jarg1, IVideoPicture jarg1_, byte[] jarg2, int jarg3, int jarg4, int jarg5, int jarg6, long jarg7);
+  public final static native int IVideoPicture_copyFromARGB(long jarg1, IVideoPicture jarg1_, int[] jarg2, int jarg3, int jarg4, int jarg5, int jarg6, long jarg7);
   
 // <<<<<<<<<<<<<<<<<<<<<<<<<<<
 // Xuggler.i: End generated code
@@ -93,6 +101,19 @@ class XugglerJNI {
   public final static native double IRational_getValue(long jarg1, IRational jarg1_);
   public final static native boolean IRational_isFinalized(long jarg1, IRational jarg1_);
   public final static native void IRational_init(long jarg1, IRational jarg1_);
+  public final static native String IPropertyHandle_getName(long jarg1, IPropertyHandle jarg1_);
+  public final static native boolean IPropertyHandle_isValid(long jarg1, IPropertyHandle jarg1_);
+  public final static native long IPropertyHandle_getPropertyMetaData(long jarg1, IPropertyHandle jarg1_);
+  public final static native int IPropertyHandle_setValue__SWIG_0(long jarg1, IPropertyHandle jarg1_, String jarg2);
+  public final static native int IPropertyHandle_setValue__SWIG_1(long jarg1, IPropertyHandle jarg1_, double jarg2);
+  public final static native int IPropertyHandle_setValue__SWIG_2(long jarg1, IPropertyHandle jarg1_, long jarg2);
+  public final static native int IPropertyHandle_setValue__SWIG_3(long jarg1, IPropertyHandle jarg1_, boolean jarg2);
+  public final static native int IPropertyHandle_setValue__SWIG_4(long jarg1, IPropertyHandle jarg1_, long jarg2, IRational jarg2_);
+  public final static native String IPropertyHandle_getValueAsString(long jarg1, IPropertyHandle jarg1_);
+  public final static native double IPropertyHandle_getValueAsDouble(long jarg1, IPropertyHandle jarg1_);
+  public final static native long IPropertyHandle_getValueAsLong(long jarg1, IPropertyHandle jarg1_);
+  public final static native long IPropertyHandle_getValueAsRational(long jarg1, IPropertyHandle jarg1_);
+  public final static native boolean IPropertyHandle_getValueAsBoolean(long jarg1, IPropertyHandle jarg1_);
   public final static native long ITimeValue_make__SWIG_0(long jarg1, int jarg2);
   public final static native long ITimeValue_make__SWIG_1(long jarg1, ITimeValue jarg1_);
   public final static native long ITimeValue_get(long jarg1, ITimeValue jarg1_, int jarg2);
@@ -288,6 +309,8 @@ class XugglerJNI {
   public final static native boolean ICodec_hasCapability(long jarg1, ICodec jarg1_, int jarg2);
   public final static native int ICodec_getNumInstalledCodecs();
   public final static native long ICodec_getInstalledCodec(int jarg1);
+  public final static native int ICodec_getNumInstalledCodecsOfType(int jarg1);
+  public final static native long ICodec_getInstalledCodecOfType(int jarg1, int jarg2);
   public final static native int ICodec_getNumSupportedVideoFrameRates(long jarg1, ICodec jarg1_);
   public final static native long ICodec_getSupportedVideoFrameRate(long jarg1, ICodec jarg1_, int jarg2);
   public final static native int ICodec_getNumSupportedVideoPixelFormats(long jarg1, ICodec jarg1_);
@@ -337,6 +360,14 @@ class XugglerJNI {
   public final static native long IVideoResampler_make(int jarg1, int jarg2, int jarg3, int jarg4, int jarg5, int jarg6);
   public final static native boolean IVideoResampler_isSupported(int jarg1);
   public final static native int IVideoResampler_setProperty__SWIG_5(long jarg1, IVideoResampler jarg1_, long jarg2, IMetaData jarg2_, long jarg3, IMetaData jarg3_);
+  public final static native int IVideoResampler_setContextCacheSize(int jarg1);
+  public final static native int IVideoResampler_getContextCacheSize();
+  public final static native int IVideoResampler_getNumCachedContexts();
+  public final static native long IVideoResampler_getContextCacheHits();
+  public final static native long IVideoResampler_getContextCacheMisses();
+  public final static native long IVideoResampler_getContextCacheEvictions();
+  public final static native void IVideoResampler_resetContextCacheStatistics();
+  public final static native void IVideoResampler_clearContextCache();
   public final static native int IStreamCoder_FLAG_QSCALE_get();
   public final static native int IStreamCoder_FLAG_4MV_get();
   public final static native int IStreamCoder_FLAG_QPEL_get();
@@ -448,6 +479,19 @@ class XugglerJNI {
   public final static native long IStreamCoder_make__SWIG_2(int jarg1, long jarg2, ICodec jarg2_);
   public final static native long IStreamCoder_make__SWIG_3(int jarg1, int jarg2);
   public final static native int IStreamCoder_setProperty__SWIG_5(long jarg1, IStreamCoder jarg1_, long jarg2, IMetaData jarg2_, long jarg3, IMetaData jarg3_);
+  public final static native int IStreamCoder_setNumThreads(long jarg1, IStreamCoder jarg1_, int jarg2);
+  public final static native int IStreamCoder_getNumThreads(long jarg1, IStreamCoder jarg1_);
+  public final static native int IStreamCoder_setThreadType(long jarg1, IStreamCoder jarg1_, int jarg2);
+  public final static native int IStreamCoder_getThreadType(long jarg1, IStreamCoder jarg1_);
+  public final static native int IStreamCoder_getActiveThreadType(long jarg1, IStreamCoder jarg1_);
+  public final static native void IStreamCoder_setDecodeKeyFramesOnly(long jarg1, IStreamCoder jarg1_, boolean jarg2);
+  public final static native boolean IStreamCoder_getDecodeKeyFramesOnly(long jarg1, IStreamCoder jarg1_);
+  public final static native int IStreamCoder_decodeVideoKeyFrame(long jarg1, IStreamCoder jarg1_, long jarg2, IVideoPicture jarg2_, long jarg3);
+  public final static native long IStreamCoder_getPropertyHandle(long jarg1, IStreamCoder jarg1_, String jarg2);
+  public final static native int IStreamCoder_THREAD_TYPE_NONE_get();
+  public final static native int IStreamCoder_THREAD_TYPE_FRAME_get();
+  public final static native int IStreamCoder_THREAD_TYPE_SLICE_get();
+  public final static native int IStreamCoder_THREAD_TYPE_FRAME_AND_SLICE_get();
   public final static native int IIndexEntry_IINDEX_FLAG_KEYFRAME_get();
   public final static native long IIndexEntry_make(long jarg1, long jarg2, int jarg3, int jarg4, int jarg5);
   public final static native long IIndexEntry_getPosition(long jarg1, IIndexEntry jarg1_);
@@ -599,6 +643,21 @@ class XugglerJNI {
   public final static native int IContainer_setFormat(long jarg1, IContainer jarg1_, long jarg2, IContainerFormat jarg2_);
   public final static native long IContainer_make__SWIG_1(long jarg1, IContainerFormat jarg1_);
   public final static native int IContainer_open__SWIG_2(long jarg1, IContainer jarg1_, String jarg2, int jarg3, long jarg4, IContainerFormat jarg4_, boolean jarg5, boolean jarg6, long jarg7, IMetaData jarg7_, long jarg8, IMetaData jarg8_);
+  public final static native void IContainer_setZeroCopyReads(long jarg1, IContainer jarg1_, boolean jarg2);
+  public final static native boolean IContainer_getZeroCopyReads(long jarg1, IContainer jarg1_);
+  public final static native int IContainer_buildKeyFrameIndex(long jarg1, IContainer jarg1_);
+  public final static native int IContainer_writeKeyFrameIndex(long jarg1, IContainer jarg1_, String jarg2);
+  public final static native int IContainer_readKeyFrameIndex(long jarg1, IContainer jarg1_, String jarg2);
+  public final static native int IContainer_setProbeSize(long jarg1, IContainer jarg1_, int jarg2);
+  public final static native int IContainer_getProbeSize(long jarg1, IContainer jarg1_);
+  public final static native int IContainer_setAnalyzeDuration(long jarg1, IContainer jarg1_, long jarg2);
+  public final static native long IContainer_getAnalyzeDuration(long jarg1, IContainer jarg1_);
+  public final static native int IContainer_setMaxProbeStreams(long jarg1, IContainer jarg1_, int jarg2);
+  public final static native int IContainer_getMaxProbeStreams(long jarg1, IContainer jarg1_);
+  public final static native void IContainer_setCacheProbeResults(long jarg1, IContainer jarg1_, boolean jarg2);
+  public final static native boolean IContainer_getCacheProbeResults(long jarg1, IContainer jarg1_);
+  public final static native boolean IContainer_isProbeResultRestored(long jarg1, IContainer jarg1_);
+  public final static native long IContainer_getPropertyHandle(long jarg1, IContainer jarg1_, String jarg2);
   public final static native void IMediaDataWrapper_wrap(long jarg1, IMediaDataWrapper jarg1_, long jarg2, IMediaData jarg2_);
   public final static native void IMediaDataWrapper_setKey(long jarg1, IMediaDataWrapper jarg1_, boolean jarg2);
   public final static native long IMediaDataWrapper_make(long jarg1, IMediaData jarg1_);
@@ -623,6 +682,14 @@ class XugglerJNI {
   public final static native String Global_getAVCodecVersionStr();
   public final static native void Global_init();
   public final static native void Global_setFFmpegLoggingLevel(int jarg1);
+  public final static native int Global_getLockManagerType();
+  public final static native int Global_setLockManagerType(int jarg1);
+  public final static native long Global_getLockManagerObtainCount();
+  public final static native long Global_getLockManagerContendedCount();
+  public final static native long Global_getLockManagerWaitTime();
+  public final static native void Global_resetLockManagerStatistics();
+  public final static native int Global_LOCK_MANAGER_NATIVE_get();
+  public final static native int Global_LOCK_MANAGER_JAVA_get();
   public final static native int IError_getType(long jarg1, IError jarg1_);
   public final static native String IError_getDescription(long jarg1, IError jarg1_);
   public final static native int IError_getErrorNumber(long jarg1, IError jarg1_);
@@ -630,9 +697,34 @@ class XugglerJNI {
   public final static native long IError_make__SWIG_1(int jarg1);
   public final static native int IError_errorNumberToType(int jarg1);
   public final static native int IError_typeToErrorNumber(int jarg1);
+  public final static native long ITranscoder_make(long jarg1, IContainer jarg1_, long jarg2, IContainer jarg2_);
+  public final static native int ITranscoder_mapStream(long jarg1, ITranscoder jarg1_, int jarg2, int jarg3);
+  public final static native int ITranscoder_setNumThreads(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native int ITranscoder_getNumThreads(long jarg1, ITranscoder jarg1_);
+  public final static native int ITranscoder_setQueueCapacity(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native int ITranscoder_getQueueCapacity(long jarg1, ITranscoder jarg1_);
+  public final static native int ITranscoder_run(long jarg1, ITranscoder jarg1_);
+  public final static native int ITranscoder_getNumStages(long jarg1, ITranscoder jarg1_);
+  public final static native String ITranscoder_getStageName(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native long ITranscoder_getStageNumItems(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native long ITranscoder_getStageBusyTime(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native int ITranscoder_getStageQueueDepth(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native int ITranscoder_getStageMaxQueueDepth(long jarg1, ITranscoder jarg1_, int jarg2);
+  public final static native long IMediaDataPool_make(int jarg1);
+  public final static native long IMediaDataPool_getPacket(long jarg1, IMediaDataPool jarg1_, int jarg2);
+  public final static native long IMediaDataPool_getVideoPicture(long jarg1, IMediaDataPool jarg1_, int jarg2, int jarg3, int jarg4);
+  public final static native long IMediaDataPool_getAudioSamples(long jarg1, IMediaDataPool jarg1_, int jarg2, int jarg3, int jarg4);
+  public final static native void IMediaDataPool_clear(long jarg1, IMediaDataPool jarg1_);
+  public final static native int IMediaDataPool_getMaxFreeObjects(long jarg1, IMediaDataPool jarg1_);
+  public final static native int IMediaDataPool_getNumFreeObjects(long jarg1, IMediaDataPool jarg1_);
+  public final static native int IMediaDataPool_getNumOutstandingObjects(long jarg1, IMediaDataPool jarg1_);
+  public final static native long IMediaDataPool_getHits(long jarg1, IMediaDataPool jarg1_);
+  public final static native long IMediaDataPool_getMisses(long jarg1, IMediaDataPool jarg1_);
+  public final static native long IMediaDataPool_getEvictions(long jarg1, IMediaDataPool jarg1_);
   public final static native long SWIGIPropertyUpcast(long jarg1);
   public final static native long SWIGIPixelFormatUpcast(long jarg1);
   public final static native long SWIGIRationalUpcast(long jarg1);
+  public final static native long SWIGIPropertyHandleUpcast(long jarg1);
   public final static native long SWIGITimeValueUpcast(long jarg1);
   public final static native long SWIGIMetaDataUpcast(long jarg1);
   public final static native long SWIGIMediaDataUpcast(long jarg1);
@@ -650,4 +742,6 @@ class XugglerJNI {
   public final static native long SWIGIMediaDataWrapperUpcast(long jarg1);
   public final static native long SWIGGlobalUpcast(long jarg1);
   public final static native long SWIGIErrorUpcast(long jarg1);
+  public final static native long SWIGITranscoderUpcast(long jarg1);
+  public final static native long SWIGIMediaDataPoolUpcast(long jarg1);
 }
@@ -118,6 +118,11 @@ public final class JNIMemoryManager
    * <td>+</td>
    * <td>+++++</td>
    * </tr>
+   * <tr>
+   * <td> {@link #NATIVE_BUFFERS_POOLED}</td>
+   * <td>+</td>
+   * <td>+++++</td>
+   * </tr>
    * 
    * </table>
    * <h2>What is &quot;Robustness&quot;?</h2>
@@ -825,7 +830,43 @@ public final class JNIMemoryManager
      * 
      * </ul>
      */
-    NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION(4);
+    NATIVE_BUFFERS_WITH_STANDARD_HEAP_NOTIFICATION(4),
+
+    /**
+     * Large memory blocks are allocated in native memory, completely bypassing
+     * the Java heap, and when released are kept on per-thread free lists
+     * (rounded up to a small set of size classes) so that the next allocation
+     * of a similar size can reuse them.
+     * <p>
+     * Decoding and encoding tend to allocate and release buffers of the same
+     * handful of sizes (packets, audio samples and video frames) thousands of
+     * times a second. This model avoids going to the native heap for most of
+     * those allocations.
+     * </p>
+     * <p>
+     * To stop the pool growing without bound, freed blocks are only retained
+     * while the total retained across all threads is under
+     * {@link JNIMemoryManager#getPoolMaxRetainedBytes()}; see
+     * {@link JNIMemoryManager#setPoolMaxRetainedBytes(long)}. Blocks cached
+     * by a thread are released when that thread exits.
+     * </p>
+     * <h2>Speed</h2>
+     * <p>
+     * Generally the same as or faster than {@link #NATIVE_BUFFERS} once the
+     * pool is warm. Use {@link JNIMemoryManager#getPoolHits()} and
+     * {@link JNIMemoryManager#getPoolMisses()} to see how well the pool is
+     * working for your application.
+     * </p>
+     * <h2>Robustness</h2>
+     * <p>
+     * The same as {@link #NATIVE_BUFFERS}, except that up to the retained byte
+     * cap of native memory may stay allocated after all objects using it have
+     * been released.
+     * </p>
+     * 
+     * @since 5.5
+     */
+    NATIVE_BUFFERS_POOLED(5);
 
     /**
      * The integer native mode that the JNIMemoryManager.cpp file expects
@@ -905,17 +946,31 @@ public final class JNIMemoryManager
 
   /**
    * Used for managing our collect-and-sweep JNIReference heap.
+   * <p>
+   * The heap is striped into segments that each have their own locks and are
+   * swept on their own, and a thread always adds its references to the same
+   * segment.  That way threads allocating Ferry objects at the same time
+   * rarely contend with each other, and a sweep only stalls the threads
+   * sharing the segment being swept.
+   * </p>
    */
-  private final AtomicBoolean mSpinLock;
-  private final Lock mLock;
-  private JNIReference mValidReferences[];
-  private volatile int mNextAvailableReferenceSlot;
-  private volatile int mMaxValidReference;
+  private final ReferenceSegment[] mSegments;
+  private final int mSegmentMask;
   private int mMinimumReferencesToCache;
   private double mExpandIncrement;
   private double mShrinkScaleFactor;
   private double mMaxFreeRatio;
   private double mMinFreeRatio;
+
+  /**
+   * The most segments we'll stripe the heap into, however many processors
+   * we have.
+   */
+  private static final int MAX_SEGMENTS = 64;
+  /**
+   * The fewest references a segment will cache.
+   */
+  private static final int MIN_SEGMENT_REFERENCES = 64;
   
   /**
    * The constructor is package level so others can't create it.
@@ -924,30 +979,248 @@ public final class JNIMemoryManager
   {
     mRefQueue = new ReferenceQueue<Object>();
     mCollectionThread = null;
-    mLock = new ReentrantLock();
-    mSpinLock = new AtomicBoolean(false);
     final int minReferences=1024*4;
     mMinimumReferencesToCache = minReferences;
     mExpandIncrement = 0.20; // expand by 20% at a time
     mShrinkScaleFactor = 0.25; // shrink by 25% of mExpandIncrement
-    mValidReferences = new JNIReference[minReferences]; 
-    mMaxValidReference = minReferences;
-    mNextAvailableReferenceSlot = 0;
     mMaxFreeRatio = 0.70;
     mMinFreeRatio = 0.30;
+
+    // one segment per processor, rounded up to a power of two so we can
+    // pick a thread's segment with a mask
+    final int processors = Runtime.getRuntime().availableProcessors();
+    int numSegments = 1;
+    while(numSegments < processors && numSegments < MAX_SEGMENTS)
+      numSegments <<= 1;
+    mSegmentMask = numSegments - 1;
+    mSegments = new ReferenceSegment[numSegments];
+    for(int i = 0; i < numSegments; i++)
+      mSegments[i] = new ReferenceSegment(getMinimumSegmentReferences());
   }
-  
-  private void blockingLock()
+
+  /**
+   * The minimum number of references each segment caches; together they
+   * cache at least {@link #getMinimumReferencesToCache()}.
+   */
+  private int getMinimumSegmentReferences()
   {
-    mLock.lock();
-    while(!mSpinLock.compareAndSet(false, true))
-      ; // grab the spin lock
+    final int numSegments = mSegments.length;
+    return Math.max(MIN_SEGMENT_REFERENCES,
+        (mMinimumReferencesToCache + numSegments - 1) / numSegments);
   }
-  private void blockingUnlock()
+
+  /**
+   * Get the number of segments our reference heap is striped into.
+   * @return the number of segments.
+   */
+  int getNumReferenceSegments()
   {
-    final boolean result = mSpinLock.compareAndSet(true, false);
-    assert result : "Should never ever be unlocked here";
-    mLock.unlock();
+    return mSegments.length;
+  }
+
+  /**
+   * One stripe of our collect-and-sweep JNIReference heap.
+   */
+  private final class ReferenceSegment
+  {
+    private final AtomicBoolean mSpinLock;
+    private final Lock mLock;
+    private JNIReference mValidReferences[];
+    private volatile int mNextAvailableReferenceSlot;
+    private volatile int mMaxValidReference;
+
+    ReferenceSegment(int minReferences)
+    {
+      mLock = new ReentrantLock();
+      mSpinLock = new AtomicBoolean(false);
+      mValidReferences = new JNIReference[minReferences];
+      mMaxValidReference = minReferences;
+      mNextAvailableReferenceSlot = 0;
+    }
+
+    private void blockingLock()
+    {
+      mLock.lock();
+      while(!mSpinLock.compareAndSet(false, true))
+        ; // grab the spin lock
+    }
+    private void blockingUnlock()
+    {
+      final boolean result = mSpinLock.compareAndSet(true, false);
+      assert result : "Should never ever be unlocked here";
+      mLock.unlock();
+    }
+
+    boolean addReference(final JNIReference ref)
+    {
+      /* Implementation note: This method is extremely
+       * hot, and so I've unrolled the lock and unlock
+       * methods from above.  Take care if you change
+       * them to change the unrolled versions here.
+       * 
+       */
+      // First try to grab the non blocking lock
+      boolean gotNonblockingLock = false;
+      gotNonblockingLock = mSpinLock.compareAndSet(false, true);
+      if (gotNonblockingLock)
+      {
+        final int slot = mNextAvailableReferenceSlot++;
+        if (slot < mMaxValidReference)
+        {
+          mValidReferences[slot] = ref;
+          // unlock the non-blocking lock, and progress to a full lock.
+          final boolean result = mSpinLock.compareAndSet(true, false);
+          assert result : "Should never be unlocked here";
+          return true;
+        }
+        // try the big lock without blocking
+        if (!mLock.tryLock()) {
+          // we couldn't get the big lock, so release the spin lock
+          // and try getting the bit lock while blocking
+          gotNonblockingLock = false;
+          mSpinLock.compareAndSet(true, false);
+        }
+      }
+      // The above code needs to make sure that we never
+      // have gotNonblockingLock set, unless we have both
+      // the spin lock and the big lock.
+      if (!gotNonblockingLock){
+        mLock.lock();
+        while(!mSpinLock.compareAndSet(false, true))
+          ; // grab the spin lock
+      }
+      try {
+        int slot = mNextAvailableReferenceSlot++;
+        if (slot >= mMaxValidReference)
+        {
+          sweepAndCollect();
+          slot = mNextAvailableReferenceSlot++;
+        }
+        mValidReferences[slot] = ref;
+      } finally {
+        final boolean result = mSpinLock.compareAndSet(true, false);
+        assert result : "Should never ever be unlocked here";
+        mLock.unlock();
+      }
+      return true;
+    }
+
+    /**
+     * Must be called with both locks held.
+     */
+    private int sweepAndCollect()
+    {
+      // time to sweep, collect, and possibly grow.
+      JNIReference[] survivors = new JNIReference[mMaxValidReference];
+      int numSurvivors=0;
+      final int numValid = mMaxValidReference;
+      for(int i = 0; i < numValid; i++)
+      {
+        JNIReference victim = mValidReferences[i];
+        if (victim != null && !victim.isDeleted())
+        {
+          survivors[numSurvivors] = victim;
+          ++numSurvivors;
+        }
+      }
+      final int survivorLength = survivors.length;
+      int freeSpace = survivorLength - numSurvivors;
+      if (freeSpace > survivorLength * mMaxFreeRatio)
+      {
+        // time to shrink
+        int newSize = (int) (survivorLength*(1.0 - mExpandIncrement*mShrinkScaleFactor));
+        // never shrink smaller than the minimum
+        if (newSize >= getMinimumSegmentReferences()) {
+          JNIReference[] shrunk = new JNIReference[newSize];
+          System.arraycopy(survivors, 0, shrunk, 0, newSize);
+          survivors = shrunk;
+        }
+      } else if (freeSpace <= survivorLength*mMinFreeRatio)
+      {
+        // time to expand
+        int newSize = (int) (survivorLength*(1.0 + mExpandIncrement));
+        // and always by at least one, or the next add has nowhere to go
+        if (newSize <= survivorLength)
+          newSize = survivorLength + 1;
+        JNIReference[] expanded = new JNIReference[newSize];
+        System.arraycopy(survivors, 0, expanded, 0, survivorLength);
+        survivors = expanded;
+      }
+      // and swap in our new array
+      // ORDER REALLY MATTERS HERE.  See #addReference
+      mValidReferences = survivors;
+      mMaxValidReference = survivors.length;
+      mNextAvailableReferenceSlot = numSurvivors;
+      return numSurvivors;
+    }
+
+    void sweep()
+    {
+      blockingLock();
+      try {
+        sweepAndCollect();
+      } finally {
+        blockingUnlock();
+      }
+    }
+
+    long getNumPinnedObjects()
+    {
+      long numPinnedObjects = 0;
+      blockingLock();
+      try {
+        int numItems = mNextAvailableReferenceSlot;
+        for(int i = 0; i < numItems; i++)
+        {
+          JNIReference ref = mValidReferences[i];
+          if (ref != null && !ref.isDeleted())
+            ++numPinnedObjects;
+        }
+      } finally {
+        blockingUnlock();
+      }
+      return numPinnedObjects;
+    }
+
+    void dumpMemoryLog(int segment)
+    {
+      blockingLock();
+      try {
+        int numItems = mNextAvailableReferenceSlot;
+        log.debug("Segment: {}; Memory slots in use: {}", segment, numItems);
+        for(int i = 0; i < numItems; i++)
+        {
+          JNIReference ref = mValidReferences[i];
+          if (ref != null)
+            log.debug("Segment: {}; Slot: {}; Ref: {}",
+                new Object[]{segment, i, ref});
+        }
+      } finally {
+        blockingUnlock();
+      }
+    }
+
+    void flush()
+    {
+      blockingLock();
+      try {
+        int numSurvivors = sweepAndCollect();
+        for(int i = 0; i < numSurvivors; i++)
+        {
+          final JNIReference ref = mValidReferences[i];
+          if (ref != null)
+            ref.delete();
+        }
+        sweepAndCollect();
+        // finally, reset the valid references to the minimum
+        final int minReferences = getMinimumSegmentReferences();
+        mValidReferences = new JNIReference[minReferences];
+        mNextAvailableReferenceSlot = 0;
+        mMaxValidReference = minReferences;
+      } finally {
+        blockingUnlock();
+      }
+    }
   }
 
   /**
@@ -1076,49 +1349,6 @@ public final class JNIMemoryManager
     return mMinFreeRatio*100;
   }
 
-  private int sweepAndCollect()
-  {
-    // time to sweep, collect, and possibly grow.
-    JNIReference[] survivors = new JNIReference[mMaxValidReference];
-    int numSurvivors=0;
-    final int numValid = mMaxValidReference;
-    for(int i = 0; i < numValid; i++)
-    {
-      JNIReference victim = mValidReferences[i];
-      if (victim != null && !victim.isDeleted())
-      {
-        survivors[numSurvivors] = victim;
-        ++numSurvivors;
-      }
-    }
-    final int survivorLength = survivors.length;
-    int freeSpace = survivorLength - numSurvivors;
-    if (freeSpace > survivorLength * mMaxFreeRatio)
-    {
-      // time to shrink
-      int newSize = (int) (survivorLength*(1.0 - mExpandIncrement*mShrinkScaleFactor));
-      // never shrink smaller than the minimum
-      if (newSize >= mMinimumReferencesToCache) {
-        JNIReference[] shrunk = new JNIReference[newSize];
-        System.arraycopy(survivors, 0, shrunk, 0, newSize);
-        survivors = shrunk;
-      }
-    } else if (freeSpace <= survivorLength*mMinFreeRatio)
-    {
-      // time to expand
-      int newSize = (int) (survivorLength*(1.0 + mExpandIncrement));
-      JNIReference[] expanded = new JNIReference[newSize];
-      System.arraycopy(survivors, 0, expanded, 0, survivorLength);
-      survivors = expanded;
-    }
-    // and swap in our new array
-    // ORDER REALLY MATTERS HERE.  See #addReference
-    mValidReferences = survivors;
-    mMaxValidReference = survivors.length;
-    mNextAvailableReferenceSlot = numSurvivors;
-    return numSurvivors;
-  }
-
   /**
    * The collection thread if running.
    */
@@ -1150,43 +1380,22 @@ public final class JNIMemoryManager
   public long getNumPinnedObjects()
   {
     long numPinnedObjects = 0;
-    blockingLock();
-    try {
-      int numItems = mNextAvailableReferenceSlot;
-      for(int i = 0; i < numItems; i++)
-      {
-        JNIReference ref = mValidReferences[i];
-        if (ref != null && !ref.isDeleted())
-          ++numPinnedObjects;
-      }
-    } finally {
-      blockingUnlock();
-    }
+    for(ReferenceSegment segment : mSegments)
+      numPinnedObjects += segment.getNumPinnedObjects();
     return numPinnedObjects;
   }
 
   /**
    * Dump the contents of our memory cache to the log.
    * <p>
-   * This method requires a global lock in order to run so only
-   * use for debugging.  
+   * This method locks each segment of the cache in turn while it runs so
+   * only use for debugging.  
    * </p>
    */
   public void dumpMemoryLog()
   {
-    blockingLock();
-    try {
-      int numItems = mNextAvailableReferenceSlot;
-      log.debug("Memory slots in use: {}", numItems);
-      for(int i = 0; i < numItems; i++)
-      {
-        JNIReference ref = mValidReferences[i];
-        if (ref != null)
-          log.debug("Slot: {}; Ref: {}", i, ref);
-      }
-    } finally {
-      blockingUnlock();
-    }
+    for(int i = 0; i < mSegments.length; i++)
+      mSegments[i].dumpMemoryLog(i);
     return;
   }
   
@@ -1240,56 +1449,8 @@ public final class JNIMemoryManager
    */
   final boolean addReference(final JNIReference ref)
   {
-    /* Implementation note: This method is extremely
-     * hot, and so I've unrolled the lock and unlock
-     * methods from above.  Take care if you change
-     * them to change the unrolled versions here.
-     * 
-     */
-    // First try to grab the non blocking lock
-    boolean gotNonblockingLock = false;
-    gotNonblockingLock = mSpinLock.compareAndSet(false, true);
-    if (gotNonblockingLock)
-    {
-      final int slot = mNextAvailableReferenceSlot++;
-      if (slot < mMaxValidReference)
-      {
-        mValidReferences[slot] = ref;
-        // unlock the non-blocking lock, and progress to a full lock.
-        final boolean result = mSpinLock.compareAndSet(true, false);
-        assert result : "Should never be unlocked here";
-        return true;
-      }
-      // try the big lock without blocking
-      if (!mLock.tryLock()) {
-        // we couldn't get the big lock, so release the spin lock
-        // and try getting the bit lock while blocking
-        gotNonblockingLock = false;
-        mSpinLock.compareAndSet(true, false);
-      }
-    }
-    // The above code needs to make sure that we never
-    // have gotNonblockingLock set, unless we have both
-    // the spin lock and the big lock.
-    if (!gotNonblockingLock){
-      mLock.lock();
-      while(!mSpinLock.compareAndSet(false, true))
-        ; // grab the spin lock
-    }
-    try {
-      int slot = mNextAvailableReferenceSlot++;
-      if (slot >= mMaxValidReference)
-      {
-        sweepAndCollect();
-        slot = mNextAvailableReferenceSlot++;
-      }
-      mValidReferences[slot] = ref;
-    } finally {
-      final boolean result = mSpinLock.compareAndSet(true, false);
-      assert result : "Should never ever be unlocked here";
-      mLock.unlock();
-    }
-    return true;
+    return mSegments[(int) Thread.currentThread().getId() & mSegmentMask]
+        .addReference(ref);
   }
 
   /**
@@ -1315,19 +1476,15 @@ public final class JNIMemoryManager
    * Does a Ferry Garbage Collection, and also sweeps our internal
    * {@link JNIReference} heap to remove any lightweight references we may
    * have left around.
-   * @param doSweep if true, we sweep the heap.  This involves a global lock
-   *   and so should be used sparingly.
+   * @param doSweep if true, we sweep the heap.  This locks each segment of
+   *   the heap in turn and so should be used sparingly.
    */
   public void gc(boolean doSweep)
   {
     gcInternal();
     if (doSweep) {
-      blockingLock();
-      try {
-        sweepAndCollect();
-      } finally {
-        blockingUnlock();
-      }
+      for(ReferenceSegment segment : mSegments)
+        segment.sweep();
     }
   }
   /**
@@ -1443,6 +1600,76 @@ public final class JNIMemoryManager
     mMemoryModel = model;
   }
 
+  /**
+   * Get the number of native allocations that were satisfied by
+   * recycling a previously released block under the
+   * {@link MemoryModel#NATIVE_BUFFERS_POOLED} model.
+   * 
+   * @return the number of pool hits since the process started.
+   * 
+   * @since 5.5
+   */
+  public static long getPoolHits()
+  {
+    return FerryJNI.getPoolHits();
+  }
+
+  /**
+   * Get the number of native allocations that could not be satisfied from
+   * the pool under the {@link MemoryModel#NATIVE_BUFFERS_POOLED} model.
+   * 
+   * @return the number of pool misses since the process started.
+   * 
+   * @since 5.5
+   */
+  public static long getPoolMisses()
+  {
+    return FerryJNI.getPoolMisses();
+  }
+
+  /**
+   * Get the number of bytes of released native memory currently being held
+   * for reuse under the {@link MemoryModel#NATIVE_BUFFERS_POOLED} model.
+   * 
+   * @return the number of bytes retained across all threads.
+   * 
+   * @since 5.5
+   */
+  public static long getPoolRetainedBytes()
+  {
+    return FerryJNI.getPoolRetainedBytes();
+  }
+
+  /**
+   * Get the maximum number of bytes of released native memory the
+   * {@link MemoryModel#NATIVE_BUFFERS_POOLED} model will retain.
+   * 
+   * @return the cap, in bytes.
+   * 
+   * @since 5.5
+   */
+  public static long getPoolMaxRetainedBytes()
+  {
+    return FerryJNI.getPoolMaxRetainedBytes();
+  }
+
+  /**
+   * Set the maximum number of bytes of released native memory the
+   * {@link MemoryModel#NATIVE_BUFFERS_POOLED} model will retain. Once the cap
+   * is reached, released blocks go straight back to the native heap.
+   * <p>
+   * Lowering the cap does not release blocks that are already retained.
+   * </p>
+   * 
+   * @param maxBytes the cap, in bytes. 0 turns recycling off.
+   * 
+   * @since 5.5
+   */
+  public static void setPoolMaxRetainedBytes(long maxBytes)
+  {
+    FerryJNI.setPoolMaxRetainedBytes(maxBytes);
+  }
+
   /**
    * Internal Only.
    * 
@@ -1451,23 +1678,8 @@ public final class JNIMemoryManager
    */
   final public void flush()
   {
-    blockingLock();
-    try {
-      int numSurvivors = sweepAndCollect();
-      for(int i = 0; i < numSurvivors; i++)
-      {
-        final JNIReference ref = mValidReferences[i];
-        if (ref != null)
-          ref.delete();
-      }
-      sweepAndCollect();
-      // finally, reset the valid references to the minimum
-      mValidReferences = new JNIReference[mMinimumReferencesToCache];
-      mNextAvailableReferenceSlot = 0;
-      mMaxValidReference = mMinimumReferencesToCache;
-    } finally {
-      blockingUnlock();
-    }
+    for(ReferenceSegment segment : mSegments)
+      segment.flush();
   }
 
 }
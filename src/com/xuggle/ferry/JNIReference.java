@@ -109,7 +109,8 @@ public final class JNIReference extends WeakReference<Object>
     }
     JNIMemoryManager.MemoryModel model = JNIMemoryManager.getMemoryModel();
     if (model == JNIMemoryManager.MemoryModel.JAVA_DIRECT_BUFFERS ||
-        model == JNIMemoryManager.MemoryModel.NATIVE_BUFFERS)
+        model == JNIMemoryManager.MemoryModel.NATIVE_BUFFERS ||
+        model == JNIMemoryManager.MemoryModel.NATIVE_BUFFERS_POOLED)
       // don't use our allocators
       return;
     if (mJavaRefCount.get() == 1 && 
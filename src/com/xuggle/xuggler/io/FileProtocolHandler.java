@@ -22,6 +22,7 @@ package com.xuggle.xuggler.io;
 import java.io.File;
 import java.io.IOException;
 import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
@@ -34,10 +35,13 @@ import com.xuggle.xuggler.io.IURLProtocolHandler;
  * that FFMPEG implemements, but demonstrates how you can have FFMPEG
  * call back into Java.
  * 
+ * Reads and writes go through the file's channel straight to and from
+ * FFMPEG's buffers (see {@link IDirectURLProtocolHandler}).
+ * 
  * @author aclarke
  *
  */
-public class FileProtocolHandler implements IURLProtocolHandler
+public class FileProtocolHandler implements IDirectURLProtocolHandler
 {
   File file = null;
   RandomAccessFile stream = null;
@@ -208,6 +212,38 @@ public class FileProtocolHandler implements IURLProtocolHandler
     }
   }
 
+  public int read(ByteBuffer buf, int size)
+  {
+    try
+    {
+      buf.limit(size);
+      return stream.getChannel().read(buf);
+    }
+    catch (IOException e)
+    {
+      log.error("Got IO exception reading from file: {}", file);
+      e.printStackTrace();
+      return -1;
+    }
+  }
+
+  public int write(ByteBuffer buf, int size)
+  {
+    try
+    {
+      buf.limit(size);
+      while (buf.hasRemaining())
+        stream.getChannel().write(buf);
+      return size;
+    }
+    catch (IOException e)
+    {
+      log.error("Got error writing to file: {}", file);
+      e.printStackTrace();
+      return -1;
+    }
+  }
+
   private String getFilename(String url)
   {
     String retval = url;
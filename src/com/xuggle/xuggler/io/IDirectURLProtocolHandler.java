@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+package com.xuggle.xuggler.io;
+
+import java.nio.ByteBuffer;
+
+/**
+ * An {@link IURLProtocolHandler} that can read into and write from
+ * {@link ByteBuffer} objects.
+ * <p>
+ * For handlers that implement this interface, Xuggler calls
+ * {@link #read(ByteBuffer, int)} and {@link #write(ByteBuffer, int)}
+ * instead of {@link #read(byte[], int)} and {@link #write(byte[], int)}.
+ * The buffers passed are direct buffers over FFMPEG's own I/O memory,
+ * and are reused from call to call, so no Java objects get allocated
+ * and no extra copies get made per read or write.  Handlers backed by
+ * NIO channels can hand the buffer straight to the channel.
+ * </p>
+ * <p>
+ * The buffers are only valid during the call: do not keep a reference
+ * to one after returning.  On each call the buffer's position is 0 and
+ * its limit is size.
+ * </p>
+ * @see ReadableWritableChannelHandler
+ * @see FileProtocolHandler
+ * @since 5.5
+ */
+public interface IDirectURLProtocolHandler extends IURLProtocolHandler
+{
+  /**
+   * This method gets called by FFMPEG when it tries to read data.
+   * <p>
+   * The same non-blocking IO conventions as {@link #read(byte[], int)}
+   * apply.
+   * </p>
+   * 
+   * @param buf The buffer to write your data to, starting at position 0.
+   * @param size The number of bytes in buf data available for you to write the data that FFMPEG will read.
+   * @return 0 for end of file, else number of bytes you wrote to the buffer, or -1 if error.
+   */
+  public int read(ByteBuffer buf, int size);
+
+  /**
+   * This method gets called by FFMPEG when it tries to write data.
+   * <p>
+   * The same non-blocking IO conventions as {@link #write(byte[], int)}
+   * apply.  Do not modify the contents of buf.
+   * </p>
+   * 
+   * @param buf The data you should write, starting at position 0.
+   * @param size The number of bytes in buf.
+   * @return 0 for end of file, else number of bytes you read from buf, or -1 if error.
+   */
+  public int write(ByteBuffer buf, int size);
+}
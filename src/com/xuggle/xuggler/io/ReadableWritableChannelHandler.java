@@ -39,12 +39,18 @@ import org.slf4j.LoggerFactory;
  * {@link #isStreamed(String, int)} will always return true.
  * 
  * </p>
+ * <p>
+ * 
+ * As an {@link IDirectURLProtocolHandler}, the channel reads into and
+ * writes from FFMPEG's buffers directly.
+ * 
+ * </p>
  * 
  * @author aclarke
  * 
  */
 
-public class ReadableWritableChannelHandler implements IURLProtocolHandler
+public class ReadableWritableChannelHandler implements IDirectURLProtocolHandler
 {
   private final Logger log = LoggerFactory.getLogger(this.getClass());
 
@@ -200,6 +206,29 @@ public class ReadableWritableChannelHandler implements IURLProtocolHandler
     }
   }
 
+  /**
+   * {@inheritDoc}
+   */
+
+  public int read(ByteBuffer buf, int size)
+  {
+    if (mOpenStream == null || !(mOpenStream instanceof ReadableByteChannel))
+      return -1;
+
+    try
+    {
+      ReadableByteChannel channel = (ReadableByteChannel) mOpenStream;
+      buf.limit(size);
+      return channel.read(buf);
+    }
+    catch (IOException e)
+    {
+      log.error("Got IO exception reading from channel: {}; {}",
+          mOpenStream, e);
+      return -1;
+    }
+  }
+
   /**
    * {@inheritDoc}
    * 
@@ -236,6 +265,29 @@ public class ReadableWritableChannelHandler implements IURLProtocolHandler
     }
   }
 
+  /**
+   * {@inheritDoc}
+   */
+
+  public int write(ByteBuffer buf, int size)
+  {
+    if (mOpenStream == null ||
+        !(mOpenStream instanceof WritableByteChannel))
+      return -1;
+
+    try
+    {
+      WritableByteChannel channel = (WritableByteChannel) mOpenStream;
+      buf.limit(size);
+      return channel.write(buf);
+    }
+    catch (IOException e)
+    {
+      log.error("Got error writing to file: {}; {}", mOpenStream, e);
+      return -1;
+    }
+  }
+
   /**
    * {@inheritDoc}
    * Always true for this class. 
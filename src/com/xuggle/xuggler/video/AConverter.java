@@ -73,6 +73,10 @@ abstract public class AConverter implements IConverter
 
   final private String mDescription;
 
+  // true if pictures are converted natively rather than resampled
+
+  final private boolean mConvertsNatively;
+
   /** 
    * Construct an abstract Converter.  This will create a
    * {@link IVideoResampler}
@@ -112,10 +116,26 @@ abstract public class AConverter implements IConverter
     mImageWidth = imageWidth;
     mImageHeight = imageHeight;
 
+    // YUV420P pictures the same size as the image can be converted
+    // natively, in one pass and without a resampler
+
+    mConvertsNatively = ConverterFactory.isNativeConversionEnabled()
+      && pictureType.equals(IPixelFormat.Type.YUV420P)
+      && (requiredPictureType.equals(IPixelFormat.Type.BGR24)
+        || requiredPictureType.equals(IPixelFormat.Type.ARGB))
+      && (mPictureWidth == mImageWidth)
+      && (mPictureHeight == mImageHeight);
+
+    if (mConvertsNatively)
+    {
+      resampleDescription = "Pictures will be converted natively to and from " +
+        requiredPictureType + " during translation.";
+    }
+
     // if the picture type is not the type or size required, create the
     // resamplers to fix that
 
-    if (!pictureType.equals(requiredPictureType) 
+    else if (!pictureType.equals(requiredPictureType) 
       || (mPictureWidth != mImageWidth)
       || (mPictureHeight != mImageHeight))
     {
@@ -190,6 +210,21 @@ abstract public class AConverter implements IConverter
     return null != mToPictureResampler && null != mToImageResampler;
   }
 
+  /**
+   * Will this converter translate pictures natively, in a single pass
+   * straight to or from the image's pixels?  This is true for {@link
+   * IPixelFormat.Type#YUV420P} pictures that are not resized, unless
+   * turned off with {@link ConverterFactory#setNativeConversion}.
+   *
+   * @return true if pictures will be converted natively, in which case
+   *         {@link #willResample()} is false.
+   */
+
+  public boolean willConvertNatively()
+  {
+    return mConvertsNatively;
+  }
+
   /** 
    * Re-sample a picture.
    * 
@@ -291,7 +326,7 @@ abstract public class AConverter implements IConverter
     // if the picture is an invalid type throw up
 
     IPixelFormat.Type type = picture.getPixelType();
-    if ((type != getPictureType()) && (willResample() && 
+    if ((type != getPictureType()) && (!willResample() || 
         type != mToImageResampler.getOutputPixelFormat()))
       throw new IllegalArgumentException(
         "Picture is of type: " + type + ", but must be " + 
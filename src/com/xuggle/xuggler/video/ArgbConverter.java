@@ -80,6 +80,11 @@ public class ArgbConverter extends AConverter
 
     validateImage(image);
 
+    // convert natively if we can
+
+    if (willConvertNatively())
+      return toPictureNatively(image, timestamp);
+
     // get the image byte buffer buffer
 
     DataBuffer imageBuffer = image.getRaster().getDataBuffer();
@@ -158,6 +163,11 @@ public class ArgbConverter extends AConverter
 
     validatePicture(picture);
 
+    // convert natively if we can
+
+    if (willConvertNatively())
+      return toImageNatively(picture);
+
     // resample as needed
 
     IVideoPicture resamplePic = null;
@@ -246,6 +256,46 @@ public class ArgbConverter extends AConverter
     }
   }
 
+  // convert a YUV420P picture straight into a new image's pixels
+
+  private BufferedImage toImageNatively(IVideoPicture picture)
+  {
+    final int w = picture.getWidth();
+    final int h = picture.getHeight();
+    final BufferedImage image = new BufferedImage(w, h, getImageType());
+    final int[] ints = ((DataBufferInt)image.getRaster().getDataBuffer())
+      .getData();
+    if (!picture.copyToARGB(ints, 0, w))
+      throw new RuntimeException("could not convert picture " + picture);
+    return image;
+  }
+
+  // convert an image's pixels straight into a new YUV420P picture
+
+  private IVideoPicture toPictureNatively(BufferedImage image,
+    long timestamp)
+  {
+    final WritableRaster raster = image.getRaster();
+    final DataBuffer imageBuffer = raster.getDataBuffer();
+    if (!(imageBuffer instanceof DataBufferInt))
+      throw new IllegalArgumentException(
+        "Unsupported BufferedImage data buffer type: " +
+        imageBuffer.getDataType());
+    final int stride = ((SinglePixelPackedSampleModel)raster.getSampleModel())
+      .getScanlineStride();
+
+    final IVideoPicture picture = IVideoPicture.make(getPictureType(),
+      image.getWidth(), image.getHeight());
+    if (!picture.copyFromARGB(((DataBufferInt)imageBuffer).getData(),
+        imageBuffer.getOffset(), stride, image.getWidth(), image.getHeight(),
+        timestamp))
+    {
+      picture.delete();
+      throw new RuntimeException("could not convert image " + image);
+    }
+    return picture;
+  }
+
   public void delete()
   {
     super.close();
@@ -30,6 +30,7 @@ import java.awt.image.DataBuffer;
 import java.awt.image.ColorModel;
 import java.awt.color.ColorSpace;
 import java.awt.image.ComponentColorModel;
+import java.awt.image.ComponentSampleModel;
 import java.awt.image.SampleModel;
 import java.awt.image.PixelInterleavedSampleModel;
 import java.awt.image.WritableRaster;
@@ -81,6 +82,11 @@ public class BgrConverter extends AConverter
 
     validateImage(image);
 
+    // convert natively if we can
+
+    if (willConvertNatively())
+      return toPictureNatively(image, timestamp);
+
     // get the image byte buffer buffer
 
     DataBuffer imageBuffer = image.getRaster().getDataBuffer();
@@ -158,6 +164,11 @@ public class BgrConverter extends AConverter
 
     validatePicture(picture);
 
+    // convert natively if we can
+
+    if (willConvertNatively())
+      return toImageNatively(picture);
+
     // resample as needed
     IVideoPicture resamplePicture = null;
     AtomicReference<JNIReference> ref = 
@@ -212,6 +223,46 @@ public class BgrConverter extends AConverter
     }
   }
 
+  // convert a YUV420P picture straight into a new image's pixels
+
+  private BufferedImage toImageNatively(IVideoPicture picture)
+  {
+    final int w = picture.getWidth();
+    final int h = picture.getHeight();
+    final BufferedImage image = new BufferedImage(w, h, getImageType());
+    final byte[] bytes = ((DataBufferByte)image.getRaster().getDataBuffer())
+      .getData();
+    if (!picture.copyToBGR24(bytes, 0, 3 * w))
+      throw new RuntimeException("could not convert picture " + picture);
+    return image;
+  }
+
+  // convert an image's pixels straight into a new YUV420P picture
+
+  private IVideoPicture toPictureNatively(BufferedImage image,
+    long timestamp)
+  {
+    final WritableRaster raster = image.getRaster();
+    final DataBuffer imageBuffer = raster.getDataBuffer();
+    if (!(imageBuffer instanceof DataBufferByte))
+      throw new IllegalArgumentException(
+        "Unsupported BufferedImage data buffer type: " +
+        imageBuffer.getDataType());
+    final int stride = ((ComponentSampleModel)raster.getSampleModel())
+      .getScanlineStride();
+
+    final IVideoPicture picture = IVideoPicture.make(getPictureType(),
+      image.getWidth(), image.getHeight());
+    if (!picture.copyFromBGR24(((DataBufferByte)imageBuffer).getData(),
+        imageBuffer.getOffset(), stride, image.getWidth(), image.getHeight(),
+        timestamp))
+    {
+      picture.delete();
+      throw new RuntimeException("could not convert image " + image);
+    }
+    return picture;
+  }
+
   public void delete()
   {
     super.close();
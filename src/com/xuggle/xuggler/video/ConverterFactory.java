@@ -59,6 +59,12 @@ import com.xuggle.xuggler.IVideoResampler;
  * if the {@link IVideoPicture#getPixelType()} is
  *  {@link com.xuggle.xuggler.IPixelFormat.Type#BGR24}. 
  * </p>
+ * <p>
+ * {@link com.xuggle.xuggler.IPixelFormat.Type#YUV420P} pictures that are
+ * not being resized skip the re-sampler altogether; they are converted
+ * natively, straight to or from the image's pixels, in a single pass.
+ * See {@link #setNativeConversion(boolean)}.
+ * </p>
  */
 
 public class ConverterFactory
@@ -84,6 +90,10 @@ public class ConverterFactory
 
   public static final String XUGGLER_BGR_24 = "XUGGLER-BGR-24";
 
+  // true if converters may convert YUV420P pictures natively
+
+  private static volatile boolean mNativeConversion = true;
+
   // the registered converter types
   
   private static Map<String, Type> mConverterTypes = new HashMap<String, Type>();
@@ -134,6 +144,38 @@ public class ConverterFactory
     return mConverterTypes.remove(converterType.getDescriptor());
   }
 
+  /**
+   * Set whether converters created from now on may convert {@link
+   * com.xuggle.xuggler.IPixelFormat.Type#YUV420P} pictures to and from
+   * images natively, in a single pass, rather than re-sampling them
+   * with an {@link IVideoResampler} and then copying the pixels.  This
+   * is on by default, and does not require a GPL build.  Turning it off
+   * is mostly useful for comparing the two.
+   *
+   * @param enable true to allow native conversion.
+   *
+   * @see AConverter#willConvertNatively()
+   */
+
+  public static void setNativeConversion(boolean enable)
+  {
+    mNativeConversion = enable;
+  }
+
+  /**
+   * Will converters created from now on convert {@link
+   * com.xuggle.xuggler.IPixelFormat.Type#YUV420P} pictures natively?
+   *
+   * @return true if native conversion is enabled.
+   *
+   * @see #setNativeConversion(boolean)
+   */
+
+  public static boolean isNativeConversionEnabled()
+  {
+    return mNativeConversion;
+  }
+
   /**
    * Get a collection of the registered converters.  The collection is unmodifiable.
    *
@@ -21,6 +21,12 @@
 #include <com/xuggle/ferry/LoggerStack.h>
 #include "LoggerTest.h"
 
+#include <ctime>
+#include <cstdio>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
 using namespace VS_CPP_NAMESPACE;
 
 VS_LOG_SETUP(VS_CPP_PACKAGE);
@@ -41,3 +47,84 @@ LoggerTestSuite :: testOutputToStandardError()
   VS_TUT_ENSURE("this test really just shouldn't crash.  check log files to ensure it outputted", true);
 }
 
+static int
+LoggerTest_countCall(int* calls)
+{
+  return ++(*calls);
+}
+
+void
+LoggerTestSuite :: testDisabledLevelsSkipArguments()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_INFO, false);
+
+  int calls = 0;
+  VS_LOG_DEBUG("never formatted: %d", LoggerTest_countCall(&calls));
+  VS_TUT_ENSURE_EQUALS("disabled level evaluated its arguments", calls, 0);
+}
+
+void
+LoggerTestSuite :: testAsynchronousLogging()
+{
+  const int numMessages = 20000;
+  // only static loggers queue; see below for the others
+  Logger* logger = Logger::getStaticLogger("com.xuggle.ferry.LoggerTest.async");
+  VS_TUT_ENSURE("", logger);
+  Logger* transient = Logger::getLogger("com.xuggle.ferry.LoggerTest.transient");
+  VS_TUT_ENSURE("", transient);
+
+  // everything goes to standard error outside of Java; send that to
+  // /dev/null while we time things
+  fflush(stderr);
+  std::cerr.flush();
+  int savedStderr = dup(2);
+  int devNull = open("/dev/null", O_WRONLY);
+  VS_TUT_ENSURE("", savedStderr >= 0 && devNull >= 0);
+  dup2(devNull, 2);
+  close(devNull);
+
+  std::clock_t start = std::clock();
+  for(int i = 0; i < numMessages; i++)
+    logger->warn(__FILE__, __LINE__, "synchronous message %d", i);
+  double syncSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+
+  Logger::setAsynchronous(true);
+  Logger::resetRecordCounts();
+  VS_TUT_ENSURE("", Logger::isAsynchronous());
+  int64_t queued = 0;
+  start = std::clock();
+  for(int i = 0; i < numMessages; i++)
+    if (logger->warn(__FILE__, __LINE__, "asynchronous message %d", i))
+      ++queued;
+  double asyncSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+  Logger::flush();
+  int64_t forwarded = Logger::getNumForwardedRecords();
+  int64_t dropped = Logger::getNumDroppedRecords();
+
+  // a logger its caller can delete logs synchronously, so deleting it
+  // right away leaves nothing queued that points at it
+  transient->warn(__FILE__, __LINE__, "synchronous while asynchronous");
+  delete transient;
+  Logger::flush();
+  int64_t transientForwarded = Logger::getNumForwardedRecords() - forwarded;
+  Logger::setAsynchronous(false);
+
+  fflush(stderr);
+  std::cerr.flush();
+  dup2(savedStderr, 2);
+  close(savedStderr);
+
+  // every message was either forwarded or counted as dropped
+  VS_TUT_ENSURE_EQUALS("", forwarded, queued);
+  VS_TUT_ENSURE_EQUALS("", forwarded + dropped, (int64_t)numMessages);
+  VS_TUT_ENSURE_EQUALS("", transientForwarded, (int64_t)0);
+  VS_TUT_ENSURE("", !Logger::isAsynchronous());
+
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_INFO, true);
+  VS_LOG_INFO("%d messages: %.3fs synchronous; %.3fs asynchronous "
+      "(%lld forwarded, %lld dropped)",
+      numMessages, syncSeconds, asyncSeconds,
+      (long long)forwarded, (long long)dropped);
+}
@@ -26,6 +26,8 @@ class LoggerTestSuite : public CxxTest::TestSuite
 {
   public:
   void testOutputToStandardError();
+  void testDisabledLevelsSkipArguments();
+  void testAsynchronousLogging();
 };
 
 
@@ -17,9 +17,18 @@
  * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
  *******************************************************************************/
 
+#include <pthread.h>
+#include <ctime>
+
+#include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/ferry/Mutex.h>
+#include <com/xuggle/ferry/SpinMutex.h>
+#include <com/xuggle/ferry/IBuffer.h>
+#include <com/xuggle/ferry/RefPointer.h>
 #include "MutexTest.h"
 
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
 using namespace VS_CPP_NAMESPACE;
 
 void
@@ -30,3 +39,87 @@ MutexTestSuite :: testCreateAndDestroy()
   mutex = Mutex::make();
   VS_TUT_ENSURE("should not get a mutex when running outside Java", !mutex);
 }
+
+namespace {
+const int32_t MutexTest_numThreads = 4;
+const int32_t MutexTest_numIterations = 250000;
+
+struct MutexTest_SpinArgs
+{
+  SpinMutex* mutex;
+  int64_t* counter;
+};
+
+void*
+MutexTest_spinIncrement(void* arg)
+{
+  MutexTest_SpinArgs* args = static_cast<MutexTest_SpinArgs*>(arg);
+  for(int32_t i = 0; i < MutexTest_numIterations; i++)
+  {
+    args->mutex->lock();
+    // deliberately non-atomic read-modify-write; only the lock makes this safe
+    int64_t value = *args->counter;
+    *args->counter = value + 1;
+    args->mutex->unlock();
+  }
+  return 0;
+}
+
+void*
+MutexTest_acquireRelease(void* arg)
+{
+  RefCounted* obj = static_cast<RefCounted*>(arg);
+  for(int32_t i = 0; i < MutexTest_numIterations; i++)
+  {
+    obj->acquire();
+    obj->release();
+  }
+  return 0;
+}
+}
+
+void
+MutexTestSuite :: testSpinMutexExcludesOtherThreads()
+{
+  SpinMutex mutex;
+  int64_t counter = 0;
+  MutexTest_SpinArgs args = { &mutex, &counter };
+  pthread_t threads[MutexTest_numThreads];
+
+  VS_TUT_ENSURE("should get lock", mutex.tryLock());
+  VS_TUT_ENSURE("should not get held lock", !mutex.tryLock());
+  mutex.unlock();
+
+  for(int32_t i = 0; i < MutexTest_numThreads; i++)
+    VS_TUT_ENSURE_EQUALS("could not start thread", 0,
+        pthread_create(&threads[i], 0, MutexTest_spinIncrement, &args));
+  for(int32_t i = 0; i < MutexTest_numThreads; i++)
+    pthread_join(threads[i], 0);
+
+  VS_TUT_ENSURE_EQUALS("lost an update",
+      (int64_t)MutexTest_numThreads*MutexTest_numIterations, counter);
+}
+
+void
+MutexTestSuite :: testRefCountContentionBenchmark()
+{
+  RefPointer<IBuffer> obj = IBuffer::make(0, 16);
+  VS_TUT_ENSURE("could not make object", obj);
+  pthread_t threads[MutexTest_numThreads];
+
+  int32_t startRefCount = obj->getCurrentRefCount();
+  std::clock_t start = std::clock();
+  for(int32_t i = 0; i < MutexTest_numThreads; i++)
+    VS_TUT_ENSURE_EQUALS("could not start thread", 0,
+        pthread_create(&threads[i], 0, MutexTest_acquireRelease,
+            obj.value()));
+  for(int32_t i = 0; i < MutexTest_numThreads; i++)
+    pthread_join(threads[i], 0);
+  std::clock_t elapsed = std::clock() - start;
+
+  VS_TUT_ENSURE_EQUALS("ref count drifted under contention",
+      startRefCount, obj->getCurrentRefCount());
+  VS_LOG_INFO("%d threads did %d acquire/release pairs each in %ld ms (cpu)",
+      MutexTest_numThreads, MutexTest_numIterations,
+      (long)(elapsed*1000/CLOCKS_PER_SEC));
+}
@@ -26,6 +26,8 @@ class MutexTestSuite : public CxxTest::TestSuite
 {
   public:
   void testCreateAndDestroy();
+  void testSpinMutexExcludesOtherThreads();
+  void testRefCountContentionBenchmark();
 };
 
 
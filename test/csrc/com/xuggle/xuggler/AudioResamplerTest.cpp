@@ -25,6 +25,10 @@
 
 // For Random
 #include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
 
 using namespace VS_CPP_NAMESPACE;
 
@@ -91,7 +95,7 @@ AudioResamplerTest :: testGetters()
   LoggerStack stack;
   stack.setGlobalLevel(Logger::LEVEL_ERROR, false);
 
-  sampler = IAudioResampler::make(3, 2,
+  sampler = IAudioResampler::make(0, 2,
       22050, 44100);
   VS_TUT_ENSURE("sampler", !sampler);
   sampler = IAudioResampler::make(-1, -1,
@@ -109,7 +113,7 @@ AudioResamplerTest :: testInvalidArguments()
   stack.setGlobalLevel(Logger::LEVEL_ERROR, false);
 
   RefPointer<IAudioResampler> sampler;
-  sampler = IAudioResampler::make(3, 2,
+  sampler = IAudioResampler::make(0, 2,
       22050, 44100);
   VS_TUT_ENSURE("sampler", !sampler);
   sampler = IAudioResampler::make(-1, -1,
@@ -438,3 +442,143 @@ AudioResamplerTest :: testTimeStampIsAdjustedWhenResamplerEatsBytesUpsampling()
         inSamples->getNextPts() - IAudioSamples::samplesToDefaultPts(16, oSampleRate));
 
 }
+
+void
+AudioResamplerTest :: testDownmixingSurroundToStereo()
+{
+  // 5.1 (FL FR FC LFE SL SR), float planar at 48k, with a tone on
+  // the front left only, to packed 16-bit stereo at 44.1k.
+  const int32_t inRate = 48000;
+  const int32_t outRate = 44100;
+  const int32_t numSamples = 4800;
+  RefPointer<IAudioResampler> sampler = IAudioResampler::make(2, 6,
+      outRate, inRate, IAudioSamples::FMT_S16, IAudioSamples::FMT_FLTP);
+  VS_TUT_ENSURE("could not make a 6 channel resampler", sampler);
+
+  RefPointer<IAudioSamples> inSamples = IAudioSamples::make(numSamples, 6,
+      IAudioSamples::FMT_FLTP);
+  RefPointer<IBuffer> inBuffer = inSamples->getData();
+  float* in = (float*)inBuffer->getBytes(0, numSamples*6*sizeof(float));
+  VS_TUT_ENSURE("!samples", in);
+  for (int32_t c = 0; c < 6; c++)
+    for (int32_t i = 0; i < numSamples; i++)
+      in[c*numSamples + i] = c == 0 ? (float)(0.5*sin(2*M_PI*1000*i/inRate)) : 0;
+  inSamples->setComplete(true, numSamples, inRate, 6,
+      IAudioSamples::FMT_FLTP, 0);
+
+  RefPointer<IAudioSamples> outSamples = IAudioSamples::make(1024, 2);
+  int32_t retval = sampler->resample(outSamples.value(), inSamples.value(), 0);
+  VS_TUT_ENSURE("could not resample", retval > 0);
+  VS_TUT_ENSURE("too few samples",
+      retval > numSamples*outRate/inRate - 2*sampler->getFilterLen());
+  VS_TUT_ENSURE_EQUALS("wrong channels", outSamples->getChannels(), 2);
+  VS_TUT_ENSURE_EQUALS("wrong format", outSamples->getFormat(),
+      IAudioSamples::FMT_S16);
+
+  // left gets the tone, scaled down so a full-level 5.1 mix can't
+  // clip; right gets nothing
+  int32_t peakLeft = 0;
+  int32_t peakRight = 0;
+  for (int32_t i = 100; i < retval - 100; i++)
+  {
+    peakLeft = std::max(peakLeft, abs(outSamples->getSample(i, 0,
+        IAudioSamples::FMT_S16)));
+    peakRight = std::max(peakRight, abs(outSamples->getSample(i, 1,
+        IAudioSamples::FMT_S16)));
+  }
+  const double expected = 0.5*32768/(1+2*M_SQRT1_2);
+  VS_TUT_ENSURE_DISTANCE("wrong left level", peakLeft, expected, 0.02*expected);
+  VS_TUT_ENSURE_EQUALS("tone leaked to the right", peakRight, 0);
+}
+
+void
+AudioResamplerTest :: testConvertingFormatsWithoutResampling()
+{
+  // Same rate, so no filter: stereo S16 in, planar S16 out is an
+  // exact rearrangement.
+  RefPointer<IAudioResampler> sampler = IAudioResampler::make(2, 2,
+      44100, 44100, IAudioSamples::FMT_S16P, IAudioSamples::FMT_S16);
+  VS_TUT_ENSURE("! sampler", sampler);
+
+  RefPointer<IAudioSamples> inSamples = IAudioSamples::make(64, 2);
+  for (int32_t i = 0; i < 64; i++)
+  {
+    inSamples->setSample(i, 0, IAudioSamples::FMT_S16, i*100);
+    inSamples->setSample(i, 1, IAudioSamples::FMT_S16, -i*100);
+  }
+  inSamples->setComplete(true, 64, 44100, 2, IAudioSamples::FMT_S16, 0);
+  RefPointer<IAudioSamples> outSamples = IAudioSamples::make(64, 2,
+      IAudioSamples::FMT_S16P);
+  int32_t retval = sampler->resample(outSamples.value(), inSamples.value(), 0);
+  VS_TUT_ENSURE_EQUALS("should not hold anything back", retval, 64);
+  VS_TUT_ENSURE_EQUALS("wrong format", outSamples->getFormat(),
+      IAudioSamples::FMT_S16P);
+
+  RefPointer<IBuffer> outBuffer = outSamples->getData();
+  int16_t* out = (int16_t*)outBuffer->getBytes(0, 2*64*sizeof(int16_t));
+  VS_TUT_ENSURE("!samples", out);
+  for (int32_t i = 0; i < 64; i++)
+  {
+    VS_TUT_ENSURE_EQUALS("wrong left", out[i], i*100);
+    VS_TUT_ENSURE_EQUALS("wrong right", out[64+i], -i*100);
+  }
+}
+
+void
+AudioResamplerTest :: testResamplingBenchmark()
+{
+  // Not a pass/fail test; this logs how many input samples per second
+  // (of CPU time) common conversions get through.
+  struct {
+    const char* name;
+    int32_t outChannels;
+    int32_t inChannels;
+    int32_t outRate;
+    int32_t inRate;
+    IAudioSamples::Format outFmt;
+    IAudioSamples::Format inFmt;
+  } cases[] = {
+    { "stereo s16 44.1k -> 48k", 2, 2, 48000, 44100,
+        IAudioSamples::FMT_S16, IAudioSamples::FMT_S16 },
+    { "mono s16 22.05k -> stereo 44.1k", 2, 1, 44100, 22050,
+        IAudioSamples::FMT_S16, IAudioSamples::FMT_S16 },
+    { "5.1 fltp 48k -> stereo s16 44.1k", 2, 6, 44100, 48000,
+        IAudioSamples::FMT_S16, IAudioSamples::FMT_FLTP },
+    { "stereo fltp -> s16, no rate change", 2, 2, 44100, 44100,
+        IAudioSamples::FMT_S16, IAudioSamples::FMT_FLTP },
+  };
+  const int32_t numSamples = 4096;
+  const int32_t passes = 200;
+  for (size_t c = 0; c < sizeof(cases)/sizeof(cases[0]); c++)
+  {
+    RefPointer<IAudioResampler> sampler = IAudioResampler::make(
+        cases[c].outChannels, cases[c].inChannels,
+        cases[c].outRate, cases[c].inRate,
+        cases[c].outFmt, cases[c].inFmt);
+    VS_TUT_ENSURE("! sampler", sampler);
+    RefPointer<IAudioSamples> inSamples = IAudioSamples::make(numSamples,
+        cases[c].inChannels, cases[c].inFmt);
+    RefPointer<IBuffer> inBuffer = inSamples->getData();
+    int32_t inBytes = inBuffer->getBufferSize();
+    memset(inBuffer->getBytes(0, inBytes), 0, inBytes);
+    inSamples->setComplete(true, numSamples, cases[c].inRate,
+        cases[c].inChannels, cases[c].inFmt, 0);
+    RefPointer<IAudioSamples> outSamples = IAudioSamples::make(
+        sampler->getMinimumNumSamplesRequiredInOutputSamples(numSamples),
+        cases[c].outChannels, cases[c].outFmt);
+
+    std::clock_t start = std::clock();
+    for (int32_t i = 0; i < passes; i++)
+    {
+      int32_t retval = sampler->resample(outSamples.value(),
+          inSamples.value(), 0);
+      VS_TUT_ENSURE("could not resample", retval > 0);
+    }
+    double seconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+    VS_LOG_INFO("%s: %d samples in %.3f seconds (%.0f samples/second)",
+        cases[c].name,
+        numSamples*passes,
+        seconds,
+        seconds > 0 ? numSamples*passes / seconds : 0.0);
+  }
+}
@@ -36,6 +36,9 @@ class AudioResamplerTest : public CxxTest::TestSuite
     void testResamplingAudio();
     void testDifferentResampleRates();
     void testTimeStampIsAdjustedWhenResamplerEatsBytesUpsampling();
+    void testDownmixingSurroundToStereo();
+    void testConvertingFormatsWithoutResampling();
+    void testResamplingBenchmark();
   private:
     Helper* h;
     Helper* hw;
@@ -19,6 +19,7 @@
 
 #include <com/xuggle/ferry/RefPointer.h>
 #include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/ferry/IBuffer.h>
 #include <com/xuggle/xuggler/IStream.h>
 #include <com/xuggle/xuggler/IStreamCoder.h>
 #include <com/xuggle/xuggler/ICodec.h>
@@ -26,6 +27,8 @@
 #include "Helper.h"
 #include "AudioSamplesTest.h"
 
+#include <vector>
+
 using namespace VS_CPP_NAMESPACE;
 
 VS_LOG_SETUP(VS_CPP_PACKAGE);
@@ -343,3 +346,111 @@ AudioSamplesTest :: testGetSampleRainyDayScenarios()
   retval = samples->getSample(0, -1, IAudioSamples::FMT_S16);
   VS_TUT_ENSURE_EQUALS("should be too small a channel", 0, retval);
 }
+
+void
+AudioSamplesTest :: testPlanarSampleAccess()
+{
+  RefPointer<IAudioSamples> samples = IAudioSamples::make(1024, 2,
+      IAudioSamples::FMT_S16P);
+  VS_TUT_ENSURE("got no samples", samples);
+  samples->setComplete(true, 512, 22050, 2, IAudioSamples::FMT_S16P, 0);
+
+  VS_TUT_ENSURE("should set sample without error",
+      samples->setSample(3, 0, IAudioSamples::FMT_S16, 8) >= 0);
+  VS_TUT_ENSURE("should set sample without error",
+      samples->setSample(3, 1, IAudioSamples::FMT_S16, 16) >= 0);
+
+  // planes sit back to back, one channel's worth of samples each
+  RefPointer<IBuffer> data = samples->getData();
+  short* raw = (short*) data->getBytes(0, 2*512*sizeof(short));
+  VS_TUT_ENSURE("no raw samples", raw);
+  VS_TUT_ENSURE_EQUALS("wrong channel 0 slot", raw[3], 8);
+  VS_TUT_ENSURE_EQUALS("wrong channel 1 slot", raw[512+3], 16);
+  VS_TUT_ENSURE_EQUALS("should be equal to set value",
+      samples->getSample(3, 0, IAudioSamples::FMT_S16), 8);
+  VS_TUT_ENSURE_EQUALS("should be equal to set value",
+      samples->getSample(3, 1, IAudioSamples::FMT_S16), 16);
+}
+
+static void
+AudioSamplesTest_decodeAll(Helper* h, const char* file, bool misaligned,
+    std::vector<uint32_t>& sizes, std::vector<uint8_t>& bytes)
+{
+  h->setupReading(file);
+  int audioStream = -1;
+  for (int i = 0; i < h->num_streams; i++)
+    if (h->codecs[i]->getType() == ICodec::CODEC_TYPE_AUDIO)
+    {
+      audioStream = i;
+      break;
+    }
+  VS_TUT_ENSURE("couldn't find an audio stream", audioStream >= 0);
+  RefPointer<IStreamCoder> coder = h->coders[audioStream];
+  VS_TUT_ENSURE("! open codec", coder->open() >= 0);
+
+  // Samples wrapping memory that is not 16-byte aligned can't be
+  // rendered into directly, so they take the decode-and-copy path.
+  std::vector<uint8_t> storage(256*1024);
+  RefPointer<IAudioSamples> samples;
+  if (misaligned)
+  {
+    RefPointer<IBuffer> buffer = IBuffer::make(0, &storage[0]+4,
+        storage.size()-4, 0, 0);
+    samples = IAudioSamples::make(buffer.value(), coder->getChannels(),
+        coder->getSampleFormat());
+  }
+  else
+    samples = IAudioSamples::make(1024, coder->getChannels(),
+        coder->getSampleFormat());
+  VS_TUT_ENSURE("got no samples", samples);
+
+  RefPointer<IPacket> packet = IPacket::make();
+  while (sizes.size() < 200 && h->container->readNextPacket(packet.value()) == 0)
+  {
+    if (packet->getStreamIndex() != audioStream)
+      continue;
+    int offset = 0;
+    while (offset < packet->getSize())
+    {
+      int retval = coder->decodeAudio(samples.value(), packet.value(), offset);
+      VS_TUT_ENSURE("could not decode any audio", retval > 0);
+      offset += retval;
+      if (!samples->isComplete())
+        continue;
+      uint32_t size = samples->getSize();
+      RefPointer<IBuffer> data = samples->getData();
+      uint8_t* raw = (uint8_t*) data->getBytes(0, size);
+      VS_TUT_ENSURE("no raw samples", raw);
+      sizes.push_back(size);
+      bytes.insert(bytes.end(), raw, raw+size);
+    }
+  }
+  coder->close();
+}
+
+void
+AudioSamplesTest :: testDecodingInPlaceMatchesCopiedDecode()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_WARN, false);
+
+  const char* files[] = { "testfile.mp3", "ucl_h264_aac.mp4" };
+  for (size_t i = 0; i < sizeof(files)/sizeof(files[0]); i++)
+  {
+    std::vector<uint32_t> directSizes;
+    std::vector<uint8_t> directBytes;
+    std::vector<uint32_t> copiedSizes;
+    std::vector<uint8_t> copiedBytes;
+
+    AudioSamplesTest_decodeAll(h, files[i], false, directSizes, directBytes);
+    setUp();
+    AudioSamplesTest_decodeAll(h, files[i], true, copiedSizes, copiedBytes);
+
+    VS_TUT_ENSURE("should decode some audio", directSizes.size() > 0);
+    VS_TUT_ENSURE("different number of frames decoded",
+        directSizes == copiedSizes);
+    VS_TUT_ENSURE("decoded audio differs",
+        directBytes == copiedBytes);
+    setUp();
+  }
+}
@@ -37,6 +37,8 @@ class AudioSamplesTest : public CxxTest::TestSuite
     void testSetSampleEdgeCases();
     void testSetSampleSunnyDayScenarios();
     void testGetSampleRainyDayScenarios();
+    void testPlanarSampleAccess();
+    void testDecodingInPlaceMatchesCopiedDecode();
   private:
     Helper* h;
     Helper* hw;
@@ -19,6 +19,7 @@
 
 #include <com/xuggle/xuggler/ICodec.h>
 #include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
 #include "Helper.h"
 #include "CodecTest.h"
 
@@ -238,3 +239,83 @@ CodecTest :: testEncodePCM()
   VS_TUT_ENSURE("", codec);
   VS_TUT_ENSURE("", codec->canEncode());
 }
+
+void
+CodecTest :: testGetInstalledCodecsOfType()
+{
+  int32_t num = ICodec::getNumInstalledCodecs();
+  int32_t total = 0;
+  ICodec::Type types[] = {
+      ICodec::CODEC_TYPE_VIDEO,
+      ICodec::CODEC_TYPE_AUDIO,
+      ICodec::CODEC_TYPE_DATA,
+      ICodec::CODEC_TYPE_SUBTITLE,
+      ICodec::CODEC_TYPE_ATTACHMENT,
+  };
+  for(size_t i = 0; i < sizeof(types)/sizeof(types[0]); i++)
+  {
+    int32_t numOfType = ICodec::getNumInstalledCodecsOfType(types[i]);
+    total += numOfType;
+    // they should come in the same order as all installed codecs
+    int32_t j = 0;
+    for(int32_t k = 0; k < numOfType; k++)
+    {
+      codec = ICodec::getInstalledCodecOfType(types[i], k);
+      VS_TUT_ENSURE("should be valid", codec);
+      VS_TUT_ENSURE_EQUALS("wrong type", types[i], codec->getType());
+      RefPointer<ICodec> installed;
+      for(; j < num; j++)
+      {
+        installed = ICodec::getInstalledCodec(j);
+        if (installed->getType() == types[i])
+          break;
+      }
+      VS_TUT_ENSURE("out of order", j < num);
+      VS_TUT_ENSURE_EQUALS("wrong codec", std::string(installed->getName()),
+          std::string(codec->getName()));
+      VS_TUT_ENSURE_EQUALS("wrong codec", installed->canEncode(),
+          codec->canEncode());
+      j++;
+    }
+    VS_TUT_ENSURE("could fail quietly",
+        0 == ICodec::getInstalledCodecOfType(types[i], numOfType));
+    VS_TUT_ENSURE("could fail quietly",
+        0 == ICodec::getInstalledCodecOfType(types[i], -1));
+  }
+  VS_TUT_ENSURE_EQUALS("every codec has one of these types", num, total);
+  VS_TUT_ENSURE_EQUALS("unknown type", 0,
+      ICodec::getNumInstalledCodecsOfType(ICodec::CODEC_TYPE_UNKNOWN));
+  VS_TUT_ENSURE("unknown type",
+      0 == ICodec::getInstalledCodecOfType(ICodec::CODEC_TYPE_UNKNOWN, 0));
+}
+
+void
+CodecTest :: testIndexMatchesFFmpeg()
+{
+  Global::init();
+  const CodecFormatIndex* index = CodecFormatIndex::get();
+  VS_TUT_ENSURE("should be built", index);
+
+  int32_t num = 0;
+  AVCodec* ffCodec = 0;
+  while((ffCodec = av_codec_next(ffCodec)) != 0)
+  {
+    VS_TUT_ENSURE("wrong order", ffCodec == index->getCodec(num));
+    ++num;
+    VS_TUT_ENSURE("wrong encoder",
+        avcodec_find_encoder(ffCodec->id) == index->findEncoder(ffCodec->id));
+    VS_TUT_ENSURE("wrong decoder",
+        avcodec_find_decoder(ffCodec->id) == index->findDecoder(ffCodec->id));
+    VS_TUT_ENSURE("wrong encoder",
+        avcodec_find_encoder_by_name(ffCodec->name) ==
+            index->findEncoder(ffCodec->name));
+    VS_TUT_ENSURE("wrong decoder",
+        avcodec_find_decoder_by_name(ffCodec->name) ==
+            index->findDecoder(ffCodec->name));
+  }
+  VS_TUT_ENSURE_EQUALS("wrong count", num, index->getNumCodecs());
+  VS_TUT_ENSURE("should not find", !index->findEncoder("not-a-codec"));
+  VS_TUT_ENSURE("should not find", !index->findDecoder((const char*)0));
+  VS_TUT_ENSURE("should not find", !index->findDecoder(-1));
+  VS_TUT_ENSURE("should not find", !index->getCodec(num));
+}
@@ -41,6 +41,8 @@ class CodecTest : public CxxTest::TestSuite
     void testGetSupportedAudioSampleFormats();
     void testGetSupportedAudioChannelLayouts();
     void testEncodePCM();
+    void testGetInstalledCodecsOfType();
+    void testIndexMatchesFFmpeg();
   private:
     RefPointer<ICodec> codec;
 };
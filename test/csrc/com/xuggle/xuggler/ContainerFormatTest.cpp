@@ -17,11 +17,13 @@
  * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
  *******************************************************************************/
 
+#include <cctype>
 #include <string>
 #include <com/xuggle/ferry/RefPointer.h>
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/IContainerFormat.h>
 #include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/CodecFormatIndex.h>
 #include "Helper.h"
 #include "ContainerFormatTest.h"
 
@@ -215,3 +217,102 @@ ContainerFormatTest :: testGetInstalledOutputFormats()
   }
 }
 
+void
+ContainerFormatTest :: testIndexMatchesFFmpeg()
+{
+  Global::init();
+  const CodecFormatIndex* index = CodecFormatIndex::get();
+  VS_TUT_ENSURE("should be built", index);
+
+  int32_t num = 0;
+  AVInputFormat* iFormat = 0;
+  while((iFormat = av_iformat_next(iFormat)) != 0)
+  {
+    VS_TUT_ENSURE("wrong order", iFormat == index->getInputFormat(num));
+    ++num;
+    // try each of its names, and the upper case of each
+    std::string names = iFormat->name;
+    size_t start = 0;
+    while(start <= names.size())
+    {
+      size_t end = names.find(',', start);
+      if (end == std::string::npos)
+        end = names.size();
+      std::string name = names.substr(start, end-start);
+      VS_TUT_ENSURE("wrong input format",
+          av_find_input_format(name.c_str()) ==
+              index->findInputFormat(name.c_str()));
+      for(size_t i = 0; i < name.size(); i++)
+        name[i] = toupper(name[i]);
+      VS_TUT_ENSURE("wrong input format",
+          av_find_input_format(name.c_str()) ==
+              index->findInputFormat(name.c_str()));
+      start = end + 1;
+    }
+    // and the whole list at once, commas and all
+    VS_TUT_ENSURE("wrong input format",
+        av_find_input_format(iFormat->name) ==
+            index->findInputFormat(iFormat->name));
+  }
+  VS_TUT_ENSURE_EQUALS("wrong count", num, index->getNumInputFormats());
+  VS_TUT_ENSURE("should not find", !index->findInputFormat("not-a-format"));
+  VS_TUT_ENSURE("should not find", !index->findInputFormat(0));
+
+  num = 0;
+  AVOutputFormat* oFormat = 0;
+  while((oFormat = av_oformat_next(oFormat)) != 0)
+  {
+    VS_TUT_ENSURE("wrong order", oFormat == index->getOutputFormat(num));
+    ++num;
+    const char* name = oFormat->name;
+    const char* mimeType = oFormat->mime_type;
+    VS_TUT_ENSURE("wrong output format",
+        av_guess_format(name, 0, 0) ==
+            index->guessOutputFormat(name, 0, 0));
+    VS_TUT_ENSURE("wrong output format",
+        av_guess_format(0, 0, mimeType) ==
+            index->guessOutputFormat(0, 0, mimeType));
+    if (!oFormat->extensions)
+      continue;
+    std::string extensions = oFormat->extensions;
+    size_t start = 0;
+    while(start <= extensions.size())
+    {
+      size_t end = extensions.find(',', start);
+      if (end == std::string::npos)
+        end = extensions.size();
+      std::string url = "dir.name/file." +
+          extensions.substr(start, end-start);
+      VS_TUT_ENSURE("wrong output format",
+          av_guess_format(0, url.c_str(), 0) ==
+              index->guessOutputFormat(0, url.c_str(), 0));
+      VS_TUT_ENSURE("wrong output format",
+          av_guess_format(0, url.c_str(), mimeType) ==
+              index->guessOutputFormat(0, url.c_str(), mimeType));
+      VS_TUT_ENSURE("wrong output format",
+          av_guess_format("mp4", url.c_str(), mimeType) ==
+              index->guessOutputFormat("mp4", url.c_str(), mimeType));
+      for(size_t i = 0; i < url.size(); i++)
+        url[i] = toupper(url[i]);
+      VS_TUT_ENSURE("wrong output format",
+          av_guess_format(0, url.c_str(), 0) ==
+              index->guessOutputFormat(0, url.c_str(), 0));
+      start = end + 1;
+    }
+  }
+  VS_TUT_ENSURE_EQUALS("wrong count", num, index->getNumOutputFormats());
+  const char* urls[] = {
+      "file%03d.png",
+      "file%03d.unknown",
+      "file",
+      "file.",
+      "dir.flv/file",
+  };
+  for(size_t i = 0; i < sizeof(urls)/sizeof(urls[0]); i++)
+    VS_TUT_ENSURE("wrong output format",
+        av_guess_format(0, urls[i], 0) ==
+            index->guessOutputFormat(0, urls[i], 0));
+  VS_TUT_ENSURE("should not find",
+      !index->guessOutputFormat("not-a-format", 0, 0));
+  VS_TUT_ENSURE("should not find", !index->guessOutputFormat(0, 0, 0));
+}
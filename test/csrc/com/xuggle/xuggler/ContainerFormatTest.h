@@ -37,6 +37,7 @@ class ContainerFormatTest : public CxxTest::TestSuite
     void testGetOutputNumCodecsSupported();
     void testGetInstalledInputFormats();
     void testGetInstalledOutputFormats();
+    void testIndexMatchesFFmpeg();
   private:
     Helper* h;
     RefPointer<IContainerFormat> format;
@@ -18,9 +18,16 @@
  *******************************************************************************/
 
 #include <string>
+#include <cstring>
+#include <ctime>
+#include <vector>
+// For getenv()
+#include <stdlib.h>
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/IContainer.h>
+#include <com/xuggle/xuggler/IIndexEntry.h>
 #include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/Container.h>
 #include "Helper.h"
 #include "ContainerTest.h"
 
@@ -475,3 +482,616 @@ ContainerTest :: testGetSDP()
     VS_TUT_ENSURE("", *sdp);
   cont->close();
 }
+
+void
+ContainerTest :: testReadFromFileWithZeroCopyReads()
+{
+  int numPackets = 0;
+  int retval = -1;
+  int zeroCopyRetval = -1;
+  h->setupReading(h->SAMPLE_FILE);
+
+  RefPointer<IContainer> zeroCopyContainer = IContainer::make();
+  VS_TUT_ENSURE("no container", zeroCopyContainer);
+  VS_TUT_ENSURE("should default to copying", !zeroCopyContainer->getZeroCopyReads());
+  zeroCopyContainer->setZeroCopyReads(true);
+  VS_TUT_ENSURE("could not enable zero copy", zeroCopyContainer->getZeroCopyReads());
+  retval = zeroCopyContainer->open(h->getSamplePath(), IContainer::READ, 0);
+  VS_TUT_ENSURE("could not open file for read", retval >= 0);
+
+  RefPointer<IPacket> zeroCopyPacket = IPacket::make();
+  VS_TUT_ENSURE("couldn't allocate a packet", zeroCopyPacket);
+  do {
+    retval = h->container->readNextPacket(h->packet.value());
+    zeroCopyRetval = zeroCopyContainer->readNextPacket(zeroCopyPacket.value());
+    VS_TUT_ENSURE_EQUALS("read results differ", retval, zeroCopyRetval);
+    if (retval == 0)
+    {
+      VS_TUT_ENSURE_EQUALS("stream index differs",
+          h->packet->getStreamIndex(), zeroCopyPacket->getStreamIndex());
+      VS_TUT_ENSURE_EQUALS("dts differs",
+          h->packet->getDts(), zeroCopyPacket->getDts());
+      VS_TUT_ENSURE_EQUALS("pts differs",
+          h->packet->getPts(), zeroCopyPacket->getPts());
+      VS_TUT_ENSURE_EQUALS("flags differ",
+          h->packet->getFlags(), zeroCopyPacket->getFlags());
+      VS_TUT_ENSURE("packet not complete", zeroCopyPacket->isComplete());
+      int32_t size = h->packet->getSize();
+      VS_TUT_ENSURE_EQUALS("size differs", size, zeroCopyPacket->getSize());
+      if (size > 0)
+      {
+        RefPointer<IBuffer> data = h->packet->getData();
+        RefPointer<IBuffer> zeroCopyData = zeroCopyPacket->getData();
+        VS_TUT_ENSURE("no data", data && zeroCopyData);
+        VS_TUT_ENSURE("payloads differ",
+            memcmp(data->getBytes(0, size), zeroCopyData->getBytes(0, size),
+                size) == 0);
+      }
+      numPackets++;
+    }
+  } while (retval >= 0);
+
+  VS_TUT_ENSURE("no packets in file", numPackets > 0);
+  if (h->expected_packets > 0)
+    VS_TUT_ENSURE_EQUALS("unexpected number of packets",
+        h->expected_packets,
+        numPackets);
+  VS_TUT_ENSURE("could not close file", zeroCopyContainer->close() >= 0);
+}
+
+void
+ContainerTest :: testReadAndWritePacketsInBatches()
+{
+  const int32_t batchSize = 16;
+  int retval = -1;
+  h->setupReading(h->SAMPLE_FILE);
+
+  RefPointer<IContainer> batchContainer = IContainer::make();
+  VS_TUT_ENSURE("no container", batchContainer);
+  retval = batchContainer->open(h->getSamplePath(), IContainer::READ, 0);
+  VS_TUT_ENSURE("could not open file for read", retval >= 0);
+
+  RefPointer<IContainer> outContainer = IContainer::make();
+  VS_TUT_ENSURE("no container", outContainer);
+  retval = outContainer->open("ContainerTest_testReadAndWritePacketsInBatches.flv",
+      IContainer::WRITE, 0);
+  VS_TUT_ENSURE("couldn't write", retval >=0);
+  int32_t numInStreams = batchContainer->getNumStreams();
+  for(int i = 0; i < numInStreams; i++)
+  {
+    RefPointer<IStream> inStream = batchContainer->getStream(i);
+    RefPointer<IStreamCoder> inCoder = inStream->getStreamCoder();
+    VS_TUT_ENSURE("input coder not open", inCoder->open() >= 0);
+    RefPointer<IStream> outStream = outContainer->addNewStream(inStream->getId());
+    VS_TUT_ENSURE("couldn't add stream", outStream);
+    RefPointer<IStreamCoder> outCoder = IStreamCoder::make(IStreamCoder::ENCODING,
+        inCoder.value());
+    VS_TUT_ENSURE("couldn't copy in coder", outStream->setStreamCoder(outCoder.value()) >= 0);
+    VS_TUT_ENSURE("couldn't open out coder", outCoder->open() >= 0);
+  }
+  VS_TUT_ENSURE("couldn't write header",
+      outContainer->writeHeader() >= 0);
+
+  VS_TUT_ENSURE("should reject null batches",
+      batchContainer->readNextPackets(0, batchSize) < 0);
+
+  // one ring of packets, re-used for every batch
+  std::vector<RefPointer<IPacket> > ring(batchSize);
+  std::vector<IPacket*> packets(batchSize);
+  for(int32_t i = 0; i < batchSize; i++)
+  {
+    ring[i] = IPacket::make();
+    packets[i] = ring[i].value();
+  }
+  VS_TUT_ENSURE_EQUALS("empty batches read nothing",
+      batchContainer->readNextPackets(&packets[0], 0), 0);
+  VS_TUT_ENSURE_EQUALS("empty batches write nothing",
+      outContainer->writePackets(&packets[0], 0, true), 0);
+
+  int32_t numPackets = 0;
+  int32_t numPacketsWritten = 0;
+  int32_t numRead = 0;
+  do
+  {
+    numRead = batchContainer->readNextPackets(&packets[0], batchSize);
+    for(int32_t i = 0; i < numRead; i++)
+    {
+      VS_TUT_ENSURE("could not read single packet",
+          h->container->readNextPacket(h->packet.value()) >= 0);
+      VS_TUT_ENSURE_EQUALS("stream index differs",
+          h->packet->getStreamIndex(), packets[i]->getStreamIndex());
+      VS_TUT_ENSURE_EQUALS("dts differs",
+          h->packet->getDts(), packets[i]->getDts());
+      VS_TUT_ENSURE_EQUALS("size differs",
+          h->packet->getSize(), packets[i]->getSize());
+      RefPointer<IRational> timeBase = packets[i]->getTimeBase();
+      RefPointer<IRational> singleTimeBase = h->packet->getTimeBase();
+      VS_TUT_ENSURE("no time base", timeBase && singleTimeBase);
+      VS_TUT_ENSURE_EQUALS("time base differs", 0,
+          timeBase->compareTo(singleTimeBase.value()));
+      numPackets++;
+    }
+    if (numRead > 0)
+    {
+      int32_t numWritten = outContainer->writePackets(&packets[0], numRead,
+          false);
+      VS_TUT_ENSURE_EQUALS("couldn't write batch", numRead, numWritten);
+      numPacketsWritten += numWritten;
+    }
+    if (numRead >= 0)
+      VS_TUT_ENSURE("batch too big", numRead <= batchSize);
+  } while (numRead == batchSize);
+  VS_TUT_ENSURE("batches ended early",
+      h->container->readNextPacket(h->packet.value()) < 0);
+
+  VS_TUT_ENSURE("no packets in file", numPackets > 0);
+  if (h->expected_packets > 0)
+    VS_TUT_ENSURE_EQUALS("unexpected number of packets",
+        h->expected_packets,
+        numPackets);
+  VS_TUT_ENSURE_EQUALS("same input as output",
+      numPackets,
+      numPacketsWritten);
+
+  VS_TUT_ENSURE("couldn't write trailer",
+      outContainer->writeTrailer() >= 0);
+  for(int i = 0; i < (int32_t) outContainer->getNumStreams(); i++)
+  {
+    RefPointer<IStream> stream = outContainer->getStream(i);
+    RefPointer<IStreamCoder> coder = stream->getStreamCoder();
+    VS_TUT_ENSURE("no close stream", coder->close() >= 0);
+    stream = batchContainer->getStream(i);
+    coder = stream->getStreamCoder();
+    VS_TUT_ENSURE("no close stream", coder->close() >= 0);
+  }
+  VS_TUT_ENSURE("couldn't close container", outContainer->close() >= 0);
+  VS_TUT_ENSURE("couldn't close container", batchContainer->close() >= 0);
+}
+
+/**
+ * Reads every packet in the sample file the given number of times,
+ * batchSize packets at a time (or one at a time with readNextPacket if
+ * batchSize is 0), and returns the number of packets read.
+ */
+static int64_t
+ContainerTest_readAllPackets(Helper* h, int32_t batchSize, int32_t passes)
+{
+  int64_t numPackets = 0;
+  int32_t ringSize = batchSize > 0 ? batchSize : 1;
+  std::vector<RefPointer<IPacket> > ring(ringSize);
+  std::vector<IPacket*> packets(ringSize);
+  for(int32_t i = 0; i < ringSize; i++)
+  {
+    ring[i] = IPacket::make();
+    packets[i] = ring[i].value();
+  }
+  for(int32_t pass = 0; pass < passes; pass++)
+  {
+    RefPointer<IContainer> container = IContainer::make();
+    VS_TUT_ENSURE("could not open file for read",
+        container->open(h->getSamplePath(), IContainer::READ, 0) >= 0);
+    if (batchSize > 0)
+    {
+      int32_t numRead = 0;
+      while((numRead = container->readNextPackets(&packets[0], batchSize)) > 0)
+        numPackets += numRead;
+    }
+    else
+    {
+      while(container->readNextPacket(packets[0]) >= 0)
+        numPackets++;
+    }
+    container->close();
+  }
+  return numPackets;
+}
+
+void
+ContainerTest :: testReadNextPacketsBenchmark()
+{
+  // Not a pass/fail test; this logs how many packets per second
+  // (of CPU time) each way of reading gets through.
+  const int32_t passes = 10;
+  const int32_t batchSizes[] = { 0, 1, 16, 64 };
+  int64_t expected = -1;
+  h->setupReading(h->SAMPLE_FILE);
+  for(size_t i = 0; i < sizeof(batchSizes)/sizeof(batchSizes[0]); i++)
+  {
+    std::clock_t start = std::clock();
+    int64_t numPackets = ContainerTest_readAllPackets(h, batchSizes[i], passes);
+    double seconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+    VS_TUT_ENSURE("no packets read", numPackets > 0);
+    if (expected < 0)
+      expected = numPackets;
+    VS_TUT_ENSURE_EQUALS("batch size changed number of packets read",
+        expected, numPackets);
+    VS_LOG_INFO("%s with batch size %d: %lld packets in %.3f seconds (%.0f packets/second)",
+        batchSizes[i] ? "readNextPackets" : "readNextPacket",
+        batchSizes[i],
+        (long long)numPackets,
+        seconds,
+        seconds > 0 ? numPackets / seconds : 0.0);
+  }
+}
+
+void
+ContainerTest :: testBuildWriteAndReadKeyFrameIndex()
+{
+  // MPEG-PS demuxers keep no index of their own, so seeks in this file
+  // go through the keyframe index
+  char file[2048];
+  const char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+  const char *sample = "testfile_mpeg1video_mp2audio.mpg";
+  if (fixtureDirectory && *fixtureDirectory)
+    snprintf(file, sizeof(file), "%s/%s", fixtureDirectory, sample);
+  else
+    snprintf(file, sizeof(file), "./%s", sample);
+  const char* indexFile = "ContainerTest_testBuildWriteAndReadKeyFrameIndex.xkfi";
+
+  RefPointer<IContainer> built = IContainer::make();
+  VS_TUT_ENSURE("should not build before opening",
+      built->buildKeyFrameIndex() < 0);
+  VS_TUT_ENSURE("should not write without an index",
+      built->writeKeyFrameIndex(indexFile) < 0);
+  VS_TUT_ENSURE("could not open file for read",
+      built->open(file, IContainer::READ, 0) >= 0);
+  int32_t numEntries = built->buildKeyFrameIndex();
+  VS_TUT_ENSURE("no keyframes indexed", numEntries > 0);
+
+  // building leaves the container back at the start
+  RefPointer<IPacket> packet = IPacket::make();
+  VS_TUT_ENSURE("could not read after building index",
+      built->readNextPacket(packet.value()) >= 0);
+
+  VS_TUT_ENSURE_EQUALS("could not write index",
+      numEntries, built->writeKeyFrameIndex(indexFile));
+
+  RefPointer<IContainer> loaded = IContainer::make();
+  VS_TUT_ENSURE("could not open file for read",
+      loaded->open(file, IContainer::READ, 0) >= 0);
+  VS_TUT_ENSURE_EQUALS("could not read index",
+      numEntries, loaded->readKeyFrameIndex(indexFile));
+
+  int32_t videoStream = -1;
+  int32_t numStreams = loaded->getNumStreams();
+  VS_TUT_ENSURE_EQUALS("stream counts differ",
+      built->getNumStreams(), numStreams);
+  for(int32_t i = 0; i < numStreams; i++)
+  {
+    RefPointer<IStream> builtStream = built->getStream(i);
+    RefPointer<IStream> loadedStream = loaded->getStream(i);
+    RefPointer<IStreamCoder> coder = loadedStream->getStreamCoder();
+    if (coder->getCodecType() == ICodec::CODEC_TYPE_VIDEO)
+      videoStream = i;
+    int32_t numIndexEntries = loadedStream->getNumIndexEntries();
+    VS_TUT_ENSURE_EQUALS("index sizes differ",
+        builtStream->getNumIndexEntries(), numIndexEntries);
+    for(int32_t j = 0; j < numIndexEntries; j++)
+    {
+      RefPointer<IIndexEntry> builtEntry = builtStream->getIndexEntry(j);
+      RefPointer<IIndexEntry> loadedEntry = loadedStream->getIndexEntry(j);
+      VS_TUT_ENSURE("missing entry", builtEntry && loadedEntry);
+      VS_TUT_ENSURE_EQUALS("positions differ",
+          builtEntry->getPosition(), loadedEntry->getPosition());
+      VS_TUT_ENSURE_EQUALS("time stamps differ",
+          builtEntry->getTimeStamp(), loadedEntry->getTimeStamp());
+    }
+  }
+  VS_TUT_ENSURE("no video stream", videoStream >= 0);
+
+  // seeking to an indexed keyframe lands on it
+  RefPointer<IStream> stream = loaded->getStream(videoStream);
+  int32_t numIndexEntries = stream->getNumIndexEntries();
+  VS_TUT_ENSURE("no video keyframes indexed", numIndexEntries > 1);
+  RefPointer<IIndexEntry> entry = stream->getIndexEntry(numIndexEntries / 2);
+  VS_TUT_ENSURE("could not seek",
+      loaded->seekKeyFrame(videoStream, entry->getTimeStamp(),
+          IContainer::SEEK_FLAG_BACKWARDS) >= 0);
+  int32_t retval = -1;
+  do
+  {
+    retval = loaded->readNextPacket(packet.value());
+  } while (retval >= 0 && packet->getStreamIndex() != videoStream);
+  VS_TUT_ENSURE("no video after seek", retval >= 0);
+  VS_TUT_ENSURE("not a keyframe", packet->isKey());
+  VS_TUT_ENSURE_EQUALS("wrong keyframe",
+      entry->getPosition(), packet->getPosition());
+  // entries are by presentation time, which is what callers seek to
+  VS_TUT_ENSURE_EQUALS("wrong time stamp",
+      entry->getTimeStamp(), packet->getPts());
+
+  // and an index for some other file is refused
+  h->setupReading(h->SAMPLE_FILE);
+  VS_TUT_ENSURE("should not read index for another file",
+      h->container->readKeyFrameIndex(indexFile) < 0);
+
+  VS_TUT_ENSURE("could not close", loaded->close() >= 0);
+  VS_TUT_ENSURE("could not close", built->close() >= 0);
+}
+
+void
+ContainerTest :: testProbeBudget()
+{
+  container = IContainer::make();
+  VS_TUT_ENSURE_EQUALS("should default to ffmpeg's probe size",
+      0, container->getProbeSize());
+  VS_TUT_ENSURE_EQUALS("should default to ffmpeg's analyze duration",
+      0, container->getAnalyzeDuration());
+  VS_TUT_ENSURE_EQUALS("should default to no stream limit",
+      0, container->getMaxProbeStreams());
+  VS_TUT_ENSURE("should default to not caching",
+      !container->getCacheProbeResults());
+
+  VS_TUT_ENSURE("should refuse negative probe size",
+      container->setProbeSize(-1) < 0);
+  VS_TUT_ENSURE("should refuse negative analyze duration",
+      container->setAnalyzeDuration(-1) < 0);
+  VS_TUT_ENSURE("should refuse negative stream limit",
+      container->setMaxProbeStreams(-1) < 0);
+  VS_TUT_ENSURE_EQUALS("could not set probe size",
+      0, container->setProbeSize(64*1024));
+  VS_TUT_ENSURE_EQUALS("could not set analyze duration",
+      0, container->setAnalyzeDuration(Global::DEFAULT_PTS_PER_SECOND/2));
+  VS_TUT_ENSURE_EQUALS("could not set stream limit",
+      0, container->setMaxProbeStreams(1));
+  VS_TUT_ENSURE_EQUALS("wrong probe size", 64*1024, container->getProbeSize());
+  VS_TUT_ENSURE_EQUALS("wrong analyze duration",
+      Global::DEFAULT_PTS_PER_SECOND/2, container->getAnalyzeDuration());
+  VS_TUT_ENSURE_EQUALS("wrong stream limit", 1, container->getMaxProbeStreams());
+
+  // a small budget still finds the streams in a simple file, and it
+  // lasts across opens
+  char file[2048];
+  const char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+  if (fixtureDirectory && *fixtureDirectory)
+    snprintf(file, sizeof(file), "%s/%s", fixtureDirectory, h->SAMPLE_FILE);
+  else
+    snprintf(file, sizeof(file), "./%s", h->SAMPLE_FILE);
+  for(int32_t i = 0; i < 2; i++)
+  {
+    VS_TUT_ENSURE("could not open file for read",
+        container->open(file, IContainer::READ, 0) >= 0);
+    VS_TUT_ENSURE("no streams", container->getNumStreams() > 0);
+    VS_TUT_ENSURE("should not be restored", !container->isProbeResultRestored());
+    VS_TUT_ENSURE("could not close", container->close() >= 0);
+  }
+  VS_TUT_ENSURE_EQUALS("probe size lost on close",
+      64*1024, container->getProbeSize());
+}
+
+void
+ContainerTest :: testMaxProbeStreamsStopsProbing()
+{
+  // MPEG-PS has no header, so without a limit the probe reads on to the
+  // probe size (here the whole file) looking for more streams
+  char file[2048];
+  const char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+  const char *sample = "testfile_mpeg1video_mp2audio.mpg";
+  if (fixtureDirectory && *fixtureDirectory)
+    snprintf(file, sizeof(file), "%s/%s", fixtureDirectory, sample);
+  else
+    snprintf(file, sizeof(file), "./%s", sample);
+
+  int64_t bytesProbed[2];
+  int32_t numStreams[2];
+  for(int32_t i = 0; i < 2; i++)
+  {
+    RefPointer<Container> probed = dynamic_cast<Container*>(
+        IContainer::make());
+    VS_TUT_ENSURE("could not make container", probed);
+    if (i > 0)
+      VS_TUT_ENSURE_EQUALS("could not set stream limit",
+          0, probed->setMaxProbeStreams(2));
+    VS_TUT_ENSURE("could not open file for read",
+        probed->open(file, IContainer::READ, 0) >= 0);
+    numStreams[i] = probed->getNumStreams();
+    bytesProbed[i] = avio_tell(probed->getFormatContext()->pb);
+    VS_TUT_ENSURE("could not close", probed->close() >= 0);
+  }
+  VS_TUT_ENSURE_EQUALS("should find both streams", 2, numStreams[0]);
+  VS_TUT_ENSURE_EQUALS("limit lost a stream", numStreams[0], numStreams[1]);
+  VS_LOG_DEBUG("probed %lld bytes; %lld with a stream limit",
+      (long long)bytesProbed[0], (long long)bytesProbed[1]);
+  VS_TUT_ENSURE("limit should stop probing early",
+      bytesProbed[1] < bytesProbed[0]);
+}
+
+static void
+ContainerTest_ensureRationalsEqual(const char* msg, IRational* a, IRational* b)
+{
+  // VS_TUT_ENSURE drops its message, so say which check this is
+  TSM_ASSERT(msg, (a == 0) == (b == 0));
+  if (a && b)
+  {
+    TSM_ASSERT_EQUALS(msg, a->getNumerator(), b->getNumerator());
+    TSM_ASSERT_EQUALS(msg, a->getDenominator(), b->getDenominator());
+  }
+}
+
+void
+ContainerTest :: testRestoreCachedProbeResult()
+{
+  char file[2048];
+  const char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+  const char *sample = "ucl_h264_aac.mp4";
+  if (fixtureDirectory && *fixtureDirectory)
+    snprintf(file, sizeof(file), "%s/%s", fixtureDirectory, sample);
+  else
+    snprintf(file, sizeof(file), "./%s", sample);
+
+  // the first open probes the file and caches what it found
+  RefPointer<IContainer> first = IContainer::make();
+  first->setCacheProbeResults(true);
+  VS_TUT_ENSURE("could not open file for read",
+      first->open(file, IContainer::READ, 0) >= 0);
+  VS_TUT_ENSURE("could not close", first->close() >= 0);
+
+  RefPointer<IContainer> restored = IContainer::make();
+  restored->setCacheProbeResults(true);
+  VS_TUT_ENSURE("could not open file for read",
+      restored->open(file, IContainer::READ, 0) >= 0);
+  VS_TUT_ENSURE("probe result not restored", restored->isProbeResultRestored());
+
+  RefPointer<IContainer> probed = IContainer::make();
+  VS_TUT_ENSURE("could not open file for read",
+      probed->open(file, IContainer::READ, 0) >= 0);
+  VS_TUT_ENSURE("should have probed", !probed->isProbeResultRestored());
+
+  VS_TUT_ENSURE_EQUALS("durations differ",
+      probed->getDuration(), restored->getDuration());
+  VS_TUT_ENSURE_EQUALS("start times differ",
+      probed->getStartTime(), restored->getStartTime());
+  VS_TUT_ENSURE_EQUALS("bit rates differ",
+      probed->getBitRate(), restored->getBitRate());
+  int32_t numStreams = probed->getNumStreams();
+  VS_TUT_ENSURE("no streams", numStreams > 0);
+  VS_TUT_ENSURE_EQUALS("stream counts differ",
+      numStreams, restored->getNumStreams());
+  int32_t videoStream = -1;
+  for(int32_t i = 0; i < numStreams; i++)
+  {
+    RefPointer<IStream> p = probed->getStream(i);
+    RefPointer<IStream> r = restored->getStream(i);
+    RefPointer<IRational> pRational;
+    RefPointer<IRational> rRational;
+
+    pRational = p->getTimeBase();
+    rRational = r->getTimeBase();
+    ContainerTest_ensureRationalsEqual("time bases differ",
+        pRational.value(), rRational.value());
+    pRational = p->getFrameRate();
+    rRational = r->getFrameRate();
+    ContainerTest_ensureRationalsEqual("frame rates differ",
+        pRational.value(), rRational.value());
+    pRational = p->getSampleAspectRatio();
+    rRational = r->getSampleAspectRatio();
+    ContainerTest_ensureRationalsEqual("aspect ratios differ",
+        pRational.value(), rRational.value());
+    VS_TUT_ENSURE_EQUALS("start times differ",
+        p->getStartTime(), r->getStartTime());
+    VS_TUT_ENSURE_EQUALS("durations differ",
+        p->getDuration(), r->getDuration());
+    VS_TUT_ENSURE_EQUALS("frame counts differ",
+        p->getNumFrames(), r->getNumFrames());
+
+    RefPointer<IStreamCoder> pCoder = p->getStreamCoder();
+    RefPointer<IStreamCoder> rCoder = r->getStreamCoder();
+    VS_TUT_ENSURE_EQUALS("codec types differ",
+        pCoder->getCodecType(), rCoder->getCodecType());
+    VS_TUT_ENSURE_EQUALS("codecs differ",
+        pCoder->getCodecID(), rCoder->getCodecID());
+    VS_TUT_ENSURE_EQUALS("codec tags differ",
+        pCoder->getCodecTag(), rCoder->getCodecTag());
+    VS_TUT_ENSURE_EQUALS("coder bit rates differ",
+        pCoder->getBitRate(), rCoder->getBitRate());
+    pRational = pCoder->getTimeBase();
+    rRational = rCoder->getTimeBase();
+    ContainerTest_ensureRationalsEqual("coder time bases differ",
+        pRational.value(), rRational.value());
+    if (pCoder->getCodecType() == ICodec::CODEC_TYPE_VIDEO)
+    {
+      videoStream = i;
+      VS_TUT_ENSURE_EQUALS("widths differ",
+          pCoder->getWidth(), rCoder->getWidth());
+      VS_TUT_ENSURE_EQUALS("heights differ",
+          pCoder->getHeight(), rCoder->getHeight());
+      VS_TUT_ENSURE_EQUALS("pixel types differ",
+          pCoder->getPixelType(), rCoder->getPixelType());
+    }
+    else if (pCoder->getCodecType() == ICodec::CODEC_TYPE_AUDIO)
+    {
+      VS_TUT_ENSURE_EQUALS("sample rates differ",
+          pCoder->getSampleRate(), rCoder->getSampleRate());
+      VS_TUT_ENSURE_EQUALS("channels differ",
+          pCoder->getChannels(), rCoder->getChannels());
+      VS_TUT_ENSURE_EQUALS("sample formats differ",
+          pCoder->getSampleFormat(), rCoder->getSampleFormat());
+    }
+    int32_t extraDataSize = pCoder->getExtraDataSize();
+    VS_TUT_ENSURE_EQUALS("extradata sizes differ",
+        extraDataSize, rCoder->getExtraDataSize());
+    if (extraDataSize > 0)
+    {
+      RefPointer<IBuffer> pExtraData = IBuffer::make(0, extraDataSize);
+      RefPointer<IBuffer> rExtraData = IBuffer::make(0, extraDataSize);
+      VS_TUT_ENSURE_EQUALS("could not get extradata", extraDataSize,
+          pCoder->getExtraData(pExtraData.value(), 0, extraDataSize));
+      VS_TUT_ENSURE_EQUALS("could not get extradata", extraDataSize,
+          rCoder->getExtraData(rExtraData.value(), 0, extraDataSize));
+      VS_TUT_ENSURE("extradata differs",
+          memcmp(pExtraData->getBytes(0, extraDataSize),
+              rExtraData->getBytes(0, extraDataSize), extraDataSize) == 0);
+    }
+  }
+  VS_TUT_ENSURE("no video stream", videoStream >= 0);
+
+  // and the restored streams decode
+  RefPointer<IStream> stream = restored->getStream(videoStream);
+  RefPointer<IStreamCoder> coder = stream->getStreamCoder();
+  VS_TUT_ENSURE("could not open coder", coder->open(0, 0) >= 0);
+  RefPointer<IVideoPicture> picture = IVideoPicture::make(coder->getPixelType(),
+      coder->getWidth(), coder->getHeight());
+  RefPointer<IPacket> packet = IPacket::make();
+  while (!picture->isComplete() &&
+      restored->readNextPacket(packet.value()) >= 0)
+  {
+    if (packet->getStreamIndex() != videoStream)
+      continue;
+    int32_t offset = 0;
+    while (offset < packet->getSize() && !picture->isComplete())
+    {
+      int32_t retval = coder->decodeVideo(picture.value(), packet.value(),
+          offset);
+      VS_TUT_ENSURE("could not decode", retval > 0);
+      offset += retval;
+    }
+  }
+  VS_TUT_ENSURE("no picture decoded", picture->isComplete());
+  VS_TUT_ENSURE("could not close coder", coder->close() >= 0);
+
+  VS_TUT_ENSURE("could not close", restored->close() >= 0);
+  VS_TUT_ENSURE("could not close", probed->close() >= 0);
+}
+
+void
+ContainerTest :: testPropertyHandle()
+{
+  container = IContainer::make();
+  VS_TUT_ENSURE("should not find a made up property",
+      !container->getPropertyHandle("not-a-valid-property-no-way"));
+
+  RefPointer<IPropertyHandle> indexMem =
+      container->getPropertyHandle("indexmem");
+  VS_TUT_ENSURE("got no handle", indexMem);
+  VS_TUT_ENSURE("could not set", indexMem->setValue((int64_t)123456) >= 0);
+  VS_TUT_ENSURE_EQUALS("", container->getPropertyAsLong("indexmem"), 123456);
+  {
+    LoggerStack stack;
+    stack.setGlobalLevel(Logger::LEVEL_ERROR, false);
+    VS_TUT_ENSURE("should be out of range",
+        indexMem->setValue((int64_t)-1) < 0);
+  }
+  VS_TUT_ENSURE_EQUALS("", indexMem->getValueAsLong(), 123456);
+
+  // the container replaces its context when closed and reopened; the
+  // handle must follow it.
+  char file[2048];
+  const char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+  if (fixtureDirectory && *fixtureDirectory)
+    snprintf(file, sizeof(file), "%s/%s", fixtureDirectory, h->SAMPLE_FILE);
+  else
+    snprintf(file, sizeof(file), "./%s", h->SAMPLE_FILE);
+  for(int32_t i = 0; i < 2; i++)
+  {
+    VS_TUT_ENSURE("could not open file for read",
+        container->open(file, IContainer::READ, 0) >= 0);
+    VS_TUT_ENSURE("should be valid", indexMem->isValid());
+    VS_TUT_ENSURE("could not set",
+        indexMem->setValue((int64_t)(4096+i)) >= 0);
+    VS_TUT_ENSURE_EQUALS("", container->getPropertyAsLong("indexmem"),
+        4096+i);
+    container->setProperty("indexmem", (int64_t)(8192+i));
+    VS_TUT_ENSURE_EQUALS("", indexMem->getValueAsLong(), 8192+i);
+    VS_TUT_ENSURE_EQUALS("", container->close(), 0);
+  }
+}
@@ -53,6 +53,14 @@ class ContainerTest : public CxxTest::TestSuite
     void testIssue97Regression();
     
     void testGetSDP();
+    void testReadFromFileWithZeroCopyReads();
+    void testReadAndWritePacketsInBatches();
+    void testReadNextPacketsBenchmark();
+    void testBuildWriteAndReadKeyFrameIndex();
+    void testProbeBudget();
+    void testMaxProbeStreamsStopsProbing();
+    void testRestoreCachedProbeResult();
+    void testPropertyHandle();
   private:
     Helper* h;
     RefPointer<IContainer> container;
@@ -0,0 +1,249 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <com/xuggle/ferry/RefPointer.h>
+#include <com/xuggle/xuggler/IMediaDataPool.h>
+#include <com/xuggle/xuggler/Global.h>
+#include "Helper.h"
+#include "MediaDataPoolTest.h"
+
+using namespace VS_CPP_NAMESPACE;
+
+MediaDataPoolTest :: MediaDataPoolTest()
+{
+}
+
+MediaDataPoolTest :: ~MediaDataPoolTest()
+{
+  tearDown();
+}
+
+void
+MediaDataPoolTest :: setUp()
+{
+  pool = IMediaDataPool::make(4);
+}
+
+void
+MediaDataPoolTest :: tearDown()
+{
+  pool = 0;
+}
+
+void
+MediaDataPoolTest :: testMake()
+{
+  VS_TUT_ENSURE("could not make pool", pool);
+  VS_TUT_ENSURE_EQUALS("", pool->getMaxFreeObjects(), 4);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 0);
+
+  RefPointer<IMediaDataPool> bad = IMediaDataPool::make(-1);
+  VS_TUT_ENSURE("made pool with negative size", !bad);
+}
+
+void
+MediaDataPoolTest :: testPacketIsReused()
+{
+  RefPointer<IPacket> packet = pool->getPacket(1024);
+  VS_TUT_ENSURE("no packet", packet);
+  VS_TUT_ENSURE_EQUALS("", pool->getMisses(), 1);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 1);
+  packet->setPts(1000);
+  packet->setStreamIndex(2);
+  packet->setComplete(true, 1024);
+  IPacket* first = packet.value();
+
+  packet = 0;
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 1);
+
+  packet = pool->getPacket(512);
+  VS_TUT_ENSURE("no packet", packet);
+  VS_TUT_ENSURE("packet not reused", packet.value() == first);
+  VS_TUT_ENSURE_EQUALS("", pool->getHits(), 1);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 1);
+
+  // and it should look new
+  VS_TUT_ENSURE_EQUALS("", packet->getPts(), Global::NO_PTS);
+  VS_TUT_ENSURE_EQUALS("", packet->getStreamIndex(), 0);
+  VS_TUT_ENSURE("", !packet->isComplete());
+  VS_TUT_ENSURE("", packet->getMaxSize() >= 512);
+}
+
+void
+MediaDataPoolTest :: testPacketTooSmallIsNotReused()
+{
+  RefPointer<IPacket> packet = pool->getPacket(16);
+  VS_TUT_ENSURE("no packet", packet);
+  IPacket* first = packet.value();
+  packet = 0;
+
+  packet = pool->getPacket(4096);
+  VS_TUT_ENSURE("no packet", packet);
+  VS_TUT_ENSURE("small packet reused", packet.value() != first);
+  VS_TUT_ENSURE_EQUALS("", pool->getHits(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getMisses(), 2);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 1);
+}
+
+void
+MediaDataPoolTest :: testVideoPictureIsReused()
+{
+  RefPointer<IVideoPicture> picture = pool->getVideoPicture(
+      IPixelFormat::YUV420P, 64, 48);
+  VS_TUT_ENSURE("no picture", picture);
+  RefPointer<IBuffer> buffer = picture->getData();
+  VS_TUT_ENSURE("no buffer", buffer);
+  unsigned char* bytes = (unsigned char*)buffer->getBytes(0, 1);
+  buffer = 0;
+  picture->setPts(30000);
+  picture->setKeyFrame(false);
+  picture->setComplete(true, IPixelFormat::YUV420P, 64, 48, 30000);
+  IVideoPicture* first = picture.value();
+  picture = 0;
+
+  picture = pool->getVideoPicture(IPixelFormat::YUV420P, 64, 48);
+  VS_TUT_ENSURE("picture not reused", picture.value() == first);
+  VS_TUT_ENSURE_EQUALS("", picture->getPixelType(), IPixelFormat::YUV420P);
+  VS_TUT_ENSURE_EQUALS("", picture->getWidth(), 64);
+  VS_TUT_ENSURE_EQUALS("", picture->getHeight(), 48);
+  VS_TUT_ENSURE("", !picture->isComplete());
+  VS_TUT_ENSURE("", picture->isKeyFrame());
+  VS_TUT_ENSURE_EQUALS("", picture->getPts(), Global::NO_PTS);
+
+  // and we kept the buffer
+  buffer = picture->getData();
+  VS_TUT_ENSURE("buffer not kept",
+      (unsigned char*)buffer->getBytes(0, 1) == bytes);
+}
+
+void
+MediaDataPoolTest :: testVideoPictureOfOtherShapeIsNotReused()
+{
+  RefPointer<IVideoPicture> picture = pool->getVideoPicture(
+      IPixelFormat::YUV420P, 64, 48);
+  IVideoPicture* first = picture.value();
+  picture = 0;
+
+  picture = pool->getVideoPicture(IPixelFormat::YUV420P, 32, 48);
+  VS_TUT_ENSURE("reused picture of other width", picture.value() != first);
+  picture = 0;
+  picture = pool->getVideoPicture(IPixelFormat::RGB24, 64, 48);
+  VS_TUT_ENSURE("reused picture of other format", picture.value() != first);
+  VS_TUT_ENSURE_EQUALS("", pool->getHits(), 0);
+}
+
+void
+MediaDataPoolTest :: testAudioSamplesAreReused()
+{
+  RefPointer<IAudioSamples> samples = pool->getAudioSamples(1024, 2,
+      IAudioSamples::FMT_S16);
+  VS_TUT_ENSURE("no samples", samples);
+  samples->setComplete(true, 1024, 44100, 2, IAudioSamples::FMT_S16, 1000);
+  IAudioSamples* first = samples.value();
+  samples = 0;
+
+  // different channels; no reuse
+  samples = pool->getAudioSamples(1024, 1, IAudioSamples::FMT_S16);
+  VS_TUT_ENSURE("reused samples of other channels", samples.value() != first);
+  samples = 0;
+
+  samples = pool->getAudioSamples(512, 2, IAudioSamples::FMT_S16);
+  VS_TUT_ENSURE("samples not reused", samples.value() == first);
+  VS_TUT_ENSURE_EQUALS("", pool->getHits(), 1);
+  VS_TUT_ENSURE("", !samples->isComplete());
+  VS_TUT_ENSURE_EQUALS("", samples->getNumSamples(), (uint32_t)0);
+  VS_TUT_ENSURE_EQUALS("", samples->getPts(), Global::NO_PTS);
+  VS_TUT_ENSURE("", samples->getMaxSamples() >= 512);
+}
+
+void
+MediaDataPoolTest :: testSharedBufferIsNotReused()
+{
+  RefPointer<IPacket> packet = pool->getPacket(1024);
+  IPacket* first = packet.value();
+  RefPointer<IBuffer> buffer = packet->getData();
+  VS_TUT_ENSURE("no buffer", buffer);
+  packet = 0;
+
+  // the packet comes back, but without the buffer someone still holds
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 1);
+  VS_TUT_ENSURE_EQUALS("", buffer->getCurrentRefCount(), 1);
+  packet = pool->getPacket(1024);
+  VS_TUT_ENSURE("packet not reused", packet.value() == first);
+  RefPointer<IBuffer> newBuffer = packet->getData();
+  VS_TUT_ENSURE("shared buffer reused", newBuffer.value() != buffer.value());
+}
+
+void
+MediaDataPoolTest :: testEviction()
+{
+  RefPointer<IPacket> packets[6];
+  for(int i = 0; i < 6; i++)
+    packets[i] = pool->getPacket(128);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 6);
+  IPacket* last = packets[5].value();
+  for(int i = 0; i < 6; i++)
+    packets[i] = 0;
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 4);
+  VS_TUT_ENSURE_EQUALS("", pool->getEvictions(), 2);
+
+  // most recently returned first
+  RefPointer<IPacket> packet = pool->getPacket(128);
+  VS_TUT_ENSURE("most recent not reused", packet.value() == last);
+}
+
+void
+MediaDataPoolTest :: testPoolOutlivesRelease()
+{
+  RefPointer<IAudioSamples> samples = pool->getAudioSamples(256, 2,
+      IAudioSamples::FMT_S16);
+  VS_TUT_ENSURE("no samples", samples);
+  // the samples keep the pool alive
+  pool = 0;
+  samples->setComplete(true, 256, 22050, 2, IAudioSamples::FMT_S16, 0);
+  // and this frees both
+  samples = 0;
+}
+
+void
+MediaDataPoolTest :: testClear()
+{
+  RefPointer<IPacket> packet = pool->getPacket(128);
+  RefPointer<IVideoPicture> picture = pool->getVideoPicture(
+      IPixelFormat::YUV420P, 16, 16);
+  packet = 0;
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 1);
+  pool->clear();
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 1);
+
+  picture = 0;
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 1);
+
+  // a pool that keeps nothing frees everything
+  pool = IMediaDataPool::make(0);
+  packet = pool->getPacket(128);
+  packet = 0;
+  VS_TUT_ENSURE_EQUALS("", pool->getNumFreeObjects(), 0);
+  VS_TUT_ENSURE_EQUALS("", pool->getNumOutstandingObjects(), 0);
+}
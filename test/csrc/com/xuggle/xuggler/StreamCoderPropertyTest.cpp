@@ -223,3 +223,127 @@ StreamCoderPropertyTest :: testGetPropertyAsDouble()
   VS_TUT_ENSURE_DISTANCE("unexpected", value, 5.0, 0.00001);
 }
 
+void
+StreamCoderPropertyTest :: testPropertyHandle()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_ERROR, false);
+
+  coder = IStreamCoder::make(IStreamCoder::ENCODING, ICodec::CODEC_ID_MPEG4);
+  VS_TUT_ENSURE("got no coder", coder);
+
+  VS_TUT_ENSURE("should not find a made up property",
+      !coder->getPropertyHandle("not-a-valid-property-no-way"));
+  VS_TUT_ENSURE("should not find an empty name",
+      !coder->getPropertyHandle(""));
+
+  RefPointer<IPropertyHandle> bitRate = coder->getPropertyHandle("b");
+  VS_TUT_ENSURE("got no handle", bitRate);
+  VS_TUT_ENSURE("should be valid", bitRate->isValid());
+  VS_TUT_ENSURE("wrong name", strcmp(bitRate->getName(), "b") == 0);
+  RefPointer<IProperty> metaData = bitRate->getPropertyMetaData();
+  VS_TUT_ENSURE("got no meta data", metaData);
+  VS_TUT_ENSURE("wrong meta data", strcmp(metaData->getName(), "b") == 0);
+
+  // setting through the handle is seen by the coder...
+  VS_TUT_ENSURE("could not set", bitRate->setValue((int64_t)123456) >= 0);
+  VS_TUT_ENSURE_EQUALS("", coder->getBitRate(), 123456);
+  VS_TUT_ENSURE_EQUALS("", coder->getPropertyAsLong("b"), 123456);
+  // ... and the other way round
+  coder->setBitRate(64000);
+  VS_TUT_ENSURE_EQUALS("", bitRate->getValueAsLong(), 64000);
+  VS_TUT_ENSURE_DISTANCE("", bitRate->getValueAsDouble(), 64000.0, 0.00001);
+  VS_TUT_ENSURE("", bitRate->getValueAsBoolean());
+
+  VS_TUT_ENSURE("could not set", bitRate->setValue("500") >= 0);
+  VS_TUT_ENSURE_EQUALS("", coder->getBitRate(), 500);
+  char* value = bitRate->getValueAsString();
+  VS_TUT_ENSURE("should be 500", value && strcmp(value, "500") == 0);
+  if (value) free(value);
+  VS_TUT_ENSURE("should fail",
+      bitRate->setValue("not_a_valid_setting") < 0);
+
+  // ints round like av_opt_set_double does
+  RefPointer<IPropertyHandle> gop = coder->getPropertyHandle("g");
+  VS_TUT_ENSURE("got no handle", gop);
+  VS_TUT_ENSURE("could not set", gop->setValue(24.6) >= 0);
+  VS_TUT_ENSURE_EQUALS("", coder->getNumPicturesInGroupOfPictures(), 25);
+
+  // rationals
+  RefPointer<IPropertyHandle> aspect = coder->getPropertyHandle("aspect");
+  VS_TUT_ENSURE("got no handle", aspect);
+  RefPointer<IRational> ratio = IRational::make(16, 9);
+  VS_TUT_ENSURE("could not set", aspect->setValue(ratio.value()) >= 0);
+  RefPointer<IRational> got = aspect->getValueAsRational();
+  VS_TUT_ENSURE("got no value", got);
+  VS_TUT_ENSURE_EQUALS("", got->getNumerator(), 16);
+  VS_TUT_ENSURE_EQUALS("", got->getDenominator(), 9);
+  got = coder->getPropertyAsRational("aspect");
+  VS_TUT_ENSURE_EQUALS("", got->getNumerator(), 16);
+  VS_TUT_ENSURE_EQUALS("", got->getDenominator(), 9);
+
+  // an option of the encoder's private context, found as a child
+  RefPointer<IPropertyHandle> partitioning =
+      coder->getPropertyHandle("data_partitioning");
+  VS_TUT_ENSURE("got no handle", partitioning);
+  VS_TUT_ENSURE("could not set", partitioning->setValue(true) >= 0);
+  VS_TUT_ENSURE("", partitioning->getValueAsBoolean());
+  VS_TUT_ENSURE("could not set",
+      coder->setProperty("data_partitioning", (int64_t)0) >= 0);
+  VS_TUT_ENSURE_EQUALS("", partitioning->getValueAsLong(), 0);
+  // and range checked like av_opt_set_int
+  VS_TUT_ENSURE("should be out of range",
+      partitioning->setValue((int64_t)2) < 0);
+  VS_TUT_ENSURE_EQUALS("", partitioning->getValueAsLong(), 0);
+
+  // the handle keeps the coder alive
+  coder = 0;
+  VS_TUT_ENSURE("could not set", bitRate->setValue((int64_t)1000) >= 0);
+  VS_TUT_ENSURE_EQUALS("", bitRate->getValueAsLong(), 1000);
+}
+
+void
+StreamCoderPropertyTest :: testPropertyHandleMatchesByName()
+{
+  h->setupReading(h->SAMPLE_FILE);
+
+  VS_TUT_ENSURE("need at least one stream", h->num_streams > 0);
+
+  // the property table is cached per class; a second coder of the same
+  // kind must see the same properties.
+  int32_t numProperties = h->coders[0]->getNumProperties();
+  VS_TUT_ENSURE("should get at least 100 properties", numProperties > 100);
+  hw->setupReading(hw->SAMPLE_FILE);
+  VS_TUT_ENSURE_EQUALS("", hw->coders[0]->getNumProperties(), numProperties);
+
+  for(int32_t i = 0; i < numProperties; i++)
+  {
+    RefPointer<IProperty> metaData = h->coders[0]->getPropertyMetaData(i);
+    VS_TUT_ENSURE("got no option", metaData);
+    const char* name = metaData->getName();
+    RefPointer<IProperty> other = hw->coders[0]->getPropertyMetaData(i);
+    VS_TUT_ENSURE("should be the same option",
+        other && strcmp(other->getName(), name) == 0);
+
+    RefPointer<IPropertyHandle> handle = h->coders[0]->getPropertyHandle(name);
+    VS_TUT_ENSURE("got no handle", handle);
+    switch(metaData->getType())
+    {
+      case IProperty::PROPERTY_FLAGS:
+      case IProperty::PROPERTY_INT:
+      case IProperty::PROPERTY_INT64:
+        VS_TUT_ENSURE_EQUALS(name, handle->getValueAsLong(),
+            h->coders[0]->getPropertyAsLong(name));
+        break;
+      case IProperty::PROPERTY_FLOAT:
+      case IProperty::PROPERTY_DOUBLE:
+        VS_TUT_ENSURE_DISTANCE(name, handle->getValueAsDouble(),
+            h->coders[0]->getPropertyAsDouble(name), 0.00001);
+        break;
+      default:
+        break;
+    }
+  }
+  VS_TUT_ENSURE("should get null",
+      !h->coders[0]->getPropertyMetaData(numProperties));
+}
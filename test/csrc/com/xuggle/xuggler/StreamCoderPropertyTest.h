@@ -37,6 +37,8 @@ class StreamCoderPropertyTest : public CxxTest::TestSuite
     void testGetPropertyMetaData();
     void testGetNumFlagSettings();
     void testGetPropertyAsDouble();
+    void testPropertyHandle();
+    void testPropertyHandleMatchesByName();
   private:
     Helper* h;
     Helper* hw;
@@ -20,10 +20,16 @@
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/IStreamCoder.h>
 #include <com/xuggle/xuggler/Global.h>
+#include <com/xuggle/xuggler/StreamCoderPool.h>
 #include "Helper.h"
 #include "StreamCoderTest.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <vector>
 
 using namespace VS_CPP_NAMESPACE;
 
@@ -925,3 +931,833 @@ StreamCoderTest :: testGetSetExtraData()
   }
 }
 
+void
+StreamCoderTest :: testSetNumThreadsAndThreadType()
+{
+  h->setupReading("ucl_h264_aac.mp4");
+  VS_TUT_ENSURE("no video stream", h->first_input_video_stream >= 0);
+  coder = h->coders[h->first_input_video_stream];
+
+  VS_TUT_ENSURE("should not allow negative threads",
+      coder->setNumThreads(-1) < 0);
+  VS_TUT_ENSURE_EQUALS("could not set auto threads",
+      coder->setNumThreads(0), 0);
+  VS_TUT_ENSURE_EQUALS("auto threads not set", coder->getNumThreads(), 0);
+  VS_TUT_ENSURE_EQUALS("could not set threads",
+      coder->setNumThreads(4), 0);
+  VS_TUT_ENSURE_EQUALS("threads not set", coder->getNumThreads(), 4);
+  VS_TUT_ENSURE_EQUALS("could not set thread type",
+      coder->setThreadType(IStreamCoder::THREAD_TYPE_SLICE), 0);
+  VS_TUT_ENSURE_EQUALS("thread type not set",
+      coder->getThreadType(), IStreamCoder::THREAD_TYPE_SLICE);
+  VS_TUT_ENSURE_EQUALS("could not set thread type",
+      coder->setThreadType(IStreamCoder::THREAD_TYPE_FRAME), 0);
+  VS_TUT_ENSURE_EQUALS("should not be active until open",
+      coder->getActiveThreadType(), IStreamCoder::THREAD_TYPE_NONE);
+
+  VS_TUT_ENSURE("could not open coder", coder->open(0, 0) >= 0);
+  VS_TUT_ENSURE("should not allow setting threads after open",
+      coder->setNumThreads(1) < 0);
+  VS_TUT_ENSURE("should not allow setting thread type after open",
+      coder->setThreadType(IStreamCoder::THREAD_TYPE_NONE) < 0);
+  coder->close();
+}
+
+/**
+ * Decodes every video picture in the given fixture, including those
+ * the decoder holds back until flushed, and records each picture's
+ * timestamp and a checksum of its bytes.
+ */
+static void
+StreamCoderTest_decodeAllVideo(const char* file, int32_t numThreads,
+    std::vector<int64_t>& timestamps, std::vector<uint32_t>& checksums)
+{
+  Helper h;
+  h.setupReading(file);
+  VS_TUT_ENSURE("no video stream", h.first_input_video_stream >= 0);
+  RefPointer<IStreamCoder> ic = h.coders[h.first_input_video_stream];
+  VS_TUT_ENSURE_EQUALS("could not set threads",
+      ic->setNumThreads(numThreads), 0);
+  VS_TUT_ENSURE_EQUALS("could not set thread type",
+      ic->setThreadType(IStreamCoder::THREAD_TYPE_FRAME), 0);
+  VS_TUT_ENSURE("could not open coder", ic->open(0, 0) >= 0);
+
+  RefPointer<IVideoPicture> frame = IVideoPicture::make(ic->getPixelType(),
+      ic->getWidth(), ic->getHeight());
+  RefPointer<IPacket> packet = IPacket::make();
+  bool flushing = false;
+  while (true)
+  {
+    if (!flushing && h.container->readNextPacket(packet.value()) < 0)
+    {
+      flushing = true;
+      packet = IPacket::make();
+    }
+    if (!flushing && packet->getStreamIndex() != h.first_input_video_stream)
+      continue;
+
+    int32_t offset = 0;
+    do
+    {
+      int32_t retval = ic->decodeVideo(frame.value(), packet.value(), offset);
+      VS_TUT_ENSURE("could not decode video", retval >= 0);
+      if (retval == 0 && !flushing)
+        break;
+      offset += retval;
+      if (frame->isComplete())
+      {
+        RefPointer<IBuffer> data = frame->getData();
+        const uint8_t* bytes = (const uint8_t*) data->getBytes(0,
+            frame->getSize());
+        uint32_t checksum = 2166136261U;
+        for (int32_t i = 0; i < frame->getSize(); i++)
+          checksum = (checksum ^ bytes[i]) * 16777619U;
+        timestamps.push_back(frame->getTimeStamp());
+        checksums.push_back(checksum);
+      }
+      else if (flushing)
+        break;
+    } while (flushing || offset < packet->getSize());
+
+    if (flushing)
+      break;
+  }
+  ic->close();
+}
+
+void
+StreamCoderTest :: testFrameThreadedDecodingMatchesSingleThreaded()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_WARN, false);
+
+  std::vector<int64_t> singleTimestamps;
+  std::vector<uint32_t> singleChecksums;
+  std::vector<int64_t> threadedTimestamps;
+  std::vector<uint32_t> threadedChecksums;
+
+  StreamCoderTest_decodeAllVideo("ucl_h264_aac.mp4", 1,
+      singleTimestamps, singleChecksums);
+  StreamCoderTest_decodeAllVideo("ucl_h264_aac.mp4", 4,
+      threadedTimestamps, threadedChecksums);
+
+  VS_TUT_ENSURE("should decode some pictures", singleTimestamps.size() > 0);
+  VS_TUT_ENSURE_EQUALS("different number of pictures decoded",
+      threadedTimestamps.size(), singleTimestamps.size());
+  for (size_t i = 0; i < singleTimestamps.size(); i++)
+  {
+    VS_TUT_ENSURE_EQUALS("timestamps differ",
+        threadedTimestamps[i], singleTimestamps[i]);
+    VS_TUT_ENSURE_EQUALS("pictures differ",
+        threadedChecksums[i], singleChecksums[i]);
+  }
+}
+
+void
+StreamCoderTest :: testDecodedPicturesOutliveDecoderBuffers()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_WARN, false);
+
+  // Decode into a new picture each time and hang on to all of them;
+  // decoders that render straight into the pictures' memory must not
+  // reuse it while we still hold a picture.
+  h->setupReading("ucl_h264_aac.mp4");
+  VS_TUT_ENSURE("no video stream", h->first_input_video_stream >= 0);
+  RefPointer<IStreamCoder> ic = h->coders[h->first_input_video_stream];
+  VS_TUT_ENSURE("could not open coder", ic->open(0, 0) >= 0);
+
+  std::vector<RefPointer<IVideoPicture> > decoded;
+  std::vector<RefPointer<IVideoPicture> > copies;
+  RefPointer<IPacket> packet = IPacket::make();
+  while (decoded.size() < 60 && h->container->readNextPacket(packet.value()) >= 0)
+  {
+    if (packet->getStreamIndex() != h->first_input_video_stream)
+      continue;
+    int32_t offset = 0;
+    while (offset < packet->getSize())
+    {
+      RefPointer<IVideoPicture> frame = IVideoPicture::make(
+          ic->getPixelType(), ic->getWidth(), ic->getHeight());
+      int32_t retval = ic->decodeVideo(frame.value(), packet.value(), offset);
+      VS_TUT_ENSURE("could not decode video", retval > 0);
+      offset += retval;
+      if (frame->isComplete())
+      {
+        RefPointer<IVideoPicture> copy = IVideoPicture::make(
+            ic->getPixelType(), ic->getWidth(), ic->getHeight());
+        VS_TUT_ENSURE("could not copy picture", copy->copy(frame.value()));
+        decoded.push_back(frame);
+        copies.push_back(copy);
+      }
+    }
+  }
+  ic->close();
+  VS_TUT_ENSURE("should decode some pictures", decoded.size() > 1);
+
+  for (size_t i = 0; i < decoded.size(); i++)
+  {
+    VS_TUT_ENSURE_EQUALS("line size changed",
+        decoded[i]->getDataLineSize(0), copies[i]->getDataLineSize(0));
+    RefPointer<IBuffer> data = decoded[i]->getData();
+    RefPointer<IBuffer> copyData = copies[i]->getData();
+    int32_t size = copies[i]->getSize();
+    VS_TUT_ENSURE("no data", data && copyData && size > 0);
+    VS_TUT_ENSURE("picture was overwritten while we held it",
+        memcmp(data->getBytes(0, size), copyData->getBytes(0, size), size) == 0);
+  }
+}
+
+void
+StreamCoderTest :: testDecodedPicturesSurviveRegetBuffer()
+{
+  // flashsv only sends the 64x64 blocks that changed, and its decoder
+  // redraws them over its last picture with reget_buffer; pictures we
+  // already hold must not change underneath us.
+  RefPointer<ICodec> encodec = ICodec::findEncodingCodecByName("flashsv");
+  RefPointer<ICodec> decodec = ICodec::findDecodingCodecByName("flashsv");
+  if (!encodec || !decodec)
+    return;
+  const int32_t width = 128;
+  const int32_t height = 128;
+  const int32_t numFrames = 8;
+
+  RefPointer<IRational> timeBase = IRational::make(1, 25);
+  RefPointer<IStreamCoder> encoder = IStreamCoder::make(IStreamCoder::ENCODING,
+      encodec.value());
+  RefPointer<IStreamCoder> decoder = IStreamCoder::make(IStreamCoder::DECODING,
+      decodec.value());
+  VS_TUT_ENSURE("could not make coders", encoder && decoder);
+  encoder->setWidth(width);
+  encoder->setHeight(height);
+  encoder->setPixelType(IPixelFormat::BGR24);
+  encoder->setTimeBase(timeBase.value());
+  VS_TUT_ENSURE("could not open encoder", encoder->open(0, 0) >= 0);
+  decoder->setWidth(width);
+  decoder->setHeight(height);
+  decoder->setPixelType(IPixelFormat::BGR24);
+  VS_TUT_ENSURE("could not open decoder", decoder->open(0, 0) >= 0);
+
+  RefPointer<IVideoPicture> source = IVideoPicture::make(IPixelFormat::BGR24,
+      width, height);
+  RefPointer<IBuffer> sourceData = source->getData();
+  uint8_t* pixels = (uint8_t*)sourceData->getBytes(0, source->getSize());
+  const int32_t lineSize = source->getDataLineSize(0);
+  memset(pixels, 0, source->getSize());
+
+  std::vector<RefPointer<IVideoPicture> > decoded;
+  std::vector<RefPointer<IVideoPicture> > copies;
+  RefPointer<IPacket> packet = IPacket::make();
+  for(int32_t i = 0; i < numFrames; i++)
+  {
+    // repaint one quarter each time
+    const int32_t left = (i % 2) * width / 2;
+    const int32_t top = ((i / 2) % 2) * height / 2;
+    for(int32_t y = top; y < top + height / 2; y++)
+      memset(pixels + y*lineSize + left*3, 30 * (i+1), width / 2 * 3);
+    source->setComplete(true, IPixelFormat::BGR24, width, height, i * 40000);
+
+    VS_TUT_ENSURE("could not encode",
+        encoder->encodeVideo(packet.value(), source.value(), -1) >= 0);
+    VS_TUT_ENSURE("no packet", packet->isComplete());
+
+    RefPointer<IVideoPicture> frame = IVideoPicture::make(IPixelFormat::BGR24,
+        width, height);
+    VS_TUT_ENSURE("could not decode",
+        decoder->decodeVideo(frame.value(), packet.value(), 0) > 0);
+    VS_TUT_ENSURE("no picture", frame->isComplete());
+    RefPointer<IVideoPicture> copy = IVideoPicture::make(IPixelFormat::BGR24,
+        width, height);
+    VS_TUT_ENSURE("could not copy picture", copy->copy(frame.value()));
+    decoded.push_back(frame);
+    copies.push_back(copy);
+  }
+  encoder->close();
+  decoder->close();
+
+  for (size_t i = 0; i < decoded.size(); i++)
+  {
+    RefPointer<IBuffer> data = decoded[i]->getData();
+    RefPointer<IBuffer> copyData = copies[i]->getData();
+    int32_t size = copies[i]->getSize();
+    VS_TUT_ENSURE("no data", data && copyData && size > 0);
+    VS_TUT_ENSURE("picture was redrawn while we held it",
+        memcmp(data->getBytes(0, size), copyData->getBytes(0, size), size) == 0);
+  }
+}
+
+static void*
+StreamCoderTest_openAndCloseCoders(void*)
+{
+  RefPointer<ICodec> codec = ICodec::findDecodingCodecByName("mpeg4");
+  for(int i = 0; codec && i < 50; i++)
+  {
+    RefPointer<IStreamCoder> coder = IStreamCoder::make(IStreamCoder::DECODING);
+    coder->setCodec(codec.value());
+    if (coder->open() >= 0)
+      coder->close();
+  }
+  return 0;
+}
+
+void
+StreamCoderTest :: testConcurrentOpenLockManagerBenchmark()
+{
+  const int numThreads = 4;
+  Global::init();
+  VS_TUT_ENSURE_EQUALS("native lock manager should be the default",
+      Global::LOCK_MANAGER_NATIVE, Global::getLockManagerType());
+
+  // once initialized, FFmpeg's locks may be held, so the lock manager
+  // can't be replaced; to compare against LOCK_MANAGER_JAVA run a
+  // process that sets it before Global::init().
+  VS_TUT_ENSURE("could switch lock manager after init",
+      Global::setLockManagerType(Global::LOCK_MANAGER_JAVA) < 0);
+  VS_TUT_ENSURE_EQUALS("lock manager changed",
+      Global::LOCK_MANAGER_NATIVE, Global::getLockManagerType());
+  VS_TUT_ENSURE_EQUALS("could not keep lock manager", 0,
+      Global::setLockManagerType(Global::LOCK_MANAGER_NATIVE));
+
+  Global::resetLockManagerStatistics();
+  pthread_t threads[numThreads];
+  std::clock_t start = std::clock();
+  for(int i = 0; i < numThreads; i++)
+    VS_TUT_ENSURE_EQUALS("could not start thread", 0,
+        pthread_create(&threads[i], 0, StreamCoderTest_openAndCloseCoders, 0));
+  for(int i = 0; i < numThreads; i++)
+    pthread_join(threads[i], 0);
+  std::clock_t elapsed = std::clock() - start;
+
+  VS_TUT_ENSURE("lock manager never used",
+      Global::getLockManagerObtainCount() > 0);
+  VS_LOG_INFO("lock manager %d: %lld obtains, %lld contended, %lld us waiting; %ld ms (cpu)",
+      (int)Global::getLockManagerType(),
+      (long long)Global::getLockManagerObtainCount(),
+      (long long)Global::getLockManagerContendedCount(),
+      (long long)Global::getLockManagerWaitTime(),
+      (long)(elapsed*1000/CLOCKS_PER_SEC));
+}
+
+static int64_t
+StreamCoderTest_decodeChecksum(IStreamCoder* coder,
+    std::vector<RefPointer<IPacket> >& packets)
+{
+  int64_t sum = 0;
+  for(size_t i = 0; i < packets.size(); i++)
+  {
+    int32_t offset = 0;
+    while (offset < packets[i]->getSize())
+    {
+      RefPointer<IVideoPicture> frame = IVideoPicture::make(
+          coder->getPixelType(), coder->getWidth(), coder->getHeight());
+      int32_t retval = coder->decodeVideo(frame.value(), packets[i].value(),
+          offset);
+      if (retval <= 0)
+        return -1;
+      offset += retval;
+      if (frame->isComplete())
+      {
+        RefPointer<IBuffer> data = frame->getData();
+        const unsigned char* bytes = (const unsigned char*)data->getBytes(0,
+            frame->getSize());
+        for(int32_t j = 0; j < frame->getSize(); j++)
+          sum = sum*31 + bytes[j];
+      }
+    }
+  }
+  return sum;
+}
+
+void
+StreamCoderTest :: testStreamCoderPoolReusesWarmCoders()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_WARN, false);
+
+  h->setupReading("ucl_h264_aac.mp4");
+  VS_TUT_ENSURE("no video stream", h->first_input_video_stream >= 0);
+  VS_TUT_ENSURE("no audio stream", h->first_input_audio_stream >= 0);
+  RefPointer<IStreamCoder> video = h->coders[h->first_input_video_stream];
+  RefPointer<IStreamCoder> audio = h->coders[h->first_input_audio_stream];
+
+  std::vector<RefPointer<IPacket> > packets;
+  while (packets.size() < 30)
+  {
+    RefPointer<IPacket> packet = IPacket::make();
+    if (h->container->readNextPacket(packet.value()) < 0)
+      break;
+    if (packet->getStreamIndex() == h->first_input_video_stream)
+      packets.push_back(packet);
+  }
+  VS_TUT_ENSURE("should read some packets", packets.size() > 0);
+
+  RefPointer<StreamCoderPool> pool = StreamCoderPool::make(2);
+  VS_TUT_ENSURE("could not make pool", pool);
+
+  RefPointer<IStreamCoder> first = pool->getCoder(video.value(), 0);
+  VS_TUT_ENSURE("could not get coder", first);
+  VS_TUT_ENSURE("coder should be open", first->isOpen());
+  VS_TUT_ENSURE_EQUALS("should miss", 1, pool->getMisses());
+  int64_t firstSum = StreamCoderTest_decodeChecksum(first.value(), packets);
+  VS_TUT_ENSURE("could not decode", firstSum != -1);
+  pool->returnCoder(first.value());
+  VS_TUT_ENSURE_EQUALS("should be idle", 1, pool->getNumIdleCoders());
+
+  RefPointer<IStreamCoder> second = pool->getCoder(video.value(), 0);
+  VS_TUT_ENSURE_EQUALS("should hit", 1, pool->getHits());
+  VS_TUT_ENSURE("should reuse the warm coder", second.value() == first.value());
+  first = 0;
+  // a flushed decoder must decode exactly as a freshly opened one does
+  VS_TUT_ENSURE_EQUALS("flushed coder decoded differently",
+      firstSum, StreamCoderTest_decodeChecksum(second.value(), packets));
+
+  RefPointer<IMetaData> options = IMetaData::make();
+  options->setValue("threads", "1");
+  RefPointer<IStreamCoder> third = pool->getCoder(video.value(),
+      options.value());
+  VS_TUT_ENSURE("could not get coder", third);
+  VS_TUT_ENSURE("different options must not share a coder",
+      third.value() != second.value());
+  VS_TUT_ENSURE_EQUALS("should miss", 2, pool->getMisses());
+
+  RefPointer<IStreamCoder> fourth = pool->getCoder(audio.value(), 0);
+  VS_TUT_ENSURE("could not get audio coder", fourth);
+  pool->returnCoder(second.value());
+  pool->returnCoder(third.value());
+  pool->returnCoder(fourth.value());
+  VS_TUT_ENSURE_EQUALS("should cap idle coders", 2, pool->getNumIdleCoders());
+  VS_TUT_ENSURE_EQUALS("should evict", 1, pool->getEvictions());
+  VS_TUT_ENSURE("evicted coder should be closed", !second->isOpen());
+
+  // and time a pooled get/return against an open/close
+  const int iterations = 50;
+  std::clock_t start = std::clock();
+  for(int i = 0; i < iterations; i++)
+  {
+    RefPointer<IStreamCoder> opened = IStreamCoder::make(
+        IStreamCoder::DECODING, video.value());
+    opened->open(0, 0);
+    opened->close();
+  }
+  std::clock_t openClose = std::clock() - start;
+  start = std::clock();
+  for(int i = 0; i < iterations; i++)
+  {
+    RefPointer<IStreamCoder> pooled = pool->getCoder(video.value(), 0);
+    pool->returnCoder(pooled.value());
+  }
+  std::clock_t pooled = std::clock() - start;
+  stack.setGlobalLevel(Logger::LEVEL_INFO, true);
+  VS_LOG_INFO("%d open/close: %ld ms; %d pooled get/return: %ld ms (cpu); %lld hits, %lld misses",
+      iterations, (long)(openClose*1000/CLOCKS_PER_SEC),
+      iterations, (long)(pooled*1000/CLOCKS_PER_SEC),
+      (long long)pool->getHits(), (long long)pool->getMisses());
+
+  // the pool keeps a reference to coders it hands out, so a coder
+  // dropped without being returned can't have its address reused by
+  // a coder the pool never saw
+  RefPointer<IStreamCoder> abandoned = pool->getCoder(video.value(), 0);
+  VS_TUT_ENSURE("could not get coder", abandoned);
+  VS_TUT_ENSURE_EQUALS("pool should hold a reference", 2,
+      abandoned->getCurrentRefCount());
+  abandoned = 0;
+  RefPointer<IStreamCoder> stranger = IStreamCoder::make(
+      IStreamCoder::DECODING, video.value());
+  VS_TUT_ENSURE("could not open coder", stranger->open(0, 0) >= 0);
+  int32_t numIdle = pool->getNumIdleCoders();
+  pool->returnCoder(stranger.value());
+  VS_TUT_ENSURE_EQUALS("should ignore coders not from the pool", numIdle,
+      pool->getNumIdleCoders());
+  stranger->close();
+
+  pool->clear();
+  VS_TUT_ENSURE_EQUALS("should be empty", 0, pool->getNumIdleCoders());
+}
+
+/**
+ * Encode numPictures identical pictures starting at timestamp, then
+ * drain the encoder.  Returns the number of packets, or -1 on error,
+ * and sets firstIsKey to whether the first packet was a keyframe.
+ */
+static int32_t
+StreamCoderTest_encodeVideo(IStreamCoder* encoder, int32_t numPictures,
+    int64_t timestamp, bool* firstIsKey)
+{
+  RefPointer<IVideoPicture> picture = IVideoPicture::make(
+      encoder->getPixelType(), encoder->getWidth(), encoder->getHeight());
+  RefPointer<IBuffer> data = picture->getData();
+  memset(data->getBytes(0, picture->getSize()), 128, picture->getSize());
+  RefPointer<IPacket> packet = IPacket::make();
+  int32_t numPackets = 0;
+  for(int32_t i = 0; i <= numPictures; i++)
+  {
+    IVideoPicture* input = 0;
+    if (i < numPictures)
+    {
+      picture->setComplete(true, encoder->getPixelType(),
+          encoder->getWidth(), encoder->getHeight(), timestamp + i * 40000);
+      input = picture.value();
+    }
+    do
+    {
+      if (encoder->encodeVideo(packet.value(), input, -1) < 0)
+        return -1;
+      if (packet->isComplete())
+      {
+        if (!numPackets)
+          *firstIsKey = packet->isKeyPacket();
+        ++numPackets;
+      }
+    } while (!input && packet->isComplete());
+  }
+  return numPackets;
+}
+
+void
+StreamCoderTest :: testStreamCoderPoolReusesEncoders()
+{
+  RefPointer<ICodec> codec = ICodec::findEncodingCodecByName("mpeg4");
+  if (!codec)
+    return;
+  RefPointer<IRational> timeBase = IRational::make(1, 25);
+  RefPointer<IStreamCoder> prototype = IStreamCoder::make(
+      IStreamCoder::ENCODING, codec.value());
+  VS_TUT_ENSURE("could not make coder", prototype);
+  prototype->setWidth(64);
+  prototype->setHeight(64);
+  prototype->setPixelType(IPixelFormat::YUV420P);
+  prototype->setTimeBase(timeBase.value());
+  // so only the first picture of a stream is a keyframe
+  prototype->setNumPicturesInGroupOfPictures(250);
+
+  RefPointer<StreamCoderPool> pool = StreamCoderPool::make(2);
+  VS_TUT_ENSURE("could not make pool", pool);
+  RefPointer<IStreamCoder> first = pool->getCoder(prototype.value(), 0);
+  VS_TUT_ENSURE("could not get coder", first && first->isOpen());
+  bool firstIsKey = false;
+  VS_TUT_ENSURE("could not encode",
+      StreamCoderTest_encodeVideo(first.value(), 5, 0, &firstIsKey) > 0);
+  VS_TUT_ENSURE("stream should start on a keyframe", firstIsKey);
+  pool->returnCoder(first.value());
+
+  // a reused encoder starts its next stream on a keyframe too; mpeg4
+  // wants its time stamps to keep going up though
+  RefPointer<IStreamCoder> second = pool->getCoder(prototype.value(), 0);
+  VS_TUT_ENSURE("should reuse the warm coder", second.value() == first.value());
+  VS_TUT_ENSURE_EQUALS("should hit", 1, pool->getHits());
+  firstIsKey = false;
+  VS_TUT_ENSURE("could not encode",
+      StreamCoderTest_encodeVideo(second.value(), 5, 1000000, &firstIsKey) > 0);
+  VS_TUT_ENSURE("reused encoder should start on a keyframe", firstIsKey);
+  pool->returnCoder(second.value());
+  first = 0;
+  second = 0;
+
+  // settings made on the prototype, not just in the open options, are
+  // part of the key
+  VS_TUT_ENSURE("could not set qmin",
+      prototype->setProperty("qmin", (int64_t)10) >= 0);
+  RefPointer<IStreamCoder> third = pool->getCoder(prototype.value(), 0);
+  VS_TUT_ENSURE("could not get coder", third);
+  VS_TUT_ENSURE_EQUALS("different qmin should miss", 2, pool->getMisses());
+  VS_TUT_ENSURE_EQUALS("should not take the idle coder", 1,
+      pool->getNumIdleCoders());
+  pool->returnCoder(third.value());
+  VS_TUT_ENSURE("could not set bf",
+      prototype->setProperty("bf", (int64_t)2) >= 0);
+  RefPointer<IStreamCoder> fourth = pool->getCoder(prototype.value(), 0);
+  VS_TUT_ENSURE("could not get coder", fourth);
+  VS_TUT_ENSURE_EQUALS("different b-frames should miss", 3, pool->getMisses());
+  pool->returnCoder(fourth.value());
+  pool->clear();
+}
+
+/*
+ * Encodes numSamples of samples chunkSize samples at a time, and appends
+ * every packet the encoder produces to encoded.  Returns the number of
+ * packets, or -1 on error.
+ */
+static int32_t
+StreamCoderTest_encodeAudio(IStreamCoder* coder, IAudioSamples* samples,
+    int32_t chunkSize, std::vector<unsigned char>& encoded)
+{
+  RefPointer<IPacket> packet = IPacket::make();
+  int32_t numPackets = 0;
+  int32_t bytesPerSample = samples->getSampleSize();
+  RefPointer<IBuffer> buffer = samples->getData();
+  unsigned char* raw = (unsigned char*)buffer->getBytes(0,
+      samples->getNumSamples() * bytesPerSample);
+  for(uint32_t start = 0; start < samples->getNumSamples(); start += chunkSize)
+  {
+    uint32_t size = std::min((uint32_t)chunkSize,
+        samples->getNumSamples() - start);
+    RefPointer<IAudioSamples> chunk = IAudioSamples::make(size,
+        samples->getChannels());
+    RefPointer<IBuffer> chunkBuffer = chunk->getData();
+    memcpy(chunkBuffer->getBytes(0, size * bytesPerSample), raw + start * bytesPerSample,
+        size * bytesPerSample);
+    chunk->setComplete(true, size, samples->getSampleRate(),
+        samples->getChannels(), samples->getFormat(),
+        samples->getTimeStamp() + IAudioSamples::samplesToDefaultPts(start,
+            samples->getSampleRate()));
+
+    uint32_t consumed = 0;
+    while (consumed < chunk->getNumSamples())
+    {
+      int32_t retval = coder->encodeAudio(packet.value(), chunk.value(),
+          consumed);
+      if (retval <= 0)
+        return -1;
+      consumed += retval;
+      if (packet->isComplete())
+      {
+        unsigned char* data = (unsigned char*)packet->getData()->getBytes(0,
+            packet->getSize());
+        encoded.insert(encoded.end(), data, data + packet->getSize());
+        ++numPackets;
+      }
+    }
+  }
+  return numPackets;
+}
+
+void
+StreamCoderTest :: testEncodeAudioFromCallerBufferMatchesFrameBuffer()
+{
+  const int32_t channels = 6;
+  const int32_t sampleRate = 48000;
+  RefPointer<ICodec> codec = ICodec::findEncodingCodecByName("ac3_fixed");
+  if (!codec)
+    return;
+
+  RefPointer<IStreamCoder> coders[2];
+  for(int i = 0; i < 2; i++)
+  {
+    coders[i] = IStreamCoder::make(IStreamCoder::ENCODING, codec.value());
+    VS_TUT_ENSURE("could not make coder", coders[i]);
+    coders[i]->setChannels(channels);
+    coders[i]->setSampleRate(sampleRate);
+    coders[i]->setBitRate(384000);
+    VS_TUT_ENSURE("could not open coder", coders[i]->open(0, 0) >= 0);
+  }
+  int32_t frameSize = coders[0]->getAudioFrameSize();
+  VS_TUT_ENSURE("no frame size", frameSize > 1);
+
+  // a bit over 20 frames of a different tone on every channel
+  const int32_t numSamples = frameSize * 20 + frameSize / 3;
+  RefPointer<IAudioSamples> samples = IAudioSamples::make(numSamples,
+      channels);
+  RefPointer<IBuffer> buffer = samples->getData();
+  int16_t* raw = (int16_t*)buffer->getBytes(0,
+      numSamples * samples->getSampleSize());
+  for(int32_t i = 0; i < numSamples; i++)
+    for(int32_t c = 0; c < channels; c++)
+      raw[i*channels+c] = (int16_t)(8000 * sin(2 * M_PI * 220 * (c+1) * i /
+          sampleRate));
+  samples->setComplete(true, numSamples, sampleRate, channels,
+      IAudioSamples::FMT_S16, 0);
+
+  // one call with every sample hands whole frames straight to the
+  // encoder; chunks smaller than a frame assemble every frame in the
+  // coder's own frame buffer.  Both must produce the same packets.
+  std::vector<unsigned char> direct;
+  std::vector<unsigned char> buffered;
+  int32_t numDirect = StreamCoderTest_encodeAudio(coders[0].value(),
+      samples.value(), numSamples, direct);
+  int32_t numBuffered = StreamCoderTest_encodeAudio(coders[1].value(),
+      samples.value(), frameSize / 5, buffered);
+  VS_TUT_ENSURE("could not encode", numDirect > 0);
+  VS_TUT_ENSURE_EQUALS("different number of packets", numDirect, numBuffered);
+  VS_TUT_ENSURE_EQUALS("different number of bytes", direct.size(),
+      buffered.size());
+  VS_TUT_ENSURE("packets differ", direct == buffered);
+
+  for(int i = 0; i < 2; i++)
+    VS_TUT_ENSURE("could not close coder", coders[i]->close() >= 0);
+}
+
+/**
+ * Fills targets with numTargets time stamps spread evenly over the
+ * first video stream of h, in that stream's time base.
+ */
+static void
+StreamCoderTest_thumbnailTargets(Helper* h, int32_t numTargets,
+    std::vector<int64_t>& targets)
+{
+  RefPointer<IStream> stream = h->container->getStream(
+      h->first_input_video_stream);
+  int64_t start = stream->getStartTime();
+  if (start == Global::NO_PTS)
+    start = 0;
+  int64_t duration = stream->getDuration();
+  VS_TUT_ENSURE("no duration", duration != Global::NO_PTS && duration > 0);
+  for(int32_t i = 0; i < numTargets; i++)
+    targets.push_back(start + duration * i / numTargets);
+}
+
+void
+StreamCoderTest :: testDecodeVideoKeyFrames()
+{
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_WARN, false);
+
+  h->setupReading("ucl_h264_aac.mp4");
+  VS_TUT_ENSURE("no video stream", h->first_input_video_stream >= 0);
+  RefPointer<IStreamCoder> ic = h->coders[h->first_input_video_stream];
+  RefPointer<IVideoPicture> picture = IVideoPicture::make(ic->getPixelType(),
+      ic->getWidth(), ic->getHeight());
+  VS_TUT_ENSURE("should not decode before opening",
+      ic->decodeVideoKeyFrame(picture.value(), 0) < 0);
+  VS_TUT_ENSURE("could not open coder", ic->open(0, 0) >= 0);
+  VS_TUT_ENSURE("should default to decoding everything",
+      !ic->getDecodeKeyFramesOnly());
+
+  std::vector<int64_t> targets;
+  StreamCoderTest_thumbnailTargets(h, 8, targets);
+  int64_t lastTimeStamp = Global::NO_PTS;
+  for(size_t i = 0; i < targets.size(); i++)
+  {
+    VS_TUT_ENSURE("could not decode keyframe",
+        ic->decodeVideoKeyFrame(picture.value(), targets[i]) >= 0);
+    VS_TUT_ENSURE("picture not complete", picture->isComplete());
+    VS_TUT_ENSURE("not a keyframe", picture->isKeyFrame());
+    VS_TUT_ENSURE("went backwards", lastTimeStamp == Global::NO_PTS ||
+        picture->getTimeStamp() >= lastTimeStamp);
+    lastTimeStamp = picture->getTimeStamp();
+  }
+  VS_TUT_ENSURE("keyframe setting not put back",
+      !ic->getDecodeKeyFramesOnly());
+
+  // ordinary decoding carries on after a seek back to the start
+  VS_TUT_ENSURE("could not seek", h->container->seekKeyFrame(
+      h->first_input_video_stream, targets[0],
+      IContainer::SEEK_FLAG_BACKWARDS) >= 0);
+  RefPointer<IPacket> packet = IPacket::make();
+  int32_t numPictures = 0;
+  int32_t numKeyPictures = 0;
+  int32_t numOtherPackets = 0;
+  while (numPictures < 30 && h->container->readNextPacket(packet.value()) >= 0)
+  {
+    if (packet->getStreamIndex() != h->first_input_video_stream)
+    {
+      ++numOtherPackets;
+      continue;
+    }
+    int32_t offset = 0;
+    while (offset < packet->getSize())
+    {
+      int32_t retval = ic->decodeVideo(picture.value(), packet.value(), offset);
+      VS_TUT_ENSURE("could not decode video", retval > 0);
+      offset += retval;
+      if (picture->isComplete())
+      {
+        ++numPictures;
+        if (picture->isKeyFrame())
+          ++numKeyPictures;
+      }
+    }
+  }
+  VS_TUT_ENSURE("should decode some pictures", numPictures > 0);
+  VS_TUT_ENSURE("should decode more than keyframes",
+      numPictures > numKeyPictures);
+  VS_TUT_ENSURE("other streams should not be dropped any more",
+      numOtherPackets > 0);
+
+  // and with keyframes only, nothing else comes out
+  ic->setDecodeKeyFramesOnly(true);
+  VS_TUT_ENSURE("could not set keyframes only", ic->getDecodeKeyFramesOnly());
+  while (h->container->readNextPacket(packet.value()) >= 0)
+  {
+    if (packet->getStreamIndex() != h->first_input_video_stream)
+      continue;
+    int32_t retval = ic->decodeVideo(picture.value(), packet.value(), 0);
+    if (!packet->isKeyPacket())
+    {
+      VS_TUT_ENSURE_EQUALS("non-keyframe not dropped",
+          packet->getSize(), retval);
+      VS_TUT_ENSURE("non-keyframe decoded", !picture->isComplete());
+    }
+  }
+  ic->setDecodeKeyFramesOnly(false);
+  ic->close();
+}
+
+void
+StreamCoderTest :: testDecodeVideoKeyFramesBenchmark()
+{
+  // Not a pass/fail test; logs how long it takes to get a thumbnail
+  // picture at each of a number of time stamps by decoding everything,
+  // and by decoding only the keyframes.
+  const int32_t numTargets = 16;
+  const char* file = "ucl_h264_aac.mp4";
+
+  // the full decode path: decode every picture, keeping the first one at
+  // or after each target
+  std::clock_t start = std::clock();
+  int32_t numFullPictures = 0;
+  {
+    Helper full;
+    full.setupReading(file);
+    VS_TUT_ENSURE("no video stream", full.first_input_video_stream >= 0);
+    RefPointer<IStreamCoder> ic = full.coders[full.first_input_video_stream];
+    VS_TUT_ENSURE("could not open coder", ic->open(0, 0) >= 0);
+    std::vector<int64_t> targets;
+    StreamCoderTest_thumbnailTargets(&full, numTargets, targets);
+    RefPointer<IStream> stream = full.container->getStream(
+        full.first_input_video_stream);
+    RefPointer<IRational> timeBase = stream->getTimeBase();
+    RefPointer<IRational> micros = IRational::make(1, 1000000);
+    RefPointer<IVideoPicture> picture = IVideoPicture::make(ic->getPixelType(),
+        ic->getWidth(), ic->getHeight());
+    RefPointer<IPacket> packet = IPacket::make();
+    size_t nextTarget = 0;
+    while (nextTarget < targets.size()
+        && full.container->readNextPacket(packet.value()) >= 0)
+    {
+      if (packet->getStreamIndex() != full.first_input_video_stream)
+        continue;
+      int32_t offset = 0;
+      while (offset < packet->getSize())
+      {
+        int32_t retval = ic->decodeVideo(picture.value(), packet.value(), offset);
+        if (retval <= 0)
+          break;
+        offset += retval;
+        if (picture->isComplete() && nextTarget < targets.size() &&
+            picture->getTimeStamp() >= micros->rescale(targets[nextTarget],
+                timeBase.value()))
+        {
+          ++numFullPictures;
+          ++nextTarget;
+        }
+      }
+    }
+    ic->close();
+  }
+  double fullSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+
+  // the keyframe path
+  start = std::clock();
+  int32_t numKeyPictures = 0;
+  {
+    Helper keys;
+    keys.setupReading(file);
+    RefPointer<IStreamCoder> ic = keys.coders[keys.first_input_video_stream];
+    VS_TUT_ENSURE("could not open coder", ic->open(0, 0) >= 0);
+    std::vector<int64_t> targets;
+    StreamCoderTest_thumbnailTargets(&keys, numTargets, targets);
+    RefPointer<IVideoPicture> picture = IVideoPicture::make(ic->getPixelType(),
+        ic->getWidth(), ic->getHeight());
+    for(size_t i = 0; i < targets.size(); i++)
+      if (ic->decodeVideoKeyFrame(picture.value(), targets[i]) >= 0)
+        ++numKeyPictures;
+    ic->close();
+  }
+  double keySeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+
+  VS_TUT_ENSURE("full decode missed pictures", numFullPictures > 0);
+  VS_TUT_ENSURE_EQUALS("keyframe decode missed pictures",
+      numTargets, numKeyPictures);
+  VS_LOG_INFO("%d thumbnails: full decode %.3f seconds; keyframes only %.3f seconds",
+      numTargets, fullSeconds, keySeconds);
+}
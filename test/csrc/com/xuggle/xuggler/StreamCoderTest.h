@@ -41,6 +41,16 @@ class StreamCoderTest : public CxxTest::TestSuite
     void testGetSetExtraData();
     void disabled_testDecodingAndEncodingNellymoserAudio();
     void testDecodingAndEncodingFullyInterleavedFile();
+    void testSetNumThreadsAndThreadType();
+    void testFrameThreadedDecodingMatchesSingleThreaded();
+    void testDecodedPicturesOutliveDecoderBuffers();
+    void testDecodedPicturesSurviveRegetBuffer();
+    void testConcurrentOpenLockManagerBenchmark();
+    void testStreamCoderPoolReusesWarmCoders();
+    void testStreamCoderPoolReusesEncoders();
+    void testEncodeAudioFromCallerBufferMatchesFrameBuffer();
+    void testDecodeVideoKeyFrames();
+    void testDecodeVideoKeyFramesBenchmark();
   private:
     Helper* h;
     Helper* hw;
@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/ferry/LoggerStack.h>
+#include <com/xuggle/xuggler/Global.h>
+#include <cstdio>
+#include <cstring>
+#include <sys/time.h>
+#include "TranscoderTest.h"
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+static const char* TranscoderTest_INPUT="testfile_mpeg1video_mp2audio.mpg";
+
+TranscoderTest :: TranscoderTest()
+{
+  h = 0;
+  hw = 0;
+}
+
+TranscoderTest :: ~TranscoderTest()
+{
+  tearDown();
+}
+
+void
+TranscoderTest :: setUp()
+{
+  h = new Helper();
+  hw = new Helper();
+}
+
+void
+TranscoderTest :: tearDown()
+{
+  if (h)
+    delete h;
+  h = 0;
+
+  if (hw)
+    delete hw;
+  hw = 0;
+}
+
+int32_t
+TranscoderTest :: transcode(const char* url, int32_t numThreads,
+    RefPointer<ITranscoder>* transcoder)
+{
+  h->setupReading(TranscoderTest_INPUT);
+  VS_TUT_ENSURE("no video", h->first_input_video_stream >= 0);
+  VS_TUT_ENSURE("no audio", h->first_input_audio_stream >= 0);
+
+  hw->setupWriting(url, "flv", "adpcm_swf", "flv");
+  RefPointer<IStreamCoder> ic = h->coders[h->first_input_video_stream];
+  RefPointer<IStreamCoder> oc = hw->coders[hw->first_output_video_stream];
+  // half size, so pictures have to be rescaled
+  oc->setWidth(ic->getWidth()/2);
+  oc->setHeight(ic->getHeight()/2);
+  oc->setPixelType(IPixelFormat::YUV420P);
+  // and a different sample rate, so audio has to be resampled
+  oc = hw->coders[hw->first_output_audio_stream];
+  oc->setSampleRate(22050);
+  oc->setChannels(1);
+
+  *transcoder = ITranscoder::make(h->container.value(), hw->container.value());
+  VS_TUT_ENSURE("could not make transcoder", *transcoder);
+  VS_TUT_ENSURE("could not map video",
+      (*transcoder)->mapStream(h->first_input_video_stream,
+          hw->first_output_video_stream) >= 0);
+  VS_TUT_ENSURE("could not map audio",
+      (*transcoder)->mapStream(h->first_input_audio_stream,
+          hw->first_output_audio_stream) >= 0);
+  VS_TUT_ENSURE("could not set threads",
+      (*transcoder)->setNumThreads(numThreads) >= 0);
+
+  int32_t retval = (*transcoder)->run();
+  // the transcoder wrote the header and trailer
+  hw->need_trailer_write = false;
+  return retval;
+}
+
+void
+TranscoderTest :: testInvalidMappings()
+{
+  h->setupReading(TranscoderTest_INPUT);
+  hw->setupWriting("TranscoderTest_1_output.flv", "flv", "adpcm_swf", "flv");
+
+  RefPointer<ITranscoder> transcoder = ITranscoder::make(h->container.value(),
+      hw->container.value());
+  VS_TUT_ENSURE("could not make transcoder", transcoder);
+  VS_TUT_ENSURE_EQUALS("", 0, transcoder->getNumStages());
+  VS_TUT_ENSURE("", !transcoder->getStageName(0));
+
+  // no such streams
+  VS_TUT_ENSURE("", transcoder->mapStream(-1,
+      hw->first_output_video_stream) < 0);
+  VS_TUT_ENSURE("", transcoder->mapStream(h->first_input_video_stream,
+      hw->container->getNumStreams()) < 0);
+  // video into audio
+  VS_TUT_ENSURE("", transcoder->mapStream(h->first_input_video_stream,
+      hw->first_output_audio_stream) < 0);
+  VS_TUT_ENSURE("", transcoder->mapStream(h->first_input_video_stream,
+      hw->first_output_video_stream) >= 0);
+  // streams can only be mapped once
+  VS_TUT_ENSURE("", transcoder->mapStream(h->first_input_video_stream,
+      hw->first_output_video_stream) < 0);
+
+  VS_TUT_ENSURE("", transcoder->setNumThreads(-1) < 0);
+  VS_TUT_ENSURE("", transcoder->setQueueCapacity(0) < 0);
+  VS_TUT_ENSURE("", transcoder->setQueueCapacity(4) >= 0);
+  VS_TUT_ENSURE_EQUALS("", 4, transcoder->getQueueCapacity());
+
+  // the output header is already written, so we can't transcode into it
+  VS_TUT_ENSURE("", hw->container->writeHeader() >= 0);
+  {
+    LoggerStack stack;
+    stack.setGlobalLevel(Logger::LEVEL_ERROR, false);
+    transcoder = ITranscoder::make(h->container.value(), hw->container.value());
+    VS_TUT_ENSURE("", !transcoder);
+  }
+}
+
+void
+TranscoderTest :: testTranscodeWithConversion()
+{
+  const char* url = "TranscoderTest_2_output.flv";
+  RefPointer<ITranscoder> transcoder;
+  VS_TUT_ENSURE("could not transcode", transcode(url, 0, &transcoder) >= 0);
+  // and you only get to run once
+  VS_TUT_ENSURE("", transcoder->run() < 0);
+
+  // demux, decode/convert/encode for two streams, and mux
+  VS_TUT_ENSURE_EQUALS("", 8, transcoder->getNumStages());
+  VS_TUT_ENSURE_EQUALS("", 0, strcmp("demux", transcoder->getStageName(0)));
+  VS_TUT_ENSURE_EQUALS("", 0, strcmp("mux", transcoder->getStageName(7)));
+  for(int32_t i = 0; i < transcoder->getNumStages(); i++)
+  {
+    VS_TUT_ENSURE("no items", transcoder->getStageNumItems(i) > 0);
+    VS_TUT_ENSURE("no time", transcoder->getStageBusyTime(i) >= 0);
+    // everything drained
+    VS_TUT_ENSURE_EQUALS("", 0, transcoder->getStageQueueDepth(i));
+    VS_TUT_ENSURE("", transcoder->getStageMaxQueueDepth(i) >= 0);
+  }
+  VS_TUT_ENSURE("", transcoder->getStageNumItems(8) < 0);
+
+  // now make sure what we wrote reads back at the size we asked for
+  Helper check;
+  check.setupReading(url);
+  VS_TUT_ENSURE("no video", check.first_input_video_stream >= 0);
+  VS_TUT_ENSURE("no audio", check.first_input_audio_stream >= 0);
+  RefPointer<IStreamCoder> vc = check.coders[check.first_input_video_stream];
+  RefPointer<IStreamCoder> ac = check.coders[check.first_input_audio_stream];
+  RefPointer<IStreamCoder> ic = h->coders[h->first_input_video_stream];
+  VS_TUT_ENSURE_EQUALS("", ic->getWidth()/2, vc->getWidth());
+  VS_TUT_ENSURE_EQUALS("", ic->getHeight()/2, vc->getHeight());
+  VS_TUT_ENSURE_EQUALS("", 22050, ac->getSampleRate());
+
+  int32_t numVideoPackets = 0;
+  int32_t numAudioPackets = 0;
+  while(check.container->readNextPacket(check.packet.value()) >= 0)
+  {
+    if (check.packet->getStreamIndex() == check.first_input_video_stream)
+      ++numVideoPackets;
+    else if (check.packet->getStreamIndex() == check.first_input_audio_stream)
+      ++numAudioPackets;
+  }
+  VS_LOG_DEBUG("video packets: %d; audio packets: %d",
+      numVideoPackets, numAudioPackets);
+  VS_TUT_ENSURE("no video", numVideoPackets > 0);
+  VS_TUT_ENSURE("no audio", numAudioPackets > 0);
+  // the video encode stage takes one picture per video packet written,
+  // plus the end of stream
+  char encodeName[32];
+  snprintf(encodeName, sizeof(encodeName), "encode:%d",
+      h->first_input_video_stream);
+  int32_t encodeStage = -1;
+  for(int32_t i = 0; i < transcoder->getNumStages(); i++)
+    if (!strcmp(encodeName, transcoder->getStageName(i)))
+      encodeStage = i;
+  VS_TUT_ENSURE("no video encode stage", encodeStage >= 0);
+  VS_TUT_ENSURE_EQUALS("", transcoder->getStageNumItems(encodeStage),
+      (int64_t)numVideoPackets+1);
+}
+
+void
+TranscoderTest :: testStageThroughput()
+{
+  RefPointer<ITranscoder> transcoder;
+  double seconds[2];
+  const char* urls[] = {
+      "TranscoderTest_3_output.flv",
+      "TranscoderTest_4_output.flv"
+  };
+  const int32_t threads[] = { 1, 0 };
+  for(int i = 0; i < 2; i++)
+  {
+    if (i > 0)
+    {
+      // the helpers check nothing else holds their coders
+      transcoder = 0;
+      tearDown();
+      setUp();
+    }
+    struct timeval start, end;
+    gettimeofday(&start, 0);
+    VS_TUT_ENSURE("could not transcode",
+        transcode(urls[i], threads[i], &transcoder) >= 0);
+    gettimeofday(&end, 0);
+    seconds[i] = (end.tv_sec - start.tv_sec) +
+      (end.tv_usec - start.tv_usec) / 1000000.0;
+  }
+
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_INFO, true);
+  VS_LOG_INFO("%s: one thread: %.3fs; one thread per stage: %.3fs",
+      TranscoderTest_INPUT, seconds[0], seconds[1]);
+  for(int32_t i = 0; i < transcoder->getNumStages(); i++)
+  {
+    int64_t items = transcoder->getStageNumItems(i);
+    int64_t busy = transcoder->getStageBusyTime(i);
+    VS_LOG_INFO("%-10s items: %5lld; busy: %8.3fms; items/s: %9.1f; max queue: %d",
+        transcoder->getStageName(i),
+        (long long)items,
+        busy / 1000.0,
+        busy > 0 ? items * 1000000.0 / busy : 0.0,
+        transcoder->getStageMaxQueueDepth(i));
+  }
+}
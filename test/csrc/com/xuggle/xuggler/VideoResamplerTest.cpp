@@ -20,6 +20,11 @@
 #include <com/xuggle/ferry/Logger.h>
 #include <com/xuggle/xuggler/Global.h>
 #include <com/xuggle/xuggler/IVideoResampler.h>
+#include <com/xuggle/xuggler/VideoPicture.h>
+#include <com/xuggle/xuggler/PixelConversion.h>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
 #include "VideoResamplerTest.h"
 
 VS_LOG_SETUP(VS_CPP_PACKAGE);
@@ -622,3 +627,169 @@ VideoResamplerTest :: testRescaleDownInYUV()
 
 }
 
+void
+VideoResamplerTest :: testPackedConversionMatchesResampler()
+{
+  if (!IVideoResampler::isSupported(IVideoResampler::FEATURE_COLORSPACECONVERSION))
+    return;
+
+  // odd sizes on purpose, so the last chroma column and row get tested
+  const int32_t width = 321;
+  const int32_t height = 241;
+  const int32_t iterations = 50;
+
+  RefPointer<IVideoPicture> yuv = IVideoPicture::make(IPixelFormat::YUV420P,
+      width, height);
+  RefPointer<IVideoPicture> bgr = IVideoPicture::make(IPixelFormat::BGR24,
+      width, height);
+  VS_TUT_ENSURE("", yuv && bgr);
+  AVFrame* frame = dynamic_cast<VideoPicture*>(yuv.value())->getAVFrame();
+  VS_TUT_ENSURE("", frame);
+
+  // keep the colors inside the RGB gamut so nothing clips on the way
+  // back, and keep chroma smooth so it doesn't matter whether swscale
+  // interpolates it
+  srand(7);
+  for(int32_t y = 0; y < height; y++)
+    for(int32_t x = 0; x < width; x++)
+      frame->data[0][y*frame->linesize[0]+x] = 64 + rand() % 128;
+  for(int32_t y = 0; y < (height+1)/2; y++)
+    for(int32_t x = 0; x < (width+1)/2; x++)
+    {
+      frame->data[1][y*frame->linesize[1]+x] = 112 + x*32/((width+1)/2);
+      frame->data[2][y*frame->linesize[2]+x] = 143 - y*32/((height+1)/2);
+    }
+  yuv->setComplete(true, IPixelFormat::YUV420P, width, height, 0);
+
+  mResampler = IVideoResampler::make(width, height, IPixelFormat::BGR24,
+      width, height, IPixelFormat::YUV420P);
+  VS_TUT_ENSURE("", mResampler);
+  VS_TUT_ENSURE("", mResampler->resample(bgr.value(), yuv.value()) >= 0);
+
+  const uint8_t* planes[3] = { frame->data[0], frame->data[1], frame->data[2] };
+  const int32_t strides[3] = { frame->linesize[0], frame->linesize[1],
+      frame->linesize[2] };
+  std::vector<uint8_t> packed(width*height*3);
+  PixelConversion::yuv420pToPacked(PixelConversion::PACKED_BGR24,
+      planes, strides, width, height, &packed[0], width*3);
+
+  // allow a little more than rounding between the two
+  RefPointer<IBuffer> buffer = bgr->getData();
+  const uint8_t* expected = (const uint8_t*)buffer->getBytes(0,
+      bgr->getSize());
+  int32_t lineSize = bgr->getDataLineSize(0);
+  int32_t maxDiff = 0;
+  for(int32_t y = 0; y < height; y++)
+    for(int32_t x = 0; x < width*3; x++)
+    {
+      int32_t diff = abs(expected[y*lineSize+x] - packed[y*width*3+x]);
+      if (diff > maxDiff)
+        maxDiff = diff;
+    }
+  VS_LOG_DEBUG("max difference from swscale: %d", maxDiff);
+  VS_TUT_ENSURE("too far from swscale", maxDiff <= 8);
+
+  // and the round trip should land back near where we started
+  std::vector<uint8_t> plane0(width*height), plane1(((width+1)/2)*((height+1)/2)),
+      plane2(plane1.size());
+  uint8_t* outPlanes[3] = { &plane0[0], &plane1[0], &plane2[0] };
+  const int32_t outStrides[3] = { width, (width+1)/2, (width+1)/2 };
+  PixelConversion::packedToYuv420p(PixelConversion::PACKED_BGR24,
+      &packed[0], width*3, width, height, outPlanes, outStrides);
+  for(int32_t y = 0; y < height; y++)
+    for(int32_t x = 0; x < width; x++)
+      VS_TUT_ENSURE_DISTANCE("", plane0[y*width+x],
+          frame->data[0][y*frame->linesize[0]+x], 3);
+  for(int32_t y = 0; y < (height+1)/2; y++)
+    for(int32_t x = 0; x < (width+1)/2; x++)
+    {
+      VS_TUT_ENSURE_DISTANCE("", plane1[y*outStrides[1]+x],
+          frame->data[1][y*frame->linesize[1]+x], 3);
+      VS_TUT_ENSURE_DISTANCE("", plane2[y*outStrides[2]+x],
+          frame->data[2][y*frame->linesize[2]+x], 3);
+    }
+
+  // finally, time both ways of getting to BGR24
+  std::clock_t start = std::clock();
+  for(int32_t i = 0; i < iterations; i++)
+    mResampler->resample(bgr.value(), yuv.value());
+  double resampleSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+  start = std::clock();
+  for(int32_t i = 0; i < iterations; i++)
+    PixelConversion::yuv420pToPacked(PixelConversion::PACKED_BGR24,
+        planes, strides, width, height, &packed[0], width*3);
+  double packedSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+  VS_LOG_INFO("%dx%d YUV420P to BGR24 x %d: swscale %.3fs; packed kernel %.3fs",
+      width, height, iterations, resampleSeconds, packedSeconds);
+}
+
+void
+VideoResamplerTest :: testContextCacheReusesScalers()
+{
+  if (!IVideoResampler::isSupported(IVideoResampler::FEATURE_COLORSPACECONVERSION))
+    return;
+  const int32_t iterations = 50;
+  int32_t oldSize = IVideoResampler::getContextCacheSize();
+  IVideoResampler::clearContextCache();
+  IVideoResampler::resetContextCacheStatistics();
+
+  // a deleted resampler's scaler goes back to the cache...
+  mResampler = IVideoResampler::make(320, 240, IPixelFormat::BGR24,
+      640, 480, IPixelFormat::YUV420P);
+  VS_TUT_ENSURE("", mResampler);
+  mResampler = 0;
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getNumCachedContexts(), 1);
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getContextCacheMisses(), 1);
+
+  // ...and is found again by a resampler doing the same conversion
+  mResampler = IVideoResampler::make(320, 240, IPixelFormat::BGR24,
+      640, 480, IPixelFormat::YUV420P);
+  VS_TUT_ENSURE("", mResampler);
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getContextCacheHits(), 1);
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getNumCachedContexts(), 0);
+
+  // but not one set up differently
+  RefPointer<IVideoResampler> other = IVideoResampler::make(
+      320, 240, IPixelFormat::RGB24, 640, 480, IPixelFormat::YUV420P);
+  VS_TUT_ENSURE("", other);
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getContextCacheMisses(), 2);
+
+  // scalers someone changed the options on are never cached
+  VS_TUT_ENSURE("", other->setProperty("sws_flags", "bilinear") >= 0);
+  other = 0;
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getNumCachedContexts(), 0);
+
+  // and past the cache size, the least recently used go
+  VS_TUT_ENSURE("", IVideoResampler::setContextCacheSize(-1) < 0);
+  VS_TUT_ENSURE("", IVideoResampler::setContextCacheSize(1) >= 0);
+  other = IVideoResampler::make(
+      320, 240, IPixelFormat::RGB24, 640, 480, IPixelFormat::YUV420P);
+  mResampler = 0;
+  other = 0;
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getNumCachedContexts(), 1);
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getContextCacheEvictions(), 1);
+  mResampler = IVideoResampler::make(
+      320, 240, IPixelFormat::RGB24, 640, 480, IPixelFormat::YUV420P);
+  VS_TUT_ENSURE_EQUALS("", IVideoResampler::getContextCacheHits(), 2);
+  mResampler = 0;
+
+  // time re-creating a resampler, as converters do on stream changes
+  std::clock_t start = std::clock();
+  for(int32_t i = 0; i < iterations; i++)
+    mResampler = IVideoResampler::make(640, 360, IPixelFormat::BGR24,
+        1280, 720, IPixelFormat::YUV420P);
+  double cachedSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+  IVideoResampler::setContextCacheSize(0);
+  start = std::clock();
+  for(int32_t i = 0; i < iterations; i++)
+    mResampler = IVideoResampler::make(640, 360, IPixelFormat::BGR24,
+        1280, 720, IPixelFormat::YUV420P);
+  double uncachedSeconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+  mResampler = 0;
+  VS_LOG_INFO("make 1280x720 YUV420P to 640x360 BGR24 resampler x %d: "
+      "%.3fs cached; %.3fs uncached",
+      iterations, cachedSeconds, uncachedSeconds);
+
+  IVideoResampler::setContextCacheSize(oldSize);
+  IVideoResampler::resetContextCacheStatistics();
+}
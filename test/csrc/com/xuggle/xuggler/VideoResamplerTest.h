@@ -38,6 +38,8 @@ class VideoResamplerTest : public CxxTest::TestSuite
     void testSwitchPixelFormatsAndOutput();
     void testRescaleUpInYUV();
     void testRescaleDownInYUV();
+    void testPackedConversionMatchesResampler();
+    void testContextCacheReusesScalers();
   private:
     Helper* h;
     Helper* hw;
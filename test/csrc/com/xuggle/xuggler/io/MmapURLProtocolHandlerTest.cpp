@@ -0,0 +1,245 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+
+#include "MmapURLProtocolHandlerTest.h"
+
+#include <com/xuggle/ferry/LoggerStack.h>
+#include <com/xuggle/xuggler/io/StdioURLProtocolManager.h>
+
+using namespace VS_CPP_NAMESPACE;
+using namespace com::xuggle::ferry;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+MmapURLProtocolHandlerTest :: MmapURLProtocolHandlerTest()
+{
+     char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+     if (fixtureDirectory)
+       snprintf(mFixtureDir, sizeof(mFixtureDir), "%s", fixtureDirectory);
+     else
+       snprintf(mFixtureDir, sizeof(mFixtureDir), ".");
+     FIXTURE_DIRECTORY = mFixtureDir;
+     SAMPLE_FILE = "testfile.flv";
+     snprintf(mSampleFile, sizeof(mSampleFile), "%s/%s", mFixtureDir, SAMPLE_FILE);
+}
+
+MmapURLProtocolHandlerTest :: ~MmapURLProtocolHandlerTest()
+{
+}
+
+void
+MmapURLProtocolHandlerTest :: setUp()
+{
+  
+}
+
+void
+MmapURLProtocolHandlerTest :: tearDown()
+{
+  URLProtocolManager::unregisterAllProtocols();
+}
+
+void
+MmapURLProtocolHandlerTest :: testCreation()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  URLProtocolHandler* handler = MmapURLProtocolManager::findHandler("mmap:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testOpenClose()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  URLProtocolHandler* handler = MmapURLProtocolManager::findHandler("mmap:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+
+  int retval = 0;
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+
+  retval = handler->url_open("mmap:/this/file/does/not/exist.flv",
+      URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval < 0);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testRead()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  StdioURLProtocolManager::registerProtocol("test");
+  URLProtocolHandler* handler = MmapURLProtocolManager::findHandler("mmap:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+  URLProtocolHandler* stdio = URLProtocolManager::findHandler("test:foo", 0,0);
+  VS_TUT_ENSURE("", stdio);
+
+  int retval = 0;
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+  retval = stdio->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+
+  int32_t totalBytes = 0;
+  do {
+    unsigned char buf[2048];
+    unsigned char expected[2048];
+    retval = handler->url_read(buf, (int)sizeof(buf));
+    VS_TUT_ENSURE_EQUALS("", stdio->url_read(expected, (int)sizeof(expected)),
+        retval);
+    if (retval > 0)
+    {
+      VS_TUT_ENSURE("", memcmp(buf, expected, retval) == 0);
+      totalBytes+= retval;
+    }
+  } while (retval > 0);
+  VS_TUT_ENSURE_EQUALS("", 4546420, totalBytes);
+
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  retval = stdio->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  delete handler;
+  delete stdio;
+}
+
+void
+MmapURLProtocolHandlerTest :: testWriteFails()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  URLProtocolHandler* handler = MmapURLProtocolManager::findHandler("mmap:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+
+  int retval = handler->url_open("mmap:MmapURLProtocolHandlerTest_testWriteFails.flv",
+      URLProtocolHandler::URL_WRONLY_MODE);
+  VS_TUT_ENSURE("", retval < 0);
+
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+  unsigned char buf[16];
+  memset(buf, 0, sizeof(buf));
+  retval = handler->url_write(buf, (int)sizeof(buf));
+  VS_TUT_ENSURE("", retval < 0);
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testSeek()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  URLProtocolHandler* handler = MmapURLProtocolManager::findHandler("mmap:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+
+  int retval = 0;
+  retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+
+  int64_t offset = 0;
+
+  offset = handler->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE);
+  VS_TUT_ENSURE_EQUALS("", 4546420, offset);
+
+  offset = handler->url_seek(-20, URLProtocolHandler::SK_SEEK_END);
+  VS_TUT_ENSURE_EQUALS("", 4546400, offset);
+  offset = handler->url_seek(-12, URLProtocolHandler::SK_SEEK_CUR);
+  VS_TUT_ENSURE_EQUALS("", 4546388, offset);
+  offset = handler->url_seek(-1, URLProtocolHandler::SK_SEEK_SET);
+  VS_TUT_ENSURE("", offset < 0);
+
+  unsigned char buf[2048];
+  retval = handler->url_read(buf, (int)sizeof(buf));
+  VS_TUT_ENSURE_EQUALS("", 32, retval);
+  retval = handler->url_read(buf, (int)sizeof(buf));
+  VS_TUT_ENSURE_EQUALS("", 0, retval);
+
+  offset = handler->url_seek(0, URLProtocolHandler::SK_SEEK_SET);
+  VS_TUT_ENSURE_EQUALS("", 0, offset);
+
+  // now ensure we can read back all the data
+  int32_t totalBytes = 0;
+  do {
+    retval = handler->url_read(buf, (int)sizeof(buf));
+    if (retval > 0)
+      totalBytes+= retval;
+  } while (retval > 0);
+  VS_TUT_ENSURE_EQUALS("", 4546420, totalBytes);
+
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testSeekableFlags()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  URLProtocolHandler* handler = MmapURLProtocolManager::findHandler("mmap:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+  URLProtocolHandler::SeekableFlags flags = handler->url_seekflags("mmap:foo", 0);
+  VS_TUT_ENSURE_EQUALS("", URLProtocolHandler::SK_SEEKABLE_NORMAL, flags);
+  delete handler;
+}
+
+void
+MmapURLProtocolHandlerTest :: testReadSpeedAgainstStdio()
+{
+  MmapURLProtocolManager::registerProtocol("mmap");
+  StdioURLProtocolManager::registerProtocol("test");
+  const char* protocols[] = { "test:foo", "mmap:foo" };
+  const int NUM_PASSES = 20;
+  double seconds[2];
+  for(int i = 0; i < 2; i++)
+  {
+    URLProtocolHandler* handler = URLProtocolManager::findHandler(protocols[i], 0,0);
+    VS_TUT_ENSURE("", handler);
+    std::clock_t start = std::clock();
+    for(int pass = 0; pass < NUM_PASSES; pass++)
+    {
+      int retval = handler->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+      VS_TUT_ENSURE("", retval >= 0);
+      int64_t totalBytes = 0;
+      do {
+        // the same size FFmpeg asks for
+        unsigned char buf[32768];
+        retval = handler->url_read(buf, (int)sizeof(buf));
+        if (retval > 0)
+          totalBytes+= retval;
+      } while (retval > 0);
+      VS_TUT_ENSURE_EQUALS("", 4546420, totalBytes);
+      retval = handler->url_close();
+      VS_TUT_ENSURE("", retval >= 0);
+    }
+    seconds[i] = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+    delete handler;
+  }
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_INFO, true);
+  VS_LOG_INFO("%d reads of %s: stdio: %.3fs; mmap: %.3fs",
+      NUM_PASSES, SAMPLE_FILE, seconds[0], seconds[1]);
+}
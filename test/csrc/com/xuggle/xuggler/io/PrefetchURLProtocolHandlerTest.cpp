@@ -0,0 +1,334 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+
+#include "PrefetchURLProtocolHandlerTest.h"
+
+#include <com/xuggle/ferry/LoggerStack.h>
+#include <com/xuggle/ferry/RefPointer.h>
+#include <com/xuggle/xuggler/IContainer.h>
+#include <com/xuggle/xuggler/IPacket.h>
+#include <com/xuggle/xuggler/io/PrefetchURLProtocolHandler.h>
+#include <com/xuggle/xuggler/io/StdioURLProtocolManager.h>
+
+using namespace VS_CPP_NAMESPACE;
+using namespace com::xuggle::ferry;
+using namespace com::xuggle::xuggler;
+
+VS_LOG_SETUP(VS_CPP_PACKAGE);
+
+/**
+ * Serves size bytes out of thin air, and refuses to seek past them.
+ */
+class PrefetchURLProtocolHandlerTest_Handler : public URLProtocolHandler
+{
+public:
+  PrefetchURLProtocolHandlerTest_Handler(int64_t size) :
+    URLProtocolHandler(0), mSize(size), mPosition(0) {}
+  static unsigned char byteAt(int64_t position)
+  {
+    return (unsigned char)(position*7);
+  }
+  virtual int url_open(const char *, int) { mPosition = 0; return 0; }
+  virtual int url_close() { return 0; }
+  virtual int url_read(unsigned char* buf, int size)
+  {
+    int bytesRead = 0;
+    for(; bytesRead < size && mPosition < mSize; bytesRead++)
+      buf[bytesRead] = byteAt(mPosition++);
+    return bytesRead;
+  }
+  virtual int url_write(const unsigned char*, int) { return -1; }
+  virtual int64_t url_seek(int64_t position, int whence)
+  {
+    if (whence == SK_SEEK_SIZE)
+      return mSize;
+    if (whence != SK_SEEK_SET || position < 0 || position > mSize)
+      return -1;
+    mPosition = position;
+    return mPosition;
+  }
+  virtual SeekableFlags url_seekflags(const char*, int)
+  {
+    return SK_SEEKABLE_NORMAL;
+  }
+private:
+  int64_t mSize;
+  int64_t mPosition;
+};
+
+PrefetchURLProtocolHandlerTest :: PrefetchURLProtocolHandlerTest()
+{
+     char *fixtureDirectory = getenv("VS_TEST_FIXTUREDIR");
+     if (fixtureDirectory)
+       snprintf(mFixtureDir, sizeof(mFixtureDir), "%s", fixtureDirectory);
+     else
+       snprintf(mFixtureDir, sizeof(mFixtureDir), ".");
+     FIXTURE_DIRECTORY = mFixtureDir;
+     SAMPLE_FILE = "testfile.flv";
+     snprintf(mSampleFile, sizeof(mSampleFile), "%s/%s", mFixtureDir, SAMPLE_FILE);
+     snprintf(mPrefetchFile, sizeof(mPrefetchFile), "prefetch:test:%s", mSampleFile);
+}
+
+PrefetchURLProtocolHandlerTest :: ~PrefetchURLProtocolHandlerTest()
+{
+}
+
+void
+PrefetchURLProtocolHandlerTest :: setUp()
+{
+  StdioURLProtocolManager::registerProtocol("test");
+}
+
+void
+PrefetchURLProtocolHandlerTest :: tearDown()
+{
+  URLProtocolManager::unregisterAllProtocols();
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testCreation()
+{
+  PrefetchURLProtocolManager::registerProtocol("prefetch");
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("prefetch:test:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+  delete handler;
+
+  // nothing to wrap
+  handler = URLProtocolManager::findHandler("prefetch:nosuchprotocol:foo", 0,0);
+  VS_TUT_ENSURE("", !handler);
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testRead()
+{
+  // small blocks so that we wrap around the ring many times
+  PrefetchURLProtocolManager* mgr =
+    PrefetchURLProtocolManager::registerProtocol("prefetch", 4096, 4);
+  URLProtocolHandler* handler = URLProtocolManager::findHandler(mPrefetchFile, 0,0);
+  VS_TUT_ENSURE("", handler);
+  URLProtocolHandler* direct = URLProtocolManager::findHandler("test:foo", 0,0);
+  VS_TUT_ENSURE("", direct);
+
+  int retval = 0;
+  retval = handler->url_open(mPrefetchFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+  retval = direct->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+
+  int32_t totalBytes = 0;
+  do {
+    unsigned char buf[3000];
+    unsigned char expected[3000];
+    retval = handler->url_read(buf, (int)sizeof(buf));
+    if (retval > 0)
+    {
+      // the ring may return a short read; ask for exactly that much
+      int expectedBytes = direct->url_read(expected, retval);
+      VS_TUT_ENSURE_EQUALS("", expectedBytes, retval);
+      VS_TUT_ENSURE("", memcmp(buf, expected, retval) == 0);
+      totalBytes+= retval;
+    }
+  } while (retval > 0);
+  VS_TUT_ENSURE_EQUALS("", 0, retval);
+  VS_TUT_ENSURE_EQUALS("", direct->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE),
+      totalBytes);
+
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  retval = direct->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+
+  VS_TUT_ENSURE("", mgr->getNumHits() + mgr->getNumStalls() > 0);
+  VS_TUT_ENSURE_EQUALS("", totalBytes, mgr->getNumBytesPrefetched());
+  delete handler;
+  delete direct;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testSeek()
+{
+  PrefetchURLProtocolManager* mgr =
+    PrefetchURLProtocolManager::registerProtocol("prefetch", 4096, 8);
+  URLProtocolHandler* handler = URLProtocolManager::findHandler(mPrefetchFile, 0,0);
+  VS_TUT_ENSURE("", handler);
+  URLProtocolHandler* direct = URLProtocolManager::findHandler("test:foo", 0,0);
+  VS_TUT_ENSURE("", direct);
+
+  int retval = 0;
+  retval = handler->url_open(mPrefetchFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+  retval = direct->url_open(mSampleFile, URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+
+  int64_t size = handler->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE);
+  VS_TUT_ENSURE_EQUALS("", direct->url_seek(0, URLProtocolHandler::SK_SEEK_SIZE),
+      size);
+  VS_TUT_ENSURE("", size > 100000);
+
+  // a mix of seeks backwards and forwards, both near (so they should
+  // land in data already read ahead) and far
+  const int64_t positions[] = {
+      0, 100, 50, 5000, 20000, size-1000, 1000, 1000, 3000, 2000, 40000,
+  };
+  for(size_t i = 0; i < sizeof(positions)/sizeof(*positions); i++)
+  {
+    int64_t position = positions[i];
+    int64_t offset = handler->url_seek(position, URLProtocolHandler::SK_SEEK_SET);
+    VS_TUT_ENSURE_EQUALS("", position, offset);
+    VS_TUT_ENSURE("", direct->url_seek(position, URLProtocolHandler::SK_SEEK_SET) >= 0);
+
+    int32_t totalBytes = 0;
+    while(totalBytes < 512)
+    {
+      unsigned char buf[512];
+      unsigned char expected[512];
+      retval = handler->url_read(buf, (int)sizeof(buf)-totalBytes);
+      VS_TUT_ENSURE("", retval > 0);
+      VS_TUT_ENSURE_EQUALS("", retval, direct->url_read(expected, retval));
+      VS_TUT_ENSURE("", memcmp(buf, expected, retval) == 0);
+      totalBytes += retval;
+    }
+  }
+
+  // relative seeks
+  int64_t offset = handler->url_seek(-1000, URLProtocolHandler::SK_SEEK_END);
+  VS_TUT_ENSURE_EQUALS("", size-1000, offset);
+  offset = handler->url_seek(-24, URLProtocolHandler::SK_SEEK_CUR);
+  VS_TUT_ENSURE_EQUALS("", size-1024, offset);
+  VS_TUT_ENSURE("", direct->url_seek(size-1024, URLProtocolHandler::SK_SEEK_SET) >= 0);
+  {
+    unsigned char buf[2048];
+    unsigned char expected[2048];
+    int32_t totalBytes = 0;
+    do {
+      retval = handler->url_read(buf+totalBytes, (int)sizeof(buf)-totalBytes);
+      if (retval > 0)
+        totalBytes += retval;
+    } while (retval > 0);
+    VS_TUT_ENSURE_EQUALS("", 1024, totalBytes);
+    VS_TUT_ENSURE_EQUALS("", 1024, direct->url_read(expected, (int)sizeof(expected)));
+    VS_TUT_ENSURE("", memcmp(buf, expected, 1024) == 0);
+  }
+
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  retval = direct->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+
+  VS_LOG_DEBUG("reused: %lld; invalidated: %lld",
+      (long long)mgr->getNumSeeksReused(),
+      (long long)mgr->getNumSeeksInvalidated());
+  VS_TUT_ENSURE("", mgr->getNumSeeksInvalidated() > 0);
+  delete handler;
+  delete direct;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testSeekFailure()
+{
+  const int64_t size = 100000;
+  URLProtocolHandler* handler = new PrefetchURLProtocolHandler(0,
+      new PrefetchURLProtocolHandlerTest_Handler(size), 4096, 4);
+
+  int retval = handler->url_open("memory", URLProtocolHandler::URL_RDONLY_MODE);
+  VS_TUT_ENSURE("", retval >= 0);
+
+  // a seek the wrapped handler refuses must fail right away, not on
+  // the next read
+  VS_TUT_ENSURE_EQUALS("", 50000,
+      handler->url_seek(50000, URLProtocolHandler::SK_SEEK_SET));
+  VS_TUT_ENSURE("", handler->url_seek(size+1, URLProtocolHandler::SK_SEEK_SET) < 0);
+  VS_TUT_ENSURE("", handler->url_seek(size*2, URLProtocolHandler::SK_SEEK_SET) < 0);
+
+  // and we can carry on from a good seek afterwards
+  const int64_t positions[] = { 1000, size-100 };
+  for(size_t i = 0; i < sizeof(positions)/sizeof(*positions); i++)
+  {
+    int64_t position = positions[i];
+    VS_TUT_ENSURE_EQUALS("", position,
+        handler->url_seek(position, URLProtocolHandler::SK_SEEK_SET));
+    unsigned char buf[100];
+    int32_t totalBytes = 0;
+    while(totalBytes < (int32_t)sizeof(buf))
+    {
+      retval = handler->url_read(buf+totalBytes, (int)sizeof(buf)-totalBytes);
+      VS_TUT_ENSURE("", retval > 0);
+      totalBytes += retval;
+    }
+    for(int32_t j = 0; j < totalBytes; j++)
+      VS_TUT_ENSURE_EQUALS("",
+          PrefetchURLProtocolHandlerTest_Handler::byteAt(position+j), buf[j]);
+  }
+
+  retval = handler->url_close();
+  VS_TUT_ENSURE("", retval >= 0);
+  delete handler;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testSeekableFlags()
+{
+  PrefetchURLProtocolManager::registerProtocol("prefetch");
+  URLProtocolHandler* handler = URLProtocolManager::findHandler("prefetch:test:foo", 0,0);
+  VS_TUT_ENSURE("", handler);
+  URLProtocolHandler::SeekableFlags flags = handler->url_seekflags("prefetch:test:foo", 0);
+  VS_TUT_ENSURE_EQUALS("", URLProtocolHandler::SK_SEEKABLE_NORMAL, flags);
+  delete handler;
+}
+
+void
+PrefetchURLProtocolHandlerTest :: testReadContainer()
+{
+  PrefetchURLProtocolManager* mgr =
+    PrefetchURLProtocolManager::registerProtocol("prefetch");
+  char directFile[4098];
+  snprintf(directFile, sizeof(directFile), "test:%s", mSampleFile);
+  const char* urls[] = { directFile, mPrefetchFile };
+  int32_t numPackets[2];
+  double seconds[2];
+  for(int i = 0; i < 2; i++)
+  {
+    std::clock_t start = std::clock();
+    RefPointer<IContainer> container = IContainer::make();
+    VS_TUT_ENSURE("", container->open(urls[i], IContainer::READ, 0) >= 0);
+    RefPointer<IPacket> packet = IPacket::make();
+    numPackets[i] = 0;
+    while(container->readNextPacket(packet.value()) >= 0)
+      ++numPackets[i];
+    VS_TUT_ENSURE("", container->close() >= 0);
+    seconds[i] = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+  }
+  VS_TUT_ENSURE("", numPackets[0] > 0);
+  VS_TUT_ENSURE_EQUALS("", numPackets[0], numPackets[1]);
+  VS_TUT_ENSURE("", mgr->getNumHits() + mgr->getNumStalls() > 0);
+
+  LoggerStack stack;
+  stack.setGlobalLevel(Logger::LEVEL_INFO, true);
+  VS_LOG_INFO("direct: %.3fs; prefetch: %.3fs; hits: %lld; stalls: %lld; "
+      "seeks reused: %lld; seeks invalidated: %lld",
+      seconds[0], seconds[1],
+      (long long)mgr->getNumHits(),
+      (long long)mgr->getNumStalls(),
+      (long long)mgr->getNumSeeksReused(),
+      (long long)mgr->getNumSeeksInvalidated());
+}
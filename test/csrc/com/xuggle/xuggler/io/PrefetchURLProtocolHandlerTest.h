@@ -0,0 +1,52 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+#ifndef PREFETCHURLPROTOCOLHANDLERTEST_H_
+#define PREFETCHURLPROTOCOLHANDLERTEST_H_
+
+#include <com/xuggle/testutils/TestUtils.h>
+#include <com/xuggle/ferry/Logger.h>
+#include <com/xuggle/xuggler/io/PrefetchURLProtocolManager.h>
+
+using namespace VS_CPP_NAMESPACE;
+
+
+class PrefetchURLProtocolHandlerTest: public CxxTest::TestSuite
+{
+public:
+  PrefetchURLProtocolHandlerTest();
+  virtual
+  ~PrefetchURLProtocolHandlerTest();
+  void setUp();
+  void tearDown();
+  void testCreation();
+  void testRead();
+  void testSeek();
+  void testSeekFailure();
+  void testSeekableFlags();
+  void testReadContainer();
+private:
+  const char * FIXTURE_DIRECTORY;
+  const char * SAMPLE_FILE;
+  char mFixtureDir[4098];
+  char mSampleFile[4098];
+  char mPrefetchFile[4098];
+};
+
+#endif /* PREFETCHURLPROTOCOLHANDLERTEST_H_ */
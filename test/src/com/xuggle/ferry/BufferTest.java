@@ -477,5 +477,42 @@ public class BufferTest
         0, JNIMemoryManager.getMgr().getNumPinnedObjects());
   }
 
+  @Test
+  public void testPooledMemoryModelRecyclesBuffers()
+  {
+    JNIMemoryManager.MemoryModel model = JNIMemoryManager.getMemoryModel();
+    long maxRetained = JNIMemoryManager.getPoolMaxRetainedBytes();
+    JNIMemoryManager.setMemoryModel(
+        JNIMemoryManager.MemoryModel.NATIVE_BUFFERS_POOLED);
+    try {
+      JNIMemoryManager.setPoolMaxRetainedBytes(1024*1024);
+      // prime the pool
+      IBuffer buf = IBuffer.make(null, 4000);
+      buf.delete();
+      long hits = JNIMemoryManager.getPoolHits();
+      for(int i = 0; i < 100; i++)
+      {
+        buf = IBuffer.make(null, 4000);
+        assertNotNull(buf);
+        assertTrue(buf.getBufferSize() >= 4000);
+        buf.delete();
+      }
+      assertTrue("expected buffers to be recycled",
+          JNIMemoryManager.getPoolHits() - hits >= 100);
+      assertTrue(JNIMemoryManager.getPoolRetainedBytes() <= 1024*1024);
+
+      // with no room to retain anything, everything should miss
+      JNIMemoryManager.setPoolMaxRetainedBytes(0);
+      long misses = JNIMemoryManager.getPoolMisses();
+      buf = IBuffer.make(null, 1024*1024*2);
+      buf.delete();
+      buf = IBuffer.make(null, 1024*1024*2);
+      buf.delete();
+      assertEquals(misses + 2, JNIMemoryManager.getPoolMisses());
+    } finally {
+      JNIMemoryManager.setPoolMaxRetainedBytes(maxRetained);
+      JNIMemoryManager.setMemoryModel(model);
+    }
+  }
 
 }
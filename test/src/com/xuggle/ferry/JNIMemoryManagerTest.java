@@ -0,0 +1,197 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+package com.xuggle.ferry;
+
+import static org.junit.Assert.*;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.concurrent.atomic.AtomicLong;
+
+import org.junit.*;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+public class JNIMemoryManagerTest
+{
+  private final Logger log = LoggerFactory.getLogger(this.getClass());
+
+  // how long each benchmark iteration runs for
+  private static final long WARMUP_MILLIS = 200;
+  private static final long MEASURE_MILLIS = 500;
+  private static final int MEASURE_ITERATIONS = 3;
+
+  @After
+  public void tearDown()
+  {
+    JNIMemoryManager.getMgr().gc(true);
+  }
+
+  @Test
+  public void testReferenceSegments()
+  {
+    final int numSegments = JNIMemoryManager.getMgr().getNumReferenceSegments();
+    assertTrue("should have at least one segment", numSegments > 0);
+    assertEquals("should be a power of two",
+        0, numSegments & (numSegments - 1));
+  }
+
+  @Test(timeout=60000)
+  public void testConcurrentAllocationsAreAllReleased()
+    throws InterruptedException
+  {
+    final JNIMemoryManager mgr = JNIMemoryManager.getMgr();
+    mgr.gc(true);
+    final long startingObjects = mgr.getNumPinnedObjects();
+
+    final int numThreads = Runtime.getRuntime().availableProcessors()*2;
+    // enough per thread to force each segment to sweep a few times
+    final int numObjects = mgr.getMinimumReferencesToCache()*4;
+    final AtomicBoolean failed = new AtomicBoolean(false);
+    final RefCountedTester[][] kept = new RefCountedTester[numThreads][];
+    Thread[] threads = new Thread[numThreads];
+    for(int i = 0; i < numThreads; i++)
+    {
+      final int thread = i;
+      threads[i] = new Thread(new Runnable() {
+        public void run()
+        {
+          // keep every tenth object alive so sweeps have survivors to move
+          RefCountedTester[] survivors = new RefCountedTester[numObjects/10];
+          for(int j = 0; j < numObjects; j++)
+          {
+            RefCountedTester obj = RefCountedTester.make();
+            if (obj == null) {
+              failed.set(true);
+              return;
+            }
+            if (j % 10 == 0 && j/10 < survivors.length)
+              survivors[j/10] = obj;
+            else
+              obj.delete();
+          }
+          kept[thread] = survivors;
+        }
+      }, "JNIMemoryManagerTest "+i);
+    }
+    for(Thread thread : threads)
+      thread.start();
+    for(Thread thread : threads)
+      thread.join();
+    assertFalse("could not make an object", failed.get());
+
+    long numKept = 0;
+    for(RefCountedTester[] survivors : kept)
+      numKept += survivors.length;
+    // objects from earlier tests may have been collected meanwhile, so
+    // all we can say is that none of ours went missing
+    assertTrue("lost some of the objects we kept",
+        mgr.getNumPinnedObjects() >= numKept);
+
+    for(RefCountedTester[] survivors : kept)
+      for(RefCountedTester obj : survivors)
+        obj.delete();
+    mgr.gc(true);
+    assertTrue("should have released every object we kept",
+        mgr.getNumPinnedObjects() <= startingObjects);
+  }
+
+  /**
+   * Not really a test; measures how many Ferry objects a second we can
+   * make and release as we add threads, in the same warmup-then-measure
+   * way a JMH benchmark would.  Every thread does nothing but allocate,
+   * so this is the worst case for contention in
+   * {@link JNIMemoryManager#addReference(JNIReference)}.
+   */
+  @Test(timeout=300000)
+  public void testAllocationThroughputByThreadCount()
+    throws InterruptedException
+  {
+    final int processors = Runtime.getRuntime().availableProcessors();
+    final int maxThreads = Math.max(4, processors*2);
+    log.info("Allocation throughput; processors: {}; segments: {}",
+        processors, JNIMemoryManager.getMgr().getNumReferenceSegments());
+    for(int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+    {
+      runAllocationThreads(numThreads, WARMUP_MILLIS);
+      long best = 0;
+      long worst = Long.MAX_VALUE;
+      long total = 0;
+      for(int i = 0; i < MEASURE_ITERATIONS; i++)
+      {
+        final long opsPerSecond = runAllocationThreads(numThreads,
+            MEASURE_MILLIS);
+        assertTrue("no objects allocated", opsPerSecond > 0);
+        best = Math.max(best, opsPerSecond);
+        worst = Math.min(worst, opsPerSecond);
+        total += opsPerSecond;
+      }
+      log.info("threads: {}; objects/sec: {} (min {}; max {})",
+          new Object[]{numThreads, total/MEASURE_ITERATIONS, worst, best});
+    }
+  }
+
+  /**
+   * Runs numThreads threads that make and delete objects for millis
+   * milliseconds.
+   * @return the number of objects made per second across all threads.
+   */
+  private long runAllocationThreads(final int numThreads, final long millis)
+    throws InterruptedException
+  {
+    final AtomicBoolean done = new AtomicBoolean(false);
+    final AtomicLong numAllocated = new AtomicLong(0);
+    final CountDownLatch ready = new CountDownLatch(numThreads);
+    final CountDownLatch start = new CountDownLatch(1);
+    Thread[] threads = new Thread[numThreads];
+    for(int i = 0; i < numThreads; i++)
+    {
+      threads[i] = new Thread(new Runnable() {
+        public void run()
+        {
+          long count = 0;
+          ready.countDown();
+          try {
+            start.await();
+          } catch (InterruptedException e) {
+            return;
+          }
+          while(!done.get())
+          {
+            RefCountedTester obj = RefCountedTester.make();
+            obj.delete();
+            ++count;
+          }
+          numAllocated.addAndGet(count);
+        }
+      }, "JNIMemoryManagerTest allocator "+i);
+      threads[i].start();
+    }
+    ready.await();
+    final long startTime = System.nanoTime();
+    start.countDown();
+    Thread.sleep(millis);
+    done.set(true);
+    for(Thread thread : threads)
+      thread.join();
+    final long elapsed = System.nanoTime() - startTime;
+    return numAllocated.get() * 1000L * 1000L * 1000L / elapsed;
+  }
+}
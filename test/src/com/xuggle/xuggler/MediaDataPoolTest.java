@@ -0,0 +1,110 @@
+/*******************************************************************************
+ * Copyright (c) 2008, 2010 Xuggle Inc.  All rights reserved.
+ *  
+ * This file is part of Xuggle-Xuggler-Main.
+ *
+ * Xuggle-Xuggler-Main is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Xuggle-Xuggler-Main is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Xuggle-Xuggler-Main.  If not, see <http://www.gnu.org/licenses/>.
+ *******************************************************************************/
+
+package com.xuggle.xuggler;
+
+import org.junit.*;
+import junit.framework.TestCase;
+
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+public class MediaDataPoolTest extends TestCase
+{
+  private final Logger log = LoggerFactory.getLogger(this.getClass());
+
+  private IMediaDataPool mPool=null;
+
+  @Before
+  public void setUp()
+  {
+    log.debug("Executing test case: {}", this.getName());
+    mPool = IMediaDataPool.make(8);
+  }
+
+  @After
+  public void tearDown()
+  {
+    if (mPool != null)
+      mPool.delete();
+    mPool = null;
+  }
+
+  @Test
+  public void testMake()
+  {
+    assertNotNull(mPool);
+    assertEquals(8, mPool.getMaxFreeObjects());
+    assertNull(IMediaDataPool.make(-1));
+  }
+
+  @Test
+  public void testRecycle()
+  {
+    IPacket packet = mPool.getPacket(1024);
+    assertNotNull(packet);
+    long ptr = IPacket.getCPtr(packet);
+    packet.setPts(42);
+    assertEquals(1, mPool.getNumOutstandingObjects());
+    mPool.recycle(packet);
+    assertEquals(0, mPool.getNumOutstandingObjects());
+    assertEquals(1, mPool.getNumFreeObjects());
+
+    packet = mPool.getPacket(1024);
+    assertEquals("packet not reused", ptr, IPacket.getCPtr(packet));
+    assertEquals(Global.NO_PTS, packet.getPts());
+    assertEquals(1, mPool.getHits());
+    mPool.recycle(packet);
+
+    IVideoPicture picture = mPool.getVideoPicture(IPixelFormat.Type.YUV420P,
+        320, 240);
+    assertNotNull(picture);
+    ptr = IVideoPicture.getCPtr(picture);
+    mPool.recycle(picture);
+    picture = mPool.getVideoPicture(IPixelFormat.Type.YUV420P, 320, 240);
+    assertEquals("picture not reused", ptr, IVideoPicture.getCPtr(picture));
+    mPool.recycle(picture);
+
+    IAudioSamples samples = mPool.getAudioSamples(1024, 2,
+        IAudioSamples.Format.FMT_S16);
+    assertNotNull(samples);
+    ptr = IAudioSamples.getCPtr(samples);
+    mPool.recycle(samples);
+    samples = mPool.getAudioSamples(1024, 2, IAudioSamples.Format.FMT_S16);
+    assertEquals("samples not reused", ptr, IAudioSamples.getCPtr(samples));
+    mPool.recycle(samples);
+
+    // null is ignored
+    mPool.recycle(null);
+    assertEquals(3, mPool.getNumFreeObjects());
+    mPool.clear();
+    assertEquals(0, mPool.getNumFreeObjects());
+  }
+
+  @Test
+  public void testObjectsOutliveThePool()
+  {
+    IAudioSamples samples = mPool.getAudioSamples(1024, 2,
+        IAudioSamples.Format.FMT_S16);
+    mPool.delete();
+    mPool = null;
+    assertEquals(1024, samples.getMaxSamples());
+    samples.delete();
+  }
+}
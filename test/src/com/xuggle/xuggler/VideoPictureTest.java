@@ -273,4 +273,31 @@ public class VideoPictureTest extends TestCase
     assertEquals(-1, pic.getDataLineSize(8));
     assertEquals(-1, pic.getDataLineSize(-1));
   }
+  
+  @Test
+  public void testCopyFromPackedRejectsMismatchedPictures()
+  {
+    final int WIDTH = 64;
+    final int HEIGHT = 48;
+    final byte[] bgr = new byte[WIDTH*HEIGHT*3];
+    final int[] argb = new int[WIDTH*HEIGHT];
+
+    // smaller than the image
+    IVideoPicture pic = IVideoPicture.make(IPixelFormat.Type.YUV420P,
+        WIDTH/2, HEIGHT/2);
+    assertFalse(pic.copyFromBGR24(bgr, 0, WIDTH*3, WIDTH, HEIGHT, 0));
+    assertFalse(pic.copyFromARGB(argb, 0, WIDTH, WIDTH, HEIGHT, 0));
+    assertFalse(pic.isComplete());
+
+    // the right size, but not YUV420P
+    pic = IVideoPicture.make(IPixelFormat.Type.GRAY8, WIDTH, HEIGHT);
+    assertFalse(pic.copyFromBGR24(bgr, 0, WIDTH*3, WIDTH, HEIGHT, 0));
+    assertFalse(pic.copyFromARGB(argb, 0, WIDTH, WIDTH, HEIGHT, 0));
+
+    // and a match works
+    pic = IVideoPicture.make(IPixelFormat.Type.YUV420P, WIDTH, HEIGHT);
+    assertTrue(pic.copyFromBGR24(bgr, 0, WIDTH*3, WIDTH, HEIGHT, 0));
+    assertTrue(pic.isComplete());
+    assertTrue(pic.copyFromARGB(argb, 0, WIDTH, WIDTH, HEIGHT, 0));
+  }
 }
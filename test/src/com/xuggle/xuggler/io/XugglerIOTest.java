@@ -28,6 +28,9 @@ import java.nio.channels.WritableByteChannel;
 
 import junit.framework.TestCase;
 
+import com.xuggle.xuggler.IContainer;
+import com.xuggle.xuggler.IPacket;
+
 import org.junit.*;
 
 public class XugglerIOTest extends TestCase
@@ -320,6 +323,57 @@ public class XugglerIOTest extends TestCase
     testFFMPEGUrlReadTestFile(mProtocolString + ":" + mSampleFile);
   }
 
+  @Test
+  public void testDirectReadThroughput()
+  {
+    final int passes = 5;
+    // hides FileProtocolHandler's ByteBuffer methods, so we go through
+    // a new byte[] per read
+    IURLProtocolHandler arrayHandler = new IURLProtocolHandler() {
+      private final FileProtocolHandler mFile =
+        new FileProtocolHandler(mSampleFile);
+      public int open(String url, int flags) { return mFile.open(null, flags); }
+      public int read(byte[] buf, int size) { return mFile.read(buf, size); }
+      public int write(byte[] buf, int size) { return mFile.write(buf, size); }
+      public long seek(long offset, int whence) { return mFile.seek(offset, whence); }
+      public int close() { return mFile.close(); }
+      public boolean isStreamed(String url, int flags) { return false; }
+    };
+    IURLProtocolHandler directHandler = new FileProtocolHandler(mSampleFile);
+
+    long arrayBytes = 0;
+    long directBytes = 0;
+    long arrayTime = 0;
+    long directTime = 0;
+    for(int i = 0; i < passes; i++)
+    {
+      long start = System.nanoTime();
+      arrayBytes = readAllPackets(arrayHandler);
+      arrayTime += System.nanoTime() - start;
+      start = System.nanoTime();
+      directBytes = readAllPackets(directHandler);
+      directTime += System.nanoTime() - start;
+    }
+    assertTrue(arrayBytes > 0);
+    assertEquals(arrayBytes, directBytes);
+    System.out.println("read " + mSampleFile + " x " + passes + ": " +
+        (passes * arrayBytes * 1e3 / arrayTime) + " MB/s with byte[]; " +
+        (passes * directBytes * 1e3 / directTime) + " MB/s with ByteBuffer");
+  }
+
+  private long readAllPackets(IURLProtocolHandler handler)
+  {
+    IContainer container = IContainer.make();
+    IPacket packet = IPacket.make();
+    assertTrue(container.open(XugglerIO.map(handler), IContainer.Type.READ,
+        null) >= 0);
+    long bytes = 0;
+    while (container.readNextPacket(packet) >= 0)
+      bytes += packet.getSize();
+    container.close();
+    return bytes;
+  }
+
   @Test
   public void testFFMPEGIOURLProtocolHandlerWrite()
   {
@@ -464,6 +464,101 @@ public class ConverterFactoryTest
       }
   }
 
+  // compares native YUV420P conversion against re-sampling, for both
+  // the pixels produced and frames per second
+
+  @Test
+  public void testNativeConversionAgainstResampling()
+  {
+    if (mPixelType != IPixelFormat.Type.YUV420P ||
+      !IVideoResampler.isSupported(Feature.FEATURE_COLORSPACECONVERSION))
+      return;
+
+    int w = 640;
+    int h = 480;
+    int frames = 50;
+    Random rnd = new Random(42);
+
+    // create a converter of each kind
+
+    IConverter resampling;
+    ConverterFactory.setNativeConversion(false);
+    try
+    {
+      resampling = ConverterFactory.createConverter(
+        mConverterType.getDescriptor(), mPixelType, w, h);
+    }
+    finally
+    {
+      ConverterFactory.setNativeConversion(true);
+    }
+    IConverter converter = ConverterFactory.createConverter(
+      mConverterType.getDescriptor(), mPixelType, w, h);
+    assertTrue(((AConverter)converter).willConvertNatively());
+    assertFalse(((AConverter)resampling).willConvertNatively());
+
+    // construct an image of random colors in 2x2 blocks, so chroma
+    // subsampling doesn't lose anything
+
+    BufferedImage image = new BufferedImage(
+      w, h, mConverterType.getImageType());
+    for (int x = 0; x < w; x += 2)
+      for (int y = 0; y < h; y += 2)
+      {
+        int color = new Color(rnd.nextInt(255), rnd.nextInt(255),
+          rnd.nextInt(255)).getRGB();
+        image.setRGB(x, y, color);
+        image.setRGB(x + 1, y, color);
+        image.setRGB(x, y + 1, color);
+        image.setRGB(x + 1, y + 1, color);
+      }
+
+    // both must agree, within the usual margin, both ways
+
+    IVideoPicture picture = resampling.toPicture(image, 0);
+    BufferedImage viaResampling = resampling.toImage(picture);
+    BufferedImage viaNative = converter.toImage(picture);
+    IVideoPicture nativePicture = converter.toPicture(image, 0);
+    BufferedImage roundTrip = resampling.toImage(nativePicture);
+    for (int x = 0; x < w; ++x)
+      for (int y = 0; y < h; ++y)
+      {
+        String message = testPixels(false, viaResampling.getRGB(x, y),
+          viaNative.getRGB(x, y), x, y, mPixelType);
+        assertNull(message, message);
+        message = testPixels(false, image.getRGB(x, y),
+          roundTrip.getRGB(x, y), x, y, mPixelType);
+        assertNull(message, message);
+      }
+    nativePicture.delete();
+
+    // and time them
+
+    long start = System.nanoTime();
+    for (int i = 0; i < frames; ++i)
+      resampling.toImage(picture);
+    long resamplingToImage = System.nanoTime() - start;
+    start = System.nanoTime();
+    for (int i = 0; i < frames; ++i)
+      converter.toImage(picture);
+    long nativeToImage = System.nanoTime() - start;
+    start = System.nanoTime();
+    for (int i = 0; i < frames; ++i)
+      resampling.toPicture(image, 0).delete();
+    long resamplingToPicture = System.nanoTime() - start;
+    start = System.nanoTime();
+    for (int i = 0; i < frames; ++i)
+      converter.toPicture(image, 0).delete();
+    long nativeToPicture = System.nanoTime() - start;
+    picture.delete();
+
+    System.out.println(mConverterType.getDescriptor() + " " + w + "x" + h +
+      " toImage: " + (frames * 1e9 / resamplingToImage) + " fps resampling, " +
+      (frames * 1e9 / nativeToImage) + " fps native; toPicture: " +
+      (frames * 1e9 / resamplingToPicture) + " fps resampling, " +
+      (frames * 1e9 / nativeToPicture) + " fps native");
+  }
+
   /**
    * Test two pixels, if the pixels are different, a detailed
    * description of the condition is returned, otherwise null is